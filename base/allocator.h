@@ -0,0 +1,43 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  allocator.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxBlockAllocator Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#ifndef _CxBlockAllocator_h_
+#define _CxBlockAllocator_h_
+
+
+//-------------------------------------------------------------------------
+// class CxBlockAllocator
+//
+// Source of raw memory blocks for the node pools.  A pool asks for large
+// blocks and carves them up itself, so the allocator is called rarely.
+// Blocks must be aligned for any type, as from ::operator new.
+//
+//-------------------------------------------------------------------------
+class CxBlockAllocator
+{
+  public:
+
+	virtual ~CxBlockAllocator( void ) { }
+	// destructor
+
+	virtual void *allocateBlock( size_t size ) = 0;
+	// return a block of at least size bytes
+
+	virtual void freeBlock( void *block ) = 0;
+	// give back a block returned by allocateBlock
+};
+
+
+#endif
@@ -0,0 +1,104 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  appendbench.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  appendbench.cpp
+//
+//  Times building a CxString one byte at a time, with append(), with +=
+//  and with a loop that reads length() on every pass, the way detab and
+//  the JSON writers build their lines.  Not part of the library, build it
+//  against libcx_base.a from this directory, all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o appendbench appendbench.cpp
+//        ../../lib/linux_x86_64/libcx_base.a -lpthread
+//
+//  Run as "appendbench [bytes]", the default is 10 MB.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include <cx/base/string.h>
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec + tv.tv_usec / 1e6 );
+}
+
+
+//-------------------------------------------------------------------------
+// report
+//
+//-------------------------------------------------------------------------
+static void
+report( const char *what, int bytes, int length, double elapsed )
+{
+	printf( "%-22s %10d bytes  %8.3f s  %8.2f ns per byte\n",
+	        what, length, elapsed, elapsed * 1e9 / bytes );
+
+	if (length != bytes) {
+		printf( "FAILED: expected %d bytes\n", bytes );
+		exit( 1 );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+	int bytes = argc > 1 ? atoi( argv[1] ) : 10 * 1024 * 1024;
+
+	// append( char )
+
+	CxString s1;
+	double start = now();
+
+	for (int i=0; i<bytes; i++) {
+		s1.append( (char) ('a' + i % 26) );
+	}
+
+	report( "append( char )", bytes, s1.length(), now() - start );
+
+	// += char
+
+	CxString s2;
+	start = now();
+
+	for (int i=0; i<bytes; i++) {
+		s2 += (char) ('a' + i % 26);
+	}
+
+	report( "+= char", bytes, s2.length(), now() - start );
+
+	// length() read on every pass
+
+	CxString s3;
+	start = now();
+
+	while (s3.length() < bytes) {
+		s3 += (char) ('a' + s3.length() % 26);
+	}
+
+	report( "length() and += char", bytes, s3.length(), now() - start );
+
+	return( 0 );
+}
@@ -0,0 +1,260 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  arena.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxArena Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <string.h>
+
+#include <cx/base/arena.h>
+#include <cx/base/exception.h>
+
+
+//-------------------------------------------------------------------------
+// every allocation is rounded up to this, enough for any built in type
+//
+//-------------------------------------------------------------------------
+#define ARENA_ALIGN  16
+
+
+//-------------------------------------------------------------------------
+// chunk header, the usable bytes follow it
+//
+//-------------------------------------------------------------------------
+struct CxArenaChunk
+{
+	CxArenaChunk *older;
+	size_t        size;     // usable bytes
+	double        align_;   // keeps the bytes after the header aligned
+	double        pad_;
+};
+
+
+static size_t
+roundUp( size_t size )
+{
+	return( (size + (ARENA_ALIGN - 1)) & ~((size_t) ARENA_ALIGN - 1) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::CxArena
+//
+//-------------------------------------------------------------------------
+CxArena::CxArena( size_t chunkSize_ )
+: _chunkSize( roundUp( chunkSize_ ) ), _chunk( NULL ), _next( NULL ), _end( NULL ),
+  _bytes( 0 ), _reserved( 0 ), _nChunks( 0 )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::~CxArena
+//
+//-------------------------------------------------------------------------
+CxArena::~CxArena( void )
+{
+	freeChunksAfter( NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::newChunk
+//
+//-------------------------------------------------------------------------
+void *
+CxArena::newChunk( size_t size )
+{
+	// allocations bigger than a chunk get a chunk of their own
+
+	size_t usable = (size > _chunkSize) ? size : _chunkSize;
+
+	CxArenaChunk *c = (CxArenaChunk *) ::operator new( sizeof(CxArenaChunk) + usable );
+
+	c->older = (CxArenaChunk *) _chunk;
+	c->size  = usable;
+
+	_chunk = c;
+	_next  = (char *) (c + 1);
+	_end   = _next + usable;
+
+	_reserved += usable;
+	_nChunks++;
+
+	return( _next );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::allocate
+//
+//-------------------------------------------------------------------------
+void *
+CxArena::allocate( size_t size )
+{
+	size = roundUp( size ? size : 1 );
+
+	if ( (size_t) (_end - _next) < size ) {
+		newChunk( size );
+	}
+
+	void *p = _next;
+	_next  += size;
+	_bytes += size;
+
+	return( p );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::strdup
+//
+//-------------------------------------------------------------------------
+char *
+CxArena::strdup( const char *s, size_t len )
+{
+	char *p = (char *) allocate( len + 1 );
+
+	memcpy( p, s, len );
+	p[len] = 0;
+
+	return( p );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::freeChunksAfter
+//
+//-------------------------------------------------------------------------
+void
+CxArena::freeChunksAfter( void *chunk )
+{
+	while ( _chunk != NULL && _chunk != chunk ) {
+
+		CxArenaChunk *c = (CxArenaChunk *) _chunk;
+
+		_chunk     = c->older;
+		_reserved -= c->size;
+		_nChunks--;
+
+		::operator delete( (void *) c );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::reset
+//
+//-------------------------------------------------------------------------
+void
+CxArena::reset( void )
+{
+	if (_chunk == NULL) return;
+
+	// keep the oldest chunk, it is at the end of the chain
+
+	CxArenaChunk *oldest = (CxArenaChunk *) _chunk;
+	while ( oldest->older != NULL ) oldest = oldest->older;
+
+	freeChunksAfter( oldest );
+
+	_next  = (char *) (oldest + 1);
+	_end   = _next + oldest->size;
+	_bytes = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::mark
+//
+//-------------------------------------------------------------------------
+CxArena::Mark
+CxArena::mark( void ) const
+{
+	Mark m;
+
+	m._chunk = _chunk;
+	m._used  = _chunk ? (size_t) (_next - (char *) ((CxArenaChunk *) _chunk + 1)) : 0;
+	m._bytes = _bytes;
+
+	return( m );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::rewind
+//
+//-------------------------------------------------------------------------
+void
+CxArena::rewind( const Mark& mark_ )
+{
+	if (mark_._chunk == NULL) {
+		reset();
+		return;
+	}
+
+	freeChunksAfter( mark_._chunk );
+
+	if (_chunk != mark_._chunk) {
+		throw CxException("CxArena::rewind(mark is not from this arena)");
+	}
+
+	CxArenaChunk *c = (CxArenaChunk *) _chunk;
+
+	_next  = (char *) (c + 1) + mark_._used;
+	_end   = (char *) (c + 1) + c->size;
+	_bytes = mark_._bytes;
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena:: statistics
+//
+//-------------------------------------------------------------------------
+size_t
+CxArena::bytesAllocated( void ) const
+{
+	return( _bytes );
+}
+
+size_t
+CxArena::bytesReserved( void ) const
+{
+	return( _reserved );
+}
+
+int
+CxArena::chunks( void ) const
+{
+	return( _nChunks );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::allocateBlock
+//
+//-------------------------------------------------------------------------
+/* virtual */
+void *
+CxArena::allocateBlock( size_t size )
+{
+	return( allocate( size ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArena::freeBlock
+//
+//-------------------------------------------------------------------------
+/* virtual */
+void
+CxArena::freeBlock( void * )
+{
+}
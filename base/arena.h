@@ -0,0 +1,172 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  arena.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxArena, CxArenaScope Classes
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <new>
+
+#include <cx/base/allocator.h>
+
+#ifndef _CxArena_h_
+#define _CxArena_h_
+
+
+//-------------------------------------------------------------------------
+// class CxArena
+//
+// Bump allocator for object graphs that all die at the same time, like
+// a parsed JSON document.  Memory comes from large chunks and is never
+// freed one object at a time; reset() or the destructor give it all back
+// at once.  Destructors of objects placed in an arena are not run, so
+// anything stored there must not own memory from anywhere else.
+//
+// A CxArena is also a CxBlockAllocator, so a CxListNodePool can carve its
+// list nodes out of one.
+//
+// An arena is not locked; use it from one thread at a time.
+//
+//-------------------------------------------------------------------------
+class CxArena : public CxBlockAllocator
+{
+  public:
+
+	//---------------------------------------------------------------------
+	// position in an arena, see mark() and rewind()
+	//
+	//---------------------------------------------------------------------
+	class Mark
+	{
+	  public:
+		Mark( void ) : _chunk( NULL ), _used( 0 ), _bytes( 0 ) { }
+
+	  private:
+		void   *_chunk;
+		size_t  _used;
+		size_t  _bytes;
+
+		friend class CxArena;
+	};
+
+	CxArena( size_t chunkSize_ = 64 * 1024 );
+	// constructor, memory is taken from the system chunkSize_ bytes at a time
+
+	~CxArena( void );
+	// destructor, frees every chunk
+
+	void *allocate( size_t size );
+	// return size bytes aligned for any type
+
+	char *strdup( const char *s, size_t len );
+	// copy len chars of s and a terminating null into the arena
+
+	void reset( void );
+	// release everything allocated from the arena.  The first chunk is kept
+	// so refilling the arena does not go back to the system
+
+	Mark mark( void ) const;
+	// return the current position
+
+	void rewind( const Mark& mark_ );
+	// release everything allocated since mark_ was taken
+
+	size_t bytesAllocated( void ) const;
+	// bytes handed out since construction or the last reset
+
+	size_t bytesReserved( void ) const;
+	// bytes held in chunks
+
+	int chunks( void ) const;
+	// number of chunks held
+
+	virtual void *allocateBlock( size_t size );
+	virtual void freeBlock( void *block );
+	// CxBlockAllocator interface; freeBlock does nothing, the block goes
+	// back with the rest of the arena
+
+  private:
+
+	CxArena( const CxArena& arena_ );
+	CxArena& operator=( const CxArena& arena_ );
+	// arenas cannot be copied
+
+	void *newChunk( size_t size );
+	// start a chunk that can hold at least size bytes
+
+	void freeChunksAfter( void *chunk );
+	// free every chunk newer than chunk, all of them if chunk is NULL
+
+	size_t  _chunkSize;
+	void   *_chunk;        // newest chunk, each chunk links to the older one
+	char   *_next;         // next free byte in the newest chunk
+	char   *_end;          // end of the newest chunk
+	size_t  _bytes;
+	size_t  _reserved;
+	int     _nChunks;
+};
+
+
+//-------------------------------------------------------------------------
+// class CxArenaScope
+//
+// Marks an arena on construction and rewinds it on destruction, so all
+// memory taken inside a block is released when the block exits.
+//
+//-------------------------------------------------------------------------
+class CxArenaScope
+{
+  public:
+
+	CxArenaScope( CxArena *arena_ ) : _arena( arena_ ), _mark( arena_->mark() ) { }
+
+	~CxArenaScope( void ) { _arena->rewind( _mark ); }
+
+  private:
+
+	CxArenaScope( const CxArenaScope& scope_ );
+	CxArenaScope& operator=( const CxArenaScope& scope_ );
+
+	CxArena       *_arena;
+	CxArena::Mark  _mark;
+};
+
+
+//-------------------------------------------------------------------------
+// placement new into an arena:  T *t = new (arena) T( ... );
+// objects made this way are never deleted.  A NULL arena falls back to
+// the normal heap, and the object is then deleted as usual, so code can
+// take an optional arena and use the one form of new
+//
+//-------------------------------------------------------------------------
+inline void *operator new( size_t size, CxArena *arena )
+{
+	if (arena == NULL) return( ::operator new( size ) );
+	return( arena->allocate( size ) );
+}
+
+inline void *operator new[]( size_t size, CxArena *arena )
+{
+	if (arena == NULL) return( ::operator new[]( size ) );
+	return( arena->allocate( size ) );
+}
+
+inline void operator delete( void *p, CxArena *arena )
+{
+	if (arena == NULL) ::operator delete( p );
+}
+
+inline void operator delete[]( void *p, CxArena *arena )
+{
+	if (arena == NULL) ::operator delete[]( p );
+}
+
+
+#endif
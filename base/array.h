@@ -0,0 +1,579 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  array.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxArray Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+#include <cx/base/exception.h>
+
+#ifndef _CxArray_h_
+#define _CxArray_h_
+
+
+//-------------------------------------------------------------------------
+// class CxArray
+//
+// Growable array of T kept in one contiguous block.  Indexing is O(1) and
+// append is amortized O(1); the block doubles when it fills.  The method
+// names follow CxSList so an indexed list can be switched over in place.
+//
+// When the block grows, or items are inserted or removed in the middle,
+// items are moved with memcpy rather than copied and destroyed, the same
+// way CxHashmap moves its slots.  T must not hold a pointer into itself.
+// References returned by operator[] and objectAt() are valid until the
+// next call that adds or removes items.
+//
+//-------------------------------------------------------------------------
+template <class T>
+class CxArray
+{
+public:
+
+	CxArray( void );
+	// constructor
+
+	CxArray( const CxArray<T>& array_ );
+	// copy constructor
+
+	~CxArray( void );
+	// destructor
+
+	CxArray<T>& operator=( const CxArray<T>& array_ );
+	// assignment operator
+
+	void append( const T& item );
+	// add item to the end of the array
+
+	void append( const CxArray<T>& array_ );
+	// add the items of another array to the end of the array
+
+	void insertAt( int i, const T& item );
+	// insert item so that it ends up at index i
+
+	void insertAtHead( const T& item );
+	// insert item at the front of the array
+
+	void insertAfter( int i, const T& item );
+	// insert item after index i
+
+	void push( const T& item );
+	// push an item onto the end of the array
+
+	T pop( void );
+	// remove the last item from the array
+
+	T peek( void ) const;
+	// get a copy of the last item in the array
+
+	void replaceAt( int i, const T& item );
+	// replace the item at index i
+
+	void removeAt( int i );
+	// remove the item at index i
+
+	void clear( void );
+	// clear the items from the array
+
+	void clearAndDelete( void );
+	// clear the items from the array and delete them
+
+	void reserve( int capacity_ );
+	// make room for capacity_ items without growing
+
+	size_t entries( void ) const;
+	// return the number of items in the array
+
+	int capacity( void ) const;
+	// return the number of items the array can hold without growing
+
+	T at( int i ) const;
+	// return a copy of the item at index i
+
+	T* objectAt( int i );
+	// return a pointer to the item at index i
+
+	T& operator[]( int i );
+	// return a reference to the item at index i (unchecked)
+
+	const T& operator[]( int i ) const;
+	// return a reference to the item at index i (unchecked)
+
+	void swap( int index1, int index2 );
+	// swap the two items in the array
+
+	void quickSort( void );
+	// sort the array using the items compare() method
+
+	// The following methods provide compatibility with STL.
+
+	void push_back( const T& item ) { append(item); }
+	size_t size() const { return _entries; }
+	int empty() const { return _entries == 0; }
+
+private:
+
+	void growTo( int capacity_ );
+	// move the items into a block of capacity_ items
+
+	void quickSort( int low, int high );
+	// sort the items between low and high inclusive
+
+	void checkIndex( int i ) const;
+	// throw if i is not the index of an item
+
+	T      *_items;
+	size_t  _entries;
+	int     _capacity;
+};
+
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::CxArray
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxArray<T>::CxArray( void )
+: _items( NULL ), _entries( 0 ), _capacity( 0 )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::CxArray
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxArray<T>::CxArray( const CxArray<T>& array_ )
+: _items( NULL ), _entries( 0 ), _capacity( 0 )
+{
+	append( array_ );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::~CxArray
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxArray<T>::~CxArray( void )
+{
+	clear();
+	::operator delete( (void *) _items );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::operator=
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxArray<T>&
+CxArray<T>::operator=( const CxArray<T>& array_ )
+{
+	if ( &array_ != this ) {
+		clear();
+		append( array_ );
+	}
+	return( *this );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::growTo
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::growTo( int capacity_ )
+{
+	T *newItems = (T *) ::operator new( sizeof(T) * capacity_ );
+
+	if (_entries) {
+		memcpy( (void *) newItems, (void *) _items, sizeof(T) * _entries );
+	}
+
+	::operator delete( (void *) _items );
+
+	_items    = newItems;
+	_capacity = capacity_;
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::reserve
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::reserve( int capacity_ )
+{
+	if ( capacity_ > _capacity ) {
+		growTo( capacity_ );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::append
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::append( const T& item )
+{
+	if ( (int) _entries == _capacity ) {
+
+		// item may live in this array, so copy it before the block moves
+
+		if ( _entries && &item >= _items && &item < _items + _entries ) {
+			T copy( item );
+			growTo( _capacity ? _capacity + _capacity : 8 );
+			new ((void *) &_items[_entries]) T( copy );
+			_entries++;
+			return;
+		}
+
+		growTo( _capacity ? _capacity + _capacity : 8 );
+	}
+
+	new ((void *) &_items[_entries]) T( item );
+	_entries++;
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::append
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::append( const CxArray<T>& array_ )
+{
+	int count = (int) array_._entries;
+
+	reserve( (int) _entries + count );
+
+	for (int c=0; c<count; c++) {
+		append( array_._items[c] );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::insertAt
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::insertAt( int i, const T& item )
+{
+	if ( i < 0 || i > (int) _entries ) {
+		throw CxException("CxArray::insertAt(invalid index)");
+	}
+
+	// build the copy first, item may live in this array
+
+	T copy( item );
+
+	if ( (int) _entries == _capacity ) {
+		growTo( _capacity ? _capacity + _capacity : 8 );
+	}
+
+	memmove( (void *) &_items[i+1], (void *) &_items[i], sizeof(T) * (_entries - i) );
+	new ((void *) &_items[i]) T( copy );
+	_entries++;
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::insertAtHead
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::insertAtHead( const T& item )
+{
+	insertAt( 0, item );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::insertAfter
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::insertAfter( int i, const T& item )
+{
+	insertAt( i+1, item );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::push
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::push( const T& item )
+{
+	append( item );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::pop
+//
+//-------------------------------------------------------------------------
+template <class T>
+T
+CxArray<T>::pop( void )
+{
+	if (_entries == 0) {
+		throw CxException("CxArray::pop(empty array)");
+	}
+
+	T item( _items[_entries-1] );
+	removeAt( (int) _entries-1 );
+
+	return( item );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::peek
+//
+//-------------------------------------------------------------------------
+template <class T>
+T
+CxArray<T>::peek( void ) const
+{
+	if (_entries == 0) {
+		throw CxException("CxArray::peek(empty array)");
+	}
+
+	return( _items[_entries-1] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::replaceAt
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::replaceAt( int i, const T& item )
+{
+	checkIndex( i );
+	_items[i] = item;
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::removeAt
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::removeAt( int i )
+{
+	checkIndex( i );
+
+	_items[i].~T();
+	memmove( (void *) &_items[i], (void *) &_items[i+1], sizeof(T) * (_entries - i - 1) );
+	_entries--;
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::clear
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::clear( void )
+{
+	for (size_t c=0; c<_entries; c++) {
+		_items[c].~T();
+	}
+	_entries = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::clearAndDelete
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::clearAndDelete( void )
+{
+	for (size_t c=0; c<_entries; c++) {
+		delete _items[c];
+	}
+	clear();
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::entries
+//
+//-------------------------------------------------------------------------
+template <class T>
+size_t
+CxArray<T>::entries( void ) const
+{
+	return( _entries );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::capacity
+//
+//-------------------------------------------------------------------------
+template <class T>
+int
+CxArray<T>::capacity( void ) const
+{
+	return( _capacity );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::checkIndex
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::checkIndex( int i ) const
+{
+	if ( i < 0 || i >= (int) _entries ) {
+		throw CxException("CxArray::at(invalid index)");
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::at
+//
+//-------------------------------------------------------------------------
+template <class T>
+T
+CxArray<T>::at( int i ) const
+{
+	checkIndex( i );
+	return( _items[i] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::objectAt
+//
+//-------------------------------------------------------------------------
+template <class T>
+T*
+CxArray<T>::objectAt( int i )
+{
+	checkIndex( i );
+	return( &_items[i] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::operator[]
+//
+//-------------------------------------------------------------------------
+template <class T>
+T&
+CxArray<T>::operator[]( int i )
+{
+	return( _items[i] );
+}
+
+template <class T>
+const T&
+CxArray<T>::operator[]( int i ) const
+{
+	return( _items[i] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::swap
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::swap( int index1, int index2 )
+{
+	if (index1 == index2) return;
+
+	checkIndex( index1 );
+	checkIndex( index2 );
+
+	// exchange the raw bytes, no copies of T are made
+
+	char temp[ sizeof(T) ];
+	memcpy( (void *) temp,             (void *) &_items[index1], sizeof(T) );
+	memcpy( (void *) &_items[index1],  (void *) &_items[index2], sizeof(T) );
+	memcpy( (void *) &_items[index2],  (void *) temp,            sizeof(T) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxArray<T>::quickSort
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxArray<T>::quickSort( void )
+{
+	quickSort( 0, (int) _entries - 1 );
+}
+
+template <class T>
+void
+CxArray<T>::quickSort( int low, int high )
+{
+	while (low < high) {
+
+		// middle element as pivot, moved to the end for the partition pass
+
+		swap( low + (high - low) / 2, high );
+
+		int i = low - 1;
+		for (int j=low; j<high; j++) {
+			if ( _items[j].compare( _items[high] ) <= 0 ) {
+				i++;
+				swap( i, j );
+			}
+		}
+		swap( i+1, high );
+
+		// recurse into the smaller side, loop on the larger to bound the stack
+
+		int pi = i+1;
+		if (pi - low < high - pi) {
+			quickSort( low, pi-1 );
+			low = pi+1;
+		} else {
+			quickSort( pi+1, high );
+			high = pi-1;
+		}
+	}
+}
+
+
+#endif
@@ -0,0 +1,140 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  arraybench.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  arraybench.cpp
+//
+//  Times indexed use of CxSList and CxArray side by side, append, at(),
+//  replaceAt() and removeAt(), and the CxPropertyList lookups that loop
+//  over an index.  Not part of the library, build it against libcx_base.a
+//  from this directory, all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o arraybench arraybench.cpp
+//        ../../lib/linux_x86_64/libcx_base.a -lpthread
+//
+//  Run as "arraybench [items]", the default is 10000 items.  Build it with
+//  -DNO_CXARRAY to time only the property list against a tree that has no
+//  CxArray.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include <cx/base/string.h>
+#include <cx/base/slist.h>
+#include <cx/base/prop.h>
+
+#if !defined(NO_CXARRAY)
+#include <cx/base/array.h>
+#endif
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec + tv.tv_usec / 1e6 );
+}
+
+
+#if !defined(NO_CXARRAY)
+
+//-------------------------------------------------------------------------
+// timeList
+//
+// the same calls on either container, L is CxSList or CxArray
+//
+//-------------------------------------------------------------------------
+template <class L>
+static void
+timeList( const char *what, const CxString *items, int n )
+{
+	L list;
+	long sum = 0;
+
+	double start = now();
+	for (int i=0; i<n; i++) list.append( items[i] );
+	double appended = now() - start;
+
+	start = now();
+	for (int i=0; i<n; i++) sum += list.at( i ).length();
+	double indexed = now() - start;
+
+	start = now();
+	for (int i=0; i<n; i++) list.replaceAt( i, items[n - 1 - i] );
+	double replaced = now() - start;
+
+	start = now();
+	while (list.entries()) {
+		sum += list.at( (int) list.entries() / 2 ).length();
+		list.removeAt( (int) list.entries() / 2 );
+	}
+	double removed = now() - start;
+
+	printf( "%-8s append %8.4f s  at %8.4f s  replaceAt %8.4f s  removeAt middle %8.4f s  (%ld)\n",
+	        what, appended, indexed, replaced, removed, sum );
+}
+
+#endif
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+	int n = argc > 1 ? atoi( argv[1] ) : 10000;
+
+	char buffer[32];
+
+	CxString *items = new CxString[n];
+
+	for (int i=0; i<n; i++) {
+		sprintf( buffer, "item%d", i );
+		items[i] = buffer;
+	}
+
+	printf( "%d items\n", n );
+
+#if !defined(NO_CXARRAY)
+	timeList< CxSList<CxString> >( "CxSList", items, n );
+	timeList< CxArray<CxString> >( "CxArray", items, n );
+#endif
+
+	// CxPropertyList looks every name up by index
+
+	CxPropertyList props;
+	int failed = 0;
+
+	double start = now();
+	for (int i=0; i<n; i++) props.set( items[i], items[i] );
+	double set = now() - start;
+
+	start = now();
+	for (int i=0; i<n; i++) {
+		if (props.get( items[i] ) != items[i]) failed = 1;
+	}
+	double got = now() - start;
+
+	printf( "CxPropertyList set %8.4f s  get %8.4f s\n", set, got );
+
+	delete [] items;
+
+	printf( failed ? "FAILED\n" : "passed\n" );
+
+	return( failed ? 1 : 0 );
+}
@@ -0,0 +1,103 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  atomic.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxAtomicCount Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <cx/base/atomic.h>
+
+#if defined(_LINUX_) || defined(_OSX_) || defined(_IRIX6_)
+#include <pthread.h>
+#endif
+
+#if defined(WIN32)
+#include <windows.h>
+#endif
+
+
+//-------------------------------------------------------------------------
+// one lock guards every count when there are no atomic builtins.  Counts
+// change rarely enough that sharing it costs little
+//
+//-------------------------------------------------------------------------
+#if defined(_LINUX_) || defined(_OSX_) || defined(_IRIX6_)
+static pthread_mutex_t countLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+//-------------------------------------------------------------------------
+// CxAtomicCount::lockedAdd
+//
+//-------------------------------------------------------------------------
+/* static */
+int
+CxAtomicCount::lockedAdd( volatile int *value_, int delta_ )
+{
+#if defined(WIN32)
+	return( InterlockedExchangeAdd( (volatile LONG *) value_, delta_ ) + delta_ );
+#else
+
+#if defined(_LINUX_) || defined(_OSX_) || defined(_IRIX6_)
+	pthread_mutex_lock( &countLock );
+#endif
+
+	int result = (*value_ += delta_);
+
+#if defined(_LINUX_) || defined(_OSX_) || defined(_IRIX6_)
+	pthread_mutex_unlock( &countLock );
+#endif
+
+	return( result );
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxAtomicCount::lockedSet
+//
+//-------------------------------------------------------------------------
+/* static */
+void
+CxAtomicCount::lockedSet( volatile int *value_, int newValue_ )
+{
+#if defined(WIN32)
+	InterlockedExchange( (volatile LONG *) value_, newValue_ );
+#else
+
+#if defined(_LINUX_) || defined(_OSX_) || defined(_IRIX6_)
+	pthread_mutex_lock( &countLock );
+#endif
+
+	*value_ = newValue_;
+
+#if defined(_LINUX_) || defined(_OSX_) || defined(_IRIX6_)
+	pthread_mutex_unlock( &countLock );
+#endif
+
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxAtomicCount::mode
+//
+//-------------------------------------------------------------------------
+/* static */
+const char *
+CxAtomicCount::mode( void )
+{
+#if defined(CX_ATOMIC_BUILTINS)
+	return( "atomic" );
+#elif defined(CX_ATOMIC_SYNC)
+	return( "sync" );
+#else
+	return( "mutex" );
+#endif
+}
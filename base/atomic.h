@@ -0,0 +1,149 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  atomic.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxAtomicCount Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#ifndef _CxAtomicCount_h_
+#define _CxAtomicCount_h_
+
+
+//-------------------------------------------------------------------------
+// pick how counts are updated.  The __atomic builtins came with gcc 4.7
+// and the __sync ones with gcc 4.1; anything older takes a lock.  Define
+// CX_ATOMIC_MUTEX to force the lock, for testing the fallback
+//
+//-------------------------------------------------------------------------
+#if !defined(CX_ATOMIC_MUTEX)
+#if defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+#define CX_ATOMIC_BUILTINS
+#elif defined(__GNUC__) && (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)
+#define CX_ATOMIC_SYNC
+#endif
+#endif
+
+
+//-------------------------------------------------------------------------
+// class CxAtomicCount
+//
+// An int that several threads can count up and down at once, for the
+// reference counts in CxCountedBody and CxCounted.  Each change returns
+// the new value, so exactly one thread sees a count reach zero.
+//
+//-------------------------------------------------------------------------
+class CxAtomicCount
+{
+  public:
+
+	CxAtomicCount( int value_ = 0 ) : _value( value_ ) { }
+	// constructor
+
+	int increment( void );
+	// add one and return the new value
+
+	int decrement( void );
+	// subtract one and return the new value
+
+	int value( void ) const;
+	// return the current value
+
+	void set( int value_ );
+	// replace the value
+
+	static const char *mode( void );
+	// how counts are updated: "atomic", "sync" or "mutex"
+
+  private:
+
+	static int lockedAdd( volatile int *value_, int delta_ );
+	static void lockedSet( volatile int *value_, int newValue_ );
+	// the fallback, change the value under a lock
+
+	volatile int _value;
+};
+
+
+//-------------------------------------------------------------------------
+// CxAtomicCount::increment
+//
+// taking another reference needs no ordering, the holder already has one
+//
+//-------------------------------------------------------------------------
+inline int
+CxAtomicCount::increment( void )
+{
+#if defined(CX_ATOMIC_BUILTINS)
+	return( __atomic_add_fetch( &_value, 1, __ATOMIC_RELAXED ) );
+#elif defined(CX_ATOMIC_SYNC)
+	return( __sync_add_and_fetch( &_value, 1 ) );
+#else
+	return( lockedAdd( &_value, 1 ) );
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxAtomicCount::decrement
+//
+// dropping a reference orders this thread's writes before whoever frees
+// the object
+//
+//-------------------------------------------------------------------------
+inline int
+CxAtomicCount::decrement( void )
+{
+#if defined(CX_ATOMIC_BUILTINS)
+	return( __atomic_sub_fetch( &_value, 1, __ATOMIC_ACQ_REL ) );
+#elif defined(CX_ATOMIC_SYNC)
+	return( __sync_sub_and_fetch( &_value, 1 ) );
+#else
+	return( lockedAdd( &_value, -1 ) );
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxAtomicCount::value
+//
+//-------------------------------------------------------------------------
+inline int
+CxAtomicCount::value( void ) const
+{
+#if defined(CX_ATOMIC_BUILTINS)
+	return( __atomic_load_n( &_value, __ATOMIC_ACQUIRE ) );
+#elif defined(CX_ATOMIC_SYNC)
+	return( __sync_add_and_fetch( (volatile int *) &_value, 0 ) );
+#else
+	return( lockedAdd( (volatile int *) &_value, 0 ) );
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxAtomicCount::set
+//
+//-------------------------------------------------------------------------
+inline void
+CxAtomicCount::set( int value_ )
+{
+#if defined(CX_ATOMIC_BUILTINS)
+	__atomic_store_n( &_value, value_, __ATOMIC_RELEASE );
+#elif defined(CX_ATOMIC_SYNC)
+	__sync_lock_test_and_set( &_value, value_ );
+	__sync_synchronize();
+#else
+	lockedSet( &_value, value_ );
+#endif
+}
+
+
+#endif
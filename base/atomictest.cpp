@@ -0,0 +1,228 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  atomictest.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  atomictest.cpp
+//
+//  Stress test and timing for the reference counts in CxCountedBody and
+//  CxHandle.  Not part of the library, build it against libcx_base.a
+//  from this directory, all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o atomictest atomictest.cpp
+//        ../../lib/linux_x86_64/libcx_base.a -lpthread
+//
+//  Add -DCX_ATOMIC_MUTEX, and build the library with it too, to test the
+//  locked fallback.  Run as "atomictest [threads] [iterations]".
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include <cx/base/atomic.h>
+#include <cx/base/cntbody.h>
+#include <cx/base/handle.h>
+
+
+#define MAX_THREADS 64
+
+
+static volatile int destroyed = 0;
+static int          iterations = 2000000;
+
+
+//-------------------------------------------------------------------------
+// Counted
+//
+// the object behind the shared handle, counts its destruction
+//
+//-------------------------------------------------------------------------
+class Counted
+{
+  public:
+	Counted( void ) : value( 7 ) { }
+	~Counted( void ) { __sync_add_and_fetch( &destroyed, 1 ); }
+	int value;
+};
+
+
+static CxHandle<Counted> *sharedHandle;
+static CxCountedBody     *sharedBody;
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec + tv.tv_usec / 1e6 );
+}
+
+
+//-------------------------------------------------------------------------
+// handleWorker
+//
+// copy and assign the shared handle, each one takes and drops a reference
+//
+//-------------------------------------------------------------------------
+static void *
+handleWorker( void * )
+{
+	long sum = 0;
+
+	for (int i=0; i<iterations; i++) {
+		CxHandle<Counted> copy( *sharedHandle );
+		CxHandle<Counted> assigned;
+		assigned = copy;
+		sum += assigned->value;
+	}
+
+	return( (void *) sum );
+}
+
+
+//-------------------------------------------------------------------------
+// bodyWorker
+//
+//-------------------------------------------------------------------------
+static void *
+bodyWorker( void * )
+{
+	for (int i=0; i<iterations; i++) {
+		sharedBody->incCount();
+		sharedBody->decCount();
+	}
+
+	return( NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// runThreads
+//
+//-------------------------------------------------------------------------
+static double
+runThreads( int threads, void *(*worker)( void * ) )
+{
+	pthread_t id[ MAX_THREADS ];
+
+	double start = now();
+
+	for (int t=0; t<threads; t++) pthread_create( &id[t], NULL, worker, NULL );
+	for (int t=0; t<threads; t++) pthread_join( id[t], NULL );
+
+	return( now() - start );
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+	int threads = argc > 1 ? atoi( argv[1] ) : 8;
+	if (argc > 2) iterations = atoi( argv[2] );
+
+	if (threads < 1) threads = 1;
+	if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+	int failed = 0;
+
+	printf( "counts are updated by: %s\n", CxAtomicCount::mode() );
+
+	// every handle is dropped before the last one, so the object must be
+	// destroyed exactly once, and only when the shared handle goes
+
+	for (int round=0; round<3; round++) {
+
+		destroyed    = 0;
+		sharedHandle = new CxHandle<Counted>( new Counted );
+
+		double elapsed = runThreads( threads, handleWorker );
+
+		if (destroyed != 0) {
+			printf( "FAILED: object destroyed while handles were held\n" );
+			failed = 1;
+		}
+
+		delete sharedHandle;
+
+		if (destroyed != 1) {
+			printf( "FAILED: object destroyed %d times\n", destroyed );
+			failed = 1;
+		}
+
+		printf( "%d threads x %d handle copy+assign: %.3f s, %.1f ns per reference\n",
+		        threads, iterations, elapsed, elapsed * 1e9 / (2.0 * iterations * threads) );
+	}
+
+	// balanced increments and decrements leave the count where it began
+
+	sharedBody = new CxCountedBody;
+	sharedBody->incCount();
+
+	double elapsed = runThreads( threads, bodyWorker );
+
+	if (sharedBody->count() != 1) {
+		printf( "FAILED: count is %d after balanced updates, not 1\n", sharedBody->count() );
+		failed = 1;
+	}
+
+	printf( "%d threads x %d incCount+decCount: %.3f s, %.1f ns per pair\n",
+	        threads, iterations, elapsed, elapsed * 1e9 / ((double) iterations * threads) );
+
+	delete sharedBody;
+
+	// the cost on one thread, next to a plain int
+
+	CxHandle<Counted> handle( new Counted );
+	long   sum   = 0;
+	double start = now();
+
+	for (int i=0; i<10 * iterations; i++) {
+		CxHandle<Counted> copy( handle );
+		sum += copy->value;
+	}
+
+	elapsed = now() - start;
+	printf( "1 thread handle copy+destroy: %.1f ns\n", elapsed * 1e9 / (10.0 * iterations) );
+
+	CxCountedBody body;
+	start = now();
+
+	for (int i=0; i<10 * iterations; i++) {
+		body.incCount();
+		body.decCount();
+	}
+
+	elapsed = now() - start;
+	printf( "1 thread incCount+decCount:   %.1f ns\n", elapsed * 1e9 / (10.0 * iterations) );
+
+	volatile int plain = 0;
+	start = now();
+
+	for (int i=0; i<10 * iterations; i++) {
+		plain++;
+		plain--;
+	}
+
+	elapsed = now() - start;
+	printf( "1 thread plain int ++/--:     %.1f ns\n", elapsed * 1e9 / (10.0 * iterations) );
+
+	printf( failed ? "FAILED\n" : "passed\n" );
+
+	return( failed ? 1 : 0 );
+}
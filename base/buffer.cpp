@@ -11,17 +11,72 @@
 //
 //-------------------------------------------------------------------------------------------------
 
+#include <new>
+
 #include <cx/base/buffer.h>
+#include <cx/base/cntbody.h>
 
 using namespace std;
 
 
+//-------------------------------------------------------------------------
+// class CxBufferBody
+//
+// Bytes shared by copies of a CxBuffer, stored after the body in the same
+// allocation.
+//
+//-------------------------------------------------------------------------
+class CxBufferBody : public CxCountedBody
+{
+  public:
+
+	static CxBufferBody *create( unsigned int len_ );
+	// return a body with room for len_ bytes, held once
+
+	static void release( CxBufferBody *body_ );
+	// drop one hold on body_, freeing it with the last
+
+	unsigned char *bytes( void ) { return( (unsigned char *) (this + 1) ); }
+	// return the bytes
+};
+
+
+//-------------------------------------------------------------------------
+// CxBufferBody::create
+//
+//-------------------------------------------------------------------------
+CxBufferBody *
+CxBufferBody::create( unsigned int len_ )
+{
+	void *p = ::operator new( sizeof(CxBufferBody) + len_ );
+
+	CxBufferBody *body = new (p) CxBufferBody;
+	body->incCount();
+
+	return( body );
+}
+
+
+//-------------------------------------------------------------------------
+// CxBufferBody::release
+//
+//-------------------------------------------------------------------------
+void
+CxBufferBody::release( CxBufferBody *body_ )
+{
+	if ( body_->decCount() == 0 ) {
+		body_->~CxBufferBody();
+		::operator delete( (void *) body_ );
+	}
+}
+
+
 //-------------------------------------------------------------------------
 // CxBuffer::CxBuffer
 //
 //-------------------------------------------------------------------------
 CxBuffer::CxBuffer( void ): 
-_data( NULL ), _len(0)
+_data( NULL ), _len(0), _body( NULL )
 {
 }
 
@@ -31,13 +86,13 @@ _data( NULL ), _len(0)
 //
 //-------------------------------------------------------------------------
 CxBuffer::CxBuffer( size_t len_ ): 
-_data( NULL ), _len(0)
+_data( NULL ), _len(0), _body( NULL )
 {
-    unsigned char *cptr = new unsigned char[ len_ ];
-    memset( cptr, 0, len_);
-
-    _data = cptr;
+    _body = CxBufferBody::create( len_ );
+    _data = _body->bytes();
     _len  = len_;
+
+    memset( _data, 0, len_);
 }
 
 
@@ -46,7 +101,7 @@ _data( NULL ), _len(0)
 //
 //-------------------------------------------------------------------------
 CxBuffer::CxBuffer( const void* b_, unsigned int len_ )
-: _data(NULL), _len(0)
+: _data(NULL), _len(0), _body( NULL )
 {
     reAssign( b_, len_ );
 }
@@ -57,10 +112,10 @@ CxBuffer::CxBuffer( const void* b_, unsigned int len_ )
 //
 //-------------------------------------------------------------------------
 CxBuffer::CxBuffer( const CxBuffer& b_ )
-: _data(NULL), _len(0)
+: _data(NULL), _len(0), _body( NULL )
 {
     if ( &b_ != this ) {
-	reAssign( b_.data(), b_.length() );
+        *this = b_;
     }
 }
 
@@ -71,7 +126,7 @@ CxBuffer::CxBuffer( const CxBuffer& b_ )
 //-------------------------------------------------------------------------
 CxBuffer::~CxBuffer( void )
 {
-	if (_len) delete[] _data;	
+	release();
 }
 
 
@@ -82,8 +137,16 @@ CxBuffer::~CxBuffer( void )
 CxBuffer&
 CxBuffer::operator=( const CxBuffer& b_ )
 {
-    if ( &b_ != this ) {
-    	reAssign( b_.data(), b_.length() );
+    // share the body rather than copying the bytes
+
+    if ( &b_ != this && b_._body != _body ) {
+
+        if (b_._body) b_._body->incCount();
+        release();
+
+        _body = b_._body;
+        _data = b_._data;
+        _len  = b_._len;
     }
     return( *this );
 }
@@ -98,14 +161,15 @@ CxBuffer::append( void *buffer_ , unsigned int len_ )
 {
     unsigned int newLen = _len + len_;
 
-    unsigned char *cptr = new unsigned char[ newLen ];
-    memset( cptr, 0, newLen );
+    CxBufferBody  *body = CxBufferBody::create( newLen );
+    unsigned char *cptr = body->bytes();
 
-    memcpy( cptr, &(_data[0]), _len );
-    memcpy( &(cptr[_len]), buffer_, len_ );
+    if (_len) memcpy( cptr, &(_data[0]), _len );
+    if (len_) memcpy( &(cptr[_len]), buffer_, len_ );
 
-    if (_len) delete[] _data;	
+    release();
 
+    _body = body;
     _data = cptr;
     _len  = newLen;
 }
@@ -118,16 +182,36 @@ CxBuffer::append( void *buffer_ , unsigned int len_ )
 void
 CxBuffer::reAssign( const void *vptr_, int len_ )
 {
-    if (_len) delete[] _data;	
+    CxBufferBody  *body = CxBufferBody::create( len_ );
+    unsigned char *cptr = body->bytes();
 
-    unsigned char *cptr = new unsigned char[ len_ ];
-    memcpy( cptr, vptr_, len_ );
+    if (len_) memcpy( cptr, vptr_, len_ );
 
+    // the source may be our own bytes, let go of them only after the copy
+
+    release();
+
+    _body = body;
     _data = cptr;
     _len  = len_;
 }
 
 
+//-------------------------------------------------------------------------
+// CxBuffer::release
+//
+//-------------------------------------------------------------------------
+void
+CxBuffer::release( void )
+{
+    if (_body) CxBufferBody::release( _body );
+
+    _body = NULL;
+    _data = NULL;
+    _len  = 0;
+}
+
+
 //-------------------------------------------------------------------------
 // CxBuffer::data
 //
@@ -135,6 +219,12 @@ CxBuffer::reAssign( const void *vptr_, int len_ )
 void *
 CxBuffer::data( void ) const
 {
+	// callers write through this pointer, so it must not be a shared body
+
+	if ( _body != NULL && _body->count() > 1 ) {
+		((CxBuffer *) this)->reAssign( _data, _len );
+	}
+
 	return( _data );
 }
 
@@ -222,11 +312,14 @@ ostream& operator<<(ostream& str, const CxBuffer& b_ )
 unsigned int
 CxBuffer::hashValue( void ) const
 {
-	unsigned int i = 0;
+	// 32 bit FNV-1a, same as CxString::hashValue
+
+	unsigned int h = 2166136261U;
 
 	for (unsigned int c=0; c<_len; c++) {
-		i += (unsigned int) _data[c];
+		h ^= (unsigned int) _data[c];
+		h *= 16777619U;
 	}
 	
-	return( i );
+	return( h );
 }
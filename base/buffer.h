@@ -44,11 +44,15 @@
 #define _CxBuffer_h_
 
 
+class CxBufferBody;
 
 
 //-------------------------------------------------------------------------
 // class CxBuffer
 //
+// The bytes live in a reference counted body that copies share until one
+// of them is changed.
+//
 //------------------------------------------------------------------------- 
 class CxBuffer
 {
@@ -79,7 +83,8 @@ class CxBuffer
 	// return the length of self
 
 	void *data( void ) const;
-	// return a pointer to data
+	// return a pointer to data.  The pointer may be written through, so a
+	// body shared with other buffers is copied first
 
 	int isEmpty( void ) const;
 	// return true if item has no data
@@ -95,11 +100,17 @@ class CxBuffer
 	void reAssign( const void *, int len=-1 );
 	// internal reassignment
 
+	void release( void );
+	// drop this buffer's hold on its body
+
 	unsigned char *_data;
-	// internal pointer 
+	// internal pointer, into _body
 
 	unsigned _len;
 	// internal length
+
+	CxBufferBody *_body;
+	// shared body holding the bytes, NULL when there are none
 };
 
 
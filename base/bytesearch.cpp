@@ -0,0 +1,602 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  bytesearch.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxByteSearch Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <string.h>
+
+#include <cx/base/bytesearch.h>
+
+
+//-------------------------------------------------------------------------
+// SSE2 is part of every x86_64 processor and the compiler says when it
+// may be used.  AVX2 code is compiled with a per function target and only
+// called after asking the processor, so no build flags are needed.
+//
+//-------------------------------------------------------------------------
+#if defined(__SSE2__)
+#define CX_SEARCH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(CX_SEARCH_SSE2) && defined(__x86_64__) && \
+	( defined(__clang__) || ( defined(__GNUC__) && (__GNUC__ >= 5) ) )
+#define CX_SEARCH_AVX2
+#include <immintrin.h>
+#define CX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+
+static int _limit    = CxByteSearch::AVX2;
+static int _detected = -1;
+
+
+//-------------------------------------------------------------------------
+// detectLevel
+//
+//-------------------------------------------------------------------------
+static int
+detectLevel( void )
+{
+	if (_detected == -1) {
+
+		int found = CxByteSearch::SCALAR;
+
+#if defined(CX_SEARCH_SSE2)
+		found = CxByteSearch::SSE2;
+#endif
+
+#if defined(CX_SEARCH_AVX2)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) found = CxByteSearch::AVX2;
+#endif
+
+		_detected = found;
+	}
+
+	return( _detected < _limit ? _detected : _limit );
+}
+
+
+//-------------------------------------------------------------------------
+// scalar versions, also used for the ends of the vector loops
+//
+//-------------------------------------------------------------------------
+static const char *
+scalarFindByte( const char *s, size_t len, char ch )
+{
+	for (size_t c=0; c<len; c++) {
+		if ( s[c] == ch ) return( s + c );
+	}
+	return( NULL );
+}
+
+static const char *
+scalarFindLastByte( const char *s, size_t len, char ch )
+{
+	while (len > 0) {
+		len--;
+		if ( s[len] == ch ) return( s + len );
+	}
+	return( NULL );
+}
+
+static size_t
+scalarCountByte( const char *s, size_t len, char ch )
+{
+	size_t n = 0;
+	for (size_t c=0; c<len; c++) {
+		if ( s[c] == ch ) n++;
+	}
+	return( n );
+}
+
+static const char *
+scalarFindAnyOf( const char *s, size_t len, const char *set, size_t setLen )
+{
+	unsigned char inSet[256];
+	memset( inSet, 0, sizeof(inSet) );
+
+	for (size_t j=0; j<setLen; j++) {
+		inSet[ (unsigned char) set[j] ] = 1;
+	}
+
+	for (size_t c=0; c<len; c++) {
+		if ( inSet[ (unsigned char) s[c] ] ) return( s + c );
+	}
+	return( NULL );
+}
+
+// candidate starts from first to last, mlen >= 2
+
+static const char *
+scalarFind( const char *s, size_t first, size_t last, const char *m, size_t mlen )
+{
+	for (size_t c=first; c<=last; c++) {
+		if ( s[c] == m[0] && s[c+mlen-1] == m[mlen-1] &&
+		     memcmp( s + c + 1, m + 1, mlen - 2 ) == 0 ) {
+			return( s + c );
+		}
+	}
+	return( NULL );
+}
+
+static const char *
+scalarFindNonASCII( const char *s, size_t len )
+{
+	for (size_t c=0; c<len; c++) {
+		if ( (unsigned char) s[c] >= 0x80 ) return( s + c );
+	}
+	return( NULL );
+}
+
+static const char *
+scalarFindNonPrintable( const char *s, size_t len )
+{
+	for (size_t c=0; c<len; c++) {
+		unsigned char b = (unsigned char) s[c];
+		if ( b < 0x20 || b >= 0x7F ) return( s + c );
+	}
+	return( NULL );
+}
+
+
+#if defined(CX_SEARCH_SSE2)
+
+//-------------------------------------------------------------------------
+// SSE2 versions.  A compare of 16 bytes gives a 16 bit mask with a bit
+// set for each byte that matched.
+//
+//-------------------------------------------------------------------------
+static const char *
+sse2FindByte( const char *s, size_t len, char ch )
+{
+	__m128i needle = _mm_set1_epi8( ch );
+	size_t  c      = 0;
+
+	for (; c + 16 <= len; c += 16) {
+		__m128i block = _mm_loadu_si128( (const __m128i *) (s + c) );
+		int mask = _mm_movemask_epi8( _mm_cmpeq_epi8( block, needle ) );
+		if (mask) return( s + c + __builtin_ctz( mask ) );
+	}
+
+	return( scalarFindByte( s + c, len - c, ch ) );
+}
+
+static const char *
+sse2FindLastByte( const char *s, size_t len, char ch )
+{
+	__m128i needle = _mm_set1_epi8( ch );
+
+	while (len >= 16) {
+		__m128i block = _mm_loadu_si128( (const __m128i *) (s + len - 16) );
+		int mask = _mm_movemask_epi8( _mm_cmpeq_epi8( block, needle ) );
+		if (mask) return( s + len - 16 + (31 - __builtin_clz( mask )) );
+		len -= 16;
+	}
+
+	return( scalarFindLastByte( s, len, ch ) );
+}
+
+static size_t
+sse2CountByte( const char *s, size_t len, char ch )
+{
+	__m128i needle = _mm_set1_epi8( ch );
+	size_t  c      = 0;
+	size_t  n      = 0;
+
+	for (; c + 16 <= len; c += 16) {
+		__m128i block = _mm_loadu_si128( (const __m128i *) (s + c) );
+		n += __builtin_popcount( _mm_movemask_epi8( _mm_cmpeq_epi8( block, needle ) ) );
+	}
+
+	return( n + scalarCountByte( s + c, len - c, ch ) );
+}
+
+// up to 16 set bytes are compared directly, bigger sets use the table
+
+static const char *
+sse2FindAnyOf( const char *s, size_t len, const char *set, size_t setLen )
+{
+	if (setLen > 16) return( scalarFindAnyOf( s, len, set, setLen ) );
+
+	__m128i needles[16];
+	for (size_t j=0; j<setLen; j++) needles[j] = _mm_set1_epi8( set[j] );
+
+	size_t c = 0;
+
+	for (; c + 16 <= len; c += 16) {
+		__m128i block = _mm_loadu_si128( (const __m128i *) (s + c) );
+		__m128i hits  = _mm_setzero_si128();
+		for (size_t j=0; j<setLen; j++) {
+			hits = _mm_or_si128( hits, _mm_cmpeq_epi8( block, needles[j] ) );
+		}
+		int mask = _mm_movemask_epi8( hits );
+		if (mask) return( s + c + __builtin_ctz( mask ) );
+	}
+
+	return( scalarFindAnyOf( s + c, len - c, set, setLen ) );
+}
+
+// compare the first and the last byte of the match at 16 starts at once,
+// and only check the middle where both agree
+
+static const char *
+sse2Find( const char *s, size_t len, const char *m, size_t mlen )
+{
+	__m128i first = _mm_set1_epi8( m[0] );
+	__m128i last  = _mm_set1_epi8( m[mlen-1] );
+	size_t  c     = 0;
+
+	for (; c + mlen - 1 + 16 <= len; c += 16) {
+
+		__m128i a = _mm_loadu_si128( (const __m128i *) (s + c) );
+		__m128i b = _mm_loadu_si128( (const __m128i *) (s + c + mlen - 1) );
+
+		int mask = _mm_movemask_epi8(
+			_mm_and_si128( _mm_cmpeq_epi8( a, first ), _mm_cmpeq_epi8( b, last ) ) );
+
+		while (mask) {
+			int bit = __builtin_ctz( mask );
+			if ( memcmp( s + c + bit + 1, m + 1, mlen - 2 ) == 0 ) return( s + c + bit );
+			mask &= mask - 1;
+		}
+	}
+
+	if (c > len - mlen) return( NULL );
+	return( scalarFind( s, c, len - mlen, m, mlen ) );
+}
+
+// the top bit of each byte is the mask itself
+
+static const char *
+sse2FindNonASCII( const char *s, size_t len )
+{
+	size_t c = 0;
+
+	for (; c + 16 <= len; c += 16) {
+		__m128i block = _mm_loadu_si128( (const __m128i *) (s + c) );
+		int mask = _mm_movemask_epi8( block );
+		if (mask) return( s + c + __builtin_ctz( mask ) );
+	}
+
+	return( scalarFindNonASCII( s + c, len - c ) );
+}
+
+// as signed bytes, printable is above 0x1F and below 0x7F; bytes from
+// 0x80 up are negative
+
+static const char *
+sse2FindNonPrintable( const char *s, size_t len )
+{
+	__m128i low  = _mm_set1_epi8( 0x1F );
+	__m128i high = _mm_set1_epi8( 0x7F );
+	size_t  c    = 0;
+
+	for (; c + 16 <= len; c += 16) {
+		__m128i block = _mm_loadu_si128( (const __m128i *) (s + c) );
+		__m128i ok    = _mm_and_si128( _mm_cmpgt_epi8( block, low ), _mm_cmplt_epi8( block, high ) );
+		int mask = ~_mm_movemask_epi8( ok ) & 0xFFFF;
+		if (mask) return( s + c + __builtin_ctz( mask ) );
+	}
+
+	return( scalarFindNonPrintable( s + c, len - c ) );
+}
+
+#endif
+
+
+#if defined(CX_SEARCH_AVX2)
+
+//-------------------------------------------------------------------------
+// AVX2 versions, the same as SSE2 but 32 bytes at a time.  The upper
+// halves of the registers are cleared before the SSE2 code takes the
+// tail; the compiler leaves that out of a tail call, and SSE2 code run
+// after it costs hundreds of cycles a call.
+//
+//-------------------------------------------------------------------------
+CX_TARGET_AVX2 static const char *
+avx2FindByte( const char *s, size_t len, char ch )
+{
+	__m256i needle = _mm256_set1_epi8( ch );
+	size_t  c      = 0;
+
+	for (; c + 32 <= len; c += 32) {
+		__m256i block = _mm256_loadu_si256( (const __m256i *) (s + c) );
+		unsigned int mask = (unsigned int) _mm256_movemask_epi8( _mm256_cmpeq_epi8( block, needle ) );
+		if (mask) return( s + c + __builtin_ctz( mask ) );
+	}
+
+	_mm256_zeroupper();
+	return( sse2FindByte( s + c, len - c, ch ) );
+}
+
+CX_TARGET_AVX2 static const char *
+avx2FindLastByte( const char *s, size_t len, char ch )
+{
+	__m256i needle = _mm256_set1_epi8( ch );
+
+	while (len >= 32) {
+		__m256i block = _mm256_loadu_si256( (const __m256i *) (s + len - 32) );
+		unsigned int mask = (unsigned int) _mm256_movemask_epi8( _mm256_cmpeq_epi8( block, needle ) );
+		if (mask) return( s + len - 32 + (31 - __builtin_clz( mask )) );
+		len -= 32;
+	}
+
+	_mm256_zeroupper();
+	return( sse2FindLastByte( s, len, ch ) );
+}
+
+CX_TARGET_AVX2 static size_t
+avx2CountByte( const char *s, size_t len, char ch )
+{
+	__m256i needle = _mm256_set1_epi8( ch );
+	size_t  c      = 0;
+	size_t  n      = 0;
+
+	for (; c + 32 <= len; c += 32) {
+		__m256i block = _mm256_loadu_si256( (const __m256i *) (s + c) );
+		n += __builtin_popcount(
+			(unsigned int) _mm256_movemask_epi8( _mm256_cmpeq_epi8( block, needle ) ) );
+	}
+
+	_mm256_zeroupper();
+	return( n + sse2CountByte( s + c, len - c, ch ) );
+}
+
+CX_TARGET_AVX2 static const char *
+avx2FindAnyOf( const char *s, size_t len, const char *set, size_t setLen )
+{
+	if (setLen > 16) return( scalarFindAnyOf( s, len, set, setLen ) );
+
+	__m256i needles[16];
+	for (size_t j=0; j<setLen; j++) needles[j] = _mm256_set1_epi8( set[j] );
+
+	size_t c = 0;
+
+	for (; c + 32 <= len; c += 32) {
+		__m256i block = _mm256_loadu_si256( (const __m256i *) (s + c) );
+		__m256i hits  = _mm256_setzero_si256();
+		for (size_t j=0; j<setLen; j++) {
+			hits = _mm256_or_si256( hits, _mm256_cmpeq_epi8( block, needles[j] ) );
+		}
+		unsigned int mask = (unsigned int) _mm256_movemask_epi8( hits );
+		if (mask) return( s + c + __builtin_ctz( mask ) );
+	}
+
+	_mm256_zeroupper();
+	return( sse2FindAnyOf( s + c, len - c, set, setLen ) );
+}
+
+CX_TARGET_AVX2 static const char *
+avx2Find( const char *s, size_t len, const char *m, size_t mlen )
+{
+	__m256i first = _mm256_set1_epi8( m[0] );
+	__m256i last  = _mm256_set1_epi8( m[mlen-1] );
+	size_t  c     = 0;
+
+	for (; c + mlen - 1 + 32 <= len; c += 32) {
+
+		__m256i a = _mm256_loadu_si256( (const __m256i *) (s + c) );
+		__m256i b = _mm256_loadu_si256( (const __m256i *) (s + c + mlen - 1) );
+
+		unsigned int mask = (unsigned int) _mm256_movemask_epi8(
+			_mm256_and_si256( _mm256_cmpeq_epi8( a, first ), _mm256_cmpeq_epi8( b, last ) ) );
+
+		while (mask) {
+			int bit = __builtin_ctz( mask );
+			if ( memcmp( s + c + bit + 1, m + 1, mlen - 2 ) == 0 ) return( s + c + bit );
+			mask &= mask - 1;
+		}
+	}
+
+	if (c > len - mlen) return( NULL );
+
+	_mm256_zeroupper();
+	return( sse2Find( s + c, len - c, m, mlen ) );
+}
+
+CX_TARGET_AVX2 static const char *
+avx2FindNonASCII( const char *s, size_t len )
+{
+	size_t c = 0;
+
+	for (; c + 32 <= len; c += 32) {
+		__m256i block = _mm256_loadu_si256( (const __m256i *) (s + c) );
+		unsigned int mask = (unsigned int) _mm256_movemask_epi8( block );
+		if (mask) return( s + c + __builtin_ctz( mask ) );
+	}
+
+	_mm256_zeroupper();
+	return( sse2FindNonASCII( s + c, len - c ) );
+}
+
+CX_TARGET_AVX2 static const char *
+avx2FindNonPrintable( const char *s, size_t len )
+{
+	__m256i low  = _mm256_set1_epi8( 0x1F );
+	__m256i high = _mm256_set1_epi8( 0x7F );
+	size_t  c    = 0;
+
+	for (; c + 32 <= len; c += 32) {
+		__m256i block = _mm256_loadu_si256( (const __m256i *) (s + c) );
+		__m256i ok    = _mm256_and_si256( _mm256_cmpgt_epi8( block, low ), _mm256_cmpgt_epi8( high, block ) );
+		unsigned int mask = ~(unsigned int) _mm256_movemask_epi8( ok );
+		if (mask) return( s + c + __builtin_ctz( mask ) );
+	}
+
+	_mm256_zeroupper();
+	return( sse2FindNonPrintable( s + c, len - c ) );
+}
+
+#endif
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::findByte
+//
+//-------------------------------------------------------------------------
+const char *
+CxByteSearch::findByte( const char *s, size_t len, char ch )
+{
+	switch (detectLevel()) {
+#if defined(CX_SEARCH_AVX2)
+		case AVX2: return( avx2FindByte( s, len, ch ) );
+#endif
+#if defined(CX_SEARCH_SSE2)
+		case SSE2: return( sse2FindByte( s, len, ch ) );
+#endif
+		default:   return( scalarFindByte( s, len, ch ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::findLastByte
+//
+//-------------------------------------------------------------------------
+const char *
+CxByteSearch::findLastByte( const char *s, size_t len, char ch )
+{
+	switch (detectLevel()) {
+#if defined(CX_SEARCH_AVX2)
+		case AVX2: return( avx2FindLastByte( s, len, ch ) );
+#endif
+#if defined(CX_SEARCH_SSE2)
+		case SSE2: return( sse2FindLastByte( s, len, ch ) );
+#endif
+		default:   return( scalarFindLastByte( s, len, ch ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::countByte
+//
+//-------------------------------------------------------------------------
+size_t
+CxByteSearch::countByte( const char *s, size_t len, char ch )
+{
+	switch (detectLevel()) {
+#if defined(CX_SEARCH_AVX2)
+		case AVX2: return( avx2CountByte( s, len, ch ) );
+#endif
+#if defined(CX_SEARCH_SSE2)
+		case SSE2: return( sse2CountByte( s, len, ch ) );
+#endif
+		default:   return( scalarCountByte( s, len, ch ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::findAnyOf
+//
+//-------------------------------------------------------------------------
+const char *
+CxByteSearch::findAnyOf( const char *s, size_t len, const char *set, size_t setLen )
+{
+	if (setLen == 0) return( NULL );
+	if (setLen == 1) return( findByte( s, len, set[0] ) );
+
+	switch (detectLevel()) {
+#if defined(CX_SEARCH_AVX2)
+		case AVX2: return( avx2FindAnyOf( s, len, set, setLen ) );
+#endif
+#if defined(CX_SEARCH_SSE2)
+		case SSE2: return( sse2FindAnyOf( s, len, set, setLen ) );
+#endif
+		default:   return( scalarFindAnyOf( s, len, set, setLen ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::find
+//
+//-------------------------------------------------------------------------
+const char *
+CxByteSearch::find( const char *s, size_t len, const char *m, size_t mlen )
+{
+	if (mlen == 0)  return( s );
+	if (mlen > len) return( NULL );
+	if (mlen == 1)  return( findByte( s, len, m[0] ) );
+
+	switch (detectLevel()) {
+#if defined(CX_SEARCH_AVX2)
+		case AVX2: return( avx2Find( s, len, m, mlen ) );
+#endif
+#if defined(CX_SEARCH_SSE2)
+		case SSE2: return( sse2Find( s, len, m, mlen ) );
+#endif
+		default:   return( scalarFind( s, 0, len - mlen, m, mlen ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::findNonASCII
+//
+//-------------------------------------------------------------------------
+const char *
+CxByteSearch::findNonASCII( const char *s, size_t len )
+{
+	switch (detectLevel()) {
+#if defined(CX_SEARCH_AVX2)
+		case AVX2: return( avx2FindNonASCII( s, len ) );
+#endif
+#if defined(CX_SEARCH_SSE2)
+		case SSE2: return( sse2FindNonASCII( s, len ) );
+#endif
+		default:   return( scalarFindNonASCII( s, len ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::findNonPrintable
+//
+//-------------------------------------------------------------------------
+const char *
+CxByteSearch::findNonPrintable( const char *s, size_t len )
+{
+	switch (detectLevel()) {
+#if defined(CX_SEARCH_AVX2)
+		case AVX2: return( avx2FindNonPrintable( s, len ) );
+#endif
+#if defined(CX_SEARCH_SSE2)
+		case SSE2: return( sse2FindNonPrintable( s, len ) );
+#endif
+		default:   return( scalarFindNonPrintable( s, len ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::level
+//
+//-------------------------------------------------------------------------
+int
+CxByteSearch::level( void )
+{
+	return( detectLevel() );
+}
+
+
+//-------------------------------------------------------------------------
+// CxByteSearch::limitLevel
+//
+//-------------------------------------------------------------------------
+void
+CxByteSearch::limitLevel( int level_ )
+{
+	_limit = level_;
+}
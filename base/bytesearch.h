@@ -0,0 +1,67 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  bytesearch.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxByteSearch Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#ifndef _CxByteSearch_h_
+#define _CxByteSearch_h_
+
+
+//-------------------------------------------------------------------------
+// class CxByteSearch
+//
+// Byte and substring search over raw buffers, used by CxString and
+// CxUTFString.  On x86 the scans run 16 bytes at a time with SSE2, or 32
+// at a time with AVX2 when the processor has it (checked once at run
+// time).  Everywhere else they are plain loops.  Buffers are never read
+// past len.
+//
+// Every search returns a pointer to the match, or NULL.
+//
+//-------------------------------------------------------------------------
+class CxByteSearch
+{
+  public:
+
+	enum Level { SCALAR, SSE2, AVX2 };
+
+	static const char *findByte( const char *s, size_t len, char ch );
+	// first occurrence of ch
+
+	static const char *findLastByte( const char *s, size_t len, char ch );
+	// last occurrence of ch
+
+	static size_t countByte( const char *s, size_t len, char ch );
+	// number of occurrences of ch
+
+	static const char *findAnyOf( const char *s, size_t len, const char *set, size_t setLen );
+	// first byte that is one of the setLen bytes in set
+
+	static const char *find( const char *s, size_t len, const char *m, size_t mlen );
+	// first occurrence of the mlen bytes at m, an empty m matches at s
+
+	static const char *findNonASCII( const char *s, size_t len );
+	// first byte from 0x80 up, the start of anything in UTF-8 that is not ASCII
+
+	static const char *findNonPrintable( const char *s, size_t len );
+	// first byte that is not printable ASCII, 0x20 to 0x7E
+
+	static int level( void );
+	// the instruction set in use
+
+	static void limitLevel( int level_ );
+	// use nothing above level_, for testing and benchmarks
+};
+
+
+#endif
@@ -154,8 +154,7 @@ class CxCallback
 
     void decBodyCount() 
     {
-        body_->decCount(); 
-        if(body_->count() == 0) delete body_;
+        if(body_->decCount() == 0) delete body_;
     }
 };
 
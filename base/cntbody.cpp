@@ -38,17 +38,17 @@ CxCountedBody::~CxCountedBody()
 void 
 CxCountedBody::incCount() 
 {
-    _count++;
+    _count.increment();
 }
 
 //-------------------------------------------------------------------------
 // CxCountedBody::decCount
 //
 //-------------------------------------------------------------------------
-void 
+int 
 CxCountedBody::decCount() 
 {
-    _count--;
+    return( _count.decrement() );
 }
 
 //-------------------------------------------------------------------------
@@ -58,5 +58,5 @@ CxCountedBody::decCount()
 int 
 CxCountedBody::count() 
 {
-    return _count;
+    return _count.value();
 }
@@ -23,6 +23,8 @@
 #if defined(_NT_)
 #endif
 
+#include <cx/base/atomic.h>
+
 
 #ifndef _CxCountedBody_h_
 #define _CxCountedBody_h_
@@ -31,6 +33,9 @@
 //-------------------------------------------------------------------------
 // class CxCountedBody
 //
+// Base for reference counted bodies.  The count is a CxAtomicCount, so
+// handles to one body can be copied and dropped from different threads.
+//
 //-------------------------------------------------------------------------
 class CxCountedBody
 {
@@ -45,15 +50,15 @@ class CxCountedBody
     void incCount( void );
 	// increment the count
 
-    void decCount( void );
-	// decrement the count
+    int decCount( void );
+	// decrement the count and return the new count, the last holder sees 0
 
     int count( void );
 	// return the count
 
   private:
 
-    int _count;
+    CxAtomicCount _count;
 };
 
 
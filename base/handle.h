@@ -14,6 +14,7 @@
 #include <stdio.h>
 
 //#include <cx/base/cntbody.h>
+#include <cx/base/atomic.h>
 
 
 #ifndef _CxHandle_h_
@@ -23,6 +24,9 @@
 //-------------------------------------------------------------------------
 // class CxCounted
 //
+// The count is a CxAtomicCount, so handles sharing an object can be copied
+// and dropped from different threads.  The object itself is not locked.
+//
 //------------------------------------------------------------------------
 class CxCounted
 {
@@ -33,18 +37,18 @@ class CxCounted
 	unsigned Add( )
 	{ 
 		unsigned int retval;
-		retval = ++_iCount;
+		retval = (unsigned int) _iCount.increment();
 		return( retval ); 
 	}
 	unsigned Remove( )
 	{ 
 		unsigned int retval;
-		retval = --_iCount;
+		retval = (unsigned int) _iCount.decrement();
 		return( retval ); 
 	}
 
 	void Reset()
-	{ _iCount = 0;  }
+	{ _iCount.set( 0 );  }
 
 
   protected:
@@ -52,7 +56,7 @@ class CxCounted
 	{ }  
 
   private:
-	unsigned  _iCount;
+	CxAtomicCount  _iCount;
 };
 
 
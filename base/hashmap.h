@@ -15,6 +15,8 @@
 #define __hashmap_
 
 #include <assert.h>
+#include <string.h>
+#include <new>
 
 
 
@@ -25,6 +27,19 @@ template<class key, class entry> class CxHashmapIterator;
 //-------------------------------------------------------------------------
 // CxHashmap::CxHashmap
 //
+// Open addressing with linear probing.  Keys and entries live inline in
+// two parallel slot arrays, next to a third array of cached hash values.
+// A probe only walks the hash array and compares keys when the cached
+// hashes match.  A cached hash of 0 marks an empty slot.
+//
+// There are no tombstones: remove() closes the hole by shifting the rest
+// of the probe run back (backward shift deletion).
+//
+// The key class must provide hashValue() and operator==.  Keys and entries
+// are relocated with memcpy when the table grows or a run shifts back, so
+// neither may hold a pointer into itself.  Pointers returned by find(),
+// operator[] and the iterator stay valid until the next insert or remove.
+//
 //-------------------------------------------------------------------------
 template<class key, class entry> class CxHashmap
 {
@@ -33,219 +48,357 @@ template<class key, class entry> class CxHashmap
 
   private:
 
-   	// static const int init_size = 32;
-
-	//---------------------------------------------------------------------    
+	//---------------------------------------------------------------------
 	// copy constructor
 	//
-	//---------------------------------------------------------------------    
+	//---------------------------------------------------------------------
     CxHashmap(const CxHashmap<key,entry> &table) {
 		assert(0);
     };
 
-	//---------------------------------------------------------------------    
+	//---------------------------------------------------------------------
 	// operator equal
-	//---------------------------------------------------------------------    
+	//---------------------------------------------------------------------
     CxHashmap<key,entry> &operator=(const CxHashmap<key,entry> &table) {
 		assert(0);
     };
 
 
-	//---------------------------------------------------------------------    
-    // double the size of the hashmap
+	//---------------------------------------------------------------------
+	// hash a key for storage, 0 is reserved to mark an empty slot
 	//
-	//---------------------------------------------------------------------    
-    void resize(void) 
+	//---------------------------------------------------------------------
+	static unsigned int slotHash(const key &thekey)
 	{
-		int new_size = hash_size + hash_size;
-
-		const key **newkeys = new const key *[new_size];
-		{ 
-	    	const key **tmp = newkeys;
-	    	for ( int i=0; i<new_size; i++ ) {
-				*tmp++=(key *)0;
-	    	} 
+		unsigned int h = thekey.hashValue();
+		return( h ? h : 1 );
+	}
+
+
+	//---------------------------------------------------------------------
+	// home slot of a hash.  Fibonacci hashing takes the top bits of the
+	// product, so keys whose hashes only differ in the high bits still
+	// spread across the table
+	//
+	//---------------------------------------------------------------------
+	int homeSlot(unsigned int h) const
+	{
+		return (int) ((h * 2654435769U) >> hash_shift);
+	}
+
+
+	//---------------------------------------------------------------------
+	// return the slot holding thekey, or the empty slot that ends its run
+	//
+	//---------------------------------------------------------------------
+	int probe(const key &thekey, unsigned int h) const
+	{
+		int mask = hash_size - 1;
+		int i    = homeSlot(h);
+
+		while ( hashes[i] ) {
+			if ( hashes[i] == h && thekey == keys[i] ) break;
+			i = (i + 1) & mask;
 		}
 
-		entry **newentries = new entry *[new_size];
-		{ 
-	    	entry **tmp = newentries;
-	    	for ( int i=0; i<new_size; i++ ) {
-				*tmp++=(entry *)0;
-	    	}	 
+		return i;
+	}
+
+
+	//---------------------------------------------------------------------
+	// allocate empty slot arrays for size slots; note: size must be 2**n
+	//
+	//---------------------------------------------------------------------
+	void allocate(int size)
+	{
+		hashes  = new unsigned int[size];
+		memset( hashes, 0, sizeof(unsigned int) * size );
+
+		keys    = (key *)   ::operator new( sizeof(key)   * size );
+		entries = (entry *) ::operator new( sizeof(entry) * size );
+
+		hash_size  = size;
+		hash_shift = 32;
+		while ( size > 1 ) {
+			size >>= 1;
+			hash_shift--;
 		}
-    
-		for ( int i=0; i<hash_size; i++ ) {
-	    	if ( keys[i] ) {
-				unsigned int h = keys[i]->hashValue() & (new_size-1);
-				for ( ; newkeys[h]; h = (h == 0) ? hash_size-1 : h-1 ) {
-		    		if ( *keys[i] == *newkeys[h] )
-					break;
+	}
+
+
+	//---------------------------------------------------------------------
+    // move every slot into a table of new_size slots.  Returns the new
+	// position of the slot at index track (-1 if not needed)
+	//
+	//---------------------------------------------------------------------
+    int resize(int new_size, int track = -1)
+	{
+		unsigned int *oldhashes  = hashes;
+		key          *oldkeys    = keys;
+		entry        *oldentries = entries;
+		int           old_size   = hash_size;
+		int           tracked    = -1;
+
+		allocate( new_size );
+
+		int mask = hash_size - 1;
+
+		for ( int i=0; i<old_size; i++ ) {
+	    	if ( oldhashes[i] ) {
+				int h = homeSlot( oldhashes[i] );
+				while ( hashes[h] ) {
+					h = (h + 1) & mask;
 				}
-				newkeys[h]    = keys[i];
-				newentries[h] = entries[i];
+				hashes[h] = oldhashes[i];
+				memcpy( (void *) &keys[h],    (void *) &oldkeys[i],    sizeof(key) );
+				memcpy( (void *) &entries[h], (void *) &oldentries[i], sizeof(entry) );
+				if ( i == track ) tracked = h;
 	    	}
 		}
 
-		delete [] keys;
-		delete [] entries;
-    
-		keys      = newkeys;
-		entries   = newentries;
-		hash_size = new_size;
+		delete [] oldhashes;
+		::operator delete( (void *) oldkeys );
+		::operator delete( (void *) oldentries );
+
+		return tracked;
     };
 
 
+	//---------------------------------------------------------------------
+	// fill a free slot with a copy of thekey, and grow the table once it
+	// is two thirds full.  Returns the (possibly moved) slot index
+	//
+	//---------------------------------------------------------------------
+	int fillSlot(int i, unsigned int h, const key &thekey)
+	{
+		hashes[i] = h;
+		new ((void *) &keys[i]) key(thekey);
+		hash_used++;
+
+		if ( hash_size - hash_used < hash_size / 3 + 1 ) {
+			i = resize( hash_size + hash_size, i );
+		}
+
+		return i;
+	}
+
+
     // actual size
     int hash_size;
 
     // used entries
     int hash_used;
 
+    // shift that turns a hash into a slot index
+    int hash_shift;
+
+    // the cached hash of each slot, 0 when the slot is empty
+    unsigned int *hashes;
+
     // the keys of the hashmap
-    const key **keys;
+    key *keys;
 
     // the data entries
-    entry **entries;
+    entry *entries;
 
 
   public:
 
-	//---------------------------------------------------------------------    
+	//---------------------------------------------------------------------
     // create empty hashmap of size `size'; note: size must be 2**n
 	//
-	//---------------------------------------------------------------------    
-    CxHashmap(int ssize = 32) 
+	//---------------------------------------------------------------------
+    CxHashmap(int ssize = 32)
 	{
-	
-		keys = new const key *[ssize];
-		{
-	    	const key **tmp = keys;
-	    	for ( int i=0; i<ssize; i++ ) {
-				*tmp++=(key *)0;
-	    	}
-		};
+		int size = 8;
+		while ( size < ssize ) size += size;
 
-		entries = new entry *[ssize];
-		{
-	    	entry **tmp = entries;
-	    	for ( int i=0; i<ssize; i++ ) {
-				*tmp++=(entry *)0;
-	    	}
-		}
-
-		hash_size = ssize;
+		allocate( size );
 		hash_used = 0;
     };
 
 
-    //---------------------------------------------------------------------    
+    //---------------------------------------------------------------------
    	// destroy table, that is delete all keys and entries and the table itself
 	//
-    //---------------------------------------------------------------------    
-    ~CxHashmap(void) 
+    //---------------------------------------------------------------------
+    ~CxHashmap(void)
 	{
-
 		for ( int i=0; i<hash_size; i++ ) {
-	    	if ( keys[i] ) {
-				delete keys[i];
-				keys[i] = 0;
-				delete entries[i];
-				entries[i] = 0;
+	    	if ( hashes[i] ) {
+				keys[i].~key();
+				entries[i].~entry();
 	    	}
 		}
 
-		delete [] keys;
-		delete [] entries;
+		delete [] hashes;
+		::operator delete( (void *) keys );
+		::operator delete( (void *) entries );
     };
 
 
-    
-    //---------------------------------------------------------------------    
-	// access entry; note: the entry is created, if it does not exist 
+
+    //---------------------------------------------------------------------
+	// access entry; note: the entry is created, if it does not exist
 	//
-	//---------------------------------------------------------------------    
-	entry &operator[](const key &thekey) 
+	//---------------------------------------------------------------------
+	entry &operator[](const key &thekey)
 	{
+		unsigned int h = slotHash( thekey );
+		int          i = probe( thekey, h );
 
-		if ( hash_size - hash_used < hash_size / 3 + 1 ) { // hash vergroessern
-	    	resize();
-		}
-
-		unsigned int h = thekey.hashValue() & (hash_size-1);
-		
-		for ( ; keys[h]; h = (h == 0) ? hash_size-1 : h-1 ) {
-	    	if ( thekey == *keys[h] ) break;
+		if ( !hashes[i] ) {
+			new ((void *) &entries[i]) entry();
+			i = fillSlot( i, h, thekey );
 		}
 
-		if ( !keys[h] ) {
-	    	hash_used++;
-	    	keys[h]=new key(thekey);
-	    	entries[h]=new (entry);
-		}
-
-		return (entry&) *entries[h];
+		return entries[i];
     };
 
 
-	//---------------------------------------------------------------------    
+	//---------------------------------------------------------------------
     // find an entry; note: returns NULL if the entry does not exist
 	//
-	//---------------------------------------------------------------------    
-    const entry *find(const key &thekey) const 
+	//---------------------------------------------------------------------
+    const entry *find(const key &thekey) const
 	{
 		if ( !hash_used ) return 0;
 
-		unsigned int h = thekey.hashValue() & (hash_size-1);
-	
-		for ( ;keys[h];h = (h == 0) ? hash_size-1 : h-1 ) {
+		int i = probe( thekey, slotHash( thekey ) );
+		if ( !hashes[i] ) return 0;
 
-	    	if ( thekey == *keys[h] ) return (entry*) entries[h];
+		return &entries[i];
+    };
+
+
+
+	//---------------------------------------------------------------------
+	// insert item, returns true if an existing entry was replaced
+	//
+	//---------------------------------------------------------------------
+	bool insert(const key &thekey, const entry &theentry)
+	{
+		unsigned int h = slotHash( thekey );
+		int          i = probe( thekey, h );
+
+		if ( hashes[i] ) {
+
+			if ( &entries[i] != &theentry ) {
+				entries[i].~entry();
+				new ((void *) &entries[i]) entry(theentry);
+			}
+	    	return true;
 		}
 
-		return 0;
+		new ((void *) &entries[i]) entry(theentry);
+		fillSlot( i, h, thekey );
+
+		return false;
     };
 
 
+	//---------------------------------------------------------------------
+	// remove item, returns true if the key was found
+	//
+	//---------------------------------------------------------------------
+	bool remove(const key &thekey)
+	{
+		if ( !hash_used ) return false;
+
+		int hole = probe( thekey, slotHash( thekey ) );
+		if ( !hashes[hole] ) return false;
+
+		keys[hole].~key();
+		entries[hole].~entry();
+		hashes[hole] = 0;
+		hash_used--;
+
+		// walk the rest of the run, pulling back any slot whose home is
+		// not between the hole and itself so every key stays reachable
+
+		int mask = hash_size - 1;
+		int j    = hole;
+
+		for (;;) {
 
-	//---------------------------------------------------------------------        
-	// insert item
+			j = (j + 1) & mask;
+			if ( !hashes[j] ) break;
+
+			int home = homeSlot( hashes[j] );
+
+			int stays = ( hole <= j ) ? ( home > hole && home <= j )
+			                          : ( home > hole || home <= j );
+			if ( stays ) continue;
+
+			hashes[hole] = hashes[j];
+			memcpy( (void *) &keys[hole],    (void *) &keys[j],    sizeof(key) );
+			memcpy( (void *) &entries[hole], (void *) &entries[j], sizeof(entry) );
+			hashes[j] = 0;
+
+			hole = j;
+		}
+
+		return true;
+	};
+
+
+	//---------------------------------------------------------------------
+	// make room for count items without any further resizing
 	//
-	//---------------------------------------------------------------------    
-	bool insert(const key &thekey, const entry &theentry) 
+	//---------------------------------------------------------------------
+	void reserve(int count)
 	{
-		bool ret=false;
+		int size = hash_size;
+		while ( size - count < size / 3 + 1 ) {
+			size += size;
+		}
 
-		if ( hash_size - hash_used < hash_size / 3 + 1 ) { // hash vergroessern
-	    	resize();
+		if ( size > hash_size ) {
+			resize( size );
 		}
+	};
+
 
-		unsigned int h = thekey.hashValue() & (hash_size-1);
-	
-		for ( ; keys[h]; h = (h == 0) ? hash_size-1 : h-1 ) {
-	    	if ( thekey == *keys[h] ) break;
+	//---------------------------------------------------------------------
+	// insert count items from parallel key and entry arrays, sizing the
+	// table once up front
+	//
+	//---------------------------------------------------------------------
+	void insertMany(const key *thekeys, const entry *theentries, int count)
+	{
+		reserve( hash_used + count );
+
+		for ( int i=0; i<count; i++ ) {
+			insert( thekeys[i], theentries[i] );
 		}
+	};
 
-		if ( ! keys[h] ) {
-	    	
-			keys[h]=new key(thekey);
-	    	hash_used++;
 
-		} else {
+	//---------------------------------------------------------------------
+	// delete all keys and entries, keeping the table at its current size
+	//
+	//---------------------------------------------------------------------
+	void clear(void)
+	{
+		if ( !hash_used ) return;
 
-	    	delete entries[h];
-	    	ret=true;
+		for ( int i=0; i<hash_size; i++ ) {
+	    	if ( hashes[i] ) {
+				keys[i].~key();
+				entries[i].~entry();
+				hashes[i] = 0;
+	    	}
 		}
 
-		entries[h]=new (entry)(theentry);
-		return ret;
-    };
+		hash_used = 0;
+	};
+
 
-	//---------------------------------------------------------------------    
+	//---------------------------------------------------------------------
 	// return number of items
 	//
-	//---------------------------------------------------------------------    
-    int getSize(void) const 
+	//---------------------------------------------------------------------
+    int getSize(void) const
 	{
 		return hash_used;
     }
@@ -262,47 +415,47 @@ template<class key, class entry> class CxHashmapIterator
 
   public:
 
-	//---------------------------------------------------------------------    
-	//---------------------------------------------------------------------    
-	CxHashmapIterator( CxHashmap<key,entry> *_table) 
+	//---------------------------------------------------------------------
+	//---------------------------------------------------------------------
+	CxHashmapIterator( CxHashmap<key,entry> *_table)
 	{
 		table = _table;
 		index = -1;
     }
 
-	//---------------------------------------------------------------------    
-	//---------------------------------------------------------------------    
-    bool next(void) 
+	//---------------------------------------------------------------------
+	//---------------------------------------------------------------------
+    bool next(void)
 	{
 		index++;
-		while ( index < table->hash_size && !table->keys[index] ) {
+		while ( index < table->hash_size && !table->hashes[index] ) {
 	    	index++;
 		}
 
 		return index < table->hash_size;
     };
 
-	//---------------------------------------------------------------------    
-	//---------------------------------------------------------------------    
-    const key *getKey(void) 
+	//---------------------------------------------------------------------
+	//---------------------------------------------------------------------
+    const key *getKey(void)
 	{
 		if ( index == -1 ) return NULL;
-		return table->keys[index];
+		return &table->keys[index];
     }
 
-	//---------------------------------------------------------------------    
-	//---------------------------------------------------------------------    
-    entry *getEntry(void) 
+	//---------------------------------------------------------------------
+	//---------------------------------------------------------------------
+    entry *getEntry(void)
 	{
 		if ( index == -1 ) return NULL;
-		return table->entries[index];
+		return &table->entries[index];
     }
 
 
   private:
 
-	//---------------------------------------------------------------------    
-	//---------------------------------------------------------------------    
+	//---------------------------------------------------------------------
+	//---------------------------------------------------------------------
     CxHashmapIterator(void);
 
 
@@ -155,11 +155,10 @@ CxPropertyList::set( CxString p, CxString v )
 {
 	for (unsigned int c=0; c<_list.entries(); c++) {
 
-		CxPropEntry pe = _list.at(c);
+		CxPropEntry& pe = _list[c];
 
-		if (pe.var() == p ) {
-			CxPropEntry pp( pe.var(), v );
-			_list.replaceAt( c, pp );
+		if (pe._var == p ) {
+			pe._val = v;
 			return;
 		}
 	}
@@ -178,10 +177,10 @@ CxPropertyList::get( CxString p ) const
 {
 	for (unsigned int c=0; c<_list.entries(); c++) {
 
-		CxPropEntry pe = _list.at(c);
+		const CxPropEntry& pe = _list[c];
 
-		if (pe.var() == p ) {
-			return( pe.val() );
+		if (pe._var == p ) {
+			return( pe._val );
 		}
 	}
     return ("");
@@ -197,8 +196,7 @@ CxPropertyList::has( CxString p ) const
 {
 	for (unsigned int c=0; c<_list.entries(); c++) {
 
-		CxPropEntry pe = _list.at(c);
-		if (pe.var() == p ) {
+		if (_list[c]._var == p ) {
 			return( TRUE );
 		}
 	}
@@ -215,8 +213,7 @@ CxPropertyList::remove( CxString p )
 {
 	for (unsigned int c=0; c<_list.entries(); c++) {
 
-		CxPropEntry pe = _list.at(c);
-		if (pe.var() == p ) {
+		if (_list[c]._var == p ) {
 			_list.removeAt( c );
 			return( TRUE );
 		}
@@ -487,7 +484,7 @@ CxPropertyList::dump( void )
 
 	for (unsigned int c=0; c<_list.entries(); c++) {
 
-		CxPropEntry pe = _list.at(c);
+		const CxPropEntry& pe = _list[c];
 		std::cout << "[" << pe.var() << "] = [" << pe.val() << "]" << std::endl;
 
 	}
@@ -12,7 +12,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <cx/base/string.h>
-#include <cx/base/slist.h>
+#include <cx/base/array.h>
 
 
 #ifndef _PROPERTYLIST_
@@ -107,7 +107,7 @@ class CxPropertyList
 
   private:
 
-    CxSList< CxPropEntry > _list;
+    CxArray< CxPropEntry > _list;
 };
 
 
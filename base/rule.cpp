@@ -242,7 +242,7 @@ CxRuleList::getMessage( int year, int month, int day, int dow, int hour, int min
 
 	for (unsigned int c=0; c<_list.entries(); c++) {
 
-		CxRuleEntry re = _list.at(c);
+		CxRuleEntry& re = _list[c];
 
 		if (re.isMatch( year, month, day, dow, hour, minute)) {
 
@@ -302,7 +302,7 @@ CxRuleList::dump( void )
 
 	for (unsigned int c=0; c<_list.entries(); c++) {
 
-		CxRuleEntry re = _list.at(c);
+		const CxRuleEntry& re = _list[c];
 
 		std::cout << "----------------------" << std::endl;
 		std::cout << "YEAR="   << re._year << std::endl;
@@ -12,7 +12,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <cx/base/string.h>
-#include <cx/base/slist.h>
+#include <cx/base/array.h>
 #include <cx/base/file.h>
 
 
@@ -123,7 +123,7 @@ class CxRuleList
 
   private:
 
-    	CxSList< CxRuleEntry > _list;
+    	CxArray< CxRuleEntry > _list;
 };
 
 
@@ -0,0 +1,162 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  searchbench.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  searchbench.cpp
+//
+//  Reports the throughput of the CxString searches that run on
+//  CxByteSearch, over a buffer of random lower case text, once for each
+//  instruction set the processor has.  Not part of the library, build it
+//  against libcx_base.a from this directory, all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o searchbench searchbench.cpp
+//        ../../lib/linux_x86_64/libcx_base.a -lpthread
+//
+//  Run as "searchbench [megabytes]", the default is 16 MB.  Build it with
+//  -DNO_BYTESEARCH to time the same calls against a tree without
+//  CxByteSearch.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include <cx/base/string.h>
+
+#if !defined(NO_BYTESEARCH)
+#include <cx/base/bytesearch.h>
+#endif
+
+
+#define REPEAT 10
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec + tv.tv_usec / 1e6 );
+}
+
+
+//-------------------------------------------------------------------------
+// rate
+//
+// GB/s for REPEAT passes over bytes
+//
+//-------------------------------------------------------------------------
+static double
+rate( int bytes, double start )
+{
+	return( (double) bytes * REPEAT / (now() - start) / 1e9 );
+}
+
+
+//-------------------------------------------------------------------------
+// run
+//
+// every search misses or runs to the end, so each pass reads the whole
+// buffer
+//
+//-------------------------------------------------------------------------
+static void
+run( const char *what, CxString& text, CxString& small )
+{
+	int          bytes = text.length();
+	volatile int sink  = 0;
+	double       start;
+
+	start = now();
+	for (int r=0; r<REPEAT; r++) sink += text.firstChar( '#' );
+	double first = rate( bytes, start );
+
+	start = now();
+	for (int r=0; r<REPEAT; r++) sink += text.lastChar( '#' );
+	double last = rate( bytes, start );
+
+	start = now();
+	for (int r=0; r<REPEAT; r++) sink += text.firstChar( "#\t\n" );
+	double set = rate( bytes, start );
+
+	start = now();
+	for (int r=0; r<REPEAT; r++) sink += text.index( "needle#in" );
+	double index = rate( bytes, start );
+
+	start = now();
+	for (int r=0; r<REPEAT; r++) sink += text.numberOfOccurances( "q" );
+	double countChar = rate( bytes, start );
+
+	start = now();
+	for (int r=0; r<REPEAT; r++) sink += text.numberOfOccurances( "abc" );
+	double countString = rate( bytes, start );
+
+	// replaceAll rewrites the string, so each pass starts from a copy
+
+	double replaced = 0;
+	for (int r=0; r<REPEAT; r++) {
+		CxString copy = small;
+		start     = now();
+		sink     += copy.replaceAll( "ab", "XYZ" );
+		replaced += now() - start;
+	}
+
+	printf( "%-7s firstChar %6.2f  lastChar %6.2f  firstChar(set) %6.2f  index %6.2f  "
+	        "count(char) %6.2f  count(string) %6.2f  replaceAll %6.3f GB/s\n",
+	        what, first, last, set, index, countChar, countString,
+	        (double) small.length() * REPEAT / replaced / 1e9 );
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+	int megabytes = argc > 1 ? atoi( argv[1] ) : 16;
+	int bytes     = megabytes * 1024 * 1024;
+
+	CxString     text;
+	char         block[4097];
+	unsigned int x = 1;
+
+	for (int i=0; i<bytes; i+=4096) {
+		for (int j=0; j<4096; j++) {
+			x = x * 1103515245 + 12345;
+			block[j] = 'a' + (x >> 8) % 26;
+		}
+		block[4096] = (char) NULL;
+		text += block;
+	}
+
+	// replaceAll grows the string, it is timed on 1 MB
+
+	CxString small = text.subString( 0, 1024 * 1024 );
+
+	printf( "%d MB of text, GB/s\n", megabytes );
+
+#if defined(NO_BYTESEARCH)
+	run( "scalar", text, small );
+#else
+	static const char *names[] = { "scalar", "SSE2", "AVX2" };
+
+	for (int level=CxByteSearch::level(); level>=CxByteSearch::SCALAR; level--) {
+		CxByteSearch::limitLevel( level );
+		run( names[level], text, small );
+	}
+#endif
+
+	return( 0 );
+}
@@ -12,8 +12,10 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <stdio.h>
+#include <new>
 
 #include <cx/base/exception.h>
+#include <cx/base/allocator.h>
 
 #ifndef _CxSList_h_
 #define _CxSList_h_
@@ -33,6 +35,225 @@ public:
     // must do operator <=
 };
 
+
+//-------------------------------------------------------------------------
+// class CxListNodePool
+//
+// Free list of CxListNode<T> carved from larger blocks.  A list given a
+// pool with CxSList::setNodePool() takes its nodes from the pool and
+// hands them back on remove and clear, so a list that is filled and
+// drained over and over stops calling the allocator once it has warmed
+// up.  Blocks start at 8 nodes and double up to 1024.  The blocks come
+// from ::operator new, or from a CxBlockAllocator such as an arena.
+//
+// A pool is not locked.  It may be shared by several lists as long as
+// they are only used from one thread at a time, and it must outlive
+// every list that uses it.  Blocks are only freed when the pool is
+// destroyed.
+//
+//-------------------------------------------------------------------------
+template <class T>
+class MYEXPORT CxListNodePool
+{
+public:
+
+	CxListNodePool( CxBlockAllocator *allocator_ = NULL );
+	// constructor, blocks come from allocator_ if one is given
+
+	~CxListNodePool( void );
+	// destructor, frees every block
+
+	CxListNode<T> *get( void );
+	// return a default constructed node
+
+	void put( CxListNode<T> *n );
+	// destroy a node and keep it for reuse
+
+	unsigned long allocated( void ) const;
+	// number of nodes handed out that were new
+
+	unsigned long recycled( void ) const;
+	// number of nodes handed out that were reused
+
+	unsigned long inUse( void ) const;
+	// number of nodes handed out and not yet put back
+
+	unsigned long peak( void ) const;
+	// highest number of nodes in use at once
+
+	unsigned long blocks( void ) const;
+	// number of blocks taken from the allocator
+
+private:
+
+	CxListNodePool( const CxListNodePool<T>& pool_ );
+	CxListNodePool<T>& operator=( const CxListNodePool<T>& pool_ );
+	// pools cannot be copied
+
+	CxBlockAllocator *_allocator;
+	CxListNode<T>    *_blocks;       // first node of each block links the blocks
+	CxListNode<T>    *_free;         // nodes that have been put back
+	CxListNode<T>    *_fresh;        // next unused node in the newest block
+	int               _freshLeft;
+	int               _blockNodes;
+
+	unsigned long     _allocated;
+	unsigned long     _recycled;
+	unsigned long     _inUse;
+	unsigned long     _peak;
+	unsigned long     _nBlocks;
+};
+
+
+//-------------------------------------------------------------------------
+// CxListNodePool<T>::CxListNodePool
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxListNodePool<T>::CxListNodePool( CxBlockAllocator *allocator_ )
+: _allocator( allocator_ ), _blocks( NULL ), _free( NULL ), _fresh( NULL ),
+  _freshLeft( 0 ), _blockNodes( 8 ),
+  _allocated( 0 ), _recycled( 0 ), _inUse( 0 ), _peak( 0 ), _nBlocks( 0 )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxListNodePool<T>::~CxListNodePool
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxListNodePool<T>::~CxListNodePool( void )
+{
+	while (_blocks != NULL) {
+
+		CxListNode<T> *nextBlock = *(CxListNode<T> **) _blocks;
+
+		if (_allocator) {
+			_allocator->freeBlock( (void *) _blocks );
+		} else {
+			::operator delete( (void *) _blocks );
+		}
+
+		_blocks = nextBlock;
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxListNodePool<T>::get
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxListNode<T> *
+CxListNodePool<T>::get( void )
+{
+	CxListNode<T> *n;
+
+	if (_free != NULL) {
+
+		n     = _free;
+		_free = *(CxListNode<T> **) n;
+		_recycled++;
+
+	} else {
+
+		if (_freshLeft == 0) {
+
+			// one extra node at the front of the block holds the link
+			// to the previous block, which keeps the nodes aligned
+
+			size_t size = sizeof(CxListNode<T>) * (_blockNodes + 1);
+			CxListNode<T> *block;
+
+			if (_allocator) {
+				block = (CxListNode<T> *) _allocator->allocateBlock( size );
+			} else {
+				block = (CxListNode<T> *) ::operator new( size );
+			}
+
+			if (block == NULL) {
+				throw CxException("CxListNodePool::get(memory allocation error)");
+			}
+
+			*(CxListNode<T> **) block = _blocks;
+			_blocks    = block;
+			_fresh     = block + 1;
+			_freshLeft = _blockNodes;
+			_nBlocks++;
+
+			if (_blockNodes < 1024) _blockNodes += _blockNodes;
+		}
+
+		n = _fresh++;
+		_freshLeft--;
+		_allocated++;
+	}
+
+	_inUse++;
+	if (_inUse > _peak) _peak = _inUse;
+
+	return( new ((void *) n) CxListNode<T> );
+}
+
+
+//-------------------------------------------------------------------------
+// CxListNodePool<T>::put
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxListNodePool<T>::put( CxListNode<T> *n )
+{
+	n->~CxListNode<T>();
+
+	*(CxListNode<T> **) n = _free;
+	_free = n;
+
+	_inUse--;
+}
+
+
+//-------------------------------------------------------------------------
+// CxListNodePool<T>:: statistics
+//
+//-------------------------------------------------------------------------
+template <class T>
+unsigned long
+CxListNodePool<T>::allocated( void ) const
+{
+	return( _allocated );
+}
+
+template <class T>
+unsigned long
+CxListNodePool<T>::recycled( void ) const
+{
+	return( _recycled );
+}
+
+template <class T>
+unsigned long
+CxListNodePool<T>::inUse( void ) const
+{
+	return( _inUse );
+}
+
+template <class T>
+unsigned long
+CxListNodePool<T>::peak( void ) const
+{
+	return( _peak );
+}
+
+template <class T>
+unsigned long
+CxListNodePool<T>::blocks( void ) const
+{
+	return( _nBlocks );
+}
+
+
 //class CxSListIterator<T>
 template <class T>
 class MYEXPORT CxSListIterator
@@ -133,6 +354,13 @@ public:
 	
 	T* objectAt( int i );
 
+	void setNodePool( CxListNodePool<T> *pool_ );
+	// take nodes from pool_ instead of new/delete, the list must be
+	// empty.  NULL goes back to new/delete
+
+	CxListNodePool<T> *nodePool( void ) const;
+	// return the node pool, NULL if the list uses new/delete
+
 	T first( void );
 	// return a copy of first item on the list
 
@@ -164,6 +392,13 @@ protected:
 	CxListNode<T>   *_tail;
 	CxListNode<T>   *_work;
 	CxListNode<T>   _pointerToHead;
+	CxListNodePool<T> *_pool;
+
+	CxListNode<T> *newNode( void );
+	// get a node from the pool, or new
+
+	void deleteNode( CxListNode<T> *n );
+	// give a node back to the pool, or delete
 
 	void deepCopy( const CxSList<T>& slist_ );
 	// copy the items in the list
@@ -180,6 +415,7 @@ protected:
 //-------------------------------------------------------------------------
 template <class T>
 CxSList<T>::CxSList( void  )
+: _pool( NULL )
 {
 	setNull();
 }
@@ -190,6 +426,7 @@ CxSList<T>::CxSList( void  )
 //-------------------------------------------------------------------------
 template <class T>
 CxSList<T>::CxSList( const CxSList<T>& slist_ )
+: _pool( NULL )
 {
 	setNull();
 	deepCopy( slist_ );
@@ -234,6 +471,64 @@ CxSList<T>::entries(void) const
 }
 
 
+//-------------------------------------------------------------------------
+// CxSList<T>::setNodePool
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxSList<T>::setNodePool( CxListNodePool<T> *pool_ )
+{
+	if (_entries != 0) {
+		throw CxException("CxSList::setNodePool(list not empty)");
+	}
+
+	_pool = pool_;
+}
+
+
+//-------------------------------------------------------------------------
+// CxSList<T>::nodePool
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxListNodePool<T> *
+CxSList<T>::nodePool( void ) const
+{
+	return( _pool );
+}
+
+
+//-------------------------------------------------------------------------
+// CxSList<T>::newNode
+//
+//-------------------------------------------------------------------------
+template <class T>
+CxListNode<T> *
+CxSList<T>::newNode( void )
+{
+	if (_pool) return( _pool->get() );
+
+	return( new CxListNode<T> );
+}
+
+
+//-------------------------------------------------------------------------
+// CxSList<T>::deleteNode
+//
+//-------------------------------------------------------------------------
+template <class T>
+void
+CxSList<T>::deleteNode( CxListNode<T> *n )
+{
+	if (_pool) {
+		_pool->put( n );
+	} else {
+		delete n;
+	}
+}
+
+
 //-------------------------------------------------------------------------
 // CxSList<T>::setNull
 //
@@ -334,7 +629,7 @@ CxSList<T>::erase( CxSListIterator<T> i )
                 _tail = prev;
             }
 
-            delete n;
+            deleteNode( n );
             _entries--;
 
             break;
@@ -368,26 +663,26 @@ CxSList<T>::removeAt( int i )
 			// case where there is only one item
 			if (( n == _head ) && ( n == _tail )) {
 				_head = _tail = _work = NULL;
-				delete n;
+				deleteNode( n );
 			} else
 
 			// case where first item is deleted.
 			if ( n == _head ) {
 				_head = n->next;
-				delete n;
+				deleteNode( n );
 			} else
 
 			// case where last item is deleted.
 			if ( n == _tail ) {
 				prev->next = NULL;
 				_tail = prev;
-				delete n;
+				deleteNode( n );
 			} else
 
 			// otherwise in the middle
 			{
 				prev->next = n->next;
-				delete n;
+				deleteNode( n );
 			}
 
 			_entries--;
@@ -459,7 +754,7 @@ template <class T>
 void
 CxSList<T>::insertAtHead( const T& item )
 {
-	CxListNode<T> *n = new CxListNode<T>;
+	CxListNode<T> *n = newNode();
 
 	if (n == NULL) {
 		throw CxException("CxSList::insertAtHead(memory allocation error)");
@@ -488,7 +783,7 @@ void
 CxSList<T>::insertAfter( int index, const T& newItem )
 {
     CxListNode<T> *n       = _head;
-    CxListNode<T> *newNode = new CxListNode<T>;
+    CxListNode<T> *newNode = this->newNode();
     
     newNode->data = newItem;
     newNode->next = NULL;
@@ -614,7 +909,7 @@ template <class T>
 void
 CxSList<T>::append( const T& item )
 {
-	CxListNode<T> *n = new CxListNode<T>;
+	CxListNode<T> *n = newNode();
 
 	if (n == NULL) {
 		throw CxException("CxSList::append(memory allocation error)");
@@ -669,7 +964,7 @@ CxSList<T>::clear( void )
 	while (_work != NULL ) {
 
 		_head = _work->next;
-		delete _work;
+		deleteNode( _work );
 		_work = _head;
 	}
 
@@ -693,7 +988,7 @@ CxSList<T>::clearAndDelete( void )
 		_head = _work->next;
 		
 		delete _work->data;
-		delete _work;
+		deleteNode( _work );
 
 		_work = _head;
 	}
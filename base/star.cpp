@@ -196,7 +196,7 @@ CxMatchTemplate::test( CxString candidate )
 	// Special case: no wildcards at all means exact match required
 	// (like shell glob behavior where "test" only matches "test")
 	if (!_leadingStar && !_trailingStar && _parts.entries() == 1) {
-		return( candidate == _parts.at(0) );
+		return( candidate == _parts[0] );
 	}
 
 	// build a string match object
@@ -205,14 +205,14 @@ CxMatchTemplate::test( CxString candidate )
 	// walk through the list of parts and see
 	// if the happen in sequence in the candidate
 	for (unsigned int c=0; c<_parts.entries(); c++) {
-		if ( !sm.isNext( _parts.at(c) )) return( FALSE );
+		if ( !sm.isNext( _parts[c] )) return( FALSE );
 	}
 
 	// if the template did not start with a star then
 	// we have to match the first object at the beginning of
 	// of the candidate
 	if (!_leadingStar) {
-		if ( candidate.index( _parts.at(0) ) ) {
+		if ( candidate.index( _parts[0] ) ) {
 			return( FALSE );
 		}
 	}
@@ -222,7 +222,7 @@ CxMatchTemplate::test( CxString candidate )
 	// candidate string.
 	if (!_trailingStar) {
 
-		CxString p = _parts.at( _parts.entries()-1 );
+		const CxString& p = _parts[ (int) _parts.entries()-1 ];
 		int offset = candidate.length() - p.length();
 		if ( offset >= 0 ) {
 			if ( p != candidate.subString( offset, p.length() )) {
@@ -25,7 +25,7 @@
 #include <iostream>
 
 #include <cx/base/string.h>
-#include <cx/base/slist.h>
+#include <cx/base/array.h>
 
 
 #ifndef _CxGLOB_
@@ -89,7 +89,7 @@ class CxMatchTemplate
 	void parse( CxString );
 	// pre-parse the template into a form ready to match against 
 
-	CxSList< CxString > _parts;
+	CxArray< CxString > _parts;
 	// list of parts to match against
 
 	int      _leadingStar;
@@ -11,16 +11,76 @@
 //
 //-------------------------------------------------------------------------------------------------
 
+#include <new>
+
 #include <cx/base/string.h>
+#include <cx/base/arena.h>
+#include <cx/base/bytesearch.h>
+#include <cx/base/cntbody.h>
+
 
 //-------------------------------------------------------------------------
-// SunOS 4.x needs extern "C" declaration for bcmp
+// class CxStringBody
+//
+// Heap characters shared by copies of a CxString.  The characters follow
+// the body in the same allocation, and the body is freed when the last
+// string holding it lets go.
+//
+//-------------------------------------------------------------------------
+class CxStringBody : public CxCountedBody
+{
+  public:
+
+	static CxStringBody *create( int capacity_ );
+	// return a body with room for capacity_ characters and a terminator,
+	// held once
+
+	static void release( CxStringBody *body_ );
+	// drop one hold on body_, freeing it with the last
+
+	char *chars( void ) { return( (char *) (this + 1) ); }
+	// return the characters
+
+	int isUnshareable( void ) const { return( _unshareable ); }
+	void setUnshareable( void ) { _unshareable = TRUE; }
+	// set once data() has handed out the characters to be written, copies
+	// of the string then take characters of their own
+
+  private:
+
+	int _unshareable;
+};
+
+
 //-------------------------------------------------------------------------
-#if defined(_SUNOS_)
-extern "C" {
-int bcmp(const char *b1, const char *b2, int length);
+// CxStringBody::create
+//
+//-------------------------------------------------------------------------
+CxStringBody *
+CxStringBody::create( int capacity_ )
+{
+	void *p = ::operator new( sizeof(CxStringBody) + capacity_ + 1 );
+
+	CxStringBody *body = new (p) CxStringBody;
+	body->_unshareable = FALSE;
+	body->incCount();
+
+	return( body );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringBody::release
+//
+//-------------------------------------------------------------------------
+void
+CxStringBody::release( CxStringBody *body_ )
+{
+	if ( body_->decCount() == 0 ) {
+		body_->~CxStringBody();
+		::operator delete( (void *) body_ );
+	}
 }
-#endif
 
 
 //-------------------------------------------------------------------------
@@ -28,7 +88,7 @@ int bcmp(const char *b1, const char *b2, int length);
 //
 //-------------------------------------------------------------------------
 CxString::CxString( void )
-: _data( NULL )
+: _length( 0 ), _capacity( SHORT_CAPACITY )
 {
 	reAssign( (char *) NULL );
 }
@@ -39,7 +99,7 @@ CxString::CxString( void )
 //
 //-------------------------------------------------------------------------
 CxString::CxString(int i)
-:_data( NULL )
+:_length( 0 ), _capacity( SHORT_CAPACITY )
 {
     reAssign( (char *) NULL );
     setInt(i);
@@ -50,7 +110,7 @@ CxString::CxString(int i)
 //
 //-------------------------------------------------------------------------
 CxString::CxString( long l )
-: _data( NULL )
+: _length( 0 ), _capacity( SHORT_CAPACITY )
 {
     reAssign( (char *) NULL );
     setLong(l);
@@ -61,7 +121,7 @@ CxString::CxString( long l )
 //
 //-------------------------------------------------------------------------
 CxString::CxString(unsigned long ul)
-: _data( NULL )
+: _length( 0 ), _capacity( SHORT_CAPACITY )
 {
     reAssign( (char *) NULL );
     setUnsignedLong(ul);
@@ -72,7 +132,7 @@ CxString::CxString(unsigned long ul)
 //
 //-------------------------------------------------------------------------
 CxString::CxString(double d)
-: _data( NULL )
+: _length( 0 ), _capacity( SHORT_CAPACITY )
 {
     reAssign( (char *) NULL );
     setDouble(d);
@@ -83,22 +143,45 @@ CxString::CxString(double d)
 //
 //-------------------------------------------------------------------------
 CxString::CxString( const char* cptr_, int len )
-: _data(NULL)
+: _length( 0 ), _capacity( SHORT_CAPACITY )
 {
 	reAssign( cptr_, len );
 }
 
 
+//-------------------------------------------------------------------------
+// CxString::CxString
+//
+//-------------------------------------------------------------------------
+CxString::CxString( const char* cptr_, int len, CxArena *arena_ )
+: _length( 0 ), _capacity( SHORT_CAPACITY )
+{
+	if ( cptr_ == NULL ) len = 0;
+
+	const char *term = (len > 0) ? (const char *) memchr( cptr_, 0, len ) : NULL;
+	if ( term != NULL ) len = (int) (term - cptr_);
+
+	if ( len <= SHORT_CAPACITY || arena_ == NULL ) {
+		reAssign( cptr_, len );
+		return;
+	}
+
+	_heap.data = arena_->strdup( cptr_, len );
+	_heap.body = NULL;
+	_length    = len;
+	_capacity  = len;
+}
+
+
 //-------------------------------------------------------------------------
 // CxString::
 //
 //-------------------------------------------------------------------------
 CxString::CxString( const CxString& sr_ )
-: _data( NULL)
+: _length( 0 ), _capacity( SHORT_CAPACITY )
 {
 	if ( &sr_ != this ) {
-		//_data = (char*) NULL;
-		reAssign( sr_.data() );
+		assignFrom( sr_ );
 	}
 }
 
@@ -108,10 +191,10 @@ CxString::CxString( const CxString& sr_ )
 //
 //-------------------------------------------------------------------------
 CxString::CxString( const CxString* sr_ )
-: _data( NULL )
+: _length( 0 ), _capacity( SHORT_CAPACITY )
 {
     if ( sr_ != NULL ) {
-        reAssign( sr_->data() );
+        assignFrom( *sr_ );
     } else {
         reAssign( (char *) NULL );
     }
@@ -123,7 +206,7 @@ CxString::CxString( const CxString* sr_ )
 //
 //-------------------------------------------------------------------------
 CxString::CxString( const char c_ )
-:_data(NULL)
+:_length( 0 ), _capacity( SHORT_CAPACITY )
 {
     char d[2];
     d[0] = c_;
@@ -138,10 +221,9 @@ CxString::CxString( const char c_ )
 //-------------------------------------------------------------------------
 CxString::~CxString( void )
 {
-	if (_data) {
-		delete[] _data;
-		_data = NULL;
-	}	
+	releaseHeap();
+	_length   = 0;
+	_capacity = SHORT_CAPACITY;
 }
 
 
@@ -153,7 +235,7 @@ CxString&
 CxString::operator=( const CxString& sr_ )
 {
 	if ( &sr_ != this ) {
-		reAssign( sr_.data() );
+		assignFrom( sr_ );
 	}
 	return( *this );
 }
@@ -166,17 +248,11 @@ CxString::operator=( const CxString& sr_ )
 CxString
 CxString::operator+( const CxString& sr_ )
 {
-	int newLen = sr_.length() + strlen( _data ) + 1;
-	char *cptr = new char[ sr_.length() + strlen( _data ) + 1 ];
-	memset( cptr, 0, newLen );
+	CxString newString;
 
-	int len = strlen( _data );
-
-	memcpy( cptr, &(_data[0]), len );
-	memcpy( &(cptr[len]), sr_.data(), sr_.length() );
-
-	CxString newString = cptr;
-	delete [] cptr;
+	newString.reserve( _length + sr_._length );
+	newString.append( *this );
+	newString.append( sr_ );
 
 	return( newString );
 }
@@ -190,42 +266,56 @@ CxString::operator+( const CxString& sr_ )
 void
 CxString::insert( const CxString& sr_, int n )
 {
-	if ( sr_.length()  == 0 ) return;
+	int insertLen = sr_._length;
+
+	if ( insertLen == 0 ) return;
 	
-	if ( strlen(_data) == 0 ) {
-		reAssign( sr_.data() );
+	if ( _length == 0 ) {
+		reAssign( sr_.storage(), sr_._length );
 		return;
 	}
 
-	if (n==length()) {
+	if (n==_length) {
 		append(sr_);
 		return;
 	}
 
-	if ( n > strlen(_data) -1 ) n = strlen(_data)-1;
+	if ( n > _length-1 ) n = _length-1;
 	if ( n < 0 ) n = 0;
 
-	int newLen = sr_.length() + strlen(_data) + 1;
-	char *cptr = new char[ sr_.length() + strlen( _data ) + 1 ];
-	memset( cptr, 0, newLen );
+	// inserting self into self, take a copy before the buffer moves
 
-	// copy first n
-	memcpy( cptr, &(_data[0]), n );
-	memcpy( cptr + n, sr_.data(), sr_.length() );
-//	memcpy( cptr + n + sr_.length(), &(_data[n]), newLen - sr_.length() );
+	if ( &sr_ == this ) {
+		CxString copy( sr_ );
+		insert( copy, n );
+		return;
+	}
 
-	memcpy( cptr + n + sr_.length(), &(_data[n]), strlen( _data )-n);
-	
-	reAssign( cptr );
+	if ( _length + insertLen > _capacity ) {
+		int newCapacity = _capacity + _capacity;
+		if ( newCapacity < _length + insertLen ) newCapacity = _length + insertLen;
+		growTo( newCapacity );
+	}
 
-	delete [] cptr;
+	// slide the tail (and the terminator) up and drop the new text in the gap
+
+	char *d = writable();
+
+	memmove( d + n + insertLen, d + n, _length - n + 1 );
+	memcpy( d + n, sr_.storage(), insertLen );
+
+	_length += insertLen;
 }
 
 
 void
 CxString::insert( char c, int n)
 {
-	CxString i(c);
+	char d[2];
+	d[0] = c;
+	d[1] = (char) NULL;
+
+	CxString i( d, 1 );
 	insert( i, n);
 }
 
@@ -263,7 +353,8 @@ CxString::operator+=( const char cc_ )
 int
 CxString::operator==( const CxString& sr_ ) const
 {
-    if ( strcmp(sr_.data(), _data) == 0 )  return( TRUE );
+    if ( sr_._length != _length ) return( FALSE );
+    if ( memcmp(sr_.storage(), storage(), _length) == 0 )  return( TRUE );
     return( FALSE );
 }
 
@@ -274,7 +365,8 @@ CxString::operator==( const CxString& sr_ ) const
 int
 CxString::operator!=( const CxString& sr_ ) const
 {
-    if ( strcmp(sr_.data(), _data) != 0 )  return( TRUE );
+    if ( sr_._length != _length ) return( TRUE );
+    if ( memcmp(sr_.storage(), storage(), _length) != 0 )  return( TRUE );
     return( FALSE );
 }
 
@@ -285,7 +377,7 @@ CxString::operator!=( const CxString& sr_ ) const
 int
 CxString::operator<=( const CxString& rhs_ ) const
 {
-    return( strcmp( data(), rhs_.data() ) <= 0 );
+    return( strcmp( storage(), rhs_.storage() ) <= 0 );
 }
 
 
@@ -296,31 +388,172 @@ CxString::operator<=( const CxString& rhs_ ) const
 void
 CxString::append( const CxString& sr_ )
 {
-	int newLen = sr_.length() + strlen( _data ) + 1;
-	char *cptr = new char[ sr_.length() + strlen( _data ) + 1 ];
-	memset( cptr, 0, newLen );
+	int appendLen = sr_._length;
+
+	if ( appendLen == 0 ) return;
+
+	// grow geometrically so a run of appends costs amortized O(1) per character
 
-	int len = strlen( _data );
+	if ( _length + appendLen > _capacity ) {
+		int newCapacity = _capacity + _capacity;
+		if ( newCapacity < _length + appendLen ) newCapacity = _length + appendLen;
+		growTo( newCapacity );
+	}
 
-	memcpy( cptr, &(_data[0]), len );
-	memcpy( &(cptr[len]), sr_.data(), sr_.length() );
+	// sr_ may be self, in which case the buffer has just moved and sr_ moved with it
 
-	reAssign( cptr );
+	char *d = writable();
 
-	delete [] cptr;	
+	memcpy( d + _length, sr_.storage(), appendLen );
+	_length += appendLen;
+	d[_length] = (char) NULL;
 }
 
 void
 CxString::append( char cc_ )
 {
-	char s[2];
-	s[1] = (char) NULL;
-	s[0] = cc_;
+	if ( cc_ == (char) NULL ) return;
+
+	if ( _length + 1 > _capacity ) {
+		int newCapacity = _capacity + _capacity;
+		if ( newCapacity < 16 ) newCapacity = 16;
+		growTo( newCapacity );
+	}
+
+	char *d = writable();
+
+	d[_length++] = cc_;
+	d[_length]   = (char) NULL;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// CxString::reserve
+//
+//------------------------------------------------------------------------------------------------
+void
+CxString::reserve( int capacity_ )
+{
+	if ( capacity_ > _capacity ) {
+		growTo( capacity_ );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// CxString::capacity
+//
+//------------------------------------------------------------------------------------------------
+int
+CxString::capacity( void ) const
+{
+	return( _capacity );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// CxString::growTo
+//
+//------------------------------------------------------------------------------------------------
+void
+CxString::growTo( int capacity_ )
+{
+	CxStringBody *body    = CxStringBody::create( capacity_ );
+	char         *newData = body->chars();
+
+	memcpy( newData, storage(), _length );
 
-	append( CxString( s ));
+	releaseHeap();
+
+	newData[_length] = (char) NULL;
+
+	_heap.data = newData;
+	_heap.body = body;
+	_capacity  = capacity_;
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// CxString::releaseHeap
+//
+//------------------------------------------------------------------------------------------------
+void
+CxString::releaseHeap( void )
+{
+	if ( _capacity > SHORT_CAPACITY && _heap.body != NULL ) {
+		CxStringBody::release( _heap.body );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// CxString::isShared
+//
+//------------------------------------------------------------------------------------------------
+int
+CxString::isShared( void ) const
+{
+	if ( _capacity > SHORT_CAPACITY && _heap.body != NULL && _heap.body->count() > 1 ) {
+		return( TRUE );
+	}
+	return( FALSE );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// CxString::writable
+//
+//------------------------------------------------------------------------------------------------
+char *
+CxString::writable( void ) const
+{
+	// a body held by only this string cannot become shared behind its back,
+	// copies are only taken from this object.  The copy keeps the capacity,
+	// so only the mutable heap block changes
+
+	if ( isShared() ) {
+		CxStringBody *body = CxStringBody::create( _capacity );
+
+		memcpy( body->chars(), _heap.data, _length );
+		body->chars()[_length] = (char) NULL;
+		CxStringBody::release( _heap.body );
+
+		_heap.data = body->chars();
+		_heap.body = body;
+	}
+	return( storage() );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// CxString::assignFrom
+//
+//------------------------------------------------------------------------------------------------
+void
+CxString::assignFrom( const CxString& sr_ )
+{
+	// inline characters, arena blocks and a body data() has handed out are
+	// copied, any other heap body is shared
+
+	if ( sr_._capacity <= SHORT_CAPACITY || sr_._heap.body == NULL ||
+	     sr_._heap.body->isUnshareable() ) {
+		reAssign( sr_.storage(), sr_._length );
+		return;
+	}
+
+	if ( _capacity > SHORT_CAPACITY && _heap.body == sr_._heap.body ) {
+		return;
+	}
+
+	sr_._heap.body->incCount();
+
+	releaseHeap();
+
+	_heap     = sr_._heap;
+	_length   = sr_._length;
+	_capacity = sr_._capacity;
+}
+
 
 //-----------------------------------------------------------------------------------------------
 // CxString::reAssign
@@ -330,46 +563,57 @@ void
 CxString::reAssign( const char *cptr, int len )
 {
 	//---------------------------------------------------------------------------------------------
-	//  if data is a valid pointer, the delete the block and set the pointer to NULL
+	// work out how many characters are coming.  A length that was passed in is an upper bound,
+	// the copy still stops at an embedded terminator the same way strncpy would.
 	//---------------------------------------------------------------------------------------------
 
-    if (_data) {
-        delete[] _data;
-        _data = NULL;
-    }
-
-	// check if the source pointer is an empty string
+	int newLen = 0;
 
 	if (cptr != NULL) {
 
 		if (len == -1) {
+			newLen = strlen( cptr );
+		} else {
+			const char *term = (const char *) memchr( cptr, 0, len );
+			newLen = (term != NULL) ? (int)(term - cptr) : len;
+		}
+	}
 
-			// the length parameter is default, just make the new memory block 
-			// the size of the source string
+	//---------------------------------------------------------------------------------------------
+	// reuse the current block (inline or heap) if it is big enough and not shared, the source
+	// may live inside it so move rather than copy.  Otherwise build a new block before letting
+	// go of the old one, the source may live in that one too.
+	//---------------------------------------------------------------------------------------------
 
-			_data = new char[ strlen( cptr ) + 1 ];
-			if (_data) {
-				strcpy( _data, cptr );
-			}
+	if ( newLen <= _capacity && !isShared() ) {
 
-		} else {
+		if (newLen) memmove( storage(), cptr, newLen );
 
-			// the length parameter was passed in so make the block the the size passed
-			// in
+	} else if ( newLen <= SHORT_CAPACITY ) {
+
+		// a shared body replaced by something short goes back inline
+
+		CxStringBody *old = _heap.body;
+
+		if (newLen) memcpy( _short, cptr, newLen );
+		_capacity = SHORT_CAPACITY;
+
+		CxStringBody::release( old );
 
-			_data = new char[ len + 1 ];
-			if (_data) {
-				strncpy( _data, cptr, len );
-				_data[len]=(char)NULL;
-			}
-		}
-	
 	} else {
 
-		// the source pointer is and empty string just create a empty string
-		_data = new char[1];
-		_data[0]=(char) NULL;
+		CxStringBody *body = CxStringBody::create( newLen );
+		memcpy( body->chars(), cptr, newLen );
+
+		releaseHeap();
+
+		_heap.data = body->chars();
+		_heap.body = body;
+		_capacity  = newLen;
 	}
+
+	_length = newLen;
+	storage()[_length] = (char) NULL;
 }
 
 
@@ -381,7 +625,15 @@ CxString::reAssign( const char *cptr, int len )
 char *
 CxString::data( void ) const
 {
-	return( _data );
+	// callers may write through this pointer for as long as the string is
+	// unchanged, so the body is unshared now and not shared again
+
+	char *d = writable();
+
+	if ( _capacity > SHORT_CAPACITY && _heap.body != NULL ) {
+		_heap.body->setUnshareable();
+	}
+	return( d );
 }
 
 
@@ -393,21 +645,17 @@ int
 CxString::firstChar( const char ch ) const
 {
 	if ( isNull() )  return( -1 );
-		
-	int c;
-	int i = strlen( _data );
 
-	for (c=0; c<i; c++ ) {
-		if ( _data[c] == ch ) return( c );
-	}
+	const char *d = storage();
+	const char *p = CxByteSearch::findByte( d, _length, ch );
 
-	return( -1 );
+	return( p ? (int) (p - d) : -1 );
 }
 
 int
 CxString::charAt(int index)
 {
-    return( _data[index] );
+    return( storage()[index] );
 }
 
 //-------------------------------------------------------------------------
@@ -418,17 +666,11 @@ int
 CxString::lastChar( const char ch ) const
 {
 	if ( isNull() )  return( -1 );
-		
-	int c;
-	int i = strlen( _data );
 
-	if (i==0) return -1;
+	const char *d = storage();
+	const char *p = CxByteSearch::findLastByte( d, _length, ch );
 
-	for (c=i-1; c>=0; c-- ) {
-		if ( _data[c] == ch ) return( c );
-	}
-
-	return( -1 );
+	return( p ? (int) (p - d) : -1 );
 }
 
 
@@ -440,22 +682,14 @@ int
 CxString::firstChar( const char *delimSet, char *theDelim) const
 {
 	if ( isNull() )  return( -1 );
-		
-	int c;
-    int j;
-    int delimSetLength = strlen( delimSet );
-	int i = strlen( _data );
-
-	for (c=0; c<i; c++ ) {
-        for (j=0; j<delimSetLength; j++) {
-		    if ( _data[c] == delimSet[j] ) {
-				if (theDelim != NULL) *theDelim = delimSet[j];
-				return( c );
-			}
-	    }
-    }
 
-	return( -1 );
+	const char *d = storage();
+	const char *p = CxByteSearch::findAnyOf( d, _length, delimSet, strlen( delimSet ) );
+
+	if (p == NULL) return( -1 );
+
+	if (theDelim != NULL) *theDelim = *p;
+	return( (int) (p - d) );
 }
 
 
@@ -468,20 +702,14 @@ CxString::index( CxString s_, int startpos_ ) const
 {
 	if ( isNull() )  return( -1 );
 
-	int c;
-	int i = strlen( _data );
+	if ( startpos_ > _length-1 ) return( -1 );
+	if ( startpos_ < 0 ) startpos_ = 0;
 
-	if ( startpos_  > i-1) return( -1 );
+	const char *d = storage();
+	const char *p = CxByteSearch::find( d + startpos_, _length - startpos_,
+	                                    s_.storage(), s_._length );
 
-	for (c=startpos_; c<i; c++ ) {
-        
-        if (!bcmp( (const char *) &_data[c], (const char *) s_.data(), s_.length() )) {
-        
-        // if (!strncmp( (const char *) &_data[c], (const char *) s_.data(), s_.length())) {
-            return(c);
-        }
-    }
-	return( -1 );
+	return( p ? (int) (p - d) : -1 );
 }	
 
 
@@ -494,19 +722,26 @@ CxString::stripLeading( const char *charSet_ )
 {
 	if ( isNull() ) return( *this );
 
-	while ( 1 ) {
+	// count the leading characters in the set and shift the rest down once
 
-		if (_data[0] == (char) NULL) {
-			reAssign( (char*) NULL );	
-			return( *this );
-		}
+	char *d = storage();
+	int count = 0;
+	while ( count < _length && CxString::charInSet(d[count], charSet_)) {
+		count++;
+	}
 
-		if (CxString::charInSet(_data[0], charSet_)) {
-			memmove( &(_data[0]), &(_data[1]), strlen( _data ) );
-		} else {
-			return( *this );
-		}
+	if (count == 0) return( *this );
+
+	if (count == _length) {
+		reAssign( (char*) NULL );
+		return( *this );
 	}
+
+	d = writable();
+	memmove( &(d[0]), &(d[count]), _length - count + 1 );
+	_length -= count;
+
+	return( *this );
 }
 
 
@@ -519,24 +754,19 @@ CxString::stripTrailing( const char *charSet_ )
 {
 	if ( isNull() ) return( *this );
 
-	int cursor = strlen( _data ) -1;
+	const char *d = storage();
+	int len = _length;
 
-	while ( 1 ) {
+	while ( len > 0 && CxString::charInSet(d[ len-1 ], charSet_)) {
+		len--;
+	}
 
-		if (_data[cursor] != (char) NULL) {
-			if (CxString::charInSet(_data[ cursor ], charSet_)) {
-				_data[ cursor ] = (char) NULL;
-			} else {
-				return( *this );
-			}
-		}
+	if (len == _length) return( *this );
 
-		if (cursor == 0) {
-			return( *this );
-		}
+	writable()[ len ] = (char) NULL;
+	_length = len;
 
-		cursor--;
-	}
+	return( *this );
 }
 
 
@@ -586,17 +816,11 @@ CxString::subString( int start, int len )
     if (len  < 0) return( *this );
 
     if (len==0) return s;  // return empty string
-	if (start > (int) strlen( _data )) return( s ); // return empty string
+	if (start > _length) return( s ); // return empty string
 
-	while ( start+len > (int) strlen(_data) ) len--;
+	if ( start+len > _length ) len = _length - start;
 
-	char *cptr = new char[ len+1 ];
-	memset( cptr, 0, len+1);
-	memcpy( cptr, &(_data[start]), len );
-
-	s = cptr;
-
-	delete[] cptr;
+	s.reAssign( &(storage()[start]), len );
 
 	return( s );
 }
@@ -615,7 +839,7 @@ CxString::remove( int start, int len )
 
 
 	if (start < 0) return( *this );
-	if (start > (int) strlen( _data )-1) return( *this );
+	if (start > _length-1) return( *this );
 	if (len < 0) return( *this );
 
     /*
@@ -631,10 +855,11 @@ CxString::remove( int start, int len )
     *destPtr = (char) NULL;
     */
     
-	while (start+len > (int) strlen(_data)) len--;
+	if (start+len > _length) len = _length - start;
 
-	int sLen = strlen( _data );
-	memmove( &(_data[start]), &(_data[start+len]), sLen-(start+len)+1);
+	char *d = writable();
+	memmove( &(d[start]), &(d[start+len]), _length-(start+len)+1);
+	_length -= len;
 
 
     return(*this);
@@ -673,7 +898,7 @@ CxString::findAndReplaceFirst( CxString findString, CxString replaceString )
 		// get the length of the replace string and a pointer
 		// to the data
 		int replaceStringLength = replaceString.length();
-		char *replaceStringPtr = replaceString.data();
+		const char *replaceStringPtr = replaceString.c_str();
 
 		// copy the replace string into the destination buffer
 		pos = 0;
@@ -714,7 +939,7 @@ CxString::findAndReplaceFirst( CxString findString, CxString replaceString, int
 
         // scr pointer is the existing contents of the string
         // dest pointer is the newly allocated buffer
-        char *srcPtr  = _data;
+        char *srcPtr  = storage();
         char *destPtr = newBuffer;
  
         // copy first part of the original string we skipped plus the part
@@ -732,7 +957,7 @@ CxString::findAndReplaceFirst( CxString findString, CxString replaceString, int
         // get the length of the replace string and a pointer
         // to the data
         int replaceStringLength = replaceString.length();
-        char *replaceStringPtr = replaceString.data();
+        const char *replaceStringPtr = replaceString.storage();
 
         // copy the replace string into the destination buffer
         pos = 0;
@@ -763,52 +988,65 @@ CxString::findAndReplaceFirst( CxString findString, CxString replaceString, int
 int
 CxString::replaceAll(CxString match, CxString replace)
 {
-    int num = 0;
-    int foundPosition = -1;
-    int startPosition =  0;
-    int done = false;
+    // an empty match would be found everywhere, there is nothing to replace
+    if (match._length == 0) return( 0 );
 
-    while (!done) {
+    if (match._length == 1) {
+        return( (int) CxByteSearch::countByte( storage(), _length, match.storage()[0] ) );
+    }
 
-        foundPosition = index( match, startPosition);
+    const char *d   = storage();
+    const char *end = d + _length;
+    const char *m   = match.storage();
 
-        if (foundPosition != -1) {
+    const char *p = CxByteSearch::find( d, _length, m, match._length );
+    if (p == NULL) return( 0 );
 
-            num++;
+    // build the result in one pass rather than removing and inserting
+    // at each match, which moved the rest of the string every time
 
-            remove( foundPosition, match.length() );
-            insert( replace, foundPosition);
+    CxString result;
+    result.reserve( _length );
 
-            startPosition = foundPosition + replace.length();
+    int num = 0;
 
-        } else {
-            
-            done = true;
-        
-        }
+    while (p != NULL) {
+
+        num++;
+
+        result.append( CxString( d, (int) (p - d) ) );
+        result.append( replace );
+
+        d = p + match._length;
+        p = CxByteSearch::find( d, end - d, m, match._length );
     }
 
+    result.append( CxString( d, (int) (end - d) ) );
+
+    *this = result;
+
     return( num );
 }
 
 int
 CxString::numberOfOccurances( CxString match )
 {
-    int num = 0;
-    int foundPosition = -1;
-    int startPosition =  0;
-    int done = false;
+    if (match._length == 0) return( 0 );
 
-    while (!done) {
+    if (match._length == 1) {
+        return( (int) CxByteSearch::countByte( storage(), _length, match.storage()[0] ) );
+    }
 
-        foundPosition = index( match, startPosition);
+    const char *d   = storage();
+    const char *end = d + _length;
+    const char *m   = match.storage();
 
-        if (foundPosition != -1) {
-            num++;
-            startPosition = foundPosition + match.length();
-        } else {
-            done = true;
-        }
+    int num = 0;
+    const char *p;
+
+    while ((p = CxByteSearch::find( d, end - d, m, match._length )) != NULL) {
+        num++;
+        d = p + match._length;
     }
 
     return( num );
@@ -822,7 +1060,7 @@ CxString::numberOfOccurances( CxString match )
 int
 CxString::length( void ) const
 {
-	return( strlen( _data ) );
+	return( _length );
 }
 
 
@@ -835,7 +1073,7 @@ CxString::toInt( void )
 {
     int i;
     if (!isNull()) {
-        if (sscanf(_data, "%d", &i )==1) {
+        if (sscanf(storage(), "%d", &i )==1) {
             return( i );
         }
     }
@@ -853,7 +1091,7 @@ CxString::toLong( void )
 {
     long l;
     if (!isNull()) {
-        if (sscanf(_data, "%ld", &l )==1) {
+        if (sscanf(storage(), "%ld", &l )==1) {
             return( l );
         }
     }
@@ -871,7 +1109,7 @@ CxString::toUnsignedLong( void )
 {
     unsigned long ul;
     if (!isNull()) {
-        if (sscanf(_data, "%lu", &ul )==1) {
+        if (sscanf(storage(), "%lu", &ul )==1) {
             return( ul );
         }
     }
@@ -889,7 +1127,7 @@ CxString::toFloat( void )
 {
     float f;
     if (!isNull()) {
-        if (sscanf(_data, "%f", &f )==1) {
+        if (sscanf(storage(), "%f", &f )==1) {
             return( f );
         }
     }
@@ -907,7 +1145,7 @@ CxString::toDouble( void )
 {
     double d;
     if (!isNull()) {
-        if (sscanf(_data, "%lf", &d )==1) {
+        if (sscanf(storage(), "%lf", &d )==1) {
             return( d );
         }
     }
@@ -951,8 +1189,7 @@ CxString::charInSet( char ch, const char *charSet_ )
 int
 CxString::isNull(void) const
 {
-	if (!_data) return( TRUE );
-	if (_data[0] == (char) NULL) return( TRUE );
+	if (_length == 0) return( TRUE );
 	return( FALSE );
 }
 
@@ -963,7 +1200,7 @@ CxString::isNull(void) const
 //-------------------------------------------------------------------------
 std::ostream& operator<<(std::ostream& str, const CxString& cxstring_ )
 {
-    str << cxstring_.data();
+    str << cxstring_.storage();
     return(str);
 }
 
@@ -1031,7 +1268,7 @@ CxString::toUpper( CxString s )
 int
 CxString::compare( CxString s )
 {
-    return( strcmp( data(), s.data() ));
+    return( strcmp( storage(), s.storage() ));
 }
 
 
@@ -1067,7 +1304,7 @@ CxString::toLower( CxString s )
 void
 CxString::setString( CxString s )
 {
-	reAssign( s.data() );	
+	assignFrom( s );
 }
 
 void
@@ -1110,18 +1347,32 @@ CxString::setDouble(double d)
 unsigned int
 CxString::hashValue( void ) const
 {
-	unsigned int i = 0;
+	return( hashValue( storage(), _length ) );
+}
 
-	char *ptr = &_data[0];
 
-	while (*ptr != (char) NULL) {
+//-------------------------------------------------------------------------
+// CxString::hashValue
+//
+//-------------------------------------------------------------------------
+/* static */
+unsigned int
+CxString::hashValue( const char *s, int len )
+{
+	// 32 bit FNV-1a.  Every byte is folded in with a multiply so that
+	// anagrams and keys differing only in position hash apart
 
-		i += (unsigned int) *ptr;
+	unsigned int h = 2166136261U;
 
-		ptr++;
+	const unsigned char *ptr = (const unsigned char *) s;
+	const unsigned char *end = ptr + len;
+
+	while (ptr < end) {
+		h ^= (unsigned int) *ptr++;
+		h *= 16777619U;
 	}
 
-	return( i );
+	return( h );
 }
 
 
@@ -1132,7 +1383,7 @@ CxString::hashValue( void ) const
 int
 CxString::isFloat( void )
 {
-	char *ptr = &_data[0];
+	char *ptr = &storage()[0];
 
 	while (*ptr != (char) NULL) {
 
@@ -1169,7 +1420,7 @@ CxString::isFloat( void )
 int
 CxString::isInt( void )
 {
-	char *ptr = &_data[0];
+	char *ptr = &storage()[0];
 
 	while (*ptr != (char) NULL) {
 
@@ -1214,7 +1465,7 @@ CxString
 CxString::urlDecode( CxString s_ )
 {
 	CxString result;
-	char *ptr = s_.data();
+	const char *ptr = s_.storage();
 
 	while (*ptr != (char) NULL) {
 		if (*ptr == '+') {
@@ -48,10 +48,18 @@
 #define FALSE 0
 #endif
 
+class CxArena;
+class CxStringBody;
+
 
 //-------------------------------------------------------------------------
 // class CxString
 //
+// Short strings are held inline.  Longer ones live in a reference counted
+// heap body that copies share until one of them is changed, so passing a
+// CxString by value does not copy the characters.  Once data() has handed
+// out a writable pointer the body is never shared again.
+//
 //-------------------------------------------------------------------------
 class CxString
 {
@@ -78,6 +86,11 @@ class CxString
 	CxString( const char * cptr_, int len=-1 );
 	// construct from a const char string
 
+	CxString( const char * cptr_, int len, CxArena *arena_ );
+	// construct from a const char string, keeping the characters in arena_.
+	// The string never frees that block, so a string that is not grown
+	// can be left in an arena without running its destructor
+
 	CxString( const CxString * sr_ );
 	// copy from a pointer
 
@@ -123,6 +136,12 @@ class CxString
 	int length( void ) const;
 	// return length of self
 
+	void reserve( int capacity_ );
+	// make room for at least capacity_ characters without reallocating
+
+	int capacity( void ) const;
+	// return the number of characters self can hold without reallocating
+
 	int firstChar( const char ) const;
 	// return index of first occurance of char, or -1
 
@@ -187,7 +206,15 @@ class CxString
 	// convert all characters in s to lower case and return
 
 	char *data( void ) const;
-	// return a pointer to a raw c string
+	// return a pointer to a raw c string that may be written through
+	// until the string is next changed.  A body shared with other strings
+	// is copied first, even for a const string, so earlier c_str()
+	// pointers can move and the call must not race with readers of the
+	// same object.  Later copies of this string get characters of their
+	// own.  c_str() reads without copying
+
+	const char *c_str( void ) const;
+	// return a read only pointer to a raw c string, never copies
 
 	int isNull( void ) const;
 	// if self contains nothing return true
@@ -195,6 +222,9 @@ class CxString
 	unsigned int hashValue( void ) const;
 	// return a integer hash value of self
 
+	static unsigned int hashValue( const char *s, int len );
+	// the same hash of the len characters at s
+
 	static CxString urlDecode( CxString s_ );
 	// return a decoded string	
 
@@ -241,10 +271,72 @@ class CxString
 	void reAssign( const char *, int len=-1 );
 	// internal assignment of self
 
-	char *_data;
-	// internal pointer to data
-	
+	void assignFrom( const CxString& sr_ );
+	// internal assignment from another string, sharing its heap body
+
+	enum { SHORT_CAPACITY = 23 };
+	// strings up to this many characters live in _short and never touch the heap
+
+	char *storage( void ) const;
+	// return the active buffer, _short or _heap depending on capacity
+
+	void growTo( int capacity_ );
+	// grow the allocation to hold capacity_ characters, keeping contents
+
+	void releaseHeap( void );
+	// drop this string's hold on the heap block, freeing it with the last one
+
+	int isShared( void ) const;
+	// return TRUE if the heap body is also held by another string
+
+	char *writable( void ) const;
+	// return the active buffer after making sure no other string shares it.
+	// Const so that data() can use it, the heap block is mutable
+
+	int _length;
+	// number of characters in the buffer, not counting the terminator
+
+	int _capacity;
+	// number of characters the buffer can hold, not counting the terminator.
+	// anything above SHORT_CAPACITY means the characters are on the heap
+
+	struct HeapBlock {
+		char         *data;
+		CxStringBody *body;
+	};
+	// a heap block.  data points at the characters in body, body is NULL
+	// when the characters belong to a CxArena
+
+	union {
+		mutable HeapBlock _heap;
+		char              _short[ SHORT_CAPACITY + 1 ];
+	};
+	// the heap block or the inline characters.  Nothing points back into the
+	// object itself, so a CxString can be relocated with a plain memcpy
+
 };
 
 
+//-------------------------------------------------------------------------
+// CxString::storage
+//
+//-------------------------------------------------------------------------
+inline char *
+CxString::storage( void ) const
+{
+	return( (_capacity > SHORT_CAPACITY) ? _heap.data : (char *) _short );
+}
+
+
+//-------------------------------------------------------------------------
+// CxString::c_str
+//
+//-------------------------------------------------------------------------
+inline const char *
+CxString::c_str( void ) const
+{
+	return( storage() );
+}
+
+
 #endif
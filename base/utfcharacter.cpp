@@ -15,6 +15,7 @@
 #include <string.h>
 
 #include <cx/base/utfcharacter.h>
+#include <cx/base/bytesearch.h>
 
 
 //-------------------------------------------------------------------------------------------------
@@ -120,6 +121,61 @@ cxUTF8Encode(unsigned int codepoint, unsigned char *outBytes)
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// cxUTF8ValidLength
+//
+// Runs of ASCII are stepped over with CxByteSearch, a block of bytes at a time; only the
+// sequences between them are decoded.
+//
+//-------------------------------------------------------------------------------------------------
+int
+cxUTF8ValidLength(const char *bytes, int len)
+{
+    if (bytes == 0 || len <= 0) return 0;
+
+    const unsigned char *start = (const unsigned char *)bytes;
+    const unsigned char *p = start;
+    const unsigned char *end = start + len;
+
+    while (p < end) {
+        const char *q = CxByteSearch::findNonASCII((const char *)p, end - p);
+        if (q == 0) return len;
+        p = (const unsigned char *)q;
+
+        int seqLen;
+        unsigned int min;
+        if (*p >= 0xC2 && *p <= 0xDF) {
+            seqLen = 2;
+            min = 0x80;
+        } else if ((*p & 0xF0) == 0xE0) {
+            seqLen = 3;
+            min = 0x800;
+        } else if (*p >= 0xF0 && *p <= 0xF4) {
+            seqLen = 4;
+            min = 0x10000;
+        } else {
+            break;
+        }
+
+        if (end - p < seqLen) break;
+
+        int i;
+        for (i = 1; i < seqLen; i++) {
+            if ((p[i] & 0xC0) != 0x80) break;
+        }
+        if (i < seqLen) break;
+
+        unsigned int cp = cxUTF8Decode(p, seqLen);
+        if (cp < min || cp > 0x10FFFF) break;
+        if (cp >= 0xD800 && cp <= 0xDFFF) break;
+
+        p += seqLen;
+    }
+
+    return (int)(p - start);
+}
+
+
 //-------------------------------------------------------------------------------------------------
 // cxUTF8IsCombiningMark
 //
@@ -328,6 +384,15 @@ CxUTFCharacter::fromUTF8(const char *utf8bytes)
         return 0;
     }
 
+    // An ASCII byte not followed by a combining mark is a character of its own
+    if (*p < 0x80 && p[1] < 0x80) {
+        _bytes[0] = *p;
+        _byteCount = 1;
+        _displayWidth = (*p >= 0x20 && *p != 0x7F) ? 1 : 0;
+        _flags = 0;
+        return 1;
+    }
+
     // Read the base character
     int baseLen = cxUTF8LeadByteLength(*p);
     int totalBytes = baseLen;
@@ -78,6 +78,9 @@ class CxUTFCharacter
 
   private:
 
+    friend class CxUTFString;
+    // builds characters straight from its bytes
+
     unsigned char _bytes[CXUTF_MAX_BYTES];
     unsigned char _byteCount;
     unsigned char _displayWidth;
@@ -106,6 +109,11 @@ int cxUTF8Encode(unsigned int codepoint, unsigned char *outBytes);
 // Returns the number of bytes written (1-4).
 // outBytes must have room for at least 4 bytes.
 
+int cxUTF8ValidLength(const char *bytes, int len);
+// Return how many bytes from the start of bytes are well-formed UTF-8: no stray continuation
+// bytes, cut short sequences, overlong forms, surrogates or codepoints past 0x10FFFF.
+// Returns len if all of them are.
+
 int cxUTF8IsCombiningMark(unsigned int codepoint);
 // Return true if the codepoint is a combining mark.
 
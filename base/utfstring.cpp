@@ -15,10 +15,193 @@
 #include <string.h>
 
 #include <cx/base/utfstring.h>
+#include <cx/base/bytesearch.h>
 
 
 #define CXUTFSTRING_INITIAL_CAPACITY 16
 
+// strings this long keep an index of where their characters start; shorter ones are read
+// from the start each time
+#define CXUTFSTRING_INDEX_BYTES 256
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFStringIndex
+//
+// Where the characters of a string start.  offset and column have an entry for each character
+// and one for the end once built.  A string other than ASCII also keeps the character at()
+// returns here.
+//
+//-------------------------------------------------------------------------------------------------
+
+class CxUTFStringIndex
+{
+  public:
+
+    CxUTFStringIndex(void)
+        : offset(0), column(0), capacity(0), built(0)
+    {
+    }
+
+    ~CxUTFStringIndex(void)
+    {
+        delete[] offset;
+        delete[] column;
+    }
+
+    int *offset;
+    int *column;
+    int capacity;
+    int built;
+
+    CxUTFCharacter character;   // what at() returns
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// sequenceLength
+//
+// Return the length of the UTF-8 sequence at p, no further than end.  A lead byte without the
+// continuation bytes it calls for is a sequence of its own.
+//
+//-------------------------------------------------------------------------------------------------
+static int
+sequenceLength(const unsigned char *p, const unsigned char *end, unsigned int *codepoint)
+{
+    int len = cxUTF8LeadByteLength(*p);
+
+    for (int i = 1; i < len; i++) {
+        if (p + i >= end || (p[i] & 0xC0) != 0x80) {
+            *codepoint = *p;
+            return 1;
+        }
+    }
+
+    *codepoint = cxUTF8Decode(p, len);
+    return len;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// clusterLength
+//
+// Return the length of the character at p, a base and the combining marks after it, as
+// CxUTFCharacter::fromUTF8 reads it.  width is set to its display width, or -1 for a tab.
+//
+//-------------------------------------------------------------------------------------------------
+static int
+clusterLength(const unsigned char *p, const unsigned char *end, int *width)
+{
+    unsigned int cp;
+    int total;
+
+    if (*p < 0x80) {
+        if (*p == '\t') {
+            *width = -1;
+            return 1;
+        }
+        *width = (*p >= 0x20 && *p != 0x7F) ? 1 : 0;
+        total = 1;
+    } else {
+        total = sequenceLength(p, end, &cp);
+        *width = cxUTF8CodepointDisplayWidth(cp);
+    }
+
+    while (p + total < end && total < CXUTF_MAX_BYTES - 4) {
+        if (p[total] < 0x80) break;
+
+        int len = sequenceLength(p + total, end, &cp);
+        if (!cxUTF8IsCombiningMark(cp)) break;
+
+        total += len;
+    }
+
+    return total;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// printableRun
+//
+// Return how many bytes from p are printable ASCII, each a column wide.  A combining mark
+// after the last adds nothing to the width, so copying or measuring them as a run is the
+// same as reading them a character at a time.
+//
+//-------------------------------------------------------------------------------------------------
+static int
+printableRun(const unsigned char *p, const unsigned char *end)
+{
+    if (p == end || *p < 0x20 || *p >= 0x7F) {
+        return 0;
+    }
+
+    const char *q = CxByteSearch::findNonPrintable((const char *) p, end - p);
+    return q ? (int)((const unsigned char *) q - p) : (int)(end - p);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// tabStopWidth
+//
+//-------------------------------------------------------------------------------------------------
+static int
+tabStopWidth(int column, int tabWidth)
+{
+    if (tabWidth <= 0) return 1;
+    return tabWidth - (column % tabWidth);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// asciiCharacter
+//
+// Return the character for an ASCII byte other than a tab, shared by every string.
+//
+//-------------------------------------------------------------------------------------------------
+static CxUTFCharacter *
+asciiCharacter(unsigned char c)
+{
+    static CxUTFCharacter table[128];
+    static int built = 0;
+
+    if (!built) {
+        char bytes[2];
+        bytes[1] = 0;
+        for (int i = 1; i < 128; i++) {
+            bytes[0] = (char) i;
+            table[i].fromUTF8(bytes);
+        }
+        built = 1;
+    }
+
+    return &table[c & 0x7F];
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// tabCharacter
+//
+// Return a tab of the given width, shared by every string.
+//
+//-------------------------------------------------------------------------------------------------
+static CxUTFCharacter *
+tabCharacter(int width)
+{
+    static CxUTFCharacter table[256];
+    static int built = 0;
+
+    if (!built) {
+        for (int i = 0; i < 256; i++) {
+            table[i] = CxUTFCharacter::makeTab(i);
+        }
+        built = 1;
+    }
+
+    if (width < 0) width = 0;
+    if (width > 255) width = 255;
+    return &table[width];
+}
+
 
 //-------------------------------------------------------------------------------------------------
 // CxUTFString:: (default constructor)
@@ -26,9 +209,13 @@
 //-------------------------------------------------------------------------------------------------
 CxUTFString::CxUTFString(void)
 {
-    _chars = 0;
+    _bytes = 0;
+    _byteCount = 0;
+    _byteCapacity = 0;
     _length = 0;
-    _capacity = 0;
+    _tabWidth = 0;
+    _flags = FLAG_ASCII | FLAG_NARROW;
+    _index = 0;
 }
 
 
@@ -38,16 +225,18 @@ CxUTFString::CxUTFString(void)
 //-------------------------------------------------------------------------------------------------
 CxUTFString::CxUTFString(const CxUTFString &s)
 {
-    _chars = 0;
-    _length = 0;
-    _capacity = 0;
-
-    if (s._length > 0) {
-        grow(s._length);
-        for (int i = 0; i < s._length; i++) {
-            _chars[i] = s._chars[i];
-        }
-        _length = s._length;
+    _bytes = 0;
+    _byteCount = 0;
+    _byteCapacity = 0;
+    _length = s._length;
+    _tabWidth = s._tabWidth;
+    _flags = s._flags;
+    _index = 0;
+
+    if (s._byteCount > 0) {
+        grow(s._byteCount, 1);
+        memcpy(_bytes, s._bytes, s._byteCount + 1);
+        _byteCount = s._byteCount;
     }
 }
 
@@ -61,13 +250,14 @@ CxUTFString::operator=(const CxUTFString &s)
 {
     if (&s != this) {
         clear();
-        if (s._length > 0) {
-            grow(s._length);
-            for (int i = 0; i < s._length; i++) {
-                _chars[i] = s._chars[i];
-            }
-            _length = s._length;
+        if (s._byteCount > 0) {
+            grow(s._byteCount, 1);
+            memcpy(_bytes, s._bytes, s._byteCount + 1);
+            _byteCount = s._byteCount;
         }
+        _length = s._length;
+        _tabWidth = s._tabWidth;
+        _flags = s._flags;
     }
     return *this;
 }
@@ -79,266 +269,342 @@ CxUTFString::operator=(const CxUTFString &s)
 //-------------------------------------------------------------------------------------------------
 CxUTFString::~CxUTFString(void)
 {
-    if (_chars) {
-        delete[] _chars;
-        _chars = 0;
-    }
+    delete[] _bytes;
+    delete _index;
+    _bytes = 0;
+    _index = 0;
+    _byteCount = 0;
+    _byteCapacity = 0;
     _length = 0;
-    _capacity = 0;
 }
 
 
 //-------------------------------------------------------------------------------------------------
 // CxUTFString::grow
 //
-// Grow the internal array to hold at least minCapacity characters.
+// Grow the byte block to hold at least minCapacity bytes and a NUL.  A block that is growing
+// because of an edit doubles, so typing into a line does not copy it each time.
 //
 //-------------------------------------------------------------------------------------------------
 void
-CxUTFString::grow(int minCapacity)
+CxUTFString::grow(int minCapacity, int exact)
 {
-    if (minCapacity <= _capacity) {
+    if (minCapacity <= _byteCapacity && _bytes) {
         return;
     }
 
-    // Calculate new capacity (double or use minCapacity, whichever is larger)
-    int newCapacity = _capacity == 0 ? CXUTFSTRING_INITIAL_CAPACITY : _capacity * 2;
-    if (newCapacity < minCapacity) {
-        newCapacity = minCapacity;
+    int newCapacity = minCapacity;
+    if (!exact) {
+        newCapacity = _byteCapacity == 0 ? CXUTFSTRING_INITIAL_CAPACITY : _byteCapacity * 2;
+        if (newCapacity < minCapacity) {
+            newCapacity = minCapacity;
+        }
     }
 
-    // Allocate new array
-    CxUTFCharacter *newChars = new CxUTFCharacter[newCapacity];
+    char *newBytes = new char[newCapacity + 1];
 
-    // Copy existing characters
-    for (int i = 0; i < _length; i++) {
-        newChars[i] = _chars[i];
+    if (_byteCount > 0) {
+        memcpy(newBytes, _bytes, _byteCount);
     }
+    newBytes[_byteCount] = 0;
 
-    // Free old array and update pointers
-    if (_chars) {
-        delete[] _chars;
-    }
-    _chars = newChars;
-    _capacity = newCapacity;
+    delete[] _bytes;
+    _bytes = newBytes;
+    _byteCapacity = newCapacity;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// CxUTFString::updateTabWidth
+// CxUTFString::splice
 //
-// Update the display width of a tab character based on its position.
+// Replace the bytes from byteStart up to byteEnd with len bytes and work out the characters
+// again.  Every edit comes through here.
 //
 //-------------------------------------------------------------------------------------------------
 void
-CxUTFString::updateTabWidth(int charIndex, int tabWidth)
+CxUTFString::splice(int byteStart, int byteEnd, const char *bytes, int len)
 {
-    if (charIndex < 0 || charIndex >= _length) return;
-    if (!_chars[charIndex].isTab()) return;
+    int newCount = _byteCount - (byteEnd - byteStart) + len;
+
+    // adding bytes can only clear flags, so an ASCII string stays ASCII if they are ASCII
+    int flags = _flags;
+    if (len > 0 && CxByteSearch::findNonPrintable(bytes, len)) {
+        flags &= ~FLAG_NARROW;
+        if (CxByteSearch::findNonASCII(bytes, len)) {
+            flags = 0;
+        }
+    }
+
+    grow(newCount, 0);
 
-    // Calculate display column of this character
-    int displayCol = displayColumnOfChar(charIndex);
+    if (byteEnd != byteStart + len) {
+        memmove(_bytes + byteStart + len, _bytes + byteEnd, _byteCount - byteEnd);
+    }
+    if (len > 0) {
+        memcpy(_bytes + byteStart, bytes, len);
+    }
 
-    // Tab width is distance to next tab stop
-    int width = tabWidth - (displayCol % tabWidth);
-    if (width == 0) width = tabWidth;
+    _byteCount = newCount;
+    _bytes[_byteCount] = 0;
 
-    // Update the tab's display width by recreating it
-    _chars[charIndex] = CxUTFCharacter::makeTab(width);
+    // ASCII bytes are characters of their own; anything else may join the characters beside it
+    if (flags == (FLAG_ASCII | FLAG_NARROW) || ((flags & FLAG_ASCII) && byteEnd == byteStart)) {
+        _flags = flags;
+        _length = _byteCount;
+        if (_index) {
+            _index->built = 0;
+        }
+    } else {
+        scan();
+    }
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// CxUTFString::fromBytes
+// CxUTFString::scan
 //
-// Parse UTF-8 bytes into an array of CxUTFCharacter.
+// Work out the flags and the number of characters from the bytes.
 //
 //-------------------------------------------------------------------------------------------------
 void
-CxUTFString::fromBytes(const char *utf8bytes, int len, int tabWidth)
+CxUTFString::scan(void)
 {
-    clear();
+    const unsigned char *p = (const unsigned char *) _bytes;
+    const unsigned char *end = p + _byteCount;
 
-    if (utf8bytes == 0 || len <= 0) {
-        return;
+    _flags = FLAG_ASCII | FLAG_NARROW;
+
+    if (CxByteSearch::findNonPrintable(_bytes, _byteCount)) {
+        _flags = FLAG_ASCII;
+        if (CxByteSearch::findNonASCII(_bytes, _byteCount)) {
+            _flags = 0;
+        }
     }
 
-    // First pass: count characters to pre-allocate
-    const char *p = utf8bytes;
-    const char *end = utf8bytes + len;
-    int count = 0;
+    if (_flags & FLAG_ASCII) {
+        _length = _byteCount;
+    } else {
+        int width;
+        _length = 0;
+        while (p < end) {
+            // every byte of an ASCII run is a character but the last, which can take marks
+            if (*p < 0x80) {
+                const char *q = CxByteSearch::findNonASCII((const char *) p, end - p);
+                int run = q ? (int)((const unsigned char *) q - p) : (int)(end - p);
+                if (run > 1) {
+                    _length += run - 1;
+                    p += run - 1;
+                }
+            }
 
-    while (p < end && *p != 0) {
-        if (*p == '\t') {
-            count++;
-            p++;
-        } else {
-            CxUTFCharacter temp;
-            int consumed = temp.fromUTF8(p);
-            if (consumed == 0) break;
-            count++;
-            p += consumed;
+            p += clusterLength(p, end, &width);
+            _length++;
         }
     }
 
-    if (count == 0) {
-        return;
+    if (_index) {
+        _index->built = 0;
     }
+}
+
 
-    // Allocate space
-    grow(count);
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::adoptTabWidth
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxUTFString::adoptTabWidth(int tabWidth)
+{
+    if (_tabWidth == 0 && tabWidth > 0) {
+        _tabWidth = tabWidth;
+        if (_index) _index->built = 0;
+    }
+}
 
-    // Second pass: parse characters
-    p = utf8bytes;
-    int displayCol = 0;
 
-    while (p < end && *p != 0 && _length < count) {
-        if (*p == '\t') {
-            // Calculate tab width based on current display column
-            int width = tabWidth - (displayCol % tabWidth);
-            if (width == 0) width = tabWidth;
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::slot
+//
+//-------------------------------------------------------------------------------------------------
+CxUTFStringIndex *
+CxUTFString::slot(void) const
+{
+    CxUTFString *self = const_cast<CxUTFString *>(this);
 
-            _chars[_length] = CxUTFCharacter::makeTab(width);
-            displayCol += width;
-            _length++;
-            p++;
-        } else {
-            int consumed = _chars[_length].fromUTF8(p);
-            if (consumed == 0) break;
-            displayCol += _chars[_length].displayWidth();
-            _length++;
-            p += consumed;
-        }
+    if (self->_index == 0) {
+        self->_index = new CxUTFStringIndex();
     }
+    return self->_index;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// CxUTFString::fromCxString
+// CxUTFString::locate
 //
-// Parse a CxString (convenience wrapper for fromBytes).
+// Find the byte offset and column where character charIndex starts, 0 to _length.  A long
+// string looks them up in its index; a short one is read from the start.
 //
 //-------------------------------------------------------------------------------------------------
 void
-CxUTFString::fromCxString(const CxString &s, int tabWidth)
+CxUTFString::locate(int charIndex, int *byteOffset, int *column) const
 {
-    fromBytes(s.data(), s.length(), tabWidth);
+    if (_flags & FLAG_NARROW) {
+        *byteOffset = charIndex;
+        if (column) *column = charIndex;
+        return;
+    }
+
+    if ((_flags & FLAG_ASCII) && column == 0) {
+        *byteOffset = charIndex;
+        return;
+    }
+
+    if (_byteCount >= CXUTFSTRING_INDEX_BYTES) {
+        CxUTFStringIndex *ix = buildIndex();
+        *byteOffset = ix->offset[charIndex];
+        if (column) *column = ix->column[charIndex];
+        return;
+    }
+
+    const unsigned char *start = (const unsigned char *) _bytes;
+    const unsigned char *p = start;
+    const unsigned char *end = start + _byteCount;
+    int col = 0;
+
+    for (int i = 0; i < charIndex; ) {
+        // the last byte of the run is left to clusterLength, for the marks that may follow it
+        int run = printableRun(p, end) - 1;
+        if (run > charIndex - i) run = charIndex - i;
+        if (run > 0) {
+            p += run;
+            col += run;
+            i += run;
+            continue;
+        }
+
+        int width;
+        p += clusterLength(p, end, &width);
+        col += width < 0 ? tabStopWidth(col, _tabWidth) : width;
+        i++;
+    }
+
+    *byteOffset = (int)(p - start);
+    if (column) *column = col;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// CxUTFString::fromUTF8Bytes
+// CxUTFString::buildIndex
+//
+//-------------------------------------------------------------------------------------------------
+CxUTFStringIndex *
+CxUTFString::buildIndex(void) const
+{
+    CxUTFStringIndex *ix = slot();
+
+    if (ix->built) {
+        return ix;
+    }
+
+    if (ix->capacity < _length + 1) {
+        delete[] ix->offset;
+        delete[] ix->column;
+        ix->capacity = _length + 1;
+        ix->offset = new int[ix->capacity];
+        ix->column = new int[ix->capacity];
+    }
+
+    const unsigned char *start = (const unsigned char *) _bytes;
+    const unsigned char *p = start;
+    const unsigned char *end = start + _byteCount;
+    int col = 0;
+
+    for (int i = 0; i < _length; i++) {
+        int width;
+        int len = clusterLength(p, end, &width);
+        if (width < 0) width = tabStopWidth(col, _tabWidth);
+
+        ix->offset[i] = (int)(p - start);
+        ix->column[i] = col;
+        p += len;
+        col += width;
+    }
+
+    ix->offset[_length] = _byteCount;
+    ix->column[_length] = col;
+    ix->built = 1;
+
+    return ix;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::fromBytes
 //
-// Parse raw UTF-8 bytes into an array of CxUTFCharacter.
-// Tabs are stored with display width 1 (no tab-stop expansion).
-// Newlines and carriage returns are NOT consumed - they are line delimiters
-// handled by the caller.
+// Take UTF-8 bytes, stopping at a NUL as a C string would.
 //
 //-------------------------------------------------------------------------------------------------
 void
-CxUTFString::fromUTF8Bytes(const char *utf8bytes, int len)
+CxUTFString::fromBytes(const char *utf8bytes, int len, int tabWidth)
 {
     clear();
+    _tabWidth = tabWidth;
 
     if (utf8bytes == 0 || len <= 0) {
         return;
     }
 
-    // First pass: count characters to pre-allocate
-    const char *p = utf8bytes;
-    const char *end = utf8bytes + len;
-    int count = 0;
-
-    while (p < end && *p != 0) {
-        if (*p == '\t') {
-            count++;
-            p++;
-        } else if (*p == '\n' || *p == '\r') {
-            count++;
-            p++;
-        } else {
-            CxUTFCharacter temp;
-            int consumed = temp.fromUTF8(p);
-            if (consumed == 0) break;
-            count++;
-            p += consumed;
-        }
+    const char *nul = (const char *) memchr(utf8bytes, 0, len);
+    if (nul) {
+        len = (int)(nul - utf8bytes);
     }
 
-    if (count == 0) {
-        return;
-    }
+    grow(len, 1);
+    splice(0, 0, utf8bytes, len);
+}
 
-    // Allocate space
-    grow(count);
 
-    // Second pass: parse characters
-    p = utf8bytes;
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::fromCxString
+//
+// Parse a CxString (convenience wrapper for fromBytes).
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxUTFString::fromCxString(const CxString &s, int tabWidth)
+{
+    fromBytes(s.data(), s.length(), tabWidth);
+}
 
-    while (p < end && *p != 0 && _length < count) {
-        if (*p == '\t') {
-            _chars[_length] = CxUTFCharacter::makeTab(1);
-            _length++;
-            p++;
-        } else if (*p == '\n' || *p == '\r') {
-            _chars[_length] = CxUTFCharacter::fromASCII(*p);
-            _length++;
-            p++;
-        } else {
-            int consumed = _chars[_length].fromUTF8(p);
-            if (consumed == 0) break;
-            _length++;
-            p += consumed;
-        }
-    }
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::fromUTF8Bytes
+//
+// Take raw UTF-8 bytes with tabs one column wide (no tab-stop expansion).
+// Newlines and carriage returns are kept as characters of their own.
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxUTFString::fromUTF8Bytes(const char *utf8bytes, int len)
+{
+    fromBytes(utf8bytes, len, 1);
 }
 
 
 //-------------------------------------------------------------------------------------------------
 // CxUTFString::toBytes
 //
-// Convert back to raw UTF-8 bytes.
+// Return the UTF-8 bytes.
 //
 //-------------------------------------------------------------------------------------------------
 CxString
 CxUTFString::toBytes(void) const
 {
-    if (_length == 0) {
+    if (_byteCount == 0) {
         return CxString("");
     }
 
-    // Calculate total byte length
-    int totalBytes = 0;
-    for (int i = 0; i < _length; i++) {
-        if (_chars[i].isTab()) {
-            totalBytes += 1;  // Just the tab character
-        } else {
-            totalBytes += _chars[i].byteCount();
-        }
-    }
-
-    // Allocate buffer
-    char *buffer = new char[totalBytes + 1];
-    char *p = buffer;
-
-    // Copy bytes
-    for (int i = 0; i < _length; i++) {
-        if (_chars[i].isTab()) {
-            *p++ = '\t';
-        } else {
-            int bc = _chars[i].byteCount();
-            const unsigned char *bytes = _chars[i].bytes();
-            for (int j = 0; j < bc; j++) {
-                *p++ = bytes[j];
-            }
-        }
-    }
-    *p = 0;
-
-    CxString result(buffer);
-    delete[] buffer;
-
-    return result;
+    return CxString(_bytes, _byteCount);
 }
 
 
@@ -351,49 +617,93 @@ CxUTFString::toBytes(void) const
 CxString
 CxUTFString::toBytesExpanded(void) const
 {
-    if (_length == 0) {
+    if (_byteCount == 0) {
         return CxString("");
     }
 
-    // Calculate total byte length with tabs expanded
-    int totalBytes = 0;
-    for (int i = 0; i < _length; i++) {
-        if (_chars[i].isTab()) {
-            totalBytes += _chars[i].displayWidth();  // Tab width in spaces
-        } else {
-            totalBytes += _chars[i].byteCount();
+    if (memchr(_bytes, '\t', _byteCount) == 0) {
+        return CxString(_bytes, _byteCount);
+    }
+
+    const unsigned char *start = (const unsigned char *) _bytes;
+    const unsigned char *end = start + _byteCount;
+
+    // every tab becomes its width in spaces
+    int totalBytes = _byteCount;
+    int col = 0;
+    for (const unsigned char *q = start; q < end; ) {
+        int run = printableRun(q, end);
+        q += run;
+        col += run;
+        if (q == end) break;
+
+        int width;
+        q += clusterLength(q, end, &width);
+        if (width < 0) {
+            width = tabStopWidth(col, _tabWidth);
+            totalBytes += width - 1;
         }
+        col += width;
     }
 
-    // Allocate buffer
     char *buffer = new char[totalBytes + 1];
     char *p = buffer;
 
-    // Copy bytes with tabs expanded to spaces
-    for (int i = 0; i < _length; i++) {
-        if (_chars[i].isTab()) {
-            // Expand tab to spaces based on its display width
-            int tabWidth = _chars[i].displayWidth();
-            for (int j = 0; j < tabWidth; j++) {
+    col = 0;
+    for (const unsigned char *q = start; q < end; ) {
+        int run = printableRun(q, end);
+        memcpy(p, q, run);
+        p += run;
+        q += run;
+        col += run;
+        if (q == end) break;
+
+        int width;
+        int len = clusterLength(q, end, &width);
+
+        if (width < 0) {
+            width = tabStopWidth(col, _tabWidth);
+            for (int j = 0; j < width; j++) {
                 *p++ = ' ';
             }
         } else {
-            int bc = _chars[i].byteCount();
-            const unsigned char *bytes = _chars[i].bytes();
-            for (int j = 0; j < bc; j++) {
-                *p++ = bytes[j];
-            }
+            memcpy(p, q, len);
+            p += len;
         }
+        q += len;
+        col += width;
     }
     *p = 0;
 
-    CxString result(buffer);
+    CxString result(buffer, (int)(p - buffer));
     delete[] buffer;
 
     return result;
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::data
+//
+//-------------------------------------------------------------------------------------------------
+const char *
+CxUTFString::data(void) const
+{
+    return _bytes ? _bytes : "";
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::byteCount
+//
+//-------------------------------------------------------------------------------------------------
+int
+CxUTFString::byteCount(void) const
+{
+    return _byteCount;
+}
+
+
 //-------------------------------------------------------------------------------------------------
 // CxUTFString::charCount
 //
@@ -414,25 +724,57 @@ CxUTFString::charCount(void) const
 int
 CxUTFString::displayWidth(void) const
 {
-    int width = 0;
-    for (int i = 0; i < _length; i++) {
-        width += _chars[i].displayWidth();
-    }
-    return width;
+    int byteOffset, column;
+    locate(_length, &byteOffset, &column);
+    return column;
 }
 
 
 //-------------------------------------------------------------------------------------------------
 // CxUTFString::at
 //
+// ASCII characters and tabs come from tables shared by every string; anything else is built in
+// the string's index.
+//
 //-------------------------------------------------------------------------------------------------
-CxUTFCharacter*
+const CxUTFCharacter*
 CxUTFString::at(int charIndex)
 {
     if (charIndex < 0 || charIndex >= _length) {
         return 0;
     }
-    return &_chars[charIndex];
+
+    if ((_flags & FLAG_ASCII) && _bytes[charIndex] != '\t') {
+        return asciiCharacter((unsigned char) _bytes[charIndex]);
+    }
+
+    int byteOffset, column;
+    locate(charIndex, &byteOffset, &column);
+
+    const unsigned char *p = (const unsigned char *) _bytes + byteOffset;
+    const unsigned char *end = (const unsigned char *) _bytes + _byteCount;
+
+    int width;
+    int len = clusterLength(p, end, &width);
+
+    if (width < 0) {
+        return tabCharacter(tabStopWidth(column, _tabWidth));
+    }
+    if (len == 1 && *p < 0x80) {
+        return asciiCharacter(*p);
+    }
+
+    CxUTFCharacter &ch = slot()->character;
+
+    memcpy(ch._bytes, p, len);
+    if (len < CXUTF_MAX_BYTES) {
+        memset(ch._bytes + len, 0, CXUTF_MAX_BYTES - len);
+    }
+    ch._byteCount = (unsigned char) len;
+    ch._displayWidth = (unsigned char) width;
+    ch._flags = 0;
+
+    return &ch;
 }
 
 
@@ -443,10 +785,7 @@ CxUTFString::at(int charIndex)
 const CxUTFCharacter*
 CxUTFString::at(int charIndex) const
 {
-    if (charIndex < 0 || charIndex >= _length) {
-        return 0;
-    }
-    return &_chars[charIndex];
+    return const_cast<CxUTFString *>(this)->at(charIndex);
 }
 
 
@@ -460,7 +799,18 @@ CxUTFString::displayWidthAt(int charIndex) const
     if (charIndex < 0 || charIndex >= _length) {
         return 0;
     }
-    return _chars[charIndex].displayWidth();
+    if (_flags & FLAG_NARROW) {
+        return 1;
+    }
+
+    int byteOffset, column;
+    locate(charIndex, &byteOffset, &column);
+
+    const unsigned char *p = (const unsigned char *) _bytes + byteOffset;
+    int width;
+    clusterLength(p, (const unsigned char *) _bytes + _byteCount, &width);
+
+    return width < 0 ? tabStopWidth(column, _tabWidth) : width;
 }
 
 
@@ -476,18 +826,17 @@ CxUTFString::displayColumnOfChar(int charIndex) const
     if (charIndex < 0) return 0;
     if (charIndex > _length) charIndex = _length;
 
-    int col = 0;
-    for (int i = 0; i < charIndex; i++) {
-        col += _chars[i].displayWidth();
-    }
-    return col;
+    int byteOffset, column;
+    locate(charIndex, &byteOffset, &column);
+    return column;
 }
 
 
 //-------------------------------------------------------------------------------------------------
 // CxUTFString::charIndexAtDisplayColumn
 //
-// Return the character index at or before the given display column.
+// Return the character index at or before the given display column: the first character
+// that reaches past displayCol.
 //
 //-------------------------------------------------------------------------------------------------
 int
@@ -496,18 +845,101 @@ CxUTFString::charIndexAtDisplayColumn(int displayCol) const
     if (_length == 0) return 0;
     if (displayCol <= 0) return 0;
 
-    int col = 0;
-    for (int i = 0; i < _length; i++) {
-        int width = _chars[i].displayWidth();
-        if (col + width > displayCol) {
-            // Display column falls within this character
-            return i;
+    if (_flags & FLAG_NARROW) {
+        return displayCol < _length ? displayCol : _length;
+    }
+
+    if (_byteCount < CXUTFSTRING_INDEX_BYTES) {
+        const unsigned char *p = (const unsigned char *) _bytes;
+        const unsigned char *end = p + _byteCount;
+        int col = 0;
+
+        for (int i = 0; i < _length; i++) {
+            int width;
+            p += clusterLength(p, end, &width);
+            col += width < 0 ? tabStopWidth(col, _tabWidth) : width;
+            if (col > displayCol) return i;
         }
-        col += width;
+        return _length;
     }
 
-    // Beyond end, return length (append position)
-    return _length;
+    CxUTFStringIndex *ix = buildIndex();
+
+    // first i whose end column, column[i + 1], is past displayCol
+    int lo = 0;
+    int hi = _length;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (ix->column[mid + 1] > displayCol) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    // Beyond end, returns length (append position)
+    return lo;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::byteOffsetOfChar
+//
+//-------------------------------------------------------------------------------------------------
+int
+CxUTFString::byteOffsetOfChar(int charIndex) const
+{
+    if (charIndex <= 0) return 0;
+    if (charIndex >= _length) return _byteCount;
+
+    int byteOffset;
+    locate(charIndex, &byteOffset, 0);
+    return byteOffset;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::charIndexAtByteOffset
+//
+//-------------------------------------------------------------------------------------------------
+int
+CxUTFString::charIndexAtByteOffset(int byteOffset) const
+{
+    if (byteOffset <= 0) return 0;
+    if (byteOffset >= _byteCount) return _length;
+
+    if (_flags & FLAG_ASCII) {
+        return byteOffset;
+    }
+
+    if (_byteCount < CXUTFSTRING_INDEX_BYTES) {
+        const unsigned char *start = (const unsigned char *) _bytes;
+        const unsigned char *p = start;
+        const unsigned char *end = start + _byteCount;
+        int i = 0;
+
+        while (p - start < byteOffset) {
+            int width;
+            p += clusterLength(p, end, &width);
+            i++;
+        }
+        return i;
+    }
+
+    CxUTFStringIndex *ix = buildIndex();
+
+    // first i starting at or after byteOffset
+    int lo = 0;
+    int hi = _length;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (ix->offset[mid] >= byteOffset) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
 }
 
 
@@ -521,15 +953,17 @@ CxUTFString::insert(int charIndex, const CxUTFCharacter &ch)
     if (charIndex < 0) charIndex = 0;
     if (charIndex > _length) charIndex = _length;
 
-    grow(_length + 1);
+    int at = byteOffsetOfChar(charIndex);
 
-    // Shift characters to make room
-    for (int i = _length; i > charIndex; i--) {
-        _chars[i] = _chars[i - 1];
+    if (ch.isTab()) {
+        adoptTabWidth(ch.displayWidth());
+        splice(at, at, "\t", 1);
+    } else {
+        // a character read from a sequence cut short can hold the NUL that ended it
+        const char *bytes = (const char *) ch.bytes();
+        const char *nul = (const char *) memchr(bytes, 0, ch.byteCount());
+        splice(at, at, bytes, nul ? (int)(nul - bytes) : ch.byteCount());
     }
-
-    _chars[charIndex] = ch;
-    _length++;
 }
 
 
@@ -540,23 +974,20 @@ CxUTFString::insert(int charIndex, const CxUTFCharacter &ch)
 void
 CxUTFString::insert(int charIndex, const CxUTFString &s)
 {
-    if (s._length == 0) return;
+    if (s._byteCount == 0) return;
     if (charIndex < 0) charIndex = 0;
     if (charIndex > _length) charIndex = _length;
 
-    grow(_length + s._length);
+    adoptTabWidth(s._tabWidth);
 
-    // Shift characters to make room
-    for (int i = _length - 1; i >= charIndex; i--) {
-        _chars[i + s._length] = _chars[i];
-    }
+    int at = byteOffsetOfChar(charIndex);
 
-    // Copy inserted characters
-    for (int i = 0; i < s._length; i++) {
-        _chars[charIndex + i] = s._chars[i];
+    if (&s == this) {
+        CxUTFString copy(s);
+        splice(at, at, copy._bytes, copy._byteCount);
+    } else {
+        splice(at, at, s._bytes, s._byteCount);
     }
-
-    _length += s._length;
 }
 
 
@@ -576,12 +1007,10 @@ CxUTFString::remove(int charIndex, int count)
         count = _length - charIndex;
     }
 
-    // Shift characters down
-    for (int i = charIndex; i < _length - count; i++) {
-        _chars[i] = _chars[i + count];
-    }
+    int start = byteOffsetOfChar(charIndex);
+    int end = byteOffsetOfChar(charIndex + count);
 
-    _length -= count;
+    splice(start, end, 0, 0);
 }
 
 
@@ -592,9 +1021,7 @@ CxUTFString::remove(int charIndex, int count)
 void
 CxUTFString::append(const CxUTFCharacter &ch)
 {
-    grow(_length + 1);
-    _chars[_length] = ch;
-    _length++;
+    insert(_length, ch);
 }
 
 
@@ -605,15 +1032,7 @@ CxUTFString::append(const CxUTFCharacter &ch)
 void
 CxUTFString::append(const CxUTFString &s)
 {
-    if (s._length == 0) return;
-
-    grow(_length + s._length);
-
-    for (int i = 0; i < s._length; i++) {
-        _chars[_length + i] = s._chars[i];
-    }
-
-    _length += s._length;
+    insert(_length, s);
 }
 
 
@@ -625,6 +1044,7 @@ CxUTFString
 CxUTFString::subString(int charStart, int charCount) const
 {
     CxUTFString result;
+    result._tabWidth = _tabWidth;
 
     if (charStart < 0) charStart = 0;
     if (charStart >= _length) return result;
@@ -634,17 +1054,33 @@ CxUTFString::subString(int charStart, int charCount) const
         charCount = _length - charStart;
     }
 
-    result.grow(charCount);
+    int start = byteOffsetOfChar(charStart);
+    int end = byteOffsetOfChar(charStart + charCount);
 
-    for (int i = 0; i < charCount; i++) {
-        result._chars[i] = _chars[charStart + i];
-    }
-    result._length = charCount;
+    result.grow(end - start, 1);
+    result.splice(0, 0, _bytes + start, end - start);
 
     return result;
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::swap
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxUTFString::swap(CxUTFString &s)
+{
+    char *bytes = _bytes;               _bytes = s._bytes;                s._bytes = bytes;
+    int byteCount = _byteCount;         _byteCount = s._byteCount;        s._byteCount = byteCount;
+    int byteCapacity = _byteCapacity;   _byteCapacity = s._byteCapacity;  s._byteCapacity = byteCapacity;
+    int length = _length;               _length = s._length;              s._length = length;
+    int tabWidth = _tabWidth;           _tabWidth = s._tabWidth;          s._tabWidth = tabWidth;
+    int flags = _flags;                 _flags = s._flags;                s._flags = flags;
+    CxUTFStringIndex *index = _index;   _index = s._index;                s._index = index;
+}
+
+
 //-------------------------------------------------------------------------------------------------
 // CxUTFString::clear
 //
@@ -652,7 +1088,15 @@ CxUTFString::subString(int charStart, int charCount) const
 void
 CxUTFString::clear(void)
 {
+    _byteCount = 0;
     _length = 0;
+    _flags = FLAG_ASCII | FLAG_NARROW;
+    if (_bytes) {
+        _bytes[0] = 0;
+    }
+    if (_index) {
+        _index->built = 0;
+    }
     // Note: we keep the allocated capacity for reuse
 }
 
@@ -675,36 +1119,37 @@ CxUTFString::isEmpty(void) const
 int
 CxUTFString::isASCII(void) const
 {
-    for (int i = 0; i < _length; i++) {
-        if (!_chars[i].isASCII() && !_chars[i].isTab()) {
-            return 0;
-        }
+    return (_flags & FLAG_ASCII) != 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFString::isValidUTF8
+//
+//-------------------------------------------------------------------------------------------------
+int
+CxUTFString::isValidUTF8(void) const
+{
+    if (_flags & FLAG_ASCII) {
+        return 1;
     }
-    return 1;
+    return cxUTF8ValidLength(_bytes, _byteCount) == _byteCount;
 }
 
 
 //-------------------------------------------------------------------------------------------------
 // CxUTFString::recalculateTabWidths
 //
-// Recalculate tab display widths based on their positions.
+// Tab widths follow from their positions, so only the tab stop spacing is kept.
 //
 //-------------------------------------------------------------------------------------------------
 void
 CxUTFString::recalculateTabWidths(int tabWidth)
 {
-    int displayCol = 0;
-
-    for (int i = 0; i < _length; i++) {
-        if (_chars[i].isTab()) {
-            // Calculate new tab width
-            int width = tabWidth - (displayCol % tabWidth);
-            if (width == 0) width = tabWidth;
-
-            _chars[i] = CxUTFCharacter::makeTab(width);
-            displayCol += width;
-        } else {
-            displayCol += _chars[i].displayWidth();
+    if (tabWidth != _tabWidth) {
+        _tabWidth = tabWidth;
+        if (_index) {
+            _index->built = 0;
         }
     }
 }
@@ -717,13 +1162,9 @@ CxUTFString::recalculateTabWidths(int tabWidth)
 int
 CxUTFString::operator==(const CxUTFString &s) const
 {
-    if (_length != s._length) return 0;
-
-    for (int i = 0; i < _length; i++) {
-        if (_chars[i] != s._chars[i]) return 0;
-    }
-
-    return 1;
+    if (_byteCount != s._byteCount) return 0;
+    if (_byteCount == 0) return 1;
+    return memcmp(_bytes, s._bytes, _byteCount) == 0;
 }
 
 
@@ -17,9 +17,25 @@
 #include <cx/base/utfcharacter.h>
 #include <cx/base/string.h>
 
+class CxUTFStringIndex;
+
+
 //-------------------------------------------------------------------------------------------------
 // CxUTFString
 //
+// A line of UTF-8 text.  The bytes are kept as they are, one block per string with tabs as
+// '\t', and characters are the grapheme clusters of those bytes: a base character and the
+// combining marks after it.  A string of ASCII text costs its own bytes and no more.
+//
+// Where each character starts, in bytes and in screen columns, is worked out when asked for.
+// If every byte is printable ASCII both are the character index itself.  Otherwise a short
+// string is read from the start, and a long one builds an index of both the first time it is
+// asked, kept until the string changes.
+//
+// Tabs are as wide as it takes to reach the next tab stop, tab width columns apart.  The tab
+// width is given by fromBytes() or recalculateTabWidths(); a string without one takes the
+// width of the first tab put into it.
+//
 //-------------------------------------------------------------------------------------------------
 
 class CxUTFString
@@ -39,14 +55,14 @@ class CxUTFString
     // destructor
 
     void fromBytes(const char *utf8bytes, int len, int tabWidth);
-    // Parse UTF-8 bytes into an array of CxUTFCharacter.
+    // Take UTF-8 bytes, up to len or the first NUL.
     // Tabs are expanded based on their position and tabWidth.
 
     void fromCxString(const CxString &s, int tabWidth);
     // Parse a CxString (convenience wrapper for fromBytes).
 
     void fromUTF8Bytes(const char *utf8bytes, int len);
-    // Parse raw UTF-8 bytes. Tabs stored as width-1 (no tab expansion).
+    // Take raw UTF-8 bytes. Tabs are width-1 (no tab expansion).
 
     CxString toBytes(void) const;
     // Convert back to raw UTF-8 bytes.
@@ -56,17 +72,23 @@ class CxUTFString
     // Convert to UTF-8 bytes with tabs expanded to spaces.
     // For display purposes only - tabs are replaced with appropriate spaces.
 
+    const char *data(void) const;
+    // Return the UTF-8 bytes, NUL terminated.
+
+    int byteCount(void) const;
+    // Return the number of bytes.
+
     int charCount(void) const;
     // Return the number of characters (grapheme clusters).
 
     int displayWidth(void) const;
     // Return the total display width in screen columns.
 
-    CxUTFCharacter* at(int charIndex);
-    // Return pointer to character at index, or NULL if out of bounds.
-
+    const CxUTFCharacter* at(int charIndex);
     const CxUTFCharacter* at(int charIndex) const;
-    // Return const pointer to character at index, or NULL if out of bounds.
+    // Return pointer to character at index, or NULL if out of bounds.
+    // The character is a copy, good until the next call to at() or a change to the string.
+    // It may be shared with other strings, so it is read only.
 
     int displayWidthAt(int charIndex) const;
     // Return the display width of the character at index.
@@ -78,6 +100,12 @@ class CxUTFString
     // Return the character index at or before the given display column.
     // If displayCol is in the middle of a wide character, returns that character's index.
 
+    int byteOffsetOfChar(int charIndex) const;
+    // Return the byte offset where character at index starts.
+
+    int charIndexAtByteOffset(int byteOffset) const;
+    // Return the index of the first character starting at or after byteOffset.
+
     void insert(int charIndex, const CxUTFCharacter &ch);
     // Insert a single character at the given index.
     // If charIndex == charCount(), appends to end.
@@ -97,6 +125,9 @@ class CxUTFString
     CxUTFString subString(int charStart, int charCount) const;
     // Return a substring from charStart with charCount characters.
 
+    void swap(CxUTFString &s);
+    // Exchange contents with s without copying.
+
     void clear(void);
     // Remove all characters.
 
@@ -106,9 +137,12 @@ class CxUTFString
     int isASCII(void) const;
     // Return true if all characters are ASCII (optimization hint).
 
+    int isValidUTF8(void) const;
+    // Return true if the bytes are well-formed UTF-8.  Other bytes are kept, each read as a
+    // character of its own.
+
     void recalculateTabWidths(int tabWidth);
-    // Recalculate tab display widths based on their positions.
-    // Call this after insert/remove operations that may affect tab positions.
+    // Set the tab width tab stops are worked out from.
 
     int operator==(const CxUTFString &s) const;
     // Equality comparison.
@@ -118,15 +152,39 @@ class CxUTFString
 
   private:
 
-    CxUTFCharacter *_chars;
-    int _length;
-    int _capacity;
+    enum Flags {
+        FLAG_ASCII  = 0x01,     // every byte is ASCII, so each is one character
+        FLAG_NARROW = 0x02      // and each is printable, so one column wide
+    };
+
+    char *_bytes;               // the UTF-8 text, NUL terminated, or NULL
+    int _byteCount;
+    int _byteCapacity;
+    int _length;                // characters
+    int _tabWidth;              // tab stop spacing, 0 until known
+    int _flags;
+    CxUTFStringIndex *_index;   // built when needed, or NULL
+
+    void grow(int minCapacity, int exact);
+    // Grow the byte block to hold at least minCapacity bytes, exactly that many if exact.
+
+    void splice(int byteStart, int byteEnd, const char *bytes, int len);
+    // Replace the bytes from byteStart up to byteEnd with len bytes.
+
+    void scan(void);
+    // Work out the flags and character count after the bytes change.
+
+    void adoptTabWidth(int tabWidth);
+    // Take tabWidth if the string has none yet.
+
+    void locate(int charIndex, int *byteOffset, int *column) const;
+    // Find where character charIndex starts, its column only if column is not NULL.
 
-    void grow(int minCapacity);
-    // Grow the internal array to hold at least minCapacity characters.
+    CxUTFStringIndex *buildIndex(void) const;
+    // Build the byte offset and column of every character if they are not built.
 
-    void updateTabWidth(int charIndex, int tabWidth);
-    // Update the display width of a tab at the given index.
+    CxUTFStringIndex *slot(void) const;
+    // Return the index, made without building it if there is none.
 };
 
 
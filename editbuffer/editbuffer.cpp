@@ -18,9 +18,13 @@
 #include <cx/base/file.h>
 #include <cx/editbuffer/editbufferpos.h>
 #include <cx/editbuffer/editbuffer.h>
+#include <cx/editbuffer/textwriter.h>
 
 #define DEBUG_EDIT_BUFFER 1
 
+// files at least this big are mapped instead of read into memory
+#define EDITBUFFER_MAP_THRESHOLD (16 * 1024 * 1024)
+
 
 
 //-------------------------------------------------------------------------------------------------
@@ -93,8 +97,10 @@ CxEditBuffer::CxEditBuffer( const CxEditBuffer& c )
         visualFirstScreenCol  = c.visualFirstScreenCol;
 
         lastRequestCol = c.lastRequestCol;
+        tabSpaces      = c.tabSpaces;
 
         _bufferLineList = c._bufferLineList;
+        _journal        = c._journal;
 
         _killAccumulator = c._killAccumulator;
         _lastWasKill = c._lastWasKill;
@@ -124,8 +130,10 @@ CxEditBuffer::operator=( const CxEditBuffer& c)
         visualFirstScreenCol  = c.visualFirstScreenCol;
 
         lastRequestCol = c.lastRequestCol;
+        tabSpaces      = c.tabSpaces;
 
         _bufferLineList = c._bufferLineList;
+        _journal        = c._journal;
 
         _killAccumulator = c._killAccumulator;
         _lastWasKill = c._lastWasKill;
@@ -155,6 +163,7 @@ CxEditBuffer::reset(void)
     touched  = false;
     inMemory = false;
     _bufferLineList = CxStringList();
+    _journal.clear();
 }
 
 
@@ -272,7 +281,7 @@ CxEditBuffer::isCursorFirstRow(void)
 int
 CxEditBuffer::isCursorLastRow(void)
 {
-    unsigned long numberOfBufferLines = _bufferLineList.entries();
+    unsigned long numberOfBufferLines = _bufferLineList.entriesThrough( cursor.row + 1 );
 
     // no lines in the buffer yet, so yes we are on the last line
     if (numberOfBufferLines == 0) {
@@ -378,9 +387,6 @@ CxEditBuffer::isCursorFirstValidPosition(void)
 int
 CxEditBuffer::isCursorRowEmpty(void)
 {
-    // get the number of buffer lines
-    unsigned long numberOfBufferLines = _bufferLineList.entries();
-
     // at this point we know we have a valid line with text (ie not append row0
     // so just check for invalid  column or append column situation
     CxString *line = _bufferLineList.at( cursor.row );
@@ -450,8 +456,8 @@ CxEditBuffer::compareCursorToMark(void)
 CxEditBuffer::POSITION
 CxEditBuffer::evaluatePosition(unsigned long row_, unsigned long col_ )
 {
-    // get the number of buffer lines
-    unsigned long numberOfBufferLines = _bufferLineList.entries();
+    // get the number of buffer lines, or at least enough of them to see row_
+    unsigned long numberOfBufferLines = _bufferLineList.entriesThrough( row_ );
 
     // if there are no lines and the cursor is at 0,0 its a new buffer
     // and this is an append row situation
@@ -481,7 +487,7 @@ CxEditBuffer::evaluatePosition(unsigned long row_, unsigned long col_ )
 
     // check to see if the location is a tab extension character
     // BUG FIX: was using cursor.col instead of col_ parameter
-    if (line->data()[col_] == '\377') {
+    if (col_ < currentLineLength && line->c_str()[col_] == '\377') {
         return( CxEditBuffer::POS_INVALID_MID_TAB);
     }
 
@@ -535,7 +541,7 @@ CxEditBuffer::cursorRightRequest(void)
 
     exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
-    unsigned long numberOfBufferLines = _bufferLineList.entries();
+    unsigned long numberOfBufferLines = _bufferLineList.entriesThrough( cursor.row + 1 );
 
     if (numberOfBufferLines==0) {
         return( CxEditHint( CxEditHint::UPDATE_HINT_NONE, CxEditHint::CURSOR_HINT_NONE ));
@@ -852,7 +858,7 @@ CxEditBuffer::cursorDownRequest(void)
 
     exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
-    unsigned long numberOfBufferLines = _bufferLineList.entries();
+    unsigned long numberOfBufferLines = _bufferLineList.entriesThrough( cursor.row + 1 );
 
     // check if we are one line beyond the number of lines
     if (cursor.row == numberOfBufferLines) {
@@ -971,6 +977,9 @@ CxEditBuffer::loadText(CxString filepath_, int preload)
 {
     filePath = filepath_;
 
+    // the history is of some other text
+    _journal.clear();
+
     // If not preloading, just store the path for lazy loading later.
     // This avoids disk I/O for every file in a project at startup.
     if (!preload) {
@@ -995,26 +1004,32 @@ CxEditBuffer::loadText(CxString filepath_, int preload)
         struct stat fileStat = inFile.getStat();
         unsigned long fileSize = (unsigned long)fileStat.st_size;
 
-        // Allocate buffer for entire file (+1 for safety)
-        char* rawBuffer = new char[fileSize + 1];
-
-        // Read entire file into buffer
-        size_t bytesRead = inFile.fread(rawBuffer, 1, fileSize);
-        rawBuffer[bytesRead] = '\0';
-
-        // Sanitize buffer: replace high-ASCII bytes (128-254) with spaces.
-        // These are typically encoding artifacts (e.g., Mac Roman curly quotes)
-        // that can cause display issues. We leave 255 (0xFF) alone since that's
-        // our internal tab extension marker.
-        for (size_t i = 0; i < bytesRead; i++) {
-            unsigned char c = (unsigned char)rawBuffer[i];
-            if (c >= 128 && c <= 254) {
-                rawBuffer[i] = ' ';
-            }
+        // Large files are mapped, not read.  Lines are found as they are
+        // asked for, so the first screen shows without reading the rest of
+        // the file.  High-ASCII bytes are cleaned up as each line is made,
+        // in both modes.
+        CxTextSource *source = NULL;
+
+        if (fileSize >= EDITBUFFER_MAP_THRESHOLD) {
+            source = CxTextSource::map( filePath.c_str() );
         }
 
-        // Use lazy loading - _bufferLineList takes ownership of rawBuffer
-        _bufferLineList.initLazy(rawBuffer, bytesRead, tabSpaces);
+        if (source != NULL) {
+
+            _bufferLineList.initLazy(source, tabSpaces);
+
+        } else {
+
+            // Allocate buffer for entire file (+1 for safety)
+            char* rawBuffer = new char[fileSize + 1];
+
+            // Read entire file into buffer
+            size_t bytesRead = inFile.fread(rawBuffer, 1, fileSize);
+            rawBuffer[bytesRead] = '\0';
+
+            // Use lazy loading - _bufferLineList takes ownership of rawBuffer
+            _bufferLineList.initLazy(rawBuffer, bytesRead, tabSpaces);
+        }
 
         inMemory = TRUE;
     }
@@ -1042,6 +1057,9 @@ CxEditBuffer::loadText(CxString filepath_, int preload)
 void
 CxEditBuffer::loadTextFromString( CxString text )
 {
+    // the history is of some other text
+    _journal.clear();
+
     // Sanitize input: replace high-ASCII bytes (128-254) with spaces.
     // Leave 255 (0xFF) alone since that's our internal tab extension marker.
     char *sanitizePtr = text.data();
@@ -1131,22 +1149,58 @@ CxEditBuffer::loadTextFromString( CxString text )
 void
 CxEditBuffer::saveText(CxString filepath_)
 {
-    CxFile outFile;
+    CxTextWriter writer;
+
+    // the new text goes to a copy that replaces the file once it is all
+    // written, so a file still mapped under the unread lines stays intact
 
-    if (!outFile.open( filepath_, "w")) {
+    if (!writer.open( filepath_.c_str() )) {
         printf("error opening file\n");
         exit(0);
     }
 
-    for (unsigned long row=0; row < _bufferLineList.entries(); row++) {
+    // without a copy the file is written over, so nothing may still be
+    // read from a mapping of it
 
-        CxString line = *(_bufferLineList.at(row));
-        line = CxStringUtils::fromTabExtensionFormat2(line);
-        outFile.printf("%s\n", line.data() );
+    if (writer.inPlace() && _bufferLineList.isSourceMapped()) {
+        _bufferLineList.detachSource();
+    }
+
+    unsigned long entries = _bufferLineList.entries();
+    unsigned long row     = 0;
+
+    while (row < entries) {
+
+        // lines never read go out straight from the loaded text, a run of
+        // them at a time
+
+        unsigned long count;
+        unsigned long length;
+        const char   *span = _bufferLineList.sourceLines( row, &count, &length );
+
+        if (span != NULL) {
+
+            writer.writeSpan( span, length );
+
+            if (length == 0 || span[length-1] != '\n') {
+                writer.writeSpan( "\n", 1 );
+            }
+
+            row = row + count;
+            continue;
+        }
+
+        CxString *line = _bufferLineList.at(row);
+        writer.writeLine( line->c_str(), line->length() );
+
+        row++;
+    }
+
+    if (!writer.commit()) {
+        printf("error writing file\n");
+        return;
     }
 
-    outFile.close();
-    
     touched = FALSE;
 }
 
@@ -1221,24 +1275,23 @@ CxEditBuffer::findAgain( CxString findString, int skipIfCurrent )
         }
     }
     
-	// start from the specified position
-    for (unsigned long row=cursor.row; row < _bufferLineList.entries(); row++) {
-        
-        CxString line = *(_bufferLineList.at(row));
-        
-        int col = line.index( findString, cursor.col );
-        
-        if (col != -1) {
+	// start from the specified position, lines not yet read are searched
+	// where they were loaded
+    unsigned long col;
+    long row = _bufferLineList.findNext( findString, cursor.row, cursor.col, &col );
 
-            cursorGotoRequest( row, col );
-            lastFindLocation = cursor;
-
-            return( TRUE );
-        }
-        
+    if (row != (long) cursor.row) {
         cursor.col = 0;
     }
 
+    if (row != -1) {
+
+        cursorGotoRequest( row, col );
+        lastFindLocation = cursor;
+
+        return( TRUE );
+    }
+
 	return( FALSE  );
 }
 
@@ -1319,6 +1372,8 @@ CxEditBuffer::replaceAgain( CxString findString, CxString replaceString  )
     if (col == cursor.col) {
    
         touched = TRUE;
+
+        undoSave( cursor.row, 1, CxEditJournal::EDIT );
   
 #ifdef NEWCODE      
 		line.findAndReplaceFirst( findString, replaceString, col);
@@ -1355,6 +1410,8 @@ CxEditBuffer::replaceAgain( CxString findString, CxString replaceString  )
         CxString *oldString =
         _bufferLineList.replaceAt( cursor.row, new CxString( line ) );
         delete oldString;
+
+        undoChanged( 1 );
     }
     
     //---------------------------------------------------------------------------------------------
@@ -1369,15 +1426,49 @@ CxEditBuffer::replaceAgain( CxString findString, CxString replaceString  )
 //-------------------------------------------------------------------------------------------------
 // CxEditBuffer::findAgainMultiLine
 //
-// Multi-line find.  The findString contains embedded '\n' characters representing line
-// boundaries.  The algorithm splits the findString into segments and checks that:
+// Multi-line find, see findMultiLine.
+//
+//-------------------------------------------------------------------------------------------------
+int
+CxEditBuffer::findAgainMultiLine( CxString findString, int skipIfCurrent )
+{
+    // handle skipIfCurrent: if cursor is at last find location, advance
+    if (cursor == lastFindLocation) {
+        if (skipIfCurrent) {
+            cursorRightRequest();
+        }
+    }
+
+    CxEditBufferPosition start;
+    CxEditBufferPosition end;
+
+    if (!findMultiLine( findString, cursor.row, cursor.col, &start, &end )) {
+        return( FALSE );
+    }
+
+    cursorGotoRequest( start.row, start.col );
+    lastFindLocation = cursor;
+    return( TRUE );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::findMultiLine
+//
+// Find a findString containing embedded '\n' characters representing line boundaries, from
+// startRow/startCol on, without moving the cursor.  The algorithm splits the findString into
+// segments and checks that:
 //   - segment 0 matches at the END of a line
 //   - middle segments match the ENTIRE content of their respective lines
 //   - the last segment matches at the START of the last line
+// Every segment of a match is in its line, so rows are only checked where the longest segment
+// is found by the line list's search, which does not read the lines in between.  start is set
+// to the first character of the match and end to just past its last.
 //
 //-------------------------------------------------------------------------------------------------
 int
-CxEditBuffer::findAgainMultiLine( CxString findString, int skipIfCurrent )
+CxEditBuffer::findMultiLine( CxString findString, unsigned long startRow, unsigned long startCol,
+                             CxEditBufferPosition *start, CxEditBufferPosition *end )
 {
     // split findString by '\n' into segments (max 64)
     CxString segments[64];
@@ -1401,21 +1492,30 @@ CxEditBuffer::findAgainMultiLine( CxString findString, int skipIfCurrent )
 
     int linesToSpan = segCount - 1;
 
-    // handle skipIfCurrent: if cursor is at last find location, advance
-    if (cursor == lastFindLocation) {
-        if (skipIfCurrent) {
-            cursorRightRequest();
+    // the segment to look for, a match starting at row has it in row + keySeg
+    int keySeg = 0;
+    for (int s = 1; s < segCount; s++) {
+        if (segments[s].length() > segments[keySeg].length()) {
+            keySeg = s;
         }
     }
 
-    // search from cursor position
-    unsigned long startRow = cursor.row;
-    unsigned long startCol = cursor.col;
+    unsigned long entries = _bufferLineList.entries();
 
-    for (unsigned long row = startRow; row < _bufferLineList.entries(); row++) {
+    for (unsigned long row = startRow; row < entries; row++) {
+
+        // skip to the next row that could start a match
+        if (segments[keySeg].length() > 0) {
+            unsigned long keyCol;
+            long keyRow = _bufferLineList.findNext( segments[keySeg], row + keySeg, 0, &keyCol );
+            if (keyRow == -1) {
+                break;
+            }
+            row = (unsigned long) keyRow - keySeg;
+        }
 
         // check if enough lines remain for the match
-        if (row + linesToSpan >= _bufferLineList.entries()) {
+        if (row + linesToSpan >= entries) {
             break;
         }
 
@@ -1481,8 +1581,10 @@ CxEditBuffer::findAgainMultiLine( CxString findString, int skipIfCurrent )
         // which we already verified exists since row+linesToSpan < entries()
 
         // match found
-        cursorGotoRequest( row, matchCol );
-        lastFindLocation = cursor;
+        start->row = row;
+        start->col = matchCol;
+        end->row   = row + linesToSpan;
+        end->col   = lastSegLen;
         return( TRUE );
     }
 
@@ -1490,6 +1592,40 @@ CxEditBuffer::findAgainMultiLine( CxString findString, int skipIfCurrent )
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::countMatches
+//
+// Single line matches are counted by the line list, which keeps counts for blocks of lines
+// and only counts blocks again after they change.  Multi-line matches are found one after
+// another.
+//
+//-------------------------------------------------------------------------------------------------
+unsigned long
+CxEditBuffer::countMatches( CxString findString )
+{
+    if (findString.length() == 0) {
+        return( 0 );
+    }
+
+    if (findString.firstChar('\n') == -1) {
+        return( _bufferLineList.countOf( findString ) );
+    }
+
+    unsigned long count = 0;
+
+    CxEditBufferPosition from( 0, 0 );
+    CxEditBufferPosition start;
+    CxEditBufferPosition end;
+
+    while (findMultiLine( findString, from.row, from.col, &start, &end )) {
+        count++;
+        from = end;
+    }
+
+    return( count );
+}
+
+
 //-------------------------------------------------------------------------------------------------
 // CxEditBuffer::replaceAgainMultiLine
 //
@@ -1593,12 +1729,47 @@ CxEditBuffer::replaceAgainMultiLine( CxString findString, CxString replaceString
     // at a valid match — perform the replacement
     touched = TRUE;
 
-    // prefix is the first line content before the match
-    CxString prefix = firstLine.subString(0, matchCol);
+    CxEditBufferPosition start( matchRow, matchCol );
+    CxEditBufferPosition end( matchRow + linesToSpan, lastSegLen );
+
+    undoBegin();
+
+    // position cursor after replacement text
+    CxEditBufferPosition after = replaceRegion( start, end, replaceString );
+
+    cursor.row = after.row;
+    cursor.col = after.col;
+
+    undoEnd();
+
+    // find the next match
+    return findAgainMultiLine( findString, TRUE );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::replaceRegion
+//
+// The text before start on its row and after end on its row stay, everything between is
+// replaced.  The replaceString may itself contain '\n' for multi-line output.
+//
+//-------------------------------------------------------------------------------------------------
+CxEditBufferPosition
+CxEditBuffer::replaceRegion( CxEditBufferPosition start, CxEditBufferPosition end,
+                             CxString replaceString )
+{
+    undoSave( start.row, end.row - start.row + 1, CxEditJournal::EDIT );
+
+    CxString firstLine = *(_bufferLineList.at(start.row));
+    CxString lastLine  = *(_bufferLineList.at(end.row));
 
-    // remove the spanned lines (lines matchRow+1 through matchRow+linesToSpan)
-    for (int i = 0; i < linesToSpan; i++) {
-        CxString *removed = _bufferLineList.removeAt( matchRow + 1 );
+    // prefix is the first line content before the region, suffix the last line after it
+    CxString prefix = firstLine.subString(0, start.col);
+    CxString suffix = lastLine.subString(end.col, lastLine.length() - end.col);
+
+    // remove the spanned lines (lines start.row+1 through end.row)
+    for (unsigned long i = start.row; i < end.row; i++) {
+        CxString *removed = _bufferLineList.removeAt( start.row + 1 );
         if (removed) delete removed;
     }
 
@@ -1621,42 +1792,154 @@ CxEditBuffer::replaceAgainMultiLine( CxString findString, CxString replaceString
         // single output line: prefix + replSegs[0] + suffix
         CxString newLine = prefix + replSegs[0] + suffix;
         newLine = CxStringUtils::fixTabs(newLine, tabSpaces);
-        CxString *old = _bufferLineList.replaceAt( matchRow, new CxString(newLine) );
+        CxString *old = _bufferLineList.replaceAt( start.row, new CxString(newLine) );
         if (old) delete old;
 
-        // position cursor after replacement text
-        cursor.row = matchRow;
-        cursor.col = prefix.length() + replSegs[0].length();
+        undoChanged( 1 );
+
+        return( CxEditBufferPosition( start.row, prefix.length() + replSegs[0].length() ) );
+    }
+
+    // multiple output lines
+    // first line: prefix + replSegs[0]
+    CxString firstNewLine = prefix + replSegs[0];
+    firstNewLine = CxStringUtils::fixTabs(firstNewLine, tabSpaces);
+    CxString *old = _bufferLineList.replaceAt( start.row, new CxString(firstNewLine) );
+    if (old) delete old;
+
+    // middle lines: replSegs[1..N-2]
+    int insertIdx = start.row;
+    for (int s = 1; s < replSegCount - 1; s++) {
+        CxString midNewLine = replSegs[s];
+        midNewLine = CxStringUtils::fixTabs(midNewLine, tabSpaces);
+        _bufferLineList.insertAfter( insertIdx, new CxString(midNewLine) );
+        insertIdx++;
+    }
+
+    // last line: replSegs[N-1] + suffix
+    CxString lastNewLine = replSegs[replSegCount - 1] + suffix;
+    lastNewLine = CxStringUtils::fixTabs(lastNewLine, tabSpaces);
+    _bufferLineList.insertAfter( insertIdx, new CxString(lastNewLine) );
+    insertIdx++;
+
+    undoChanged( replSegCount );
+
+    return( CxEditBufferPosition( insertIdx, replSegs[replSegCount - 1].length() ) );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::replaceAll
+//
+// Single line matches are found by the line list's search, so lines without a match are
+// never read.  Every match in a line is replaced as the new line is built and its tabs are
+// fixed once, rather than rebuilding the line for each match.  Matches do not overlap and
+// the text put in is not searched again, the same matches replaceAgain would replace going
+// from the top.  Multi-line matches are replaced one after another, each search starting
+// after the last replacement.
+//
+//-------------------------------------------------------------------------------------------------
+CxEditHint
+CxEditBuffer::replaceAll( CxString findString, CxString replaceString )
+{
+    if (readOnly) return( CxEditHint() );
+
+    if (findString.length() == 0) {
+        return( CxEditHint() );
+    }
+
+    int multiLine = (findString.firstChar('\n') != -1);
+
+    // as with replaceAgain, only a multi-line find may replace with nothing
+    if (replaceString.length() == 0 && !multiLine) {
+        return( CxEditHint() );
+    }
+
+    unsigned long linesBefore = _bufferLineList.entries();
+    unsigned long count       = 0;
+    unsigned long firstRow    = 0;
+
+    CxEditBufferPosition after( 0, 0 );
+
+    undoBegin();
+
+    if (multiLine) {
+
+        CxEditBufferPosition start;
+        CxEditBufferPosition end;
+
+        while (findMultiLine( findString, after.row, after.col, &start, &end )) {
+
+            if (count == 0) firstRow = start.row;
+
+            after = replaceRegion( start, end, replaceString );
+            count++;
+        }
+
     } else {
-        // multiple output lines
-        // first line: prefix + replSegs[0]
-        CxString firstNewLine = prefix + replSegs[0];
-        firstNewLine = CxStringUtils::fixTabs(firstNewLine, tabSpaces);
-        CxString *old = _bufferLineList.replaceAt( matchRow, new CxString(firstNewLine) );
-        if (old) delete old;
 
-        // middle lines: replSegs[1..N-2]
-        int insertIdx = matchRow;
-        for (int s = 1; s < replSegCount - 1; s++) {
-            CxString midNewLine = replSegs[s];
-            midNewLine = CxStringUtils::fixTabs(midNewLine, tabSpaces);
-            _bufferLineList.insertAfter( insertIdx, new CxString(midNewLine) );
-            insertIdx++;
+        unsigned long findLength = findString.length();
+        unsigned long col;
+
+        long row = _bufferLineList.findNext( findString, 0, 0, &col );
+
+        if (row != -1) firstRow = row;
+
+        while (row != -1) {
+
+            CxString line = *(_bufferLineList.at(row));
+            CxString newLine;
+
+            int from = 0;
+            int c    = (int) col;
+
+            while (c != -1) {
+                newLine.append( line.subString(from, c - from) );
+                newLine.append( replaceString );
+                count++;
+
+                from = c + (int) findLength;
+                c    = line.index( findString, from );
+            }
+
+            after.row = row;
+            after.col = newLine.length();
+
+            newLine.append( line.subString(from, line.length() - from) );
+            newLine = CxStringUtils::fixTabs(newLine, tabSpaces);
+
+            undoSave( row, 1, CxEditJournal::EDIT );
+
+            CxString *old = _bufferLineList.replaceAt( row, new CxString(newLine) );
+            if (old) delete old;
+
+            undoChanged( 1 );
+
+            row = _bufferLineList.findNext( findString, row + 1, 0, &col );
         }
+    }
 
-        // last line: replSegs[N-1] + suffix
-        CxString lastNewLine = replSegs[replSegCount - 1] + suffix;
-        lastNewLine = CxStringUtils::fixTabs(lastNewLine, tabSpaces);
-        _bufferLineList.insertAfter( insertIdx, new CxString(lastNewLine) );
-        insertIdx++;
+    if (count == 0) {
+        undoEnd();
+        return( CxEditHint() );
+    }
+
+    touched = TRUE;
+
+    cursor.row = after.row;
+    cursor.col = after.col;
+
+    undoEnd();
+
+    // rows below only move if lines were added or taken away
+
+    CxEditHint::UPDATE_HINT update = CxEditHint::UPDATE_HINT_ROWS;
 
-        // position cursor after the last replacement segment
-        cursor.row = insertIdx;
-        cursor.col = replSegs[replSegCount - 1].length();
+    if (_bufferLineList.entries() != linesBefore) {
+        update = CxEditHint::UPDATE_HINT_SCREEN_PAST_POINT;
     }
 
-    // find the next match
-    return findAgainMultiLine( findString, TRUE );
+    return( CxEditHint( firstRow, after.row, count, update, CxEditHint::CURSOR_HINT_JUMP ) );
 }
 
 
@@ -1713,6 +1996,8 @@ CxEditBuffer::detab( void )
 {
     if (readOnly) return;
 
+    undoBegin();
+
     for (unsigned long row = 0; row < _bufferLineList.entries(); row++) {
         CxString *line = _bufferLineList.at(row);
         if (line == NULL) continue;
@@ -1729,10 +2014,19 @@ CxEditBuffer::detab( void )
             }
         }
 
+        // lines without tabs are left alone, there is nothing to undo
+        if (newLine == *line) continue;
+
+        undoSave( row, 1, CxEditJournal::EDIT );
+
         CxString *oldLine = _bufferLineList.replaceAt(row, new CxString(newLine));
         delete oldLine;
+
+        undoChanged( 1 );
     }
 
+    undoEnd();
+
     touched = TRUE;
 }
 
@@ -1751,6 +2045,8 @@ CxEditBuffer::trimTrailing( void )
 
     int totalRemoved = 0;
 
+    undoBegin();
+
     for (unsigned long row = 0; row < _bufferLineList.entries(); row++) {
         CxString *line = _bufferLineList.at(row);
         if (line == NULL) continue;
@@ -1769,12 +2065,16 @@ CxEditBuffer::trimTrailing( void )
         int charsToRemove = (int)line->length() - (lastNonSpace + 1);
         if (charsToRemove > 0) {
             CxString trimmed = line->subString(0, lastNonSpace + 1);
+            undoSave( row, 1, CxEditJournal::EDIT );
             CxString *oldLine = _bufferLineList.replaceAt(row, new CxString(trimmed));
             delete oldLine;
+            undoChanged( 1 );
             totalRemoved += charsToRemove;
         }
     }
 
+    undoEnd();
+
     if (totalRemoved > 0) {
         touched = TRUE;
     }
@@ -1794,6 +2094,8 @@ CxEditBuffer::entab( void )
 {
     if (readOnly) return;
 
+    undoBegin();
+
     for (unsigned long row = 0; row < _bufferLineList.entries(); row++) {
         CxString *line = _bufferLineList.at(row);
         if (line == NULL) continue;
@@ -1840,11 +2142,17 @@ CxEditBuffer::entab( void )
         }
         *destPtr = '\0';
 
+        undoSave( row, 1, CxEditJournal::EDIT );
+
         CxString *oldLine = _bufferLineList.replaceAt(row, new CxString(newBuffer));
         delete oldLine;
         delete[] newBuffer;
+
+        undoChanged( 1 );
     }
 
+    undoEnd();
+
     touched = TRUE;
 }
 
@@ -2080,8 +2388,8 @@ CxEditBuffer::cursorGotoLine( unsigned long row_)
 
     exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
-    // get the number of buffer lines
-    unsigned long numberOfBufferLines = _bufferLineList.entries();
+    // get the number of buffer lines, indexing only as far as row_
+    unsigned long numberOfBufferLines = _bufferLineList.entriesThrough( row_ );
 
     if (numberOfBufferLines == 0) {
         row_ = 0;
@@ -2132,26 +2440,20 @@ CxEditBuffer::joinLines( )
             return( editHint );
         }
 
-        CxString *prevLine = _bufferLineList.at( cursor.row-1 );
+        undoSave( cursor.row-1, 2, CxEditJournal::TYPING );
+
+        CxString *prevLine = _bufferLineList.editAt( cursor.row-1 );
         CxString *line     = _bufferLineList.at( cursor.row );
 
         // calculate where the cursor will be when we are done
         unsigned newCursorRow = cursor.row - 1;
         unsigned newCursorCol = prevLine->length();
 
-        // put the prev line in working text
-        CxString workingText = *prevLine;
-
-        // append the line to the last line
-        workingText.append( line->data() );
+        // append the line to the previous line in place
+        prevLine->append( *line );
 
         // fix up tabs
-        workingText = CxStringUtils::fixTabs( workingText, tabSpaces );
-
-        // replace the string in teh buffer and delete the old version
-        CxString *oldString =
-            _bufferLineList.replaceAt( cursor.row-1, new CxString(workingText));
-        delete oldString;
+        *prevLine = CxStringUtils::fixTabs( *prevLine, tabSpaces );
 
         // remove the current line
         CxString *deletedString = _bufferLineList.removeAt(cursor.row );
@@ -2170,6 +2472,8 @@ CxEditBuffer::joinLines( )
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         // if it is there is nothing else to do
@@ -2197,26 +2501,20 @@ CxEditBuffer::joinLines( )
             return( editHint );
         }
 
-        CxString *prevLine = _bufferLineList.at( cursor.row-1 );
+        undoSave( cursor.row-1, 2, CxEditJournal::TYPING );
+
+        CxString *prevLine = _bufferLineList.editAt( cursor.row-1 );
         CxString *line     = _bufferLineList.at( cursor.row );
 
         // calculate where the cursor will be when we are done
         unsigned newCursorRow = cursor.row - 1;
         unsigned newCursorCol = prevLine->length();
 
-        // put the prev line in working text
-        CxString workingText = *prevLine;
-
-        // append the line to the last line
-        workingText.append( *line );
+        // append the current line to the preveous line in place
+        prevLine->append( *line );
 
         // fix up tabs
-        workingText = CxStringUtils::fixTabs( workingText, tabSpaces );
-
-        // append the current line to the preveous line
-        CxString *oldString =
-            _bufferLineList.replaceAt( cursor.row-1, new CxString( workingText) );
-        delete oldString;
+        *prevLine = CxStringUtils::fixTabs( *prevLine, tabSpaces );
 
 
         // remove the current line
@@ -2236,6 +2534,8 @@ CxEditBuffer::joinLines( )
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         // if it is there is nothing else to do
@@ -2306,21 +2606,23 @@ CxEditBuffer::addBackspace(void)
             return ( joinLines(  ) );
         }
 
-        // get the line element
-        CxString *line = _bufferLineList.at( cursor.row );
+        undoSave( cursor.row, 1, CxEditJournal::TYPING );
 
-        // get the text
-        CxString text = line->data();
+        // get the line element, it is changed in place
+        CxString *line = _bufferLineList.editAt( cursor.row );
 
         // if the character to the left is a tab-extension, then eat those
         // up
-        if (line->data()[cursor.col-1] == '\377') {
+        if (line->c_str()[cursor.col-1] == '\377') {
+
+            // work on a copy, the loop reads the line as it was
+            CxString text = *line;
 
             // move cursor back one col
             cursor.col = cursor.col - 1;
 
             // while the current character is a tab extension, keep moving back
-            while (line->data()[cursor.col] == '\377') {
+            while (line->c_str()[cursor.col] == '\377') {
 
                 // get the string
                 text = text.remove( cursor.col-1, 1 );
@@ -2332,10 +2634,7 @@ CxEditBuffer::addBackspace(void)
                 cursor.col = cursor.col - 1;
             }
 
-
-            CxString *oldString =
-                _bufferLineList.replaceAt( cursor.row, new CxString( text ));
-            delete oldString;
+            *line = text;
 
 
             CxEditHint editHint(
@@ -2349,22 +2648,19 @@ CxEditBuffer::addBackspace(void)
 
 	        exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+            undoChanged( 1 );
+
             touched = TRUE;
             
             // if it is there is nothing else to do
             return( editHint );
         }
 
-        // get the string
-        text = text.remove( cursor.col-1, 1 );
+        // remove the character
+        line->remove( cursor.col-1, 1 );
 
         // fix up the tabs
-        text = CxStringUtils::fixTabs( text, tabSpaces );
-
-        // put the working text back into the buffer
-        CxString *oldString =
-            _bufferLineList.replaceAt( cursor.row, new CxString( text ));
-        delete oldString;
+        *line = CxStringUtils::fixTabs( *line, tabSpaces );
 
         // move cursor back one col
         // POSSIBLE PROBLEM
@@ -2380,6 +2676,8 @@ CxEditBuffer::addBackspace(void)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         // if it is there is nothing else to do
@@ -2439,28 +2737,22 @@ CxEditBuffer::addTab(void)
 
     if (position == CxEditBuffer::POS_VALID_INSERT) {
 
-        // get the line element
-        CxString *line = _bufferLineList.at( cursor.row );
+        undoSave( cursor.row, 1, CxEditJournal::TYPING );
 
-        // get the string
-        CxString existingString = line->data();
+        // get the line element, it is changed in place
+        CxString *line = _bufferLineList.editAt( cursor.row );
 
         // get the number of tab extension characters to add.
         unsigned long tabExtensionsToAdd = CxStringUtils::calcTab(cursor.col, tabSpaces);
 
         // insert the actual tab
-        existingString.insert("\t", cursor.col++);
+        line->insert('\t', cursor.col++);
 
         // fill in with the number of extension characters needed
         for (int c=0; c<tabExtensionsToAdd-1; c++) {
-            existingString.insert('\377', cursor.col++);
+            line->insert('\377', cursor.col++);
         }
 
-        // set the text item
-        CxString *oldString =
-            _bufferLineList.replaceAt( cursor.row, new CxString( existingString ));
-        delete oldString;
-
         //return( CxEditBuffer::NONE);
         CxEditHint editHint(
             cursor.row,
@@ -2472,6 +2764,8 @@ CxEditBuffer::addTab(void)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2482,29 +2776,22 @@ CxEditBuffer::addTab(void)
 
     if (position == CxEditBuffer::POS_VALID_APPEND_COL) {
 
-        // get the line element
-        CxString *line = _bufferLineList.at( cursor.row );
+        undoSave( cursor.row, 1, CxEditJournal::TYPING );
 
-        // get the string
-        CxString existingString = line->data();
+        // get the line element, it is changed in place
+        CxString *line = _bufferLineList.editAt( cursor.row );
 
         // get the number of tab extension characters to add.
         unsigned long tabExtensionsToAdd = CxStringUtils::calcTab(cursor.col, tabSpaces);
 
         // insert the actual tab
-        existingString.insert('\t', cursor.col++);
+        line->insert('\t', cursor.col++);
 
         // fill in with the number of extension characters needed
         for (int c=0; c<tabExtensionsToAdd-1; c++) {
-            existingString.insert('\377', cursor.col++);
+            line->insert('\377', cursor.col++);
         }
 
-        // set the text item
-        CxString *oldString =
-            _bufferLineList.replaceAt(cursor.row, new CxString( existingString ));
-
-        delete oldString;
-
         CxEditHint editHint(
             cursor.row,
             cursor.col-1,
@@ -2515,6 +2802,8 @@ CxEditBuffer::addTab(void)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2526,6 +2815,8 @@ CxEditBuffer::addTab(void)
 
     if (position == CxEditBuffer::POS_VALID_INITIAL) {
 
+        undoSave( 0, 0, CxEditJournal::TYPING );
+
         // appending a row, so make a new string
         CxString text = "\t";
 
@@ -2554,6 +2845,8 @@ CxEditBuffer::addTab(void)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2608,21 +2901,17 @@ CxEditBuffer::addReturn(void)
 
     if (position == CxEditBuffer::POS_VALID_INSERT) {
 
-        // get the line element
-        CxString *line = _bufferLineList.at( cursor.row );
+        undoSave( cursor.row, 1, CxEditJournal::TYPING );
 
-        // get the string
-        CxString existingString = *line;
+        // get the line element, the left part stays in it
+        CxString *line = _bufferLineList.editAt( cursor.row );
 
-        CxString leftString  = existingString.subString(0, cursor.col);
-        CxString rightString = existingString.subString(cursor.col, existingString.length() - cursor.col);
+        CxString rightString = line->subString(cursor.col, line->length() - cursor.col);
 
         // create a new CxString on the heap and append FIX
         rightString = CxStringUtils::fixTabs(rightString, tabSpaces);
-        
-        CxString *oldString =
-            _bufferLineList.replaceAt( cursor.row, new CxString(leftString) );
-        delete oldString;
+
+        line->remove(cursor.col, line->length() - cursor.col);
 
         CxString *line2 = new CxString( rightString );
 
@@ -2641,6 +2930,8 @@ CxEditBuffer::addReturn(void)
 
         lastRequestCol = cursor.col;
 
+        undoChanged( 2 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2650,6 +2941,8 @@ CxEditBuffer::addReturn(void)
     // below the current line and placing the cursor there.
     if (position == CxEditBuffer::POS_VALID_APPEND_COL) {
 
+        undoSave( cursor.row, 1, CxEditJournal::TYPING );
+
         CxString *line = new CxString();
 
         _bufferLineList.insertAfter( cursor.row, line);
@@ -2668,6 +2961,8 @@ CxEditBuffer::addReturn(void)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 2 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2680,6 +2975,8 @@ CxEditBuffer::addReturn(void)
         // we need to add a blank line at 0 and a blank line at 1, then place
         // the cursor on the second blank allocated line
 
+        undoSave( 0, 0, CxEditJournal::TYPING );
+
         CxString *line = new CxString();
         _bufferLineList.append( line );
 
@@ -2700,6 +2997,8 @@ CxEditBuffer::addReturn(void)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 2 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2790,25 +3089,16 @@ CxEditBuffer::addCharacter(char c)
 
     if (position == CxEditBuffer::POS_VALID_INSERT) {
 
-        // get the line element
-        CxString *line = _bufferLineList.at( cursor.row );
+        undoSave( cursor.row, 1, CxEditJournal::TYPING );
 
-        // get the string
-        CxString existingString = line->data();
+        // get the line element, it is changed in place
+        CxString *line = _bufferLineList.editAt( cursor.row );
 
         // insert the character
-        existingString.insert(c, cursor.col);
+        line->insert(c, cursor.col);
 
 		// fix tabs, and insert can effect tab stops to the right
-        existingString = CxStringUtils::fixTabs( existingString, tabSpaces );
-
-        // advance the cursor o
-        //cursor.col++;
-
-        // set the text item (NEED TO DELETE RETURN)
-        CxString *oldString =
-            _bufferLineList.replaceAt( cursor.row, new CxString(existingString));
-        delete oldString;
+        *line = CxStringUtils::fixTabs( *line, tabSpaces );
 
         // advance the cursor o
         cursor.col++;
@@ -2823,6 +3113,8 @@ CxEditBuffer::addCharacter(char c)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2833,19 +3125,13 @@ CxEditBuffer::addCharacter(char c)
 
     if (position == CxEditBuffer::POS_VALID_APPEND_COL) {
 
-        // get the line element
-        CxString *line = _bufferLineList.at( cursor.row );
-
-        // get the string
-        CxString existingString = line->data();
+        undoSave( cursor.row, 1, CxEditJournal::TYPING );
 
-        // insert the character
-        existingString.append(c);
+        // get the line element, it is changed in place
+        CxString *line = _bufferLineList.editAt( cursor.row );
 
-
-        CxString *oldString =
-            _bufferLineList.replaceAt(cursor.row, new CxString(existingString));
-        delete oldString;
+        // append the character
+        line->append(c);
 
         // advance the cursor o
         cursor.col++;
@@ -2860,6 +3146,8 @@ CxEditBuffer::addCharacter(char c)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2871,6 +3159,8 @@ CxEditBuffer::addCharacter(char c)
 
     if (position == CxEditBuffer::POS_VALID_INITIAL) {
 
+        undoSave( 0, 0, CxEditJournal::TYPING );
+
         // appending a row, so make a new string
         CxString text;
 
@@ -2897,6 +3187,8 @@ CxEditBuffer::addCharacter(char c)
 
         exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+        undoChanged( 1 );
+
         touched = TRUE;
         
         return( editHint );
@@ -2931,7 +3223,7 @@ CxEditBuffer::addCharacter(char c)
 CxString *
 CxEditBuffer::line(unsigned long row)
 {
-    if (row < _bufferLineList.entries()) {
+    if (row < _bufferLineList.entriesThrough(row)) {
         return( _bufferLineList.at(row) );
     }
 
@@ -2975,10 +3267,14 @@ CxEditBuffer::insertTextAtCursor( CxString text )
 
     CxString workingString = CxStringUtils::fromTabExtensionFormat( text );
 
+    undoBegin();
+
     for (unsigned long i=0; i<workingString.length(); i++) {
         char c = workingString.charAt(i);
         addCharacter( c );
     }
+
+    undoEnd();
 }
 
 
@@ -3101,11 +3397,14 @@ CxEditBuffer::cutTextToEndOfLine(void)
     CxString *currentLine = _bufferLineList.at(cursor.row);
     if (currentLine != NULL && cursor.col >= currentLine->length()) {
         // Cursor is at end of line - join with next line if one exists
-        unsigned long numberOfBufferLines = _bufferLineList.entries();
+        unsigned long numberOfBufferLines = _bufferLineList.entriesThrough( cursor.row + 1 );
         if (cursor.row + 1 < numberOfBufferLines) {
             CxString *nextLine = _bufferLineList.at(cursor.row + 1);
             if (nextLine != NULL) {
+                undoSave(cursor.row, 2, CxEditJournal::EDIT);
+
                 // Append next line to current line
+                currentLine = _bufferLineList.editAt(cursor.row);
                 currentLine->append(nextLine->data());
                 *currentLine = CxStringUtils::fixTabs(*currentLine, tabSpaces);
 
@@ -3113,6 +3412,8 @@ CxEditBuffer::cutTextToEndOfLine(void)
                 CxString *deletedLine = _bufferLineList.removeAt(cursor.row + 1);
                 delete deletedLine;
 
+                undoChanged(1);
+
                 touched = true;
                 theCutText = "\n";
             }
@@ -3276,6 +3577,8 @@ CxEditBuffer::deleteText(void)
 
     CxEditBufferPosition saveCursor = cursor;
 
+    undoBegin();
+
     //---------------------------------------------------------------------------------------------
     // Handle some special cases first,
     // if the cursor is in the first col
@@ -3304,6 +3607,8 @@ CxEditBuffer::deleteText(void)
 
         			exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+                    undoEnd();
+
                     return;
 
                     //-----------------------------------------------------------------------------
@@ -3320,6 +3625,8 @@ CxEditBuffer::deleteText(void)
 
         			exitDumpIfCursorIsInvalid( __FUNCTION__ , __LINE__);
 
+                    undoEnd();
+
                     return;
                 }
             }
@@ -3327,9 +3634,18 @@ CxEditBuffer::deleteText(void)
     }
 
     //---------------------------------------------------------------------------------------------
-    // just deleting a chunck without any special handling
+    // just deleting a chunck without any special handling.  The rows are saved first, so the
+    // backspaces below are all inside the one change
     //
     //---------------------------------------------------------------------------------------------
+    {
+        unsigned long firstRow = (mark.row < cursor.row) ? mark.row : cursor.row;
+        unsigned long lastRow  = (mark.row < cursor.row) ? cursor.row : mark.row;
+
+        // nothing has changed yet, the rows saved are still there
+        undoChanged( undoSave( firstRow, lastRow - firstRow + 1, CxEditJournal::EDIT ) );
+    }
+
     switch (compareCursorToMark()) {
 
         // cursor if before mark, swap them so cursor is end of region
@@ -3346,6 +3662,7 @@ CxEditBuffer::deleteText(void)
         // they are same position, nothing to do here
         case 0:
         {
+            undoEnd();
             return;
         }
 
@@ -3359,6 +3676,7 @@ CxEditBuffer::deleteText(void)
         // should not happen
         default:
         {
+            undoEnd();
             return;
         }
     }
@@ -3371,6 +3689,7 @@ CxEditBuffer::deleteText(void)
 
         // handle the nothing in buffer case
         if (position == CxEditBuffer::POS_VALID_INITIAL) {
+            undoEnd();
             return;
         }
 
@@ -3381,6 +3700,7 @@ CxEditBuffer::deleteText(void)
         // if we have completed the request
         if (cursor == mark) {
             //cursor = saveCursor;
+            undoEnd();
             return;
         }
     }
@@ -3405,6 +3725,8 @@ CxEditBuffer::insertCommentBlock( unsigned long lastCol )
     // cut the preceeding text before the cursor
     text = text.subString(0, cursor.col);
 
+    undoBegin();
+
     // remove tab extensions
     //text = CxStringUtils::fromTabExtensionFormat( text );
 
@@ -3445,8 +3767,347 @@ CxEditBuffer::insertCommentBlock( unsigned long lastCol )
     cursorRightRequest();
     cursorRightRequest();
     cursorRightRequest();
+
+    undoEnd();
 }
 
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undo
+//
+// puts back the rows changed by the last step in the journal.  A run of typing still being
+// recorded is ended first, so it is what gets undone.
+//
+//-------------------------------------------------------------------------------------------------
+CxEditHint
+CxEditBuffer::undo( void )
+{
+    if (readOnly) {
+        return( CxEditHint( cursor.row, cursor.col, CxEditHint::UPDATE_HINT_NONE,
+                            CxEditHint::CURSOR_HINT_NONE ) );
+    }
+
+    _lastWasKill = false;
+
+    undoClose();
+
+    CxEditJournalStep *step = _journal.undoStep();
+
+    if (step == NULL) {
+        return( CxEditHint( cursor.row, cursor.col, CxEditHint::UPDATE_HINT_NONE,
+                            CxEditHint::CURSOR_HINT_NONE ) );
+    }
+
+    return( undoApply( step, TRUE ) );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::redo
+//
+//-------------------------------------------------------------------------------------------------
+CxEditHint
+CxEditBuffer::redo( void )
+{
+    if (readOnly) {
+        return( CxEditHint( cursor.row, cursor.col, CxEditHint::UPDATE_HINT_NONE,
+                            CxEditHint::CURSOR_HINT_NONE ) );
+    }
+
+    _lastWasKill = false;
+
+    undoClose();
+
+    CxEditJournalStep *step = _journal.redoStep();
+
+    if (step == NULL) {
+        return( CxEditHint( cursor.row, cursor.col, CxEditHint::UPDATE_HINT_NONE,
+                            CxEditHint::CURSOR_HINT_NONE ) );
+    }
+
+    return( undoApply( step, FALSE ) );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::canUndo
+//
+//-------------------------------------------------------------------------------------------------
+int
+CxEditBuffer::canUndo( void )
+{
+    return( _journal.canUndo() );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::canRedo
+//
+//-------------------------------------------------------------------------------------------------
+int
+CxEditBuffer::canRedo( void )
+{
+    return( _journal.canRedo() );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::setUndoLimit
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxEditBuffer::setUndoLimit( unsigned long bytes )
+{
+    _journal.setLimit( bytes );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undoApply
+//
+// each change was recorded with the rows as they were between it and the next change, so
+// undo goes from the last change back and redo from the first on.
+//
+//-------------------------------------------------------------------------------------------------
+CxEditHint
+CxEditBuffer::undoApply( CxEditJournalStep *step, int backward )
+{
+    unsigned long firstRow     = (unsigned long) -1;
+    unsigned long lastRow      = 0;
+    int           linesChanged = FALSE;
+
+    int n = step->deltas();
+
+    for (int k = 0; k < n; k++) {
+
+        CxEditJournalDelta *d = step->delta( backward ? n - 1 - k : k );
+
+        unsigned long count = d->liveCount;
+
+        CxString text = _journal.swap( d, undoText( d->row, count ) );
+
+        undoReplace( d->row, count, text, d->liveCount );
+
+        if (d->liveCount != count) {
+            linesChanged = TRUE;
+        }
+
+        if (d->row < firstRow) {
+            firstRow = d->row;
+        }
+
+        if (d->row + d->liveCount > lastRow) {
+            lastRow = d->row + d->liveCount;
+        }
+    }
+
+    cursor  = backward ? step->before : step->after;
+    markSet = FALSE;
+
+    // the cursor goes back where it was, which may not be a place it can be now
+    unsigned long lines = _bufferLineList.entriesThrough( cursor.row );
+
+    if (lines == 0) {
+
+        cursor = CxEditBufferPosition( 0, 0 );
+
+    } else {
+
+        if (cursor.row >= lines) {
+            cursor.row = lines - 1;
+        }
+
+        CxString *line = _bufferLineList.at( cursor.row );
+
+        if (cursor.col > line->length()) {
+            cursor.col = line->length();
+        }
+
+        while (cursor.col > 0 && cursor.col < line->length() && line->c_str()[cursor.col] == '\377') {
+            cursor.col--;
+        }
+    }
+
+    lastRequestCol = cursor.col;
+
+    touched = TRUE;
+
+    if (lastRow > firstRow) {
+        lastRow = lastRow - 1;
+    }
+
+    return( CxEditHint(
+        firstRow,
+        lastRow,
+        (unsigned long) n,
+        linesChanged ? CxEditHint::UPDATE_HINT_SCREEN_PAST_POINT : CxEditHint::UPDATE_HINT_ROWS,
+        CxEditHint::CURSOR_HINT_JUMP ) );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undoText
+//
+//-------------------------------------------------------------------------------------------------
+CxString
+CxEditBuffer::undoText( unsigned long row, unsigned long count )
+{
+    CxString text;
+
+    for (unsigned long i = 0; i < count; i++) {
+
+        CxString *line = _bufferLineList.at( row + i );
+
+        if (line == NULL) {
+            break;
+        }
+
+        CxEditJournal::appendRow( &text, *line );
+    }
+
+    return( text );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undoReplace
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxEditBuffer::undoReplace( unsigned long row, unsigned long count, CxString text,
+                           unsigned long newCount )
+{
+    unsigned long offset = 0;
+
+    for (unsigned long k = 0; k < newCount; k++) {
+
+        CxString *line = new CxString( CxEditJournal::nextRow( text, &offset ) );
+
+        if (k < count) {
+
+            delete _bufferLineList.replaceAt( row + k, line );
+
+        } else if (row + k > 0) {
+
+            _bufferLineList.insertAfter( (int) (row + k - 1), line );
+
+        } else if (_bufferLineList.entriesThrough( 0 ) > 0) {
+
+            _bufferLineList.insertBefore( 0, line );
+
+        } else {
+
+            _bufferLineList.append( line );
+        }
+    }
+
+    for (unsigned long k = newCount; k < count; k++) {
+        delete _bufferLineList.removeAt( row + newCount );
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undoSave
+//
+// called before count rows from row change, returns how many of them exist.  A change that
+// does not belong with the step being recorded ends it, and one that does not overlap the last
+// change recorded completes that change, so both are trimmed while their rows are still where
+// they were recorded.
+//
+//-------------------------------------------------------------------------------------------------
+unsigned long
+CxEditBuffer::undoSave( unsigned long row, unsigned long count, int kind )
+{
+    // only rows that exist can be saved
+
+    if (count > 0) {
+
+        unsigned long lines = _bufferLineList.entriesThrough( row + count - 1 );
+
+        if (lines < row + count) {
+            count = (lines > row) ? lines - row : 0;
+        }
+    }
+
+    if (!_journal.continues( row, count, kind )) {
+
+        undoClose();
+
+    } else if (!_journal.touches( row, count )) {
+
+        CxEditJournalDelta *d = _journal.untrimmed();
+
+        if (d != NULL) {
+            _journal.trimLast( undoText( d->row, d->liveCount ) );
+        }
+    }
+
+    if (_journal.covers( row, count )) {
+        _journal.save( row, count, CxString(), kind, cursor );
+    } else {
+        _journal.save( row, count, undoText( row, count ), kind, cursor );
+    }
+
+    return( count );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undoChanged
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxEditBuffer::undoChanged( unsigned long count )
+{
+    _journal.changed( count, cursor );
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undoBegin
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxEditBuffer::undoBegin( void )
+{
+    if (_journal.depth() == 0) {
+        undoClose();
+    }
+
+    _journal.begin();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undoEnd
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxEditBuffer::undoEnd( void )
+{
+    if (_journal.end( cursor )) {
+        undoClose();
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxEditBuffer::undoClose
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxEditBuffer::undoClose( void )
+{
+    CxEditJournalDelta *d = _journal.untrimmed();
+
+    if (d != NULL) {
+        _journal.trimLast( undoText( d->row, d->liveCount ) );
+    }
+
+    _journal.close();
+}
+
+
 void
 CxEditBuffer::setVisualFirstScreenLine(int line)
 {
@@ -24,6 +24,7 @@
 #include <cx/editbuffer/edithint.h>
 #include <cx/editbuffer/editbufferpos.h>
 #include <cx/editbuffer/stringutils.h>
+#include <cx/editbuffer/editjournal.h>
 
 
 #ifndef _CxEditBuffer_
@@ -289,6 +290,40 @@ class CxEditBuffer
     // similar to replaceString but the same replace string is used from
     // the last replace.  A successive call to replaceAgain should move
     // the cursor one character forward before calling.
+
+    CxEditHint
+    replaceAll( CxString findString, CxString replaceString );
+    // replace every match of findString in the buffer in one pass, which
+    // may span lines.  Each changed line is rebuilt once.  The hint gives
+    // the first and last rows changed and the number of replacements, and
+    // the cursor is left after the last one
+
+    CxEditHint
+    undo( void );
+    // put back the rows changed by the last command, or the last run of
+    // typing, and move the cursor to where it was before it.  The hint
+    // gives the rows changed
+
+    CxEditHint
+    redo( void );
+    // make the change undo() last put back again
+
+    int
+    canUndo( void );
+    int
+    canRedo( void );
+    // return TRUE if there is anything to undo or redo
+
+    void
+    setUndoLimit( unsigned long bytes );
+    // most memory the undo history may use, the oldest changes are
+    // forgotten past it
+
+    unsigned long
+    countMatches( CxString findString );
+    // return how many times findString is in the buffer, for status
+    // display.  Matches do not overlap.  Counting again after an edit
+    // only counts the lines near the edit again
     
     CxEditBufferPosition cursor;
     // the current cursor position in the buffer
@@ -388,9 +423,45 @@ class CxEditBuffer
     int findAgainMultiLine( CxString findString, int skipIfCurrent );
     // multi-line find across line boundaries
 
+    int findMultiLine( CxString findString, unsigned long startRow, unsigned long startCol,
+                       CxEditBufferPosition *start, CxEditBufferPosition *end );
+    // find a multi-line findString without moving the cursor
+
     int replaceAgainMultiLine( CxString findString, CxString replaceString );
     // multi-line replace across line boundaries
 
+    CxEditBufferPosition replaceRegion( CxEditBufferPosition start, CxEditBufferPosition end,
+                                        CxString replaceString );
+    // replace the text from start up to end, which may be on a later row,
+    // with replaceString.  Return the position just after the replacement
+
+    CxString undoText( unsigned long row, unsigned long count );
+    // return count rows from row as text for the journal
+
+    void undoReplace( unsigned long row, unsigned long count, CxString text,
+                      unsigned long newCount );
+    // replace count rows from row with the newCount rows of text
+
+    unsigned long undoSave( unsigned long row, unsigned long count, int kind );
+    // record count rows from row before a change to them, return how many
+    // of them exist
+
+    void undoChanged( unsigned long count );
+    // record how many rows replaced the rows last saved
+
+    void undoBegin( void );
+    void undoEnd( void );
+    // bracket a command made of several changes, which undo together
+
+    void undoClose( void );
+    // end the step being recorded
+
+    CxEditHint undoApply( CxEditJournalStep *step, int backward );
+    // swap the rows of each change in step, last first if backward
+
+    CxEditJournal _journal;
+    // undo and redo history
+
     CxEditBufferPosition lastFindLocation;
     // holds the last find location
     
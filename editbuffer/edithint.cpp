@@ -22,7 +22,7 @@
 //
 //-------------------------------------------------------------------------
 CxEditHint::CxEditHint( void )
-:_startRow(0), _startCol(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
+:_startRow(0), _startCol(0), _endRow(0), _count(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
 {
 }
 
@@ -31,7 +31,7 @@ CxEditHint::CxEditHint( void )
 //
 //-------------------------------------------------------------------------
 CxEditHint::CxEditHint( CxEditHint::UPDATE_HINT updateHint_)
-:_startRow(0), _startCol(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
+:_startRow(0), _startCol(0), _endRow(0), _count(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
 {
     _startRow = 0;
     _startCol = 0;
@@ -43,7 +43,7 @@ CxEditHint::CxEditHint( CxEditHint::UPDATE_HINT updateHint_)
 //
 //-------------------------------------------------------------------------
 CxEditHint::CxEditHint( CxEditHint::CURSOR_HINT cursorHint_)
-:_startRow(0), _startCol(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
+:_startRow(0), _startCol(0), _endRow(0), _count(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
 {
     _startRow = 0;
     _startCol = 0;
@@ -55,7 +55,7 @@ CxEditHint::CxEditHint( CxEditHint::CURSOR_HINT cursorHint_)
 //
 //-------------------------------------------------------------------------
 CxEditHint::CxEditHint( CxEditHint::UPDATE_HINT updateHint_, CxEditHint::CURSOR_HINT cursorHint_)
-:_startRow(0), _startCol(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
+:_startRow(0), _startCol(0), _endRow(0), _count(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
 {
     _startRow = 0;
     _startCol = 0;
@@ -73,12 +73,33 @@ CxEditHint::CxEditHint(
     unsigned long startCol_,
     CxEditHint::UPDATE_HINT updateHint_,
     CxEditHint::CURSOR_HINT cursorHint_)
-:_startRow(0), _startCol(0), _updateHint(UPDATE_HINT_LINE), _cursorHint(CURSOR_HINT_NONE)
+:_startRow(0), _startCol(0), _endRow(0), _count(0), _updateHint(UPDATE_HINT_LINE), _cursorHint(CURSOR_HINT_NONE)
 {
     _startRow = startRow_;
     _startCol = startCol_;
     _updateHint = updateHint_;
     _cursorHint = cursorHint_;
+    _endRow = startRow_;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditHint:: (constructor)
+//
+//-------------------------------------------------------------------------
+CxEditHint::CxEditHint(
+    unsigned long startRow_,
+    unsigned long endRow_,
+    unsigned long count_,
+    CxEditHint::UPDATE_HINT updateHint_,
+    CxEditHint::CURSOR_HINT cursorHint_)
+:_startRow(0), _startCol(0), _endRow(0), _count(0), _updateHint(UPDATE_HINT_ROWS), _cursorHint(CURSOR_HINT_NONE)
+{
+    _startRow = startRow_;
+    _endRow = endRow_;
+    _count = count_;
+    _updateHint = updateHint_;
+    _cursorHint = cursorHint_;
 }
 
 
@@ -87,11 +108,13 @@ CxEditHint::CxEditHint(
 //
 //-------------------------------------------------------------------------
 CxEditHint::CxEditHint( const CxEditHint& hint_ )
-:_startRow(0), _startCol(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
+:_startRow(0), _startCol(0), _endRow(0), _count(0), _updateHint(UPDATE_HINT_NONE), _cursorHint(CURSOR_HINT_NONE)
 {
     if (&hint_ != this) {
         _startRow    = hint_._startRow;
         _startCol    = hint_._startCol;
+        _endRow      = hint_._endRow;
+        _count       = hint_._count;
         _updateHint  = hint_._updateHint;
         _cursorHint  = hint_._cursorHint;
     }
@@ -108,6 +131,8 @@ CxEditHint::operator=( const CxEditHint& hint_)
     if (&hint_ != this) {
         _startRow     = hint_._startRow;
         _startCol     = hint_._startCol;
+        _endRow       = hint_._endRow;
+        _count        = hint_._count;
         _updateHint   = hint_._updateHint;
         _cursorHint   = hint_._cursorHint;
     }
@@ -140,6 +165,18 @@ CxEditHint::startCol(void)
     return( _startCol );
 }
 
+int
+CxEditHint::endRow(void)
+{
+    return( _endRow );
+}
+
+unsigned long
+CxEditHint::count(void)
+{
+    return( _count );
+}
+
 void
 CxEditHint::printHint(void)
 {
@@ -161,6 +198,9 @@ CxEditHint::printHint(void)
             break;
         case UPDATE_HINT_SCREEN_PAST_POINT:     // update screen past row, col point
             updateStr.append("UPDATE_HINT_SCREEN_PAST_POINT");
+            break;
+        case UPDATE_HINT_ROWS:                  // update rows startRow through endRow
+            updateStr.append("UPDATE_HINT_ROWS");
     }
     
     switch( _cursorHint ) {
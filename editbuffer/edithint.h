@@ -25,6 +25,7 @@ class CxEditHint {
         UPDATE_HINT_LINE_PAST_POINT,       // update row line past col
         UPDATE_HINT_SCREEN,                // update entire screen
         UPDATE_HINT_SCREEN_PAST_POINT,     // update screen past row, col point
+        UPDATE_HINT_ROWS                   // update rows startRow through endRow
     };
     
     enum CURSOR_HINT {
@@ -40,6 +41,8 @@ class CxEditHint {
     
     unsigned long _startRow;                // update reference logical row
     unsigned long _startCol;                // update reference logical col
+    unsigned long _endRow;                  // last row changed, for a range
+    unsigned long _count;                   // changes made, for bulk edits
 
     CxEditHint::UPDATE_HINT _updateHint;  // the update hint
     CxEditHint::CURSOR_HINT _cursorHint;  // the cursor location hint
@@ -60,6 +63,10 @@ class CxEditHint {
     CxEditHint( unsigned long startRow_, unsigned long startCol_,
                CxEditHint::UPDATE_HINT hint_, CxEditHint::CURSOR_HINT cursorHint_ );
     // constructor
+
+    CxEditHint( unsigned long startRow_, unsigned long endRow_, unsigned long count_,
+               CxEditHint::UPDATE_HINT hint_, CxEditHint::CURSOR_HINT cursorHint_ );
+    // constructor for an edit of many rows
     
     CxEditHint( const CxEditHint& hint_ );
     // copy constructor
@@ -77,6 +84,12 @@ class CxEditHint {
     
     int startCol(void);
     // col
+
+    int endRow(void);
+    // last row changed
+
+    unsigned long count(void);
+    // number of changes made
     
     void printHint();
     
@@ -0,0 +1,881 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  editjournal.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxEditJournal Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <string.h>
+
+#include <cx/base/bytesearch.h>
+#include <cx/editbuffer/editjournal.h>
+
+
+//-------------------------------------------------------------------------
+// bytes held before old steps are dropped
+//
+//-------------------------------------------------------------------------
+#define JOURNAL_DEFAULT_LIMIT  (64UL * 1024 * 1024)
+
+
+//-------------------------------------------------------------------------
+// most keystrokes merged into one typing step
+//
+//-------------------------------------------------------------------------
+#define JOURNAL_TYPING_RUN  64
+
+
+//-------------------------------------------------------------------------
+// escapes a newline or itself inside a row
+//
+//-------------------------------------------------------------------------
+#define JOURNAL_ESCAPE  '\001'
+
+
+//-------------------------------------------------------------------------
+// lineOffset
+//
+// the offset just past the k'th newline of text, where row k starts
+//
+//-------------------------------------------------------------------------
+static unsigned long
+lineOffset( const CxString& text, unsigned long k )
+{
+    const char    *p = text.c_str();
+    unsigned long  n = text.length();
+    unsigned long  i = 0;
+
+    while (k > 0 && i < n) {
+        if (p[i] == '\n') k--;
+        i++;
+    }
+
+    return( i );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalDelta::CxEditJournalDelta
+//
+//-------------------------------------------------------------------------
+CxEditJournalDelta::CxEditJournalDelta( void )
+:row( 0 ), liveCount( 0 ), savedCount( 0 ), head( 0 ), tail( 0 )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalStep::CxEditJournalStep
+//
+//-------------------------------------------------------------------------
+CxEditJournalStep::CxEditJournalStep( void )
+:_delta( NULL ), _count( 0 ), _capacity( 0 ), _kind( CxEditJournal::EDIT ),
+ _trimmed( 0 ), _keystrokes( 0 )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalStep::~CxEditJournalStep
+//
+//-------------------------------------------------------------------------
+CxEditJournalStep::~CxEditJournalStep( void )
+{
+    for (int i = 0; i < _count; i++) {
+        delete _delta[i];
+    }
+
+    delete[] _delta;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalStep::deltas
+//
+//-------------------------------------------------------------------------
+int
+CxEditJournalStep::deltas( void )
+{
+    return( _count );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalStep::delta
+//
+//-------------------------------------------------------------------------
+CxEditJournalDelta *
+CxEditJournalStep::delta( int i )
+{
+    if (i < 0 || i >= _count) {
+        return( NULL );
+    }
+
+    return( _delta[i] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalStep::copyOf
+//
+//-------------------------------------------------------------------------
+CxEditJournalStep *
+CxEditJournalStep::copyOf( void )
+{
+    CxEditJournalStep *s = new CxEditJournalStep();
+
+    s->before      = before;
+    s->after       = after;
+    s->_kind       = _kind;
+    s->_trimmed    = _trimmed;
+    s->_keystrokes = _keystrokes;
+
+    for (int i = 0; i < _count; i++) {
+        s->add( new CxEditJournalDelta( *_delta[i] ) );
+    }
+
+    return( s );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalStep::add
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournalStep::add( CxEditJournalDelta *d )
+{
+    if (_count == _capacity) {
+
+        int capacity = (_capacity == 0) ? 4 : _capacity * 2;
+
+        CxEditJournalDelta **grown = new CxEditJournalDelta *[ capacity ];
+
+        if (_count > 0) {
+            memcpy( grown, _delta, _count * sizeof( CxEditJournalDelta * ) );
+        }
+
+        delete[] _delta;
+
+        _delta    = grown;
+        _capacity = capacity;
+    }
+
+    _delta[ _count++ ] = d;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalStep::removeAt
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournalStep::removeAt( int i )
+{
+    delete _delta[i];
+
+    for (int k = i; k < _count - 1; k++) {
+        _delta[k] = _delta[k+1];
+    }
+
+    _count--;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournalStep::size
+//
+//-------------------------------------------------------------------------
+unsigned long
+CxEditJournalStep::size( void )
+{
+    unsigned long n = sizeof( CxEditJournalStep );
+
+    for (int i = 0; i < _count; i++) {
+        n = n + sizeof( CxEditJournalDelta ) + _delta[i]->saved.length();
+    }
+
+    return( n );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::CxEditJournal
+//
+//-------------------------------------------------------------------------
+CxEditJournal::CxEditJournal( void )
+:_undo( NULL ), _undoCount( 0 ), _undoCapacity( 0 ),
+ _redo( NULL ), _redoCount( 0 ), _redoCapacity( 0 ),
+ _open( NULL ), _depth( 0 ), _span( 0 ), _spanCount( 0 ),
+ _bytes( 0 ), _limit( JOURNAL_DEFAULT_LIMIT )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::CxEditJournal (copy constructor)
+//
+//-------------------------------------------------------------------------
+CxEditJournal::CxEditJournal( const CxEditJournal& j )
+:_undo( NULL ), _undoCount( 0 ), _undoCapacity( 0 ),
+ _redo( NULL ), _redoCount( 0 ), _redoCapacity( 0 ),
+ _open( NULL ), _depth( 0 ), _span( 0 ), _spanCount( 0 ),
+ _bytes( 0 ), _limit( JOURNAL_DEFAULT_LIMIT )
+{
+    copyFrom( j );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::operator=
+//
+//-------------------------------------------------------------------------
+CxEditJournal&
+CxEditJournal::operator=( const CxEditJournal& j )
+{
+    if (&j != this) {
+        clear();
+        copyFrom( j );
+    }
+
+    return( *this );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::~CxEditJournal
+//
+//-------------------------------------------------------------------------
+CxEditJournal::~CxEditJournal( void )
+{
+    clear();
+
+    delete[] _undo;
+    delete[] _redo;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::copyFrom
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::copyFrom( const CxEditJournal& j )
+{
+    for (int i = 0; i < j._undoCount; i++) {
+        push( &_undo, &_undoCount, &_undoCapacity, j._undo[i]->copyOf() );
+    }
+
+    for (int i = 0; i < j._redoCount; i++) {
+        push( &_redo, &_redoCount, &_redoCapacity, j._redo[i]->copyOf() );
+    }
+
+    _open      = (j._open != NULL) ? j._open->copyOf() : NULL;
+    _depth     = j._depth;
+    _span      = j._span;
+    _spanCount = j._spanCount;
+    _bytes     = j._bytes;
+    _limit     = j._limit;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::clear
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::clear( void )
+{
+    for (int i = 0; i < _undoCount; i++) {
+        delete _undo[i];
+    }
+
+    _undoCount = 0;
+
+    clearRedo();
+
+    delete _open;
+    _open = NULL;
+
+    _depth     = 0;
+    _span      = 0;
+    _spanCount = 0;
+    _bytes     = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::clearRedo
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::clearRedo( void )
+{
+    for (int i = 0; i < _redoCount; i++) {
+        _bytes = _bytes - _redo[i]->size();
+        delete _redo[i];
+    }
+
+    _redoCount = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::setLimit
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::setLimit( unsigned long bytes_ )
+{
+    _limit = bytes_;
+
+    enforceLimit();
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::bytes
+//
+//-------------------------------------------------------------------------
+unsigned long
+CxEditJournal::bytes( void )
+{
+    return( _bytes );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::canUndo
+//
+//-------------------------------------------------------------------------
+int
+CxEditJournal::canUndo( void )
+{
+    return( _undoCount > 0 || _open != NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::canRedo
+//
+//-------------------------------------------------------------------------
+int
+CxEditJournal::canRedo( void )
+{
+    return( _redoCount > 0 && _open == NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::begin
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::begin( void )
+{
+    _depth++;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::end
+//
+//-------------------------------------------------------------------------
+int
+CxEditJournal::end( CxEditBufferPosition cursor )
+{
+    if (_depth > 0) {
+        _depth--;
+    }
+
+    if (_open != NULL) {
+        _open->after = cursor;
+    }
+
+    return( _depth == 0 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::depth
+//
+//-------------------------------------------------------------------------
+int
+CxEditJournal::depth( void )
+{
+    return( _depth );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::continues
+//
+// Inside a command every change joins the step it opened.  Outside one
+// only typing joins typing, and only where it touches the last change.
+//-------------------------------------------------------------------------
+int
+CxEditJournal::continues( unsigned long row, unsigned long count, int kind )
+{
+    if (_open == NULL) {
+        return( FALSE );
+    }
+
+    if (_depth > 0) {
+        return( TRUE );
+    }
+
+    if (kind != TYPING || _open->_kind != TYPING) {
+        return( FALSE );
+    }
+
+    if (_open->_keystrokes >= JOURNAL_TYPING_RUN) {
+        return( FALSE );
+    }
+
+    return( touches( row, count ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::touches
+//
+//-------------------------------------------------------------------------
+int
+CxEditJournal::touches( unsigned long row, unsigned long count )
+{
+    CxEditJournalDelta *last = untrimmed();
+
+    if (last == NULL) {
+        return( FALSE );
+    }
+
+    unsigned long lastEnd = last->row + last->liveCount;
+
+    // rows that are only next to it start a change of their own, so each
+    // line of a command that goes down the file is trimmed by itself.  A
+    // change of no rows has nothing to overlap
+
+    if (count == 0 || last->liveCount == 0) {
+        return( row <= lastEnd && row + count >= last->row );
+    }
+
+    return( row < lastEnd && row + count > last->row );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::covers
+//
+//-------------------------------------------------------------------------
+int
+CxEditJournal::covers( unsigned long row, unsigned long count )
+{
+    CxEditJournalDelta *last = untrimmed();
+
+    if (last == NULL) {
+        return( FALSE );
+    }
+
+    return( row >= last->row && row + count <= last->row + last->liveCount );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::save
+//
+// A change that touches the last one is merged into it.  The rows of the
+// new change outside the last one's have not changed since the step was
+// opened, so they are added to its saved text as they are now.  A command
+// that saves the whole region it is about to change first makes every
+// change after it inside the last one, and those cost nothing.
+//-------------------------------------------------------------------------
+void
+CxEditJournal::save( unsigned long row, unsigned long count, const CxString& text, int kind,
+                     CxEditBufferPosition cursor )
+{
+    if (_open == NULL) {
+
+        clearRedo();
+
+        _open = new CxEditJournalStep();
+        _open->_kind  = (_depth > 0) ? EDIT : kind;
+        _open->before = cursor;
+        _open->after  = cursor;
+    }
+
+    _open->_keystrokes++;
+    _spanCount = count;
+
+    if (touches( row, count )) {
+
+        CxEditJournalDelta *last = untrimmed();
+
+        unsigned long lastEnd = last->row + last->liveCount;
+
+        unsigned long above = (row < last->row) ? last->row - row : 0;
+        unsigned long below = (row + count > lastEnd) ? row + count - lastEnd : 0;
+
+        CxString rows = text;
+
+        if (above > 0) {
+
+            CxString merged = rows.subString( 0, (int) lineOffset( rows, above ) );
+            merged += last->saved;
+            last->saved = merged;
+        }
+
+        if (below > 0) {
+
+            unsigned long belowStart = lineOffset( rows, count - below );
+
+            last->saved += rows.subString( (int) belowStart, (int) (rows.length() - belowStart) );
+        }
+
+        last->savedCount = last->savedCount + above + below;
+
+        unsigned long first = (row < last->row) ? row : last->row;
+        unsigned long end   = (row + count > lastEnd) ? row + count : lastEnd;
+
+        last->row = first;
+        _span     = end - first;
+
+        return;
+    }
+
+    // the last change is complete, kept whole if it was not trimmed
+
+    _open->_trimmed = _open->_count;
+
+    CxEditJournalDelta *d = new CxEditJournalDelta();
+
+    d->row        = row;
+    d->liveCount  = count;
+    d->savedCount = count;
+    d->saved      = text;
+
+    _open->add( d );
+
+    _span = count;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::changed
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::changed( unsigned long count, CxEditBufferPosition cursor )
+{
+    CxEditJournalDelta *last = untrimmed();
+
+    if (last == NULL) {
+        return;
+    }
+
+    last->liveCount = _span - _spanCount + count;
+
+    _open->after = cursor;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::untrimmed
+//
+//-------------------------------------------------------------------------
+CxEditJournalDelta *
+CxEditJournal::untrimmed( void )
+{
+    if (_open == NULL || _open->_count == _open->_trimmed) {
+        return( NULL );
+    }
+
+    return( _open->_delta[ _open->_count - 1 ] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::trimLast
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::trimLast( const CxString& live )
+{
+    CxEditJournalDelta *d = untrimmed();
+
+    if (d == NULL) {
+        return;
+    }
+
+    CxString       s     = d->saved;
+    const char    *sp    = s.c_str();
+    const char    *lp    = live.c_str();
+    unsigned long  sLen  = s.length();
+    unsigned long  lLen  = live.length();
+    unsigned long  most  = (sLen < lLen) ? sLen : lLen;
+    unsigned long  head  = 0;
+    unsigned long  tail  = 0;
+
+    while (head < most && sp[head] == lp[head]) {
+        head++;
+    }
+
+    while (tail < most - head && sp[sLen - 1 - tail] == lp[lLen - 1 - tail]) {
+        tail++;
+    }
+
+    // the rows are as they were before the change, nothing to undo
+
+    if (sLen == lLen && head == sLen) {
+        _open->removeAt( _open->_count - 1 );
+        _open->_trimmed = _open->_count;
+        return;
+    }
+
+    d->saved = s.subString( (int) head, (int) (sLen - head - tail) );
+    d->head  = head;
+    d->tail  = tail;
+
+    _open->_trimmed = _open->_count;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::close
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::close( void )
+{
+    if (_open == NULL) {
+        return;
+    }
+
+    CxEditJournalStep *step = _open;
+
+    _open      = NULL;
+    _span      = 0;
+    _spanCount = 0;
+
+    if (step->_count == 0) {
+        delete step;
+        return;
+    }
+
+    _bytes = _bytes + step->size();
+
+    push( &_undo, &_undoCount, &_undoCapacity, step );
+
+    enforceLimit();
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::undoStep
+//
+//-------------------------------------------------------------------------
+CxEditJournalStep *
+CxEditJournal::undoStep( void )
+{
+    if (_open != NULL || _undoCount == 0) {
+        return( NULL );
+    }
+
+    CxEditJournalStep *step = _undo[ --_undoCount ];
+
+    push( &_redo, &_redoCount, &_redoCapacity, step );
+
+    return( step );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::redoStep
+//
+//-------------------------------------------------------------------------
+CxEditJournalStep *
+CxEditJournal::redoStep( void )
+{
+    if (_open != NULL || _redoCount == 0) {
+        return( NULL );
+    }
+
+    CxEditJournalStep *step = _redo[ --_redoCount ];
+
+    push( &_undo, &_undoCount, &_undoCapacity, step );
+
+    return( step );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::swap
+//
+// The shared head and tail are taken from live, they are the same in both
+// versions.  They are clamped in case the rows were changed behind the
+// journal's back, which leaves the text wrong but the buffer whole.
+//-------------------------------------------------------------------------
+CxString
+CxEditJournal::swap( CxEditJournalDelta *d, const CxString& live )
+{
+    CxString       rows   = live;
+    unsigned long  length = rows.length();
+    unsigned long  head   = (d->head < length) ? d->head : length;
+    unsigned long  tail   = (d->tail < length - head) ? d->tail : length - head;
+
+    CxString middle = rows.subString( (int) head, (int) (length - head - tail) );
+
+    CxString result = rows.subString( 0, (int) head );
+    result += d->saved;
+    result += rows.subString( (int) (length - tail), (int) tail );
+
+    _bytes = _bytes + middle.length() - d->saved.length();
+
+    d->saved = middle;
+
+    unsigned long count = d->liveCount;
+    d->liveCount  = d->savedCount;
+    d->savedCount = count;
+
+    return( result );
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::push
+//
+//-------------------------------------------------------------------------
+void
+CxEditJournal::push( CxEditJournalStep ***list, int *count, int *capacity, CxEditJournalStep *step )
+{
+    if (*count == *capacity) {
+
+        int grownCapacity = (*capacity == 0) ? 16 : *capacity * 2;
+
+        CxEditJournalStep **grown = new CxEditJournalStep *[ grownCapacity ];
+
+        if (*count > 0) {
+            memcpy( grown, *list, *count * sizeof( CxEditJournalStep * ) );
+        }
+
+        delete[] *list;
+
+        *list     = grown;
+        *capacity = grownCapacity;
+    }
+
+    (*list)[ (*count)++ ] = step;
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::enforceLimit
+//
+// The oldest undo goes first, then the redo furthest away.  A step larger
+// than the limit by itself is dropped too, leaving nothing to undo.
+//-------------------------------------------------------------------------
+void
+CxEditJournal::enforceLimit( void )
+{
+    while (_bytes > _limit && (_undoCount > 0 || _redoCount > 0)) {
+
+        CxEditJournalStep ***list  = (_undoCount > 0) ? &_undo      : &_redo;
+        int                 *count = (_undoCount > 0) ? &_undoCount : &_redoCount;
+
+        CxEditJournalStep *oldest = (*list)[0];
+
+        _bytes = _bytes - oldest->size();
+        delete oldest;
+
+        memmove( *list, *list + 1, (*count - 1) * sizeof( CxEditJournalStep * ) );
+        (*count)--;
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::appendRow
+//
+// Rows hardly ever hold a newline or the escape, so most are copied whole.
+//-------------------------------------------------------------------------
+void
+CxEditJournal::appendRow( CxString *text, const CxString& row )
+{
+    const char    *p = row.c_str();
+    unsigned long  n = row.length();
+
+    if (CxByteSearch::findByte( p, n, '\n' ) == NULL &&
+        CxByteSearch::findByte( p, n, JOURNAL_ESCAPE ) == NULL) {
+
+        *text += row;
+        *text += '\n';
+        return;
+    }
+
+    for (unsigned long i = 0; i < n; i++) {
+
+        if (p[i] == '\n') {
+            *text += JOURNAL_ESCAPE;
+            *text += 'n';
+        } else if (p[i] == JOURNAL_ESCAPE) {
+            *text += JOURNAL_ESCAPE;
+            *text += JOURNAL_ESCAPE;
+        } else {
+            *text += p[i];
+        }
+    }
+
+    *text += '\n';
+}
+
+
+//-------------------------------------------------------------------------
+// CxEditJournal::nextRow
+//
+//-------------------------------------------------------------------------
+CxString
+CxEditJournal::nextRow( const CxString& text, unsigned long *offset )
+{
+    const char    *p       = text.c_str();
+    unsigned long  n       = text.length();
+    unsigned long  start   = *offset;
+    unsigned long  end     = start;
+    int            escaped = FALSE;
+
+    while (end < n && p[end] != '\n') {
+        if (p[end] == JOURNAL_ESCAPE) {
+            escaped = TRUE;
+            end++;
+        }
+        end++;
+    }
+
+    if (end > n) {
+        end = n;
+    }
+
+    *offset = (end < n) ? end + 1 : n;
+
+    if (!escaped) {
+        return( CxString( p + start, (int) (end - start) ) );
+    }
+
+    CxString row;
+
+    for (unsigned long i = start; i < end; i++) {
+
+        if (p[i] == JOURNAL_ESCAPE && i + 1 < end) {
+            i++;
+            row += (p[i] == 'n') ? '\n' : p[i];
+        } else {
+            row += p[i];
+        }
+    }
+
+    return( row );
+}
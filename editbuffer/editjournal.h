@@ -0,0 +1,268 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  editjournal.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxEditJournal Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include <cx/base/string.h>
+#include <cx/editbuffer/editbufferpos.h>
+
+#ifndef _CxEditJournal_h_
+#define _CxEditJournal_h_
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+
+//-------------------------------------------------------------------------
+// class CxEditJournalDelta
+//
+// One change to a run of rows.  The rows are written as text, each row
+// followed by a newline, so no rows at all and one empty row differ (see
+// CxEditJournal::appendRow).
+// saved holds the other version of the run, with head bytes at the start
+// and tail bytes at the end left out because both versions share them.
+// Putting saved back takes out the version in the buffer, which becomes
+// the new saved, so undo and redo are the same swap.
+//
+//-------------------------------------------------------------------------
+class CxEditJournalDelta
+{
+  public:
+
+    CxEditJournalDelta( void );
+    // constructor
+
+    unsigned long  row;           // first row of the run
+    unsigned long  liveCount;     // rows of the run in the buffer
+    unsigned long  savedCount;    // rows of the other version
+    unsigned long  head;          // bytes shared at the start
+    unsigned long  tail;          // bytes shared at the end
+    CxString       saved;         // the other version, less head and tail
+};
+
+
+//-------------------------------------------------------------------------
+// class CxEditJournalStep
+//
+// The changes one command made, undone together.  Changes are put back
+// last first on undo and first first on redo.
+//
+//-------------------------------------------------------------------------
+class CxEditJournalStep
+{
+  public:
+
+    CxEditJournalStep( void );
+    // constructor
+
+    ~CxEditJournalStep( void );
+    // destructor
+
+    int deltas( void );
+    // return the number of changes
+
+    CxEditJournalDelta *delta( int i );
+    // return change i
+
+    CxEditBufferPosition before;  // cursor before the command
+    CxEditBufferPosition after;   // cursor after it
+
+  private:
+
+    friend class CxEditJournal;
+
+    CxEditJournalStep( const CxEditJournalStep& s );
+    CxEditJournalStep& operator=( const CxEditJournalStep& s );
+    // steps are copied with copyOf
+
+    CxEditJournalStep *copyOf( void );
+    // return a new step with the same changes
+
+    void add( CxEditJournalDelta *d );
+    // add a change at the end
+
+    void removeAt( int i );
+    // delete change i
+
+    unsigned long size( void );
+    // bytes held
+
+    CxEditJournalDelta **_delta;
+    int                  _count;
+    int                  _capacity;
+    int                  _kind;
+    int                  _trimmed;     // changes before this are trimmed
+    int                  _keystrokes;  // typing changes merged in
+};
+
+
+//-------------------------------------------------------------------------
+// class CxEditJournal
+//
+// Undo history for an edit buffer.  The buffer reports each change as
+// the rows it is about to change, with their text, and then how many
+// rows replace them.  A change over the last one made by the same
+// command, or by the typing just before it, is merged into it, so a run
+// of keystrokes on a line is one change holding the line as it was.
+// Once a change is complete it is cut down to the bytes that differ from
+// the buffer, so a keystroke costs a few bytes and retabbing a file keeps
+// only the leading white space of the lines it changed.
+//
+// The journal never touches the buffer.  The buffer reads rows for it
+// and puts back the text swap() returns, so both CxEditBuffer and
+// CxUTFEditBuffer use it.  Undo and redo cost the size of the changes
+// they put back.  Old steps are dropped once the journal holds more
+// than its limit.
+//
+//-------------------------------------------------------------------------
+class CxEditJournal
+{
+  public:
+
+    enum KIND {
+        EDIT,                   // a command, one step
+        TYPING                  // keystrokes, merged with the typing before
+    };
+
+    CxEditJournal( void );
+    // constructor
+
+    CxEditJournal( const CxEditJournal& j );
+    // copy constructor, copies the history
+
+    CxEditJournal& operator=( const CxEditJournal& j );
+    // assignment operator
+
+    ~CxEditJournal( void );
+    // destructor
+
+    void clear( void );
+    // forget everything
+
+    void setLimit( unsigned long bytes );
+    // most bytes to hold, old steps are dropped past it
+
+    unsigned long bytes( void );
+    // bytes held
+
+    int canUndo( void );
+    int canRedo( void );
+    // return TRUE if there is a step to undo or redo
+
+    //----- recording -----
+
+    void begin( void );
+    // start a command made of several changes, every change until the
+    // matching end() is one step.  Commands may nest
+
+    int end( CxEditBufferPosition cursor );
+    // end a command.  Return TRUE when the outermost one ends and the open
+    // step should be closed
+
+    int depth( void );
+    // return how many commands are open
+
+    int continues( unsigned long row, unsigned long count, int kind );
+    // return TRUE if a change to count rows from row belongs to the open
+    // step.  If not the buffer closes the open step before saving
+
+    int touches( unsigned long row, unsigned long count );
+    // return TRUE if count rows from row overlap the last change saved,
+    // which has not been trimmed.  A change there is merged into it
+
+    int covers( unsigned long row, unsigned long count );
+    // return TRUE if count rows from row are inside the last change saved,
+    // a change there needs no text of its own
+
+    void save( unsigned long row, unsigned long count, const CxString& text, int kind,
+               CxEditBufferPosition cursor );
+    // record count rows from row, as text, before they change.  text may
+    // be empty if covers() is TRUE
+
+    void changed( unsigned long count, CxEditBufferPosition cursor );
+    // record how many rows replaced the rows last saved
+
+    CxEditJournalDelta *untrimmed( void );
+    // return the last change of the open step if it has not been trimmed,
+    // or NULL
+
+    void trimLast( const CxString& live );
+    // cut the last change down to the bytes that differ from live, the
+    // text of its rows in the buffer, or drop it if it left them as they
+    // were.  Call it before a change that does not touch it, while its
+    // rows are where it was recorded; it is never merged into again
+
+    void close( void );
+    // end the open step and put it on the undo list.  A last change not
+    // trimmed is kept whole
+
+    //----- replaying -----
+
+    CxEditJournalStep *undoStep( void );
+    // return the step to undo and move it to the redo list, NULL if none
+
+    CxEditJournalStep *redoStep( void );
+    // return the step to redo and move it to the undo list, NULL if none
+
+    CxString swap( CxEditJournalDelta *d, const CxString& live );
+    // given live, the text of the rows of d in the buffer, return the text
+    // to put in their place.  d then holds what was taken out
+
+    //----- row text -----
+
+    static void appendRow( CxString *text, const CxString& row );
+    // add row to text followed by a newline.  A newline in the row itself
+    // is escaped, so the text splits back into the same rows
+
+    static CxString nextRow( const CxString& text, unsigned long *offset );
+    // return the row at offset in text and move offset past it
+
+  private:
+
+    void copyFrom( const CxEditJournal& j );
+    // copy the history of j
+
+    void clearRedo( void );
+    // drop every step that could be redone
+
+    void push( CxEditJournalStep ***list, int *count, int *capacity, CxEditJournalStep *step );
+    // add step to the end of a list
+
+    void enforceLimit( void );
+    // drop the oldest steps until the journal fits its limit
+
+    CxEditJournalStep  **_undo;         // oldest first
+    int                  _undoCount;
+    int                  _undoCapacity;
+
+    CxEditJournalStep  **_redo;         // next to redo last
+    int                  _redoCount;
+    int                  _redoCapacity;
+
+    CxEditJournalStep   *_open;         // step being recorded, or NULL
+    int                  _depth;
+
+    unsigned long        _span;         // rows the last save's change spans
+    unsigned long        _spanCount;    // rows of it being replaced
+
+    unsigned long        _bytes;
+    unsigned long        _limit;
+};
+
+
+#endif
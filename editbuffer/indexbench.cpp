@@ -0,0 +1,192 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  indexbench.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  indexbench.cpp
+//
+//  Times finding every line of a large file, once with the single byte
+//  loop initLazy used to run and once with CxLineIndexer on 1, 2, 4 and 8
+//  threads, and checks that they agree.  Not part of the library, build
+//  it against the cx libraries from this directory, all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o indexbench indexbench.cpp
+//        -L../../lib/linux_x86_64 -lcx_editbuffer -lcx_thread -lcx_base
+//        -lpthread
+//
+//  Run as "indexbench [file] [megabytes]".  If the file is not there it
+//  is written first, the default is /tmp/indexbench.txt of 1024 MB.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include <cx/editbuffer/textsource.h>
+#include <cx/editbuffer/lineindexer.h>
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+//-------------------------------------------------------------------------
+// writeFile
+//
+// lines of 20 to 120 characters, about the mix of a source tree or a log
+//
+//-------------------------------------------------------------------------
+static int
+writeFile( const char *path, unsigned long megabytes )
+{
+    FILE *f = fopen( path, "w" );
+    if (f == NULL) return FALSE;
+
+    unsigned long bytes   = megabytes * 1024 * 1024;
+    unsigned long written = 0;
+    unsigned int  x       = 1;
+    char          line[160];
+
+    while (written < bytes) {
+
+        x = x * 1103515245 + 12345;
+        int length = 20 + (x >> 8) % 100;
+
+        int n = sprintf( line, "%lu ", written );
+        while (n < length) {
+            line[n] = 'a' + (n % 26);
+            n++;
+        }
+        line[n++] = '\n';
+
+        fwrite( line, 1, n, f );
+        written += n;
+    }
+
+    fclose( f );
+    return TRUE;
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+    const char   *path      = argc > 1 ? argv[1] : "/tmp/indexbench.txt";
+    unsigned long megabytes = argc > 2 ? atol( argv[2] ) : 1024;
+
+    FILE *f = fopen( path, "r" );
+    if (f != NULL) {
+        fclose( f );
+    } else {
+        printf( "writing %lu MB to %s\n", megabytes, path );
+        if (!writeFile( path, megabytes )) {
+            printf( "cannot write %s\n", path );
+            return 1;
+        }
+    }
+
+    CxTextSource *source = CxTextSource::map( path );
+    if (source == NULL) {
+        printf( "cannot map %s\n", path );
+        return 1;
+    }
+
+    const char   *bytes = source->bytes();
+    unsigned long size  = source->size();
+
+    // touch every page first so no run pays for reading the file
+
+    volatile unsigned long sink = 0;
+    for (unsigned long i = 0; i < size; i += 4096) sink += bytes[i];
+
+    // the serial loop: count the newlines, then walk again for the lines
+
+    double start = now();
+
+    unsigned long lines = 0;
+    for (unsigned long i = 0; i < size; i++) {
+        if (bytes[i] == '\n') lines++;
+    }
+
+    unsigned long *offsets = new unsigned long[lines + 1];
+    unsigned long *lengths = new unsigned long[lines + 1];
+    unsigned long  line    = 0;
+    unsigned long  begin   = 0;
+
+    for (unsigned long i = 0; i < size; i++) {
+        if (bytes[i] == '\n') {
+            offsets[line] = begin;
+            lengths[line] = i - begin;
+            line++;
+            begin = i + 1;
+        }
+    }
+    offsets[lines] = begin;
+
+    double serial = now() - start;
+
+    printf( "%.1f MB, %lu lines, %d processors\n",
+            size / 1048576.0, lines, CxLineIndexer::threadsToUse() );
+    printf( "serial byte loop            %7.3f s  %6.2f GB/s\n", serial, size / serial / 1e9 );
+
+    int failed = 0;
+
+    for (int threads = 1; threads <= 8; threads += threads) {
+
+        start = now();
+
+        CxLineIndexer indexer( bytes, 0, size, threads );
+        unsigned long count = indexer.count();
+
+        unsigned long *o = new unsigned long[count + 1];
+        unsigned long *l = new unsigned long[count + 1];
+        indexer.locate( o, l );
+
+        double elapsed = now() - start;
+
+        printf( "CxLineIndexer, %d thread%s  %7.3f s  %6.2f GB/s\n",
+                threads, threads == 1 ? " " : "s", elapsed, size / elapsed / 1e9 );
+
+        if (count != lines) {
+            failed = 1;
+        } else {
+            for (unsigned long i = 0; i < count; i++) {
+                if (o[i] != offsets[i] || l[i] != lengths[i]) {
+                    failed = 1;
+                    break;
+                }
+            }
+            if (o[count] != offsets[lines]) failed = 1;
+        }
+
+        delete [] o;
+        delete [] l;
+    }
+
+    delete [] offsets;
+    delete [] lengths;
+
+    source->release();
+
+    printf( failed ? "FAILED\n" : "passed\n" );
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,289 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  lineindexer.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxLineIndexer Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#if defined(_LINUX_) || defined(_OSX_)
+#include <unistd.h>
+#include <cx/thread/threadpool.h>
+#endif
+
+#include <cx/base/bytesearch.h>
+#include <cx/editbuffer/lineindexer.h>
+
+
+//-------------------------------------------------------------------------
+// more threads than this only fight over memory bandwidth
+//
+//-------------------------------------------------------------------------
+#define LINEINDEXER_MAX_THREADS  8
+
+#define PASS_COUNT   0
+#define PASS_LOCATE  1
+
+
+//-------------------------------------------------------------------------
+// class CxLineIndexer::Piece
+//
+// One thread's part of the text
+//
+//-------------------------------------------------------------------------
+class CxLineIndexer::Piece
+{
+  public:
+
+    Piece( void ) : start( NULL ), end( NULL ), newlines( 0 ), firstLine( 0 ) { }
+
+    void count( void );
+    // count the newlines in the piece
+
+    void locate( const char *bytes, unsigned long *offsets, unsigned long *lengths );
+    // write the offsets and lengths of the lines ending in the piece
+
+    const char    *start;
+    const char    *end;
+    unsigned long  newlines;
+    unsigned long  firstLine;
+};
+
+
+//-------------------------------------------------------------------------
+// CxLineIndexer::Piece::count
+//
+//-------------------------------------------------------------------------
+void
+CxLineIndexer::Piece::count( void )
+{
+    newlines = CxByteSearch::countByte( start, end - start, '\n' );
+}
+
+
+//-------------------------------------------------------------------------
+// CxLineIndexer::Piece::locate
+//
+// The first line of a piece usually began in the piece before, so its
+// start is not known here.  Its length is left as the offset of its
+// newline and corrected once every piece is done.
+//-------------------------------------------------------------------------
+void
+CxLineIndexer::Piece::locate( const char *bytes, unsigned long *offsets, unsigned long *lengths )
+{
+    const char   *p    = start;
+    unsigned long line = firstLine;
+
+    while (p < end) {
+
+        const char *nl = CxByteSearch::findByte( p, end - p, '\n' );
+        if (nl == NULL) break;
+
+        unsigned long at = nl - bytes;
+
+        if (line == firstLine) {
+            lengths[line] = at;
+        } else {
+            lengths[line] = at - offsets[line];
+        }
+
+        offsets[line+1] = at + 1;
+
+        line++;
+        p = nl + 1;
+    }
+}
+
+
+#if defined(_LINUX_) || defined(_OSX_)
+
+//-------------------------------------------------------------------------
+// class CxLineIndexTask
+//
+// runs one pass over one piece on a pool thread
+//
+//-------------------------------------------------------------------------
+class CxLineIndexTask : public CxRunnable
+{
+  public:
+
+    CxLineIndexTask( CxLineIndexer::Piece *piece_, int pass_, const char *bytes_,
+                     unsigned long *offsets_, unsigned long *lengths_ )
+    : piece( piece_ ), pass( pass_ ), bytes( bytes_ ), offsets( offsets_ ), lengths( lengths_ ) { }
+
+    virtual void run( void )
+    {
+        if (pass == PASS_COUNT) {
+            piece->count();
+        } else {
+            piece->locate( bytes, offsets, lengths );
+        }
+    }
+
+  private:
+
+    CxLineIndexer::Piece *piece;
+    int                   pass;
+    const char           *bytes;
+    unsigned long        *offsets;
+    unsigned long        *lengths;
+};
+
+#endif
+
+
+//-------------------------------------------------------------------------
+// CxLineIndexer::CxLineIndexer
+//
+//-------------------------------------------------------------------------
+CxLineIndexer::CxLineIndexer( const char *bytes, unsigned long from, unsigned long to, int threads )
+:_bytes( bytes ), _from( from ), _pieces( NULL ), _nPieces( 0 ), _counted( 0 )
+{
+    if (threads < 1) threads = 1;
+
+    unsigned long size = to - from;
+    unsigned long each = size / threads;
+
+    // pieces too small to be worth a thread are merged
+
+    if (each < 1024 * 1024) {
+        threads = 1;
+        each = size;
+    }
+
+    _nPieces = threads;
+    _pieces  = new Piece[ _nPieces ];
+
+    for (int k=0; k<_nPieces; k++) {
+        _pieces[k].start = bytes + from + k * each;
+        _pieces[k].end   = (k == _nPieces-1) ? bytes + to : _pieces[k].start + each;
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// CxLineIndexer::~CxLineIndexer
+//
+//-------------------------------------------------------------------------
+CxLineIndexer::~CxLineIndexer( void )
+{
+    delete[] _pieces;
+}
+
+
+//-------------------------------------------------------------------------
+// CxLineIndexer::runPass
+//
+// the pool's workers end once the quit requests behind the work reach
+// them, so joining them means every piece has run
+//-------------------------------------------------------------------------
+void
+CxLineIndexer::runPass( int pass, unsigned long *offsets, unsigned long *lengths )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+    if (_nPieces > 1) {
+
+        CxThreadPool pool( _nPieces, 2 * _nPieces );
+        pool.start();
+
+        for (int k=0; k<_nPieces; k++) {
+            pool.enQueue( new CxLineIndexTask( &_pieces[k], pass, _bytes, offsets, lengths ) );
+        }
+
+        pool.suggestQuit();
+        pool.join();
+
+        return;
+    }
+#endif
+
+    for (int k=0; k<_nPieces; k++) {
+        if (pass == PASS_COUNT) {
+            _pieces[k].count();
+        } else {
+            _pieces[k].locate( _bytes, offsets, lengths );
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// CxLineIndexer::count
+//
+//-------------------------------------------------------------------------
+unsigned long
+CxLineIndexer::count( void )
+{
+    if (!_counted) {
+
+        runPass( PASS_COUNT, NULL, NULL );
+
+        unsigned long line = 0;
+        for (int k=0; k<_nPieces; k++) {
+            _pieces[k].firstLine = line;
+            line += _pieces[k].newlines;
+        }
+
+        _counted = 1;
+    }
+
+    unsigned long total = 0;
+    for (int k=0; k<_nPieces; k++) {
+        total += _pieces[k].newlines;
+    }
+
+    return( total );
+}
+
+
+//-------------------------------------------------------------------------
+// CxLineIndexer::locate
+//
+//-------------------------------------------------------------------------
+void
+CxLineIndexer::locate( unsigned long *offsets, unsigned long *lengths )
+{
+    count();
+
+    offsets[0] = _from;
+
+    runPass( PASS_LOCATE, offsets, lengths );
+
+    // the first line of each piece now has its start, written by the
+    // piece before
+
+    for (int k=0; k<_nPieces; k++) {
+        if (_pieces[k].newlines) {
+            unsigned long first = _pieces[k].firstLine;
+            lengths[first] = lengths[first] - offsets[first];
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// CxLineIndexer::threadsToUse
+//
+//-------------------------------------------------------------------------
+/* static */
+int
+CxLineIndexer::threadsToUse( void )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+    long n = sysconf( _SC_NPROCESSORS_ONLN );
+
+    if (n < 1) return( 1 );
+    if (n > LINEINDEXER_MAX_THREADS) return( LINEINDEXER_MAX_THREADS );
+
+    return( (int) n );
+#else
+    return( 1 );
+#endif
+}
@@ -0,0 +1,73 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  lineindexer.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxLineIndexer Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#ifndef _CxLineIndexer_h_
+#define _CxLineIndexer_h_
+
+
+//-------------------------------------------------------------------------
+// class CxLineIndexer
+//
+// Finds the lines in a large block of text on several threads.  The text
+// is cut into one piece per thread.  A first pass counts the newlines in
+// every piece, which tells each piece the number of its first line, and
+// a second pass has every piece write the start and length of its own
+// lines.  Both passes run on a CxThreadPool; with one thread, or where
+// there are no threads, the pieces run in turn on the caller's thread.
+//
+// CxStringList uses this when it has to index all of a big source.
+//
+//-------------------------------------------------------------------------
+class CxLineIndexer
+{
+  public:
+
+    CxLineIndexer( const char *bytes, unsigned long from, unsigned long to, int threads );
+    // constructor, index bytes[from] up to bytes[to] using threads threads
+
+    ~CxLineIndexer( void );
+    // destructor
+
+    unsigned long count( void );
+    // return the number of newlines, which is the number of lines that
+    // end with one
+
+    void locate( unsigned long *offsets, unsigned long *lengths );
+    // fill in offsets[0..count()] and lengths[0..count()-1].  Offsets are
+    // from the start of bytes.  offsets[count()] is where the text after
+    // the last newline starts, which is to if there is none
+
+    static int threadsToUse( void );
+    // the number of threads worth using, one per processor up to a limit
+
+    class Piece;
+
+  private:
+
+    CxLineIndexer( const CxLineIndexer& l );
+    CxLineIndexer& operator=( const CxLineIndexer& l );
+
+    void runPass( int pass, unsigned long *offsets, unsigned long *lengths );
+    // run one pass over every piece
+
+    const char    *_bytes;
+    unsigned long  _from;
+    Piece         *_pieces;
+    int            _nPieces;
+    int            _counted;
+};
+
+
+#endif
@@ -0,0 +1,131 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  pastebench.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  pastebench.cpp
+//
+//  Times the line list under the editor: appending lines to a CxStringList,
+//  inserting and removing lines in the middle of a very long one, and
+//  pasting a block of lines into the middle of a CxEditBuffer.  Not part
+//  of the library, build it against the cx libraries from this directory,
+//  all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o pastebench pastebench.cpp
+//        -L../../lib/linux_x86_64 -lcx_editbuffer -lcx_thread -lcx_base
+//        -lpthread
+//
+//  Run as "pastebench [paste lines] [list lines]", the defaults are a
+//  100000 line paste and a 10000000 line list.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include <cx/base/string.h>
+#include <cx/editbuffer/stringlist.h>
+#include <cx/editbuffer/editbuffer.h>
+
+
+#define MIDDLE_EDITS 1000
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+    int           paste = argc > 1 ? atoi( argv[1] ) : 100000;
+    unsigned long big   = argc > 2 ? atol( argv[2] ) : 10000000;
+
+    int failed = 0;
+
+    // append, the way a load or a paste fills the list
+
+    CxStringList *list  = new CxStringList;
+    double        start = now();
+
+    for (unsigned long i = 0; i < big; i++) {
+        list->append( new CxString( "a line of the document" ) );
+    }
+
+    printf( "append %lu lines                %8.3f s\n", big, now() - start );
+
+    // lines put in and taken out of the middle
+
+    start = now();
+
+    for (int i = 0; i < MIDDLE_EDITS; i++) {
+        list->insertAfter( (int) (big / 2), new CxString( "inserted" ) );
+    }
+
+    double inserted = now() - start;
+
+    start = now();
+
+    for (int i = 0; i < MIDDLE_EDITS; i++) {
+        delete list->removeAt( big / 2 + 1 );
+    }
+
+    double removed = now() - start;
+
+    printf( "insertAfter middle of %lu       %8.3f us each\n", big, inserted * 1e6 / MIDDLE_EDITS );
+    printf( "removeAt middle of %lu          %8.3f us each\n", big, removed * 1e6 / MIDDLE_EDITS );
+
+    if (list->entries() != big) {
+        printf( "FAILED: %lu lines after the edits, not %lu\n", list->entries(), big );
+        failed = 1;
+    }
+
+    delete list;
+
+    // a paste into the middle of a document as long as the paste
+
+    CxString doc;
+    CxString clip;
+
+    for (int i = 0; i < paste; i++) doc  += "existing line of the document\n";
+    for (int i = 0; i < paste; i++) clip += "pasted line\n";
+
+    CxEditBuffer buffer( 4 );
+    buffer.loadTextFromString( doc );
+
+    unsigned long lines = buffer.numberOfLines();
+    buffer.cursorGotoLine( paste / 2 );
+
+    start = now();
+    buffer.pasteFromCutBuffer( clip );
+
+    printf( "paste %d lines into %lu          %8.3f s\n", paste, lines, now() - start );
+
+    if (buffer.numberOfLines() != lines + paste) {
+        printf( "FAILED: %lu lines after the paste, not %lu\n",
+                buffer.numberOfLines(), lines + paste );
+        failed = 1;
+    }
+
+    printf( failed ? "FAILED\n" : "passed\n" );
+
+    return failed ? 1 : 0;
+}
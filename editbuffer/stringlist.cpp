@@ -12,29 +12,202 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <stdio.h>
+#include <string.h>
 #include <cx/base/exception.h>
+#include <cx/base/bytesearch.h>
 #include <cx/editbuffer/stringlist.h>
 #include <cx/editbuffer/stringutils.h>
+#include <cx/editbuffer/lineindexer.h>
+
+
+//-------------------------------------------------------------------------
+// the source is split into lines this many bytes at a time
+//
+//-------------------------------------------------------------------------
+#define STRINGLIST_INDEX_CHUNK  (256 * 1024)
+
+
+//-------------------------------------------------------------------------
+// indexing at least this much of the source at once is split over threads
+//
+//-------------------------------------------------------------------------
+#define STRINGLIST_PARALLEL_INDEX  (64 * 1024 * 1024)
+
+
+//-------------------------------------------------------------------------
+// the threads index this much of the source at a time, the lines found
+// are copied into the tree before the next slab
+//
+//-------------------------------------------------------------------------
+#define STRINGLIST_INDEX_SLAB  (8 * 1024 * 1024)
+
+
+//-------------------------------------------------------------------------
+// most items in a leaf and children of an inner node
+//
+//-------------------------------------------------------------------------
+#define STRINGLIST_LEAF_SIZE  256
+#define STRINGLIST_NODE_SIZE  64
+
+
+//-------------------------------------------------------------------------
+// class CxStringListEntry
+//
+// one line of the list
+//
+//-------------------------------------------------------------------------
+class CxStringListEntry
+{
+  public:
+    CxString      *line;      // the line, NULL while it is still only in the source
+    unsigned long  offset;    // where the line starts in the source
+    unsigned long  length;    // its length there, without the newline
+};
+
+
+class CxStringListInner;
+
+//-------------------------------------------------------------------------
+// class CxStringListNode
+//
+// the part of every tree node that says where it is and how many lines
+// are under it
+//
+//-------------------------------------------------------------------------
+class CxStringListNode
+{
+  public:
+    CxStringListNode( int isLeaf_ ) : isLeaf( isLeaf_ ), count( 0 ), lines( 0 ), parent( NULL ) { }
+
+    int                 isLeaf;
+    int                 count;     // items in a leaf, children in an inner node
+    unsigned long       lines;     // lines in this node and everything under it
+    CxStringListInner  *parent;
+};
+
+
+//-------------------------------------------------------------------------
+// class CxStringListLeaf
+//
+// a block of lines.  Leaves are linked in order so lines can be read
+// one after the other without going back through the tree.  A leaf also
+// keeps how many times the last pattern counted matched in it, good while
+// searchStamp is the list's stamp for that pattern
+//
+//-------------------------------------------------------------------------
+class CxStringListLeaf : public CxStringListNode
+{
+  public:
+    CxStringListLeaf( void ) : CxStringListNode( TRUE ), prev( NULL ), next( NULL ),
+        searchStamp( 0 ), searchCount( 0 ) { }
+
+    CxStringListLeaf   *prev;
+    CxStringListLeaf   *next;
+    unsigned long       searchStamp;
+    unsigned long       searchCount;
+    CxStringListEntry   entry[ STRINGLIST_LEAF_SIZE ];
+};
+
+
+//-------------------------------------------------------------------------
+// class CxStringListInner
+//
+//-------------------------------------------------------------------------
+class CxStringListInner : public CxStringListNode
+{
+  public:
+    CxStringListInner( void ) : CxStringListNode( FALSE ) { }
+
+    CxStringListNode   *child[ STRINGLIST_NODE_SIZE ];
+};
+
+
+//-------------------------------------------------------------------------
+// linesIn
+//
+//-------------------------------------------------------------------------
+static unsigned long
+linesIn( CxStringListNode *node )
+{
+    return( node ? node->lines : 0 );
+}
+
+
+//-------------------------------------------------------------------------
+// firstLeaf
+//
+//-------------------------------------------------------------------------
+static CxStringListLeaf *
+firstLeaf( CxStringListNode *node )
+{
+    if (node == NULL) return( NULL );
+
+    while (!node->isLeaf) {
+        node = ((CxStringListInner *) node)->child[0];
+    }
+
+    return( (CxStringListLeaf *) node );
+}
+
+
+//-------------------------------------------------------------------------
+// childIndex
+//
+//-------------------------------------------------------------------------
+static int
+childIndex( CxStringListInner *parent, CxStringListNode *node )
+{
+    int c = 0;
+    while (parent->child[c] != node) c++;
+    return( c );
+}
+
 
 //-------------------------------------------------------------------------
 // CxStringList::
 //
 //-------------------------------------------------------------------------
 CxStringList::CxStringList( void  )
-:_entries(0), _allocated(0),
- _rawBuffer(NULL), _lineOffsets(NULL), _lineLengths(NULL),
- _tabSpaces(4), _lazyMode(0)
+:_root(NULL), _lastLeaf(NULL), _cacheLeaf(NULL), _cacheFirst(0),
+ _source(NULL), _tabSpaces(4), _lazyMode(0), _indexedTo(0), _indexComplete(TRUE),
+ _tailCounted(FALSE), _tailLines(0), _searchStamp(1)
 {
-    allocate( 1000 );
 }
 
 
 CxStringList::CxStringList(unsigned long preallocated)
-:_entries(0), _allocated(0),
- _rawBuffer(NULL), _lineOffsets(NULL), _lineLengths(NULL),
- _tabSpaces(4), _lazyMode(0)
+:_root(NULL), _lastLeaf(NULL), _cacheLeaf(NULL), _cacheFirst(0),
+ _source(NULL), _tabSpaces(4), _lazyMode(0), _indexedTo(0), _indexComplete(TRUE),
+ _tailCounted(FALSE), _tailLines(0), _searchStamp(1)
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::CxStringList (copy constructor)
+//
+//-------------------------------------------------------------------------
+CxStringList::CxStringList( const CxStringList& l )
+:_root(NULL), _lastLeaf(NULL), _cacheLeaf(NULL), _cacheFirst(0),
+ _source(NULL), _tabSpaces(4), _lazyMode(0), _indexedTo(0), _indexComplete(TRUE),
+ _tailCounted(FALSE), _tailLines(0), _searchStamp(1)
+{
+    copyFrom( l );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::operator=
+//
+//-------------------------------------------------------------------------
+CxStringList&
+CxStringList::operator=( const CxStringList& l )
 {
-    allocate( preallocated );
+    if (&l != this) {
+        freeAll();
+        copyFrom( l );
+    }
+    return( *this );
 }
 
 
@@ -44,366 +217,1485 @@ CxStringList::CxStringList(unsigned long preallocated)
 //-------------------------------------------------------------------------
 CxStringList::~CxStringList( void )
 {
-    if (_lazyMode) {
-        // In lazy mode, we own the CxString objects that were materialized
-        for (unsigned long i = 0; i < _entries; i++) {
-            if (_list[i] != NULL) {
-                delete _list[i];
-            }
-        }
-        delete[] _list;
-        delete[] _rawBuffer;
-        delete[] _lineOffsets;
-        delete[] _lineLengths;
-    }
+    freeAll();
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::allocate
+// CxStringList::copyFrom
 //
+// The new list gets its own index and its own CxString objects, but the
+// strings share their characters with the originals until either side
+// edits them, and the source is shared outright.
 //-------------------------------------------------------------------------
 void
-CxStringList::allocate(unsigned long entries)
+CxStringList::copyFrom( const CxStringList& l )
 {
-    size_t size = sizeof( CxString * );
-
-    _allocated = entries;
-    _entries   = 0;
+    _tabSpaces = l._tabSpaces;
+    _lazyMode  = l._lazyMode;
+
+    _indexedTo     = l._indexedTo;
+    _indexComplete = l._indexComplete;
+    _tailCounted   = l._tailCounted;
+    _tailLines     = l._tailLines;
+
+    for (CxStringListLeaf *leaf = firstLeaf( l._root ); leaf != NULL; leaf = leaf->next) {
+        for (int k=0; k<leaf->count; k++) {
+            CxStringListEntry *e = &leaf->entry[k];
+            pushBack( e->line ? new CxString( *(e->line) ) : (CxString *) NULL,
+                      e->offset, e->length );
+        }
+    }
 
-    // new
-    _list = new CxString*[ _allocated ];
+    _source = l._source;
+    if (_source != NULL) _source->hold();
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::reallocate
+// CxStringList::freeAll
 //
 //-------------------------------------------------------------------------
 void
-CxStringList::reallocate(unsigned long increaseCount)
+CxStringList::freeAll( void )
 {
-    size_t size = sizeof( CxString * );
+    freeTree( _root );
 
-    unsigned long newNumberOfEntries = _allocated + increaseCount;
+    if (_source != NULL) _source->release();
 
-    //new
-    CxString **newList = new  CxString*[ newNumberOfEntries ];
+    _root        = NULL;
+    _lastLeaf    = NULL;
+    _cacheLeaf   = NULL;
+    _cacheFirst  = 0;
+    _source      = NULL;
+    _lazyMode    = 0;
+
+    _indexedTo     = 0;
+    _indexComplete = TRUE;
+    _tailCounted   = FALSE;
+    _tailLines     = 0;
+}
 
-    for (unsigned long c=0; c<newNumberOfEntries; c++) {
-        if (c<_entries) {
-            newList[c] = _list[c];
-        } else {
-            newList[c] = (CxString *) NULL;
-        }
-    }
 
-    // new
-    delete[] _list;
+//-------------------------------------------------------------------------
+// CxStringList::freeTree
+//
+//-------------------------------------------------------------------------
+void
+CxStringList::freeTree( CxStringListNode *node )
+{
+    if (node == NULL) {
+        return;
+    }
 
-    _list = newList;
-    _allocated = newNumberOfEntries;
+    if (node->isLeaf) {
 
-    // Also reallocate offset/length arrays if in lazy mode
-    if (_lazyMode) {
-        unsigned long *newOffsets = new unsigned long[ newNumberOfEntries ];
-        unsigned long *newLengths = new unsigned long[ newNumberOfEntries ];
+        CxStringListLeaf *leaf = (CxStringListLeaf *) node;
 
-        for (unsigned long c=0; c<newNumberOfEntries; c++) {
-            if (c < _entries) {
-                newOffsets[c] = _lineOffsets[c];
-                newLengths[c] = _lineLengths[c];
-            } else {
-                newOffsets[c] = 0;
-                newLengths[c] = 0;
+        for (int k=0; k<leaf->count; k++) {
+            if (leaf->entry[k].line != NULL) {
+                delete leaf->entry[k].line;
             }
         }
 
-        delete[] _lineOffsets;
-        delete[] _lineLengths;
+        delete leaf;
+        return;
+    }
+
+    CxStringListInner *inner = (CxStringListInner *) node;
 
-        _lineOffsets = newOffsets;
-        _lineLengths = newLengths;
+    for (int c=0; c<inner->count; c++) {
+        freeTree( inner->child[c] );
     }
+
+    delete inner;
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::entries
+// CxStringList::allocate
 //
 //-------------------------------------------------------------------------
-unsigned long
-CxStringList::entries(void)
+void
+CxStringList::allocate(unsigned long entries)
 {
-    return(_entries);
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::replaceAt
+// CxStringList::reallocate
 //
 //-------------------------------------------------------------------------
-CxString *
-CxStringList::replaceAt( unsigned long i, CxString *item )
+void
+CxStringList::reallocate(unsigned long increaseCount)
 {
-    if (i >= _entries) {
-        throw CxException("CxStringList::at(invalid index)");
-    }
+}
 
-    CxString *oldItem = _list[i];
-    _list[i] = item;
 
-    // In lazy mode, replaced line is no longer from raw buffer
-    if (_lazyMode) {
-        _lineOffsets[i] = 0;
-        _lineLengths[i] = 0;
+//-------------------------------------------------------------------------
+// CxStringList::addLines
+//
+//-------------------------------------------------------------------------
+void
+CxStringList::addLines( CxStringListNode *node, long delta )
+{
+    while (node != NULL) {
+        node->lines += delta;
+        node = node->parent;
     }
-
-    return( oldItem );
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::removeAt
+// CxStringList::entryAt
 //
+// The leaf found last time, or the one after it, is tried before the
+// tree, so reading lines in order does not search for each one.
 //-------------------------------------------------------------------------
-CxString *
-CxStringList::removeAt( unsigned long i )
+CxStringListEntry *
+CxStringList::entryAt( unsigned long i )
 {
-    if (_entries == 0) {
-        throw CxException("CxStringList::at(invalid index)");
+    if (i >= linesIn( _root )) {
+        return( NULL );
     }
 
-    if (i >= _entries) {
-        throw CxException("CxStringList::at(invalid index)");
-    }
+    if (_cacheLeaf != NULL && i >= _cacheFirst) {
 
-    CxString *oldItem = _list[i];
+        unsigned long k = i - _cacheFirst;
 
-    for (unsigned long j=i+1; j<_entries; j++) {
-        _list[j-1] = _list[j];
-    }
+        if (k < (unsigned long) _cacheLeaf->count) {
+            return( &_cacheLeaf->entry[k] );
+        }
+
+        CxStringListLeaf *next = _cacheLeaf->next;
+        k = k - _cacheLeaf->count;
 
-    // Also shift offset/length arrays in lazy mode
-    if (_lazyMode) {
-        for (unsigned long j=i+1; j<_entries; j++) {
-            _lineOffsets[j-1] = _lineOffsets[j];
-            _lineLengths[j-1] = _lineLengths[j];
+        if (next != NULL && k < (unsigned long) next->count) {
+            _cacheFirst = _cacheFirst + _cacheLeaf->count;
+            _cacheLeaf  = next;
+            return( &next->entry[k] );
         }
     }
 
-    _list[ _entries ] = NULL;
+    CxStringListNode *node = _root;
+    unsigned long     k    = i;
 
-    _entries = _entries - 1;
+    while (!node->isLeaf) {
 
-    return( oldItem );
+        CxStringListInner *inner = (CxStringListInner *) node;
+
+        int c = 0;
+        while (k >= inner->child[c]->lines) {
+            k = k - inner->child[c]->lines;
+            c++;
+        }
+
+        node = inner->child[c];
+    }
+
+    _cacheLeaf  = (CxStringListLeaf *) node;
+    _cacheFirst = i - k;
+
+    return( &_cacheLeaf->entry[k] );
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::insertAfter
+// CxStringList::pushBack
 //
+// A full last leaf is not split in half; a new empty leaf is started
+// after it, so a list built by appending has full leaves.
 //-------------------------------------------------------------------------
 void
-CxStringList::insertAfter( int i,  CxString *newItem )
+CxStringList::pushBack( CxString *line, unsigned long offset, unsigned long length )
 {
-    if (_entries == 0) {
-        throw CxException("CxStringList::at(invalid index)");
+    if (_root == NULL) {
+        _lastLeaf = new CxStringListLeaf;
+        _root     = _lastLeaf;
     }
 
-    if (i >= (int)_entries) {
-        throw CxException("CxStringList::at(invalid index)");
-    }
+    CxStringListLeaf *leaf = _lastLeaf;
 
-    if (_entries == _allocated) {
-        reallocate(10);
-    }
+    if (leaf->count == STRINGLIST_LEAF_SIZE) {
 
-    _entries = _entries + 1;
+        CxStringListLeaf *right = new CxStringListLeaf;
 
-    for (unsigned long j=_entries; j>(unsigned long)i; j--) {
-        _list[j] = _list[j-1];
-    }
+        right->prev = leaf;
+        leaf->next  = right;
+        _lastLeaf   = right;
 
-    // Also shift offset/length arrays in lazy mode
-    if (_lazyMode) {
-        for (unsigned long j=_entries; j>(unsigned long)i; j--) {
-            _lineOffsets[j] = _lineOffsets[j-1];
-            _lineLengths[j] = _lineLengths[j-1];
-        }
-        // Inserted line is not from raw buffer
-        _lineOffsets[i+1] = 0;
-        _lineLengths[i+1] = 0;
+        addChild( leaf, right );
+
+        leaf = right;
     }
 
-    _list[i+1] = newItem;
+    CxStringListEntry *e = &leaf->entry[ leaf->count ];
+    e->line   = line;
+    e->offset = offset;
+    e->length = length;
+
+    leaf->count++;
+    leaf->searchStamp = 0;
+    addLines( leaf, 1 );
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::insertBefore
+// CxStringList::pushSpans
 //
+// Same as calling pushBack for each line, but the counts above a leaf are
+// updated once for all the lines that go in it.
 //-------------------------------------------------------------------------
 void
-CxStringList::insertBefore( int i,  CxString *newItem )
+CxStringList::pushSpans( const unsigned long *offsets, const unsigned long *lengths, unsigned long n )
 {
-    if (_entries == 0) {
-        throw CxException("CxStringList::insertBefore(invalid index)");
-    }
+    while (n > 0) {
 
-    if (i >= (int)_entries) {
-        throw CxException("CxStringList::insertBefore(invalid index)");
-    }
+        // pushBack makes room in a new leaf when the last one is full
 
-    if (_entries == _allocated) {
-        reallocate(10);
-    }
+        pushBack( NULL, offsets[0], lengths[0] );
 
-    _entries = _entries + 1;
+        offsets++;
+        lengths++;
+        n--;
 
-    for (unsigned long j=_entries; j>(unsigned long)i; j--) {
-        _list[j] = _list[j-1];
-    }
+        CxStringListLeaf *leaf = _lastLeaf;
+
+        unsigned long room = STRINGLIST_LEAF_SIZE - leaf->count;
+        if (room > n) room = n;
 
-    // Also shift offset/length arrays in lazy mode
-    if (_lazyMode) {
-        for (unsigned long j=_entries; j>(unsigned long)i; j--) {
-            _lineOffsets[j] = _lineOffsets[j-1];
-            _lineLengths[j] = _lineLengths[j-1];
+        for (unsigned long k = 0; k < room; k++) {
+            CxStringListEntry *e = &leaf->entry[ leaf->count + k ];
+            e->line   = NULL;
+            e->offset = offsets[k];
+            e->length = lengths[k];
         }
-        // Inserted line is not from raw buffer
-        _lineOffsets[i] = 0;
-        _lineLengths[i] = 0;
-    }
 
-    _list[i] = newItem;
+        leaf->count += (int) room;
+        addLines( leaf, (long) room );
+
+        offsets += room;
+        lengths += room;
+        n       -= room;
+    }
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::append
+// CxStringList::insertEntry
 //
 //-------------------------------------------------------------------------
 void
-CxStringList::append( CxString *item )
+CxStringList::insertEntry( unsigned long i, CxString *line, unsigned long offset, unsigned long length )
 {
-    if ( _entries == _allocated) {
-        reallocate(10);
+    if (i >= linesIn( _root )) {
+        pushBack( line, offset, length );
+        return;
+    }
+
+    _cacheLeaf = NULL;
+
+    // find the leaf that holds item i now
+
+    CxStringListNode *node = _root;
+    unsigned long     k    = i;
+
+    while (!node->isLeaf) {
+
+        CxStringListInner *inner = (CxStringListInner *) node;
+
+        int c = 0;
+        while (k >= inner->child[c]->lines) {
+            k = k - inner->child[c]->lines;
+            c++;
+        }
+
+        node = inner->child[c];
     }
 
-    _list[ _entries ] = item;
+    CxStringListLeaf *leaf = (CxStringListLeaf *) node;
+
+    if (leaf->count == STRINGLIST_LEAF_SIZE) {
 
-    // In lazy mode, appended line is not from raw buffer
-    if (_lazyMode) {
-        _lineOffsets[_entries] = 0;
-        _lineLengths[_entries] = 0;
+        splitLeaf( leaf, STRINGLIST_LEAF_SIZE / 2 );
+
+        if (k > STRINGLIST_LEAF_SIZE / 2) {
+            k    = k - STRINGLIST_LEAF_SIZE / 2;
+            leaf = leaf->next;
+        }
     }
 
-    _entries++;
+    memmove( &leaf->entry[k+1], &leaf->entry[k],
+             (leaf->count - k) * sizeof( CxStringListEntry ) );
+
+    CxStringListEntry *e = &leaf->entry[k];
+    e->line   = line;
+    e->offset = offset;
+    e->length = length;
+
+    leaf->count++;
+    leaf->searchStamp = 0;
+    addLines( leaf, 1 );
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::at
+// CxStringList::splitLeaf
 //
 //-------------------------------------------------------------------------
-CxString *
-CxStringList::at( unsigned long i )
+void
+CxStringList::splitLeaf( CxStringListLeaf *leaf, int keep )
 {
-    // In lazy mode, materialize line on first access
-    if (_lazyMode && _list[i] == NULL) {
-        materializeLine(i);
-    }
+    _cacheLeaf = NULL;
 
-    return( _list[i] );
+    CxStringListLeaf *right = new CxStringListLeaf;
+
+    int moved = leaf->count - keep;
+
+    memcpy( right->entry, &leaf->entry[keep], moved * sizeof( CxStringListEntry ) );
+
+    right->count = moved;
+    right->lines = moved;
+
+    leaf->count = keep;
+    leaf->searchStamp = 0;
+    addLines( leaf, -(long) moved );
+
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (leaf->next != NULL) leaf->next->prev = right;
+    leaf->next = right;
+
+    if (_lastLeaf == leaf) _lastLeaf = right;
+
+    addChild( leaf, right );
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::initLazy
+// CxStringList::addChild
 //
-// Initialize lazy loading mode. Takes ownership of buffer.
-// Single pass to count lines and record offsets.
+// newNode's lines are not yet counted anywhere above it.  A full parent
+// is split first; when node is its last child the parent is left full and
+// newNode starts a new parent, the same as pushBack does for leaves.
 //-------------------------------------------------------------------------
 void
-CxStringList::initLazy(char* buffer, unsigned long size, int tabSpaces)
+CxStringList::addChild( CxStringListNode *node, CxStringListNode *newNode )
 {
-    _rawBuffer = buffer;
-    _tabSpaces = tabSpaces;
-    _lazyMode = 1;
+    CxStringListInner *parent = node->parent;
 
-    // First pass: count lines
-    unsigned long lineCount = 0;
-    for (unsigned long i = 0; i < size; i++) {
-        if (buffer[i] == '\n') {
-            lineCount++;
-        }
-    }
-    // Account for final line without newline
-    if (size > 0 && buffer[size-1] != '\n') {
-        lineCount++;
-    }
+    if (parent == NULL) {
+
+        CxStringListInner *root = new CxStringListInner;
 
-    // Allocate arrays
-    _allocated = lineCount + 100;  // Some extra for insertions
-    _entries = lineCount;
+        root->child[0] = node;
+        root->child[1] = newNode;
+        root->count    = 2;
+        root->lines    = node->lines + newNode->lines;
 
-    _list = new CxString*[_allocated];
-    _lineOffsets = new unsigned long[_allocated];
-    _lineLengths = new unsigned long[_allocated];
+        node->parent    = root;
+        newNode->parent = root;
 
-    // Initialize list to NULL
-    for (unsigned long i = 0; i < _allocated; i++) {
-        _list[i] = NULL;
-        _lineOffsets[i] = 0;
-        _lineLengths[i] = 0;
+        _root = root;
+        return;
     }
 
-    // Second pass: record offsets and lengths
-    unsigned long lineIndex = 0;
-    unsigned long lineStart = 0;
+    if (parent->count == STRINGLIST_NODE_SIZE) {
+
+        CxStringListInner *right = new CxStringListInner;
+
+        if (parent->child[ parent->count-1 ] == node) {
+
+            addChild( parent, right );
+
+            right->child[0] = newNode;
+            right->count    = 1;
+            newNode->parent = right;
+
+            addLines( right, newNode->lines );
+            return;
+        }
+
+        int keep = STRINGLIST_NODE_SIZE / 2;
 
-    for (unsigned long i = 0; i < size; i++) {
-        if (buffer[i] == '\n') {
-            _lineOffsets[lineIndex] = lineStart;
-            _lineLengths[lineIndex] = i - lineStart;
-            lineIndex++;
-            lineStart = i + 1;
+        for (int c=keep; c<parent->count; c++) {
+            CxStringListNode *child = parent->child[c];
+            right->child[ c - keep ] = child;
+            right->lines += child->lines;
+            child->parent = right;
         }
+
+        right->count  = parent->count - keep;
+        parent->count = keep;
+
+        addLines( parent, -(long) right->lines );
+        addChild( parent, right );
+
+        parent = node->parent;
     }
 
-    // Handle final line without newline
-    if (size > 0 && buffer[size-1] != '\n') {
-        _lineOffsets[lineIndex] = lineStart;
-        _lineLengths[lineIndex] = size - lineStart;
+    int c = childIndex( parent, node );
+
+    for (int j=parent->count; j>c+1; j--) {
+        parent->child[j] = parent->child[j-1];
     }
+
+    parent->child[c+1] = newNode;
+    parent->count++;
+    newNode->parent = parent;
+
+    addLines( parent, newNode->lines );
 }
 
 
 //-------------------------------------------------------------------------
-// CxStringList::materializeLine
+// CxStringList::removeNode
 //
-// Create CxString on demand from raw buffer.
-// Temporarily null-terminates line for tab expansion.
+// A root left with one child is replaced by that child, so the tree
+// shrinks as lines go.
 //-------------------------------------------------------------------------
 void
-CxStringList::materializeLine(unsigned long i)
+CxStringList::removeNode( CxStringListNode *node )
 {
-    if (!_lazyMode || i >= _entries) {
+    _cacheLeaf = NULL;
+
+    CxStringListInner *parent = node->parent;
+
+    if (node->isLeaf) {
+
+        CxStringListLeaf *leaf = (CxStringListLeaf *) node;
+
+        if (leaf->prev != NULL) leaf->prev->next = leaf->next;
+        if (leaf->next != NULL) leaf->next->prev = leaf->prev;
+        if (_lastLeaf == leaf)  _lastLeaf = leaf->prev;
+
+        delete leaf;
+
+    } else {
+
+        delete (CxStringListInner *) node;
+    }
+
+    if (parent == NULL) {
+        _root     = NULL;
+        _lastLeaf = NULL;
+        return;
+    }
+
+    int c = childIndex( parent, node );
+
+    for (int j=c; j<parent->count-1; j++) {
+        parent->child[j] = parent->child[j+1];
+    }
+
+    parent->count--;
+
+    if (parent->count == 0) {
+        removeNode( parent );
         return;
     }
 
-    unsigned long offset = _lineOffsets[i];
-    unsigned long length = _lineLengths[i];
+    while (_root != NULL && !_root->isLeaf && _root->count == 1) {
+        CxStringListNode *only = ((CxStringListInner *) _root)->child[0];
+        delete (CxStringListInner *) _root;
+        _root = only;
+        _root->parent = NULL;
+    }
+}
 
-    // Save char after line, temporarily null-terminate
-    char savedChar = _rawBuffer[offset + length];
-    _rawBuffer[offset + length] = '\0';
 
-    // Create CxString with tab expansion
-    // toTabExtensionFormat2 takes a CxString which can be constructed from char*
-    _list[i] = new CxString(CxStringUtils::toTabExtensionFormat2(&_rawBuffer[offset], _tabSpaces));
+//-------------------------------------------------------------------------
+// CxStringList::entries
+//
+//-------------------------------------------------------------------------
+unsigned long
+CxStringList::entries(void)
+{
+    return( linesIn( _root ) + unindexedLines() );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::entriesThrough
+//
+//-------------------------------------------------------------------------
+unsigned long
+CxStringList::entriesThrough( unsigned long i )
+{
+    indexThrough( i );
+
+    return( linesIn( _root ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::replaceAt
+//
+//-------------------------------------------------------------------------
+CxString *
+CxStringList::replaceAt( unsigned long i, CxString *item )
+{
+    indexThrough( i );
+
+    CxStringListEntry *e = entryAt( i );
+
+    if (e == NULL) {
+        throw CxException("CxStringList::at(invalid index)");
+    }
+
+    CxString *oldItem = e->line;
+    e->line = item;
+
+    _cacheLeaf->searchStamp = 0;
+
+    return( oldItem );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::removeAt
+//
+// A leaf that runs low is merged into the leaf before or after it when
+// they share a parent and fit in half a leaf together, and an empty leaf
+// is taken out of the tree.
+//-------------------------------------------------------------------------
+CxString *
+CxStringList::removeAt( unsigned long i )
+{
+    indexThrough( i );
+
+    CxStringListEntry *e = entryAt( i );
+
+    if (e == NULL) {
+        throw CxException("CxStringList::at(invalid index)");
+    }
+
+    CxString         *oldItem = e->line;
+    CxStringListLeaf *leaf    = _cacheLeaf;
+    unsigned long     k       = i - _cacheFirst;
+
+    memmove( &leaf->entry[k], &leaf->entry[k+1],
+             (leaf->count - k - 1) * sizeof( CxStringListEntry ) );
+
+    leaf->count--;
+    leaf->searchStamp = 0;
+    addLines( leaf, -1 );
+
+    _cacheLeaf = NULL;
+
+    if (leaf->count == 0) {
+        if (leaf != _root) removeNode( leaf );
+        return( oldItem );
+    }
+
+    CxStringListLeaf *next = leaf->next;
+
+    if (next != NULL && next->parent == leaf->parent &&
+        leaf->count + next->count <= STRINGLIST_LEAF_SIZE / 2) {
+
+        int moved = next->count;
+
+        memcpy( &leaf->entry[ leaf->count ], next->entry, moved * sizeof( CxStringListEntry ) );
+
+        leaf->count += moved;
+        next->count  = 0;
+
+        addLines( next, -(long) moved );
+        addLines( leaf, moved );
+
+        removeNode( next );
+    }
+
+    return( oldItem );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::insertAfter
+//
+//-------------------------------------------------------------------------
+void
+CxStringList::insertAfter( int i,  CxString *newItem )
+{
+    if (i >= 0) indexThrough( i );
+
+    unsigned long entries = linesIn( _root );
+
+    if (entries == 0) {
+        throw CxException("CxStringList::at(invalid index)");
+    }
+
+    if (i < 0 || (unsigned long) i >= entries) {
+        throw CxException("CxStringList::at(invalid index)");
+    }
+
+    insertEntry( i+1, newItem, 0, 0 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::insertBefore
+//
+//-------------------------------------------------------------------------
+void
+CxStringList::insertBefore( int i,  CxString *newItem )
+{
+    if (i >= 0) indexThrough( i );
+
+    unsigned long entries = linesIn( _root );
+
+    if (entries == 0) {
+        throw CxException("CxStringList::insertBefore(invalid index)");
+    }
+
+    if (i < 0 || (unsigned long) i >= entries) {
+        throw CxException("CxStringList::insertBefore(invalid index)");
+    }
+
+    insertEntry( i, newItem, 0, 0 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::append
+//
+//-------------------------------------------------------------------------
+void
+CxStringList::append( CxString *item )
+{
+    // the item goes after every line of the source
+    indexRest();
+
+    pushBack( item, 0, 0 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::at
+//
+//-------------------------------------------------------------------------
+CxString *
+CxStringList::at( unsigned long i )
+{
+    indexThrough( i );
+
+    CxStringListEntry *e = entryAt( i );
+
+    if (e == NULL) {
+        return( NULL );
+    }
+
+    // In lazy mode, materialize line on first access
+    if (e->line == NULL) {
+        materializeLine( e );
+    }
+
+    return( e->line );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::editAt
+//
+//-------------------------------------------------------------------------
+CxString *
+CxStringList::editAt( unsigned long i )
+{
+    indexThrough( i );
+
+    CxStringListEntry *e = entryAt( i );
+
+    if (e == NULL) {
+        throw CxException("CxStringList::editAt(invalid index)");
+    }
+
+    // the caller is about to change the line
+    _cacheLeaf->searchStamp = 0;
+
+    if (e->line == NULL) {
+        materializeLine( e );
+    }
+
+    return( e->line );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::initLazy
+//
+// Initialize lazy loading mode. Takes ownership of buffer.
+//-------------------------------------------------------------------------
+void
+CxStringList::initLazy(char* buffer, unsigned long size, int tabSpaces)
+{
+    initLazy( CxTextSource::adopt( buffer, size ), tabSpaces );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::initLazy
+//
+// Initialize lazy loading mode from a source.  Nothing is indexed yet,
+// lines are found as they are asked for.
+//-------------------------------------------------------------------------
+void
+CxStringList::initLazy(CxTextSource* source, int tabSpaces)
+{
+    // start from an empty list, whatever was loaded before goes away
+
+    freeAll();
+
+    _source = source;
+    _tabSpaces = tabSpaces;
+    _lazyMode = 1;
+
+    _indexedTo = 0;
+    _indexComplete = FALSE;
+    _tailCounted = FALSE;
+    _tailLines = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::indexThrough
+//
+//-------------------------------------------------------------------------
+void
+CxStringList::indexThrough( unsigned long i )
+{
+    while (!_indexComplete && i >= linesIn( _root )) {
+        indexChunk();
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::indexRest
+//
+//-------------------------------------------------------------------------
+void
+CxStringList::indexRest( void )
+{
+    if (_indexComplete) {
+        return;
+    }
+
+    // a lot left goes to the two pass indexer, which also sizes the index
+    // once instead of growing it, so it wins even on one processor
+
+    if (_source->size() - _indexedTo >= STRINGLIST_PARALLEL_INDEX) {
+        indexParallel( CxLineIndexer::threadsToUse() );
+        return;
+    }
+
+    while (!_indexComplete) {
+        indexChunk();
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::indexParallel
+//
+// Index everything left in the source with a CxLineIndexer, a slab at a
+// time so the arrays of lines found stay small and stay in cache.  A line still open at the end
+// of a slab is finished by the next one.
+//-------------------------------------------------------------------------
+void
+CxStringList::indexParallel( int threads )
+{
+    const char    *bytes     = _source->bytes();
+    unsigned long  size      = _source->size();
+    unsigned long  lineStart = _indexedTo;
+    unsigned long  scanFrom  = _indexedTo;
+
+    // the arrays are kept from slab to slab, and only grow for a slab with
+    // more lines than any before it
+
+    unsigned long  room    = 0;
+    unsigned long *offsets = NULL;
+    unsigned long *lengths = NULL;
+
+    while (scanFrom < size) {
+
+        unsigned long to = scanFrom + STRINGLIST_INDEX_SLAB;
+        if (to > size) to = size;
+
+        CxLineIndexer indexer( bytes, scanFrom, to, threads );
+
+        unsigned long lines = indexer.count();
+
+        if (lines + 1 > room) {
+            delete[] offsets;
+            delete[] lengths;
+            room    = lines + 1;
+            offsets = new unsigned long[ room ];
+            lengths = new unsigned long[ room ];
+        }
+
+        indexer.locate( offsets, lengths );
+
+        // the first line began before the slab if the last one left a line open
+
+        offsets[0] = lineStart;
+        if (lines > 0) {
+            lengths[0] = lengths[0] + (scanFrom - lineStart);
+        }
+
+        pushSpans( offsets, lengths, lines );
+
+        lineStart = offsets[lines];
+        scanFrom  = to;
+    }
+
+    delete[] offsets;
+    delete[] lengths;
+
+    // a final line without a newline is still a line
+
+    if (lineStart < size) {
+        pushBack( NULL, lineStart, size - lineStart );
+    }
+
+    _indexedTo = size;
+    _indexComplete = TRUE;
+    _tailLines = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::indexChunk
+//
+// Add the lines that end in the next chunk of the source.  A line longer
+// than a chunk is followed to its end, so every call makes progress.
+// Indexed lines always go at the end of the list: edits only reach lines
+// that have been indexed, and the unindexed rest of the source comes
+// after all of them.
+//-------------------------------------------------------------------------
+void
+CxStringList::indexChunk( void )
+{
+    if (_indexComplete) {
+        return;
+    }
+
+    const char *bytes = _source->bytes();
+    const char *end   = bytes + _source->size();
+
+    const char *p     = bytes + _indexedTo;
+    const char *limit = p + STRINGLIST_INDEX_CHUNK;
+
+    if (limit > end) {
+        limit = end;
+    }
+
+    int found = 0;
+
+    while (p < end) {
+
+        const char *nl = CxByteSearch::findByte( p, limit - p, '\n' );
+
+        if (nl == NULL) {
+
+            // nothing ended in this chunk, look past it for the end of the line
+
+            if (found || limit == end) {
+                break;
+            }
+
+            nl = CxByteSearch::findByte( limit, end - limit, '\n' );
+
+            if (nl == NULL) {
+                limit = end;
+                break;
+            }
+
+            limit = nl + 1;
+        }
+
+        pushBack( NULL, p - bytes, nl - p );
+        p = nl + 1;
+        found++;
+    }
+
+    if (_tailCounted) {
+        _tailLines = _tailLines - found;
+    }
+
+    // at the end of the source, a final line without a newline is still a line
+
+    if (limit == end) {
+
+        if (p < end) {
+            pushBack( NULL, p - bytes, end - p );
+            p = end;
+        }
+
+        _indexComplete = TRUE;
+        _tailLines = 0;
+    }
+
+    _indexedTo = p - bytes;
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::unindexedLines
+//
+// The newlines left are counted the first time, on several threads if
+// there is a lot left, and indexChunk() takes off the lines it adds.
+//-------------------------------------------------------------------------
+unsigned long
+CxStringList::unindexedLines( void )
+{
+    if (_indexComplete) {
+        return( 0 );
+    }
+
+    if (!_tailCounted) {
+
+        const char    *bytes = _source->bytes();
+        unsigned long  size  = _source->size();
+        unsigned long  left  = size - _indexedTo;
+
+        if (left >= STRINGLIST_PARALLEL_INDEX) {
+            CxLineIndexer indexer( bytes, _indexedTo, size, CxLineIndexer::threadsToUse() );
+            _tailLines = indexer.count();
+        } else {
+            _tailLines = CxByteSearch::countByte( bytes + _indexedTo, left, '\n' );
+        }
+
+        // a final line without a newline is still a line
+
+        if (left > 0 && bytes[size - 1] != '\n') {
+            _tailLines++;
+        }
+
+        _tailCounted = TRUE;
+    }
+
+    return( _tailLines );
+}
+
+
+//-------------------------------------------------------------------------
+// rawLine
+//
+// TRUE if reading the line as a string keeps its bytes as they are.
+// readLine() turns bytes from 128 up into spaces, 0xFF is dropped on the
+// way out as a tab extension, and a NUL ends the string.
+//
+//-------------------------------------------------------------------------
+static int
+rawLine( const char *bytes, unsigned long length )
+{
+    return( CxByteSearch::findNonASCII( bytes, length ) == NULL &&
+            CxByteSearch::findByte( bytes, length, '\0' ) == NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::sourceLines
+//
+// Only lines that were never handed out count, a line returned by at()
+// may have been changed through the pointer.  The run follows the leaves
+// until a line is a string, does not start where the last one ended, or
+// holds a byte that reading it would change, so the run reads the same
+// as the lines made from it.
+//-------------------------------------------------------------------------
+const char *
+CxStringList::sourceLines( unsigned long i, unsigned long *count, unsigned long *length )
+{
+    indexThrough( i );
+
+    CxStringListEntry *e = entryAt( i );
+
+    if (e == NULL || e->line != NULL || _source == NULL) {
+        return( NULL );
+    }
+
+    const char    *bytes = _source->bytes();
+
+    if (!rawLine( bytes + e->offset, e->length )) {
+        return( NULL );
+    }
+
+    unsigned long  size  = _source->size();
+
+    unsigned long  start = e->offset;
+    unsigned long  end   = e->offset;
+    unsigned long  n     = 0;
+
+    CxStringListLeaf *leaf = _cacheLeaf;
+    int               k    = (int) (i - _cacheFirst);
+
+    while (leaf != NULL) {
+
+        for (; k < leaf->count; k++) {
+
+            e = &leaf->entry[k];
+
+            if (e->line != NULL || e->offset != end || !rawLine( bytes + e->offset, e->length )) {
+                leaf = NULL;
+                break;
+            }
+
+            end = e->offset + e->length;
+            n++;
+
+            // a line that does not end in a newline ends the source
+
+            if (end >= size || bytes[end] != '\n') {
+                leaf = NULL;
+                break;
+            }
+
+            end++;
+        }
+
+        if (leaf != NULL) {
+            leaf = leaf->next;
+            k    = 0;
+        }
+    }
+
+    *count  = n;
+    *length = end - start;
+
+    return( bytes + start );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::isSourceMapped
+//
+//-------------------------------------------------------------------------
+int
+CxStringList::isSourceMapped( void )
+{
+    return( _source != NULL && _source->isMapped() );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::detachSource
+//
+// Every line becomes a string of its own, so the source can go away or
+// the file under a mapped source can be rewritten.
+//-------------------------------------------------------------------------
+void
+CxStringList::detachSource( void )
+{
+    if (_source == NULL) {
+        return;
+    }
+
+    indexRest();
+
+    for (CxStringListLeaf *leaf = firstLeaf( _root ); leaf != NULL; leaf = leaf->next) {
+        for (int k=0; k<leaf->count; k++) {
+            if (leaf->entry[k].line == NULL) {
+                materializeLine( &leaf->entry[k] );
+            }
+        }
+    }
+
+    _source->release();
+    _source = NULL;
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::materializeLine
+//
+// Create CxString on demand from raw buffer.
+//-------------------------------------------------------------------------
+void
+CxStringList::materializeLine( CxStringListEntry *e )
+{
+    if (_source == NULL) {
+        return;
+    }
+
+    e->line = new CxString( readLine( e ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::readLine
+//
+// The source is only read, copies of the list may be reading it at the
+// same time.
+//-------------------------------------------------------------------------
+CxString
+CxStringList::readLine( CxStringListEntry *e )
+{
+    unsigned long offset = e->offset;
+    unsigned long length = e->length;
+
+    CxString text( _source->bytes() + offset, (int) length );
+
+    // replace high-ASCII bytes (128-254) with spaces.  These are typically
+    // encoding artifacts (e.g., Mac Roman curly quotes) that can cause display
+    // issues.  255 (0xFF) is left alone, it is the tab extension marker.  The
+    // source itself may be a read only mapping, so only the copy is changed
+
+    char *c = text.data();
+    for (unsigned long k = 0; k < length; k++) {
+        unsigned char u = (unsigned char) c[k];
+        if (u >= 128 && u <= 254) {
+            c[k] = ' ';
+        }
+    }
+
+    return( CxStringUtils::toTabExtensionFormat2(text, _tabSpaces) );
+}
+
+
+//-------------------------------------------------------------------------
+// plainByte
+//
+// a byte that reads the same in the source and in a line made from it
+//
+//-------------------------------------------------------------------------
+static int
+plainByte( char c )
+{
+    unsigned char u = (unsigned char) c;
+
+    return( u > ' ' && u < 128 );
+}
+
+
+//-------------------------------------------------------------------------
+// searchKey
+//
+// The longest run of plain bytes in pattern.  Spaces are left out because
+// high bytes in the source read as spaces, and tabs because they gain
+// extension characters, so a line can only match pattern if its source
+// holds the key.
+//
+//-------------------------------------------------------------------------
+static void
+searchKey( const CxString& pattern, const char **key, unsigned long *keyLength )
+{
+    const char    *p = pattern.c_str();
+    unsigned long  n = pattern.length();
+    unsigned long  k = 0;
+
+    *key       = NULL;
+    *keyLength = 0;
+
+    while (k < n) {
+
+        while (k < n && !plainByte( p[k] )) k++;
+
+        unsigned long start = k;
+
+        while (k < n && plainByte( p[k] )) k++;
+
+        if (k - start > *keyLength) {
+            *key       = p + start;
+            *keyLength = k - start;
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// countInLine
+//
+// matches do not overlap, the same ones a replace of every match changes
+//
+//-------------------------------------------------------------------------
+static unsigned long
+countInLine( const CxString& line, const CxString& pattern )
+{
+    unsigned long n = 0;
+    int           c = line.index( pattern, 0 );
+
+    while (c != -1) {
+        n++;
+        c = line.index( pattern, c + (int) pattern.length() );
+    }
+
+    return( n );
+}
+
+
+//-------------------------------------------------------------------------
+// plainLine
+//
+// A source line without tabs, NULs or high bytes reads exactly as it is in
+// the list, so it can be searched where it lies instead of being read.
+//
+//-------------------------------------------------------------------------
+static int
+plainLine( const char *s, unsigned long n )
+{
+    for (unsigned long k = 0; k < n; k++) {
+        unsigned char u = (unsigned char) s[k];
+        if (u == '\t' || u == 0 || u >= 128) {
+            return( FALSE );
+        }
+    }
+
+    return( TRUE );
+}
+
+
+//-------------------------------------------------------------------------
+// countInBytes
+//
+//-------------------------------------------------------------------------
+static unsigned long
+countInBytes( const char *s, unsigned long n, const CxString& pattern )
+{
+    unsigned long count = 0;
+    unsigned long m     = pattern.length();
+    const char   *end   = s + n;
+
+    const char *hit = CxByteSearch::find( s, n, pattern.c_str(), m );
+
+    while (hit != NULL) {
+        count++;
+        s   = hit + m;
+        hit = CxByteSearch::find( s, end - s, pattern.c_str(), m );
+    }
+
+    return( count );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::skipUnread
+//
+// Search the run of unread lines from item k of leaf, that follow each
+// other in the source, for key.  Return the item holding the first hit,
+// or the item after the run if there is none; k itself when it is a
+// string of its own.  The run is searched a few lines first and then in
+// windows twice as large, so where hits are close together each costs
+// only the lines up to it.
+//-------------------------------------------------------------------------
+int
+CxStringList::skipUnread( CxStringListLeaf *leaf, int k, const char *key, unsigned long keyLength )
+{
+    const char    *bytes = _source->bytes();
+    int            end   = k;
+    int            step  = 8;
+    unsigned long  next  = leaf->entry[k].offset;
+
+    while (end < leaf->count) {
+
+        int start = end;
+        int limit = end + step;
+
+        if (limit > leaf->count) limit = leaf->count;
+
+        while (end < limit && leaf->entry[end].line == NULL &&
+               leaf->entry[end].offset == next) {
+            next = leaf->entry[end].offset + leaf->entry[end].length + 1;
+            end++;
+        }
+
+        if (end == start) {
+            break;
+        }
+
+        unsigned long from = leaf->entry[start].offset;
+        unsigned long to   = leaf->entry[end-1].offset + leaf->entry[end-1].length;
+
+        const char *hit = CxByteSearch::find( bytes + from, to - from, key, keyLength );
+
+        if (hit != NULL) {
+
+            // the key holds no newline, so the hit is inside one line
+
+            unsigned long at = hit - bytes;
+            int           i  = start;
+
+            while (leaf->entry[i].offset + leaf->entry[i].length <= at) {
+                i++;
+            }
+
+            return( i );
+        }
+
+        if (end < limit) {
+            break;
+        }
+
+        step = step * 2;
+    }
+
+    return( end );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::findNext
+//
+//-------------------------------------------------------------------------
+long
+CxStringList::findNext( const CxString& pattern, unsigned long row, unsigned long col,
+                        unsigned long *matchCol )
+{
+    if (pattern.length() == 0) {
+        return( -1 );
+    }
+
+    indexThrough( row );
+
+    if (entryAt( row ) == NULL) {
+        return( -1 );
+    }
+
+    const char    *key;
+    unsigned long  keyLength;
+
+    searchKey( pattern, &key, &keyLength );
+
+    CxStringListLeaf *leaf = _cacheLeaf;
+    int               k    = (int) (row - _cacheFirst);
+
+    while (leaf != NULL) {
+
+        while (k < leaf->count) {
+
+            CxStringListEntry *e = &leaf->entry[k];
+
+            if (e->line == NULL && keyLength > 0) {
+
+                int hit = skipUnread( leaf, k, key, keyLength );
+
+                if (hit != k) {
+                    row = row + (hit - k);
+                    k   = hit;
+                    col = 0;
+                    continue;
+                }
+            }
+
+            int         c     = -1;
+            const char *bytes = (e->line == NULL) ? _source->bytes() + e->offset : NULL;
+
+            if (e->line != NULL) {
+                c = e->line->index( pattern, (int) col );
+            } else if (!plainLine( bytes, e->length )) {
+                c = readLine( e ).index( pattern, (int) col );
+            } else if (col < e->length) {
+                const char *hit = CxByteSearch::find( bytes + col, e->length - col,
+                                                      pattern.c_str(), pattern.length() );
+                if (hit != NULL) c = (int) (hit - bytes);
+            }
+
+            if (c != -1) {
+                *matchCol = (unsigned long) c;
+                return( (long) row );
+            }
+
+            row++;
+            k++;
+            col = 0;
+        }
+
+        // past the lines indexed so far, index the next chunk of the source.
+        // Lines only go on at the end, so leaf and k stay where they are
+
+        if (leaf->next == NULL && !_indexComplete) {
+            indexChunk();
+            continue;
+        }
+
+        leaf = leaf->next;
+        k    = 0;
+    }
+
+    return( -1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::countOf
+//
+//-------------------------------------------------------------------------
+unsigned long
+CxStringList::countOf( const CxString& pattern )
+{
+    if (pattern.length() == 0) {
+        return( 0 );
+    }
+
+    indexRest();
+
+    // a new pattern makes every leaf's count stale at once
+
+    if (!(pattern == _searchPattern)) {
+        _searchPattern = pattern;
+        _searchStamp++;
+    }
+
+    const char    *key;
+    unsigned long  keyLength;
+
+    searchKey( pattern, &key, &keyLength );
+
+    unsigned long total = 0;
+
+    for (CxStringListLeaf *leaf = firstLeaf( _root ); leaf != NULL; leaf = leaf->next) {
+
+        if (leaf->searchStamp != _searchStamp) {
+            leaf->searchCount = countInLeaf( leaf, pattern, key, keyLength );
+            leaf->searchStamp = _searchStamp;
+        }
+
+        total = total + leaf->searchCount;
+    }
+
+    return( total );
+}
+
+
+//-------------------------------------------------------------------------
+// CxStringList::countInLeaf
+//
+// Unread lines are counted where they lie in the source, or read into a
+// scratch string when they hold tabs or high bytes, and are not kept, so
+// counting does not fill the list with strings.
+//-------------------------------------------------------------------------
+unsigned long
+CxStringList::countInLeaf( CxStringListLeaf *leaf, const CxString& pattern,
+                           const char *key, unsigned long keyLength )
+{
+    unsigned long n = 0;
+    int           k = 0;
+
+    while (k < leaf->count) {
+
+        CxStringListEntry *e = &leaf->entry[k];
+
+        if (e->line == NULL && keyLength > 0) {
+
+            int hit = skipUnread( leaf, k, key, keyLength );
+
+            if (hit != k) {
+                k = hit;
+                continue;
+            }
+        }
+
+        const char *bytes = (e->line == NULL) ? _source->bytes() + e->offset : NULL;
+
+        if (e->line != NULL) {
+            n = n + countInLine( *(e->line), pattern );
+        } else if (plainLine( bytes, e->length )) {
+            n = n + countInBytes( bytes, e->length, pattern );
+        } else {
+            n = n + countInLine( readLine( e ), pattern );
+        }
+
+        k++;
+    }
 
-    // Restore original char
-    _rawBuffer[offset + length] = savedChar;
+    return( n );
 }
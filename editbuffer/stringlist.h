@@ -13,14 +13,42 @@
 
 #include <stdio.h>
 #include <cx/base/exception.h>
+#include <cx/base/string.h>
+#include <cx/editbuffer/textsource.h>
 
 #ifndef _CxBufferList_h_
 #define _CxBufferList_h_
 
+class CxStringListNode;
+class CxStringListLeaf;
+class CxStringListEntry;
+
 
 //-------------------------------------------------------------------------
 // class CxStringList
 //
+// The lines of an edit buffer.  A line is either a span of the loaded
+// file, kept in a shared and never changed CxTextSource, or a CxString
+// owned by the list.  Spans are turned into strings the first time they
+// are asked for, and only lines that have been looked at or edited cost
+// any memory beyond the file itself.
+//
+// Copies share the source and the characters of every line (CxString
+// copies share their bodies), so copying a list copies the index and not
+// the text.
+//
+// The source is split into lines a chunk at a time, as lines are asked
+// for.  Finding line 100 of a large file reads only the first part of
+// it, and a search indexes only as far as its match.  entries() counts
+// the newlines left without indexing them, splitting the work over
+// threads when a lot is left.
+//
+// The index is a B-tree of line blocks.  Each leaf holds up to a few
+// hundred lines and each inner node knows how many lines are under each
+// of its children, so finding, inserting or removing any line costs time
+// logarithmic in the number of lines, never a shift of the whole list.
+// Reading lines in order is a walk along the leaves.
+//
 //-------------------------------------------------------------------------
 
 class CxStringList
@@ -32,15 +60,20 @@ public:
     
     CxStringList(unsigned long preallocated);
     // constructor
+
+    CxStringList( const CxStringList& l );
+    // copy constructor
+
+    CxStringList& operator=( const CxStringList& l );
+    // assignment operator
     
     ~CxStringList( void );
-    // destructor
+    // destructor, deletes the lines still in the list
     
     void allocate(unsigned long entries = 10);
-    // allocate the pointer array
-    
     void reallocate(unsigned long increaseCount = 10);
-    // reallocate the new pointer array
+    // kept for existing callers, the index grows a leaf at a time and
+    // needs no room set aside
     
     void insertAfter( int index, CxString *newItem );
     // insert a new item below the index
@@ -58,32 +91,135 @@ public:
     // remove the item at item i
     
     unsigned long entries( void );
-    // return the number of items in the list
+    // return the number of items in the list.  The lines of the source
+    // not indexed yet are counted, once, but not indexed
+
+    unsigned long entriesThrough( unsigned long i );
+    // return the number of items indexed so far, after indexing far
+    // enough to know whether item i exists.  Item i exists if the result
+    // is greater than i; otherwise the result is the full count
     
     CxString * at( unsigned long i );
-    // return a copy of the item at index i
+    // return the item at index i, or NULL past the end
+
+    CxString * editAt( unsigned long i );
+    // return the item at index i to be changed in place.  The line stops
+    // referring to the source
 
     void initLazy(char* buffer, unsigned long size, int tabSpaces);
     // initialize lazy loading mode with raw buffer
 
-//protected:
+    void initLazy(CxTextSource* source, int tabSpaces);
+    // initialize lazy loading mode from a source, taking over the
+    // caller's hold on it
+
+    const char *sourceLines( unsigned long i, unsigned long *count, unsigned long *length );
+    // return where item i is in the source if it has not been read since
+    // it was indexed, with the unread items that follow it there.  count
+    // is set to the number of items, and length to their size with the
+    // newline ending each, if any.  Return NULL if item i is a string of
+    // its own, or holds bytes that reading it as a string would change
+
+    long findNext( const CxString& pattern, unsigned long row, unsigned long col,
+                   unsigned long *matchCol );
+    // return the first item from row on holding pattern, from col on in
+    // row itself, setting matchCol to where it starts.  Return -1 if there
+    // is none.  Unread lines are searched in the source and only read when
+    // they may hold pattern, and are not kept.  The source is indexed a
+    // chunk at a time as the search reaches it
+
+    unsigned long countOf( const CxString& pattern );
+    // return how many times pattern is in the items, not counting overlaps.
+    // Counts are kept per leaf, and only leaves changed since pattern was
+    // last counted are counted again; items changed through the pointer
+    // from at() are not noticed, use editAt() or replaceAt()
+
+    int isSourceMapped( void );
+    // return TRUE if unread lines still come from a mapped file
+
+    void detachSource( void );
+    // read every line still in the source and let go of it
+
+private:
+
+    CxStringListEntry *entryAt( unsigned long i );
+    // find item i in the tree, NULL past the end
+
+    void insertEntry( unsigned long i, CxString *line, unsigned long offset, unsigned long length );
+    // put a new item at index i, moving i and everything after it down
+
+    void pushBack( CxString *line, unsigned long offset, unsigned long length );
+    // add an item after the last one
+
+    void pushSpans( const unsigned long *offsets, const unsigned long *lengths, unsigned long n );
+    // add n lines of the source after the last item, a leaf at a time
+
+    void splitLeaf( CxStringListLeaf *leaf, int keep );
+    // move the items of a full leaf after keep into a new leaf to its right
+
+    void addChild( CxStringListNode *node, CxStringListNode *newNode );
+    // link newNode into the tree just after node
 
-    unsigned long  _entries;
-    unsigned long  _allocated;
+    void removeNode( CxStringListNode *node );
+    // unlink an empty node from the tree and delete it
 
-    CxString **_list;
+    void addLines( CxStringListNode *node, long delta );
+    // change the line counts of node and everything above it
+
+    void freeTree( CxStringListNode *node );
+    // delete a node, everything under it and the lines it holds
+
+    void materializeLine( CxStringListEntry *e );
+    // create CxString on demand from raw buffer
+
+    CxString readLine( CxStringListEntry *e );
+    // return the text of an unread line as it reads in the list
+
+    int skipUnread( CxStringListLeaf *leaf, int k, const char *key, unsigned long keyLength );
+    // skip unread items of leaf from k whose source does not hold key
+
+    unsigned long countInLeaf( CxStringListLeaf *leaf, const CxString& pattern,
+                               const char *key, unsigned long keyLength );
+    // count pattern in the items of leaf
+
+    void indexThrough( unsigned long i );
+    // index the source until item i exists or the source runs out
+
+    void indexChunk( void );
+    // index the lines in the next chunk of the source
+
+    void indexRest( void );
+    // index the rest of the source, on several threads if there is a lot
+
+    void indexParallel( int threads );
+    // index the rest of the source with a CxLineIndexer
+
+    unsigned long unindexedLines( void );
+    // return the number of lines of the source not indexed yet
+
+    void copyFrom( const CxStringList& l );
+    // copy the index of l and share its lines and source
+
+    void freeAll( void );
+    // delete every line and the index and let go of the source
+
+    CxStringListNode  *_root;          // top of the tree, NULL when empty
+    CxStringListLeaf  *_lastLeaf;      // rightmost leaf, for appends
+
+    CxStringListLeaf  *_cacheLeaf;     // leaf of the last item found, and
+    unsigned long      _cacheFirst;    // the index of its first item
 
     // Lazy loading support
-    char*           _rawBuffer;      // Raw file content (owned in lazy mode)
-    unsigned long*  _lineOffsets;    // Start offset of each line
-    unsigned long*  _lineLengths;    // Length of each line (excluding newline)
+    CxTextSource*   _source;         // File content, shared between copies
     int             _tabSpaces;      // Tab expansion setting
     int             _lazyMode;       // 1 = lazy mode active
+    unsigned long   _indexedTo;      // Source offset of the first unindexed line
+    int             _indexComplete;  // TRUE once the whole source is indexed
+    int             _tailCounted;    // TRUE once _tailLines is known, the
+    unsigned long   _tailLines;      // lines of the source not indexed yet
 
-private:
-    void materializeLine(unsigned long i);
-    // create CxString on demand from raw buffer
-
+    CxString        _searchPattern;  // the pattern last counted, and
+    unsigned long   _searchStamp;    // the stamp of leaves counted for it
 };
 
 #endif
@@ -25,6 +25,12 @@ CxStringUtils::calcTab(unsigned long pos, int tabSpaces)
 CxString
 CxStringUtils::fixTabs( CxString fromString, int tabSpaces)
 {
+    // a line without tabs has nothing to fix, hand back the same characters
+
+    if (fromString.firstChar('\t') == -1 && fromString.firstChar('\377') == -1) {
+        return( fromString );
+    }
+
     CxString removedTabs = CxStringUtils::fromTabExtensionFormat2( fromString );
     CxString newString   = CxStringUtils::toTabExtensionFormat2( removedTabs, tabSpaces );
     return( newString );
@@ -54,7 +60,7 @@ CxStringUtils::replaceTabExtensionsWithSpaces( CxString s)
 CxString
 CxStringUtils::toTabExtensionFormat2( CxString fromString, int tabSpaces)
 {
-	char *cPtr = fromString.data();
+	const char *cPtr = fromString.c_str();
 	unsigned long tabCount = 0;
 
 	// count the tab characters in the string
@@ -72,7 +78,7 @@ CxStringUtils::toTabExtensionFormat2( CxString fromString, int tabSpaces)
 	char *newBufferPtr = newBuffer;
 
 	// create a source pointer to the orginal string
-	cPtr = fromString.data();
+	cPtr = fromString.c_str();
 
 	// while the source pointer is not the end of the string
 	while (*cPtr != (char) NULL) {
@@ -130,7 +136,7 @@ CxStringUtils::toTabExtensionFormat( CxString fromString, int tabSpaces )
 
     for (unsigned long c=0; c<fromStringLength; c++) {
 
-        char ch = fromString.data()[c];
+        char ch = fromString.c_str()[c];
 
         if (ch == '\t'){
             
@@ -146,7 +152,7 @@ CxStringUtils::toTabExtensionFormat( CxString fromString, int tabSpaces )
 
         } else {
 
-            toString = toString + CxString(fromString.data()[c]);
+            toString = toString + CxString(fromString.c_str()[c]);
             resultingColumn = resultingColumn + 1;
         }
     }
@@ -162,11 +168,14 @@ CxStringUtils::fromTabExtensionFormat( CxString fromString )
     CxString toString;
 	unsigned long fromStringLength = fromString.length();
 
+    // append grows the result in place; building a new string for every
+    // char copied everything so far, and pasting a large block was quadratic
+
     for (unsigned long c=0; c<fromStringLength; c++) {
 
-        char ch = fromString.data()[c];
+        char ch = fromString.c_str()[c];
         if (ch != '\377') {
-            toString = toString + CxString(ch);
+            toString.append( ch );
         }
     }
 
@@ -180,7 +189,7 @@ CxStringUtils::fromTabExtensionFormat2( CxString fromString )
 {
     char *newBuffer = new char[ fromString.length()+1 ];
     
-    char *srcPtr  = fromString.data();
+    const char *srcPtr  = fromString.c_str();
     char *destPtr = newBuffer;
     
     while (*srcPtr!= (char) NULL) {
@@ -208,7 +217,7 @@ CxStringUtils::debugPrintString(CxString s)
 {
     for (unsigned long c=0; c<s.length(); c++) {
 
-        char ch = s.data()[c];
+        char ch = s.c_str()[c];
 
         if (ch == '\t'){
 
@@ -219,7 +228,7 @@ CxStringUtils::debugPrintString(CxString s)
             printf("[exp-tab]");
 
         } else {
-            printf("[%c]", s.data()[c]);
+            printf("[%c]", s.c_str()[c]);
         }
     }
 }
@@ -0,0 +1,163 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  textsource.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxTextSource Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#if defined(_LINUX_) || defined(_OSX_)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cx/editbuffer/textsource.h>
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::CxTextSource
+//
+//-------------------------------------------------------------------------
+CxTextSource::CxTextSource( char *bytes, unsigned long size, int mapped )
+:_bytes( bytes ), _size( size ), _mapped( mapped )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::~CxTextSource
+//
+//-------------------------------------------------------------------------
+CxTextSource::~CxTextSource( void )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+    if (_mapped) {
+        munmap( _bytes, _size );
+        return;
+    }
+#endif
+
+    delete[] _bytes;
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::adopt
+//
+//-------------------------------------------------------------------------
+/* static */
+CxTextSource *
+CxTextSource::adopt( char *bytes, unsigned long size )
+{
+    CxTextSource *source = new CxTextSource( bytes, size, FALSE );
+    source->hold();
+
+    return( source );
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::map
+//
+// Empty files cannot be mapped, and neither can anything on a platform
+// without mmap; callers read those instead.
+//-------------------------------------------------------------------------
+/* static */
+CxTextSource *
+CxTextSource::map( const char *path )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+    int fd = open( path, O_RDONLY );
+    if (fd < 0) {
+        return( NULL );
+    }
+
+    struct stat st;
+    if (fstat( fd, &st ) != 0 || !S_ISREG( st.st_mode ) || st.st_size == 0) {
+        close( fd );
+        return( NULL );
+    }
+
+    void *bytes = mmap( NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+    // the mapping keeps the file open
+    close( fd );
+
+    if (bytes == MAP_FAILED) {
+        return( NULL );
+    }
+
+    CxTextSource *source =
+        new CxTextSource( (char *) bytes, (unsigned long) st.st_size, TRUE );
+    source->hold();
+
+    return( source );
+#else
+    return( NULL );
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::isMapped
+//
+//-------------------------------------------------------------------------
+int
+CxTextSource::isMapped( void ) const
+{
+    return( _mapped );
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::bytes
+//
+//-------------------------------------------------------------------------
+const char *
+CxTextSource::bytes( void ) const
+{
+    return( _bytes );
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::size
+//
+//-------------------------------------------------------------------------
+unsigned long
+CxTextSource::size( void ) const
+{
+    return( _size );
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::hold
+//
+//-------------------------------------------------------------------------
+void
+CxTextSource::hold( void )
+{
+    incCount();
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextSource::release
+//
+//-------------------------------------------------------------------------
+void
+CxTextSource::release( void )
+{
+    if (decCount() == 0) {
+        delete this;
+    }
+}
@@ -0,0 +1,93 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  textsource.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxTextSource Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <cx/base/cntbody.h>
+
+#ifndef _CxTextSource_h_
+#define _CxTextSource_h_
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+
+//-------------------------------------------------------------------------
+// class CxTextSource
+//
+// The bytes of a file as loaded, before any editing.  A source is never
+// changed once made; edited lines live in their own strings and only
+// unedited lines still point into the source.  Copies of a CxStringList
+// share one source, so copying a buffer does not copy the file.
+//
+// A source either owns a buffer read from the file, or maps the file
+// itself so pages are only read when lines on them are looked at.  A
+// mapped file must not be truncated or rewritten while the source is
+// alive.
+//
+// Sources are reference counted.  Take a hold with hold() and give it
+// back with release(), the source is freed with the last hold.
+//
+//-------------------------------------------------------------------------
+class CxTextSource : public CxCountedBody
+{
+  public:
+
+    static CxTextSource *adopt( char *bytes, unsigned long size );
+    // make a source from a new[] allocated buffer, which the source then
+    // owns.  The caller gets the first hold
+
+    static CxTextSource *map( const char *path );
+    // make a source that maps the file at path read only, or return NULL
+    // if it cannot be mapped.  The caller gets the first hold
+
+    int isMapped( void ) const;
+    // return TRUE if the bytes are a mapping of the file
+
+    const char *bytes( void ) const;
+    // return the bytes
+
+    unsigned long size( void ) const;
+    // return the number of bytes
+
+    void hold( void );
+    // take another hold on the source
+
+    void release( void );
+    // give back a hold, freeing the source with the last one
+
+  protected:
+
+    CxTextSource( char *bytes, unsigned long size, int mapped );
+    // constructor, use adopt() or map()
+
+    virtual ~CxTextSource( void );
+    // destructor, frees or unmaps the bytes
+
+    char          *_bytes;
+    unsigned long  _size;
+    int            _mapped;
+
+  private:
+
+    CxTextSource( const CxTextSource& s );
+    CxTextSource& operator=( const CxTextSource& s );
+    // sources are shared, never copied
+};
+
+
+#endif
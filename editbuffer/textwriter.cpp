@@ -0,0 +1,464 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  textwriter.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxTextWriter Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(_LINUX_) || defined(_OSX_)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#endif
+
+#include <cx/base/bytesearch.h>
+#include <cx/editbuffer/textwriter.h>
+
+
+//-------------------------------------------------------------------------
+// edited lines are copied into a buffer this large
+//
+//-------------------------------------------------------------------------
+#define TEXTWRITER_BUFFER  (1024 * 1024)
+
+
+//-------------------------------------------------------------------------
+// most pieces passed to one writev, and most bytes in one piece or one
+// call.  Some systems refuse a writev of 2 GB or more
+//
+//-------------------------------------------------------------------------
+#define TEXTWRITER_IOVECS     1024
+#define TEXTWRITER_MAX_WRITE  (1024UL * 1024 * 1024)
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::CxTextWriter
+//
+//-------------------------------------------------------------------------
+CxTextWriter::CxTextWriter( void )
+:_path( NULL ), _tempPath( NULL ), _fd( -1 ), _fp( NULL ), _failed( FALSE ),
+ _inPlace( FALSE ), _written( 0 ), _buffer( NULL ), _used( 0 ), _iovCount( 0 )
+{
+    _buffer = new char[ TEXTWRITER_BUFFER ];
+
+#if defined(_LINUX_) || defined(_OSX_)
+    _iov = new struct iovec[ TEXTWRITER_IOVECS ];
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::~CxTextWriter
+//
+//-------------------------------------------------------------------------
+CxTextWriter::~CxTextWriter( void )
+{
+    abandon();
+
+    delete[] _buffer;
+
+#if defined(_LINUX_) || defined(_OSX_)
+    delete[] _iov;
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::open
+//
+// The copy takes the mode and, where allowed, the owner of the file it
+// replaces.  A symbolic link is followed, so the file it points at is
+// replaced and the link stays.  When the copy cannot be created the file
+// is opened to be written over, and cut to length by commit().  It is not
+// truncated here, the caller may still have to read from it.
+//-------------------------------------------------------------------------
+int
+CxTextWriter::open( const char *path )
+{
+    abandon();
+
+    _failed   = FALSE;
+    _inPlace  = FALSE;
+    _written  = 0;
+    _used     = 0;
+    _iovCount = 0;
+
+#if defined(_LINUX_) || defined(_OSX_)
+
+    char resolved[ PATH_MAX ];
+
+    struct stat st;
+    int exists = (stat( path, &st ) == 0);
+
+    if (exists && realpath( path, resolved ) != NULL) {
+        path = resolved;
+    }
+
+    _path = new char[ strlen( path ) + 1 ];
+    strcpy( _path, path );
+
+    _tempPath = new char[ strlen( path ) + 8 ];
+    strcpy( _tempPath, path );
+    strcat( _tempPath, ".XXXXXX" );
+
+    _fd = mkstemp( _tempPath );
+
+    if (_fd < 0) {
+
+        delete[] _tempPath;
+        _tempPath = NULL;
+
+        _fd = ::open( path, O_WRONLY | O_CREAT, 0666 );
+
+        if (_fd < 0) {
+            abandon();
+            return( FALSE );
+        }
+
+        _inPlace = TRUE;
+        return( TRUE );
+    }
+
+    if (exists) {
+
+        if (fchown( _fd, st.st_uid, st.st_gid ) != 0) {
+            // not ours to give away, the copy stays with us
+        }
+
+        fchmod( _fd, st.st_mode & 07777 );
+
+    } else {
+
+        mode_t mask = umask( 0 );
+        umask( mask );
+
+        fchmod( _fd, 0666 & ~mask );
+    }
+
+    return( TRUE );
+
+#else
+
+    // no way to replace a file in one step here, write it in place
+
+    _fp = fopen( path, "w" );
+
+    return( _fp != NULL );
+
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::inPlace
+//
+//-------------------------------------------------------------------------
+int
+CxTextWriter::inPlace( void ) const
+{
+    return( _inPlace );
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::writeSpan
+//
+//-------------------------------------------------------------------------
+void
+CxTextWriter::writeSpan( const char *bytes, unsigned long length )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+    queue( bytes, length );
+#else
+    copyIn( bytes, length );
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::writeLine
+//
+//-------------------------------------------------------------------------
+void
+CxTextWriter::writeLine( const char *bytes, unsigned long length )
+{
+    while (length > 0) {
+
+        const char *ext = CxByteSearch::findByte( bytes, length, '\377' );
+
+        if (ext == NULL) {
+            copyIn( bytes, length );
+            break;
+        }
+
+        copyIn( bytes, ext - bytes );
+
+        length = length - (ext - bytes) - 1;
+        bytes  = ext + 1;
+    }
+
+    copyIn( "\n", 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::queue
+//
+//-------------------------------------------------------------------------
+void
+CxTextWriter::queue( const char *bytes, unsigned long length )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+    while (length > 0) {
+
+        unsigned long n = length;
+
+        if (_iovCount > 0) {
+
+            struct iovec *last = &_iov[ _iovCount-1 ];
+
+            if ((const char *) last->iov_base + last->iov_len == bytes &&
+                last->iov_len < TEXTWRITER_MAX_WRITE) {
+
+                if (n > TEXTWRITER_MAX_WRITE - last->iov_len) {
+                    n = TEXTWRITER_MAX_WRITE - last->iov_len;
+                }
+
+                last->iov_len += n;
+
+                bytes  = bytes  + n;
+                length = length - n;
+                continue;
+            }
+        }
+
+        if (_iovCount == TEXTWRITER_IOVECS) {
+            flush();
+        }
+
+        if (n > TEXTWRITER_MAX_WRITE) {
+            n = TEXTWRITER_MAX_WRITE;
+        }
+
+        _iov[ _iovCount ].iov_base = (void *) bytes;
+        _iov[ _iovCount ].iov_len  = n;
+        _iovCount++;
+
+        bytes  = bytes  + n;
+        length = length - n;
+    }
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::copyIn
+//
+// Room is made before copying, flushing after would throw away what was
+// just copied.
+//-------------------------------------------------------------------------
+void
+CxTextWriter::copyIn( const char *bytes, unsigned long length )
+{
+    while (length > 0) {
+
+        if (_used == TEXTWRITER_BUFFER || _iovCount == TEXTWRITER_IOVECS) {
+            flush();
+        }
+
+        unsigned long n = TEXTWRITER_BUFFER - _used;
+        if (n > length) n = length;
+
+        memcpy( _buffer + _used, bytes, n );
+
+#if defined(_LINUX_) || defined(_OSX_)
+        queue( _buffer + _used, n );
+#endif
+
+        _used  = _used  + n;
+        bytes  = bytes  + n;
+        length = length - n;
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::flush
+//
+//-------------------------------------------------------------------------
+void
+CxTextWriter::flush( void )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+
+    int i = 0;
+
+    while (i < _iovCount && !_failed) {
+
+        // as many pieces as fit in one call
+
+        int           n     = 1;
+        unsigned long total = _iov[i].iov_len;
+
+        while (i + n < _iovCount && n < TEXTWRITER_IOVECS &&
+               total + _iov[i+n].iov_len <= TEXTWRITER_MAX_WRITE) {
+            total = total + _iov[i+n].iov_len;
+            n++;
+        }
+
+        ssize_t written = writev( _fd, &_iov[i], n );
+
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            _failed = TRUE;
+            break;
+        }
+
+        _written = _written + (unsigned long) written;
+
+        // step over what went out, a short write leaves part of a piece
+
+        unsigned long left = (unsigned long) written;
+
+        while (i < _iovCount && left >= _iov[i].iov_len) {
+            left = left - _iov[i].iov_len;
+            i++;
+        }
+
+        if (left > 0) {
+            _iov[i].iov_base = (char *) _iov[i].iov_base + left;
+            _iov[i].iov_len  = _iov[i].iov_len - left;
+        }
+    }
+
+    _iovCount = 0;
+
+#else
+
+    if (_fp != NULL && _used > 0) {
+        if (fwrite( _buffer, 1, _used, _fp ) != _used) {
+            _failed = TRUE;
+        }
+    }
+
+#endif
+
+    _used = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::commit
+//
+//-------------------------------------------------------------------------
+int
+CxTextWriter::commit( void )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+
+    if (_fd < 0) {
+        return( FALSE );
+    }
+
+    flush();
+
+    // written over in place, the old text may run on past the new
+
+    if (_inPlace && !_failed && ftruncate( _fd, (off_t) _written ) != 0) {
+        _failed = TRUE;
+    }
+
+    if (fsync( _fd ) != 0) {
+        _failed = TRUE;
+    }
+
+    if (close( _fd ) != 0) {
+        _failed = TRUE;
+    }
+
+    _fd = -1;
+
+    if (_inPlace) {
+        delete[] _path;
+        _path = NULL;
+        return( !_failed );
+    }
+
+    if (_failed || rename( _tempPath, _path ) != 0) {
+        abandon();
+        return( FALSE );
+    }
+
+    delete[] _tempPath;
+    _tempPath = NULL;
+
+    delete[] _path;
+    _path = NULL;
+
+    return( TRUE );
+
+#else
+
+    if (_fp == NULL) {
+        return( FALSE );
+    }
+
+    flush();
+
+    if (fclose( _fp ) != 0) {
+        _failed = TRUE;
+    }
+
+    _fp = NULL;
+
+    return( !_failed );
+
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// CxTextWriter::abandon
+//
+//-------------------------------------------------------------------------
+void
+CxTextWriter::abandon( void )
+{
+#if defined(_LINUX_) || defined(_OSX_)
+    if (_fd >= 0) {
+        close( _fd );
+        _fd = -1;
+    }
+
+    if (_tempPath != NULL) {
+        unlink( _tempPath );
+    }
+#else
+    if (_fp != NULL) {
+        fclose( _fp );
+        _fp = NULL;
+    }
+#endif
+
+    delete[] _tempPath;
+    _tempPath = NULL;
+
+    delete[] _path;
+    _path = NULL;
+
+    _used     = 0;
+    _iovCount = 0;
+}
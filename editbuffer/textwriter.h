@@ -0,0 +1,121 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  textwriter.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxTextWriter Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#if defined(_LINUX_) || defined(_OSX_)
+#include <sys/types.h>
+#include <sys/uio.h>
+#endif
+
+#ifndef _CxTextWriter_h_
+#define _CxTextWriter_h_
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+
+//-------------------------------------------------------------------------
+// class CxTextWriter
+//
+// Writes a new copy of a file for CxEditBuffer::saveText.  Bytes that
+// stay put until the save is done, like the unread lines of a loaded
+// file, are queued as they are and never copied.  Edited lines are
+// copied into one large buffer.  Both go out together with writev, so a
+// mostly unedited file is written with a few large calls.
+//
+// The copy is written beside the file under a temporary name, synced,
+// and renamed over the file by commit().  Until then the old file is
+// untouched, so a failed save leaves it as it was, and a file still
+// mapped by a CxTextSource keeps its old contents under the mapping.
+//
+// The renamed copy is a new file.  It gets the old file's mode, and its
+// owner where that is allowed, but not its ACLs or extended attributes,
+// and other hard links to the old file keep the old contents.  When no
+// copy can be made beside the file, because the directory is not
+// writable, the file is written in place as saves always were; see
+// inPlace().
+//
+//-------------------------------------------------------------------------
+class CxTextWriter
+{
+  public:
+
+    CxTextWriter( void );
+    // constructor
+
+    ~CxTextWriter( void );
+    // destructor, throws away a copy that was not committed
+
+    int open( const char *path );
+    // start a new copy of the file at path, or failing that open the file
+    // itself.  Return FALSE if neither can be written
+
+    int inPlace( void ) const;
+    // TRUE if the file itself is being written.  Anything still to be
+    // read from it, like a mapped source, must be copied out first
+
+    void writeSpan( const char *bytes, unsigned long length );
+    // write bytes that will not change or go away before commit()
+
+    void writeLine( const char *bytes, unsigned long length );
+    // write a line in tab extension format and a newline.  The extension
+    // characters are dropped as the line is copied
+
+    int commit( void );
+    // write everything out and replace the file with the copy.  Return
+    // FALSE if anything failed, the file is then left as it was
+
+    void abandon( void );
+    // throw away the copy
+
+  private:
+
+    CxTextWriter( const CxTextWriter& w );
+    CxTextWriter& operator=( const CxTextWriter& w );
+    // writers cannot be copied
+
+    void queue( const char *bytes, unsigned long length );
+    // add bytes to the list to write, joining them to the last entry when
+    // they follow on from it
+
+    void copyIn( const char *bytes, unsigned long length );
+    // copy bytes into the buffer, flushing when it fills
+
+    void flush( void );
+    // write the list out and empty the buffer
+
+    char          *_path;        // the file being replaced
+    char          *_tempPath;    // the copy, beside it
+    int            _fd;
+    FILE          *_fp;          // used where there is no writev
+    int            _failed;
+    int            _inPlace;     // no copy, _fd is the file itself
+    unsigned long  _written;     // bytes written to _fd
+
+    char          *_buffer;
+    unsigned long  _used;
+
+#if defined(_LINUX_) || defined(_OSX_)
+    struct iovec  *_iov;
+#endif
+    int            _iovCount;
+};
+
+
+#endif
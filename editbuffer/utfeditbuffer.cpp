@@ -15,6 +15,7 @@
 #include <string.h>
 #include <sys/stat.h>
 
+#include <cx/base/bytesearch.h>
 #include <cx/editbuffer/utfeditbuffer.h>
 
 #ifndef TRUE
@@ -99,6 +100,7 @@ CxUTFEditBuffer::CxUTFEditBuffer(const CxUTFEditBuffer &c)
         _bufferLineList = c._bufferLineList;
         _killAccumulator = c._killAccumulator;
         _lastWasKill = c._lastWasKill;
+        _journal = c._journal;
     }
 }
 
@@ -126,6 +128,7 @@ CxUTFEditBuffer::operator=(const CxUTFEditBuffer &c)
         _bufferLineList = c._bufferLineList;
         _killAccumulator = c._killAccumulator;
         _lastWasKill = c._lastWasKill;
+        _journal = c._journal;
     }
     return *this;
 }
@@ -150,6 +153,7 @@ CxUTFEditBuffer::reset(void)
     touched = false;
     inMemory = false;
     _bufferLineList.clear();
+    _journal.clear();
 }
 
 
@@ -402,6 +406,9 @@ CxUTFEditBuffer::loadText(CxString filepath_, int preload)
     // Preload requested - open and read the file
     CxFile inFile;
 
+    // the history is of some other text
+    _journal.clear();
+
     if (!inFile.open(filePath, "r")) {
         return FALSE;
     }
@@ -414,34 +421,8 @@ CxUTFEditBuffer::loadText(CxString filepath_, int preload)
         size_t bytesRead = inFile.fread(rawBuffer, 1, fileSize);
         rawBuffer[bytesRead] = '\0';
 
-        // Parse buffer into lines
-        char *lineStart = rawBuffer;
-        char *p = rawBuffer;
-
-        while (*p != '\0') {
-            if (*p == '\n') {
-                *p = '\0';
-
-                // Remove trailing CR if present (Windows line endings)
-                if (p > lineStart && *(p - 1) == '\r') {
-                    *(p - 1) = '\0';
-                }
-
-                CxUTFString utfLine;
-                utfLine.fromBytes(lineStart, p - lineStart, tabSpaces);
-                _bufferLineList.append(utfLine);
-
-                lineStart = p + 1;
-            }
-            p++;
-        }
-
-        // Handle last line without newline
-        if (p > lineStart) {
-            CxUTFString utfLine;
-            utfLine.fromBytes(lineStart, p - lineStart, tabSpaces);
-            _bufferLineList.append(utfLine);
-        }
+        // Parse buffer into lines, removing the CR of Windows line endings
+        appendLines(rawBuffer, (unsigned long)bytesRead, TRUE);
 
         delete[] rawBuffer;
         inMemory = TRUE;
@@ -461,27 +442,47 @@ CxUTFEditBuffer::loadText(CxString filepath_, int preload)
 void
 CxUTFEditBuffer::loadTextFromString(CxString text)
 {
-    char *ptr = text.data();
-    char *lineStart = ptr;
+    // the history is of some other text
+    _journal.clear();
 
-    while (*ptr != '\0') {
-        if (*ptr == '\n') {
-            *ptr = '\0';
+    appendLines(text.data(), text.length(), FALSE);
+}
 
-            CxUTFString utfLine;
-            utfLine.fromBytes(lineStart, ptr - lineStart, tabSpaces);
-            _bufferLineList.append(utfLine);
 
-            lineStart = ptr + 1;
-        }
-        ptr++;
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::appendLines
+//
+// Split text at newlines, stopping at a NUL, and parse each line in place at the end of the
+// line list.  dropCR removes the CR of a CRLF ending.
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxUTFEditBuffer::appendLines(const char *text, unsigned long len, int dropCR)
+{
+    const char *nul = CxByteSearch::findByte(text, len, '\0');
+    if (nul != NULL) {
+        len = (unsigned long)(nul - text);
     }
 
-    // Handle last line without newline
-    if (ptr > lineStart) {
-        CxUTFString utfLine;
-        utfLine.fromBytes(lineStart, ptr - lineStart, tabSpaces);
-        _bufferLineList.append(utfLine);
+    const char *end = text + len;
+    const char *lineStart = text;
+
+    while (lineStart < end) {
+        const char *newline = CxByteSearch::findByte(lineStart, end - lineStart, '\n');
+        const char *lineEnd = newline ? newline : end;
+
+        if (newline && dropCR && lineEnd > lineStart && *(lineEnd - 1) == '\r') {
+            lineEnd--;
+        }
+
+        _bufferLineList.append(CxUTFString());
+        _bufferLineList.at(_bufferLineList.entries() - 1)->fromBytes(
+            lineStart, (int)(lineEnd - lineStart), tabSpaces);
+
+        if (newline == NULL) {
+            break;
+        }
+        lineStart = newline + 1;
     }
 }
 
@@ -606,15 +607,20 @@ CxUTFEditBuffer::addCharacter(CxString c)
 
     // Empty buffer - create first line
     if (_bufferLineList.entries() == 0) {
+        undoSave(0, 0, CxEditJournal::TYPING);
         CxUTFString newLine;
         newLine.append(ch);
         _bufferLineList.append(newLine);
         cursor.col = 1;
         lastRequestCol = cursor.col;
+        undoChanged(1);
         return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_LINE, CxEditHint::CURSOR_HINT_RIGHT);
     }
 
+    undoSave(cursor.row, 1, CxEditJournal::TYPING);
+
     CxUTFString *line = _bufferLineList.at(cursor.row);
+    int before = line->charCount();
 
     // Insert character
     line->insert(cursor.col, ch);
@@ -622,8 +628,10 @@ CxUTFEditBuffer::addCharacter(CxString c)
     // Recalculate tabs if any exist after insert point
     line->recalculateTabWidths(tabSpaces);
 
-    cursor.col++;
+    // a combining mark joins the character before it
+    cursor.col += line->charCount() - before;
     lastRequestCol = cursor.col;
+    undoChanged(1);
 
     return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_LINE_PAST_POINT, CxEditHint::CURSOR_HINT_RIGHT);
 }
@@ -656,14 +664,18 @@ CxUTFEditBuffer::addCharacter(char c)
 
     // Empty buffer - create first line
     if (_bufferLineList.entries() == 0) {
+        undoSave(0, 0, CxEditJournal::TYPING);
         CxUTFString newLine;
         newLine.append(CxUTFCharacter::fromASCII(c));
         _bufferLineList.append(newLine);
         cursor.col = 1;
         lastRequestCol = cursor.col;
+        undoChanged(1);
         return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_LINE, CxEditHint::CURSOR_HINT_RIGHT);
     }
 
+    undoSave(cursor.row, 1, CxEditJournal::TYPING);
+
     CxUTFString *line = _bufferLineList.at(cursor.row);
 
     // Insert character
@@ -675,6 +687,7 @@ CxUTFEditBuffer::addCharacter(char c)
 
     cursor.col++;
     lastRequestCol = cursor.col;
+    undoChanged(1);
 
     return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_LINE_PAST_POINT, CxEditHint::CURSOR_HINT_RIGHT);
 }
@@ -695,14 +708,18 @@ CxUTFEditBuffer::addTab(void)
 
     // Empty buffer - create first line with tab
     if (_bufferLineList.entries() == 0) {
+        undoSave(0, 0, CxEditJournal::TYPING);
         CxUTFString newLine;
         newLine.append(CxUTFCharacter::makeTab(tabSpaces));
         _bufferLineList.append(newLine);
         cursor.col = 1;
         lastRequestCol = cursor.col;
+        undoChanged(1);
         return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_LINE, CxEditHint::CURSOR_HINT_RIGHT);
     }
 
+    undoSave(cursor.row, 1, CxEditJournal::TYPING);
+
     CxUTFString *line = _bufferLineList.at(cursor.row);
 
     // Calculate tab width based on cursor display column
@@ -718,6 +735,7 @@ CxUTFEditBuffer::addTab(void)
 
     cursor.col++;
     lastRequestCol = cursor.col;
+    undoChanged(1);
 
     return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_LINE_PAST_POINT, CxEditHint::CURSOR_HINT_RIGHT);
 }
@@ -741,15 +759,19 @@ CxUTFEditBuffer::addReturn(void)
 
     // Empty buffer - create first line
     if (_bufferLineList.entries() == 0) {
+        undoSave(0, 0, CxEditJournal::TYPING);
         CxUTFString newLine;
         _bufferLineList.append(newLine);
         _bufferLineList.append(newLine);
         cursor.row = 1;
         cursor.col = 0;
         lastRequestCol = 0;
+        undoChanged(2);
         return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_SCREEN, CxEditHint::CURSOR_HINT_JUMP);
     }
 
+    undoSave(cursor.row, 1, CxEditJournal::TYPING);
+
     CxUTFString *currentLine = _bufferLineList.at(cursor.row);
 
     // Split the current line
@@ -770,6 +792,7 @@ CxUTFEditBuffer::addReturn(void)
     cursor.row++;
     cursor.col = 0;
     lastRequestCol = 0;
+    undoChanged(2);
 
     return editHint;
 }
@@ -802,12 +825,15 @@ CxUTFEditBuffer::addBackspace(void)
     }
 
     // Delete character before cursor
+    undoSave(cursor.row, 1, CxEditJournal::TYPING);
+
     CxUTFString *line = _bufferLineList.at(cursor.row);
     line->remove(cursor.col - 1, 1);
     line->recalculateTabWidths(tabSpaces);
 
     cursor.col--;
     lastRequestCol = cursor.col;
+    undoChanged(1);
 
     return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_LINE, CxEditHint::CURSOR_HINT_LEFT);
 }
@@ -824,6 +850,8 @@ CxUTFEditBuffer::joinLines(void)
         return CxEditHint(CxEditHint::UPDATE_HINT_NONE, CxEditHint::CURSOR_HINT_NONE);
     }
 
+    undoSave(cursor.row - 1, 2, CxEditJournal::TYPING);
+
     CxUTFString *prevLine = _bufferLineList.at(cursor.row - 1);
     CxUTFString *currentLine = _bufferLineList.at(cursor.row);
 
@@ -839,6 +867,7 @@ CxUTFEditBuffer::joinLines(void)
     cursor.row--;
     cursor.col = joinCol;
     lastRequestCol = cursor.col;
+    undoChanged(1);
 
     return CxEditHint(cursor.row, cursor.col, CxEditHint::UPDATE_HINT_SCREEN_PAST_POINT, CxEditHint::CURSOR_HINT_JUMP);
 }
@@ -943,6 +972,8 @@ CxUTFEditBuffer::deleteText(void)
 
     touched = TRUE;
 
+    undoSave(start.row, end.row - start.row + 1, CxEditJournal::EDIT);
+
     if (start.row == end.row) {
         // Single line deletion
         CxUTFString *line = _bufferLineList.at(start.row);
@@ -972,6 +1003,7 @@ CxUTFEditBuffer::deleteText(void)
     cursor = start;
     lastRequestCol = cursor.col;
     markSet = false;
+    undoChanged(1);
 }
 
 
@@ -1013,12 +1045,15 @@ CxUTFEditBuffer::cutTextToEndOfLine(void)
         if (cursor.row + 1 < numberOfBufferLines) {
             CxUTFString *nextLine = _bufferLineList.at(cursor.row + 1);
             if (nextLine != 0) {
+                undoSave(cursor.row, 2, CxEditJournal::EDIT);
+
                 // Append next line to current line
                 line->append(*nextLine);
                 line->recalculateTabWidths(tabSpaces);
 
                 // Remove the next line
                 _bufferLineList.removeAt(cursor.row + 1);
+                undoChanged(1);
 
                 touched = TRUE;
                 theCutText = "\n";
@@ -1029,7 +1064,9 @@ CxUTFEditBuffer::cutTextToEndOfLine(void)
         CxUTFString cut = line->subString(cursor.col, line->charCount() - cursor.col);
         theCutText = cut.toBytes();
 
+        undoSave(cursor.row, 1, CxEditJournal::EDIT);
         line->remove(cursor.col, line->charCount() - cursor.col);
+        undoChanged(1);
         touched = TRUE;
     }
 
@@ -1056,6 +1093,8 @@ CxUTFEditBuffer::insertTextAtCursor(CxString text)
 {
     if (readOnly) return;
 
+    undoBegin();
+
     const char *ptr = text.data();
     const char *end = ptr + text.length();
 
@@ -1086,21 +1125,27 @@ CxUTFEditBuffer::insertTextAtCursor(CxString text)
             touched = TRUE;
 
             if (_bufferLineList.entries() == 0) {
+                undoSave(0, 0, CxEditJournal::EDIT);
                 CxUTFString newLine;
                 newLine.append(ch);
                 _bufferLineList.append(newLine);
                 cursor.col = 1;
             } else {
+                undoSave(cursor.row, 1, CxEditJournal::EDIT);
                 CxUTFString *line = _bufferLineList.at(cursor.row);
+                int before = line->charCount();
                 line->insert(cursor.col, ch);
                 line->recalculateTabWidths(tabSpaces);
-                cursor.col++;
+                cursor.col += line->charCount() - before;
             }
             lastRequestCol = cursor.col;
+            undoChanged(1);
 
             ptr += consumed;
         }
     }
+
+    undoEnd();
 }
 
 
@@ -1116,6 +1161,8 @@ CxUTFEditBuffer::insertTextAtCursor(CxUTFString &text)
 {
     if (readOnly) return;
 
+    undoBegin();
+
     for (int i = 0; i < text.charCount(); i++) {
         const CxUTFCharacter *ch = text.at(i);
 
@@ -1133,19 +1180,25 @@ CxUTFEditBuffer::insertTextAtCursor(CxUTFString &text)
             touched = TRUE;
 
             if (_bufferLineList.entries() == 0) {
+                undoSave(0, 0, CxEditJournal::EDIT);
                 CxUTFString newLine;
                 newLine.append(*ch);
                 _bufferLineList.append(newLine);
                 cursor.col = 1;
             } else {
+                undoSave(cursor.row, 1, CxEditJournal::EDIT);
                 CxUTFString *line = _bufferLineList.at(cursor.row);
+                int before = line->charCount();
                 line->insert(cursor.col, *ch);
                 line->recalculateTabWidths(tabSpaces);
-                cursor.col++;
+                cursor.col += line->charCount() - before;
             }
             lastRequestCol = cursor.col;
+            undoChanged(1);
         }
     }
+
+    undoEnd();
 }
 
 
@@ -1230,25 +1283,12 @@ CxUTFEditBuffer::findAgain(CxString findStr, int skipIfCurrent)
         unsigned long searchStart = (row == cursor.row) ? cursor.col : 0;
 
         // Convert character column to byte offset for search
-        int byteOffset = 0;
-        if (row == cursor.row && searchStart > 0) {
-            byteOffset = line->displayColumnOfChar(searchStart);
-            // Actually need byte offset, not display column - use toBytes and count
-            CxString prefix = line->subString(0, searchStart).toBytes();
-            byteOffset = prefix.length();
-        }
+        int byteOffset = line->byteOffsetOfChar(searchStart);
 
         int found = lineBytes.index(findStr, byteOffset);
         if (found != -1) {
             // Convert byte offset back to character index
-            // Count characters up to found position
-            int charIndex = 0;
-            int bytes = 0;
-            while (charIndex < (int)line->charCount() && bytes < found) {
-                const CxUTFCharacter *ch = line->at(charIndex);
-                bytes += ch->byteCount();
-                charIndex++;
-            }
+            int charIndex = line->charIndexAtByteOffset(found);
 
             cursorGotoRequest(row, charIndex);
             lastFindLocation = cursor;
@@ -1288,8 +1328,7 @@ CxUTFEditBuffer::replaceAgain(CxString findStr, CxString replaceStr)
     CxString lineBytes = line->toBytes();
 
     // Check if findStr is at current position
-    CxString prefix = line->subString(0, cursor.col).toBytes();
-    int byteOffset = prefix.length();
+    int byteOffset = line->byteOffsetOfChar(cursor.col);
 
     int found = lineBytes.index(findStr, byteOffset);
 
@@ -1297,16 +1336,10 @@ CxUTFEditBuffer::replaceAgain(CxString findStr, CxString replaceStr)
         // Found at cursor position - do replacement
         touched = TRUE;
 
+        undoSave(cursor.row, 1, CxEditJournal::EDIT);
+
         // Remove find string characters
-        int findCharCount = 0;
-        int findBytes = 0;
-        int charIndex = cursor.col;
-        while (findBytes < findStr.length() && charIndex < (int)line->charCount()) {
-            const CxUTFCharacter *ch = line->at(charIndex);
-            findBytes += ch->byteCount();
-            findCharCount++;
-            charIndex++;
-        }
+        int findCharCount = line->charIndexAtByteOffset(byteOffset + findStr.length()) - cursor.col;
 
         line->remove(cursor.col, findCharCount);
 
@@ -1314,14 +1347,13 @@ CxUTFEditBuffer::replaceAgain(CxString findStr, CxString replaceStr)
         CxUTFString replaceUTF;
         replaceUTF.fromBytes(replaceStr.data(), replaceStr.length(), tabSpaces);
 
-        for (int i = replaceUTF.charCount() - 1; i >= 0; i--) {
-            line->insert(cursor.col, *replaceUTF.at(i));
-        }
-
+        int before = line->charCount();
+        line->insert(cursor.col, replaceUTF);
         line->recalculateTabWidths(tabSpaces);
 
-        cursor.col += replaceUTF.charCount();
+        cursor.col += line->charCount() - before;
         lastRequestCol = cursor.col;
+        undoChanged(1);
     }
 
     return findAgain(findStr, TRUE);
@@ -1335,21 +1367,26 @@ CxUTFEditBuffer::replaceAgain(CxString findStr, CxString replaceStr)
 void
 CxUTFEditBuffer::entab(void)
 {
+    undoBegin();
+
     // Convert leading spaces to tabs
     for (unsigned long row = 0; row < _bufferLineList.entries(); row++) {
         CxUTFString *line = _bufferLineList.at(row);
 
+        const char *bytes = line->data();
         int leadingSpaces = 0;
-        for (int i = 0; i < (int)line->charCount(); i++) {
-            const CxUTFCharacter *ch = line->at(i);
-            if (ch->isASCII() && ch->bytes()[0] == ' ') {
-                leadingSpaces++;
-            } else {
-                break;
-            }
+        while (bytes[leadingSpaces] == ' ') {
+            leadingSpaces++;
+        }
+
+        // a combining mark after the last space makes it a character of its own
+        if (leadingSpaces > 0 && line->byteOffsetOfChar(leadingSpaces) != leadingSpaces) {
+            leadingSpaces--;
         }
 
         if (leadingSpaces >= tabSpaces) {
+            undoSave(row, 1, CxEditJournal::EDIT);
+
             // Remove leading spaces
             line->remove(0, leadingSpaces);
 
@@ -1366,9 +1403,12 @@ CxUTFEditBuffer::entab(void)
             }
 
             line->recalculateTabWidths(tabSpaces);
+            undoChanged(1);
             touched = TRUE;
         }
     }
+
+    undoEnd();
 }
 
 
@@ -1379,13 +1419,25 @@ CxUTFEditBuffer::entab(void)
 void
 CxUTFEditBuffer::detab(void)
 {
+    undoBegin();
+
     for (unsigned long row = 0; row < _bufferLineList.entries(); row++) {
         CxUTFString *line = _bufferLineList.at(row);
+        int saved = FALSE;
+
+        if (memchr(line->data(), '\t', line->byteCount()) == NULL) {
+            continue;
+        }
 
         // Find and replace tabs with spaces
         for (int i = 0; i < (int)line->charCount(); i++) {
-            CxUTFCharacter *ch = line->at(i);
+            const CxUTFCharacter *ch = line->at(i);
             if (ch->isTab()) {
+                if (!saved) {
+                    undoSave(row, 1, CxEditJournal::EDIT);
+                    saved = TRUE;
+                }
+
                 int width = ch->displayWidth();
                 line->remove(i, 1);
 
@@ -1396,7 +1448,13 @@ CxUTFEditBuffer::detab(void)
                 touched = TRUE;
             }
         }
+
+        if (saved) {
+            undoChanged(1);
+        }
     }
+
+    undoEnd();
 }
 
 
@@ -1412,37 +1470,262 @@ CxUTFEditBuffer::trimTrailing(void)
 {
     int totalRemoved = 0;
 
+    undoBegin();
+
     for (unsigned long row = 0; row < _bufferLineList.entries(); row++) {
         CxUTFString *line = _bufferLineList.at(row);
 
-        // Find last non-whitespace character
-        int lastNonSpace = -1;
-        for (int i = 0; i < (int)line->charCount(); i++) {
-            const CxUTFCharacter *ch = line->at(i);
-            if (ch->isASCII()) {
-                char c = ch->bytes()[0];
-                if (c != ' ' && c != '\t') {
-                    lastNonSpace = i;
-                }
-            } else {
-                // Non-ASCII characters are not whitespace
-                lastNonSpace = i;
-            }
+        // Trailing spaces and tabs are a byte and a character each
+        const char *bytes = line->data();
+        int end = line->byteCount();
+        while (end > 0 && (bytes[end - 1] == ' ' || bytes[end - 1] == '\t')) {
+            end--;
         }
 
         // Remove trailing whitespace
-        int charsToRemove = (int)line->charCount() - (lastNonSpace + 1);
+        int charsToRemove = line->byteCount() - end;
         if (charsToRemove > 0) {
-            line->remove(lastNonSpace + 1, charsToRemove);
+            undoSave(row, 1, CxEditJournal::EDIT);
+            line->remove((int)line->charCount() - charsToRemove, charsToRemove);
+            undoChanged(1);
             totalRemoved += charsToRemove;
             touched = TRUE;
         }
     }
 
+    undoEnd();
+
     return totalRemoved;
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::undo
+//
+// Put back the rows changed by the last step in the journal. A run of typing still being
+// recorded is ended first, so it is what gets undone.
+//
+//-------------------------------------------------------------------------------------------------
+CxEditHint
+CxUTFEditBuffer::undo(void)
+{
+    if (readOnly) {
+        return CxEditHint(CxEditHint::UPDATE_HINT_NONE, CxEditHint::CURSOR_HINT_NONE);
+    }
+
+    _lastWasKill = false;
+
+    undoClose();
+
+    CxEditJournalStep *step = _journal.undoStep();
+    if (step == 0) {
+        return CxEditHint(CxEditHint::UPDATE_HINT_NONE, CxEditHint::CURSOR_HINT_NONE);
+    }
+
+    return undoApply(step, TRUE);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::redo
+//
+//-------------------------------------------------------------------------------------------------
+CxEditHint
+CxUTFEditBuffer::redo(void)
+{
+    if (readOnly) {
+        return CxEditHint(CxEditHint::UPDATE_HINT_NONE, CxEditHint::CURSOR_HINT_NONE);
+    }
+
+    _lastWasKill = false;
+
+    undoClose();
+
+    CxEditJournalStep *step = _journal.redoStep();
+    if (step == 0) {
+        return CxEditHint(CxEditHint::UPDATE_HINT_NONE, CxEditHint::CURSOR_HINT_NONE);
+    }
+
+    return undoApply(step, FALSE);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::canUndo / canRedo / setUndoLimit
+//
+//-------------------------------------------------------------------------------------------------
+int CxUTFEditBuffer::canUndo(void) { return _journal.canUndo(); }
+int CxUTFEditBuffer::canRedo(void) { return _journal.canRedo(); }
+void CxUTFEditBuffer::setUndoLimit(unsigned long bytes) { _journal.setLimit(bytes); }
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::undoApply
+//
+// Swap the rows of each change in step, last first on undo and first first on redo, and put
+// the cursor back where it was before or after the step.
+//
+//-------------------------------------------------------------------------------------------------
+CxEditHint
+CxUTFEditBuffer::undoApply(CxEditJournalStep *step, int backward)
+{
+    unsigned long firstRow = (unsigned long) -1;
+    unsigned long lastRow = 0;
+    int linesChanged = FALSE;
+
+    int n = step->deltas();
+
+    for (int k = 0; k < n; k++) {
+        CxEditJournalDelta *d = step->delta(backward ? n - 1 - k : k);
+        unsigned long count = d->liveCount;
+
+        CxString text = _journal.swap(d, undoText(d->row, count));
+        undoReplace(d->row, count, text, d->liveCount);
+
+        if (d->liveCount != count) linesChanged = TRUE;
+        if (d->row < firstRow) firstRow = d->row;
+        if (d->row + d->liveCount > lastRow) lastRow = d->row + d->liveCount;
+    }
+
+    cursor = backward ? step->before : step->after;
+    markSet = false;
+
+    // the cursor goes back where it was, which may not be a place it can be now
+    unsigned long lines = _bufferLineList.entries();
+    if (lines == 0) {
+        cursor = CxEditBufferPosition();
+    } else {
+        if (cursor.row >= lines) cursor.row = lines - 1;
+        CxUTFString *line = _bufferLineList.at(cursor.row);
+        if (cursor.col > (unsigned long)line->charCount()) cursor.col = line->charCount();
+    }
+
+    lastRequestCol = cursor.col;
+    touched = TRUE;
+
+    if (lastRow > firstRow) lastRow--;
+
+    return CxEditHint(firstRow, lastRow, (unsigned long) n,
+                      linesChanged ? CxEditHint::UPDATE_HINT_SCREEN_PAST_POINT : CxEditHint::UPDATE_HINT_ROWS,
+                      CxEditHint::CURSOR_HINT_JUMP);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::undoText
+//
+//-------------------------------------------------------------------------------------------------
+CxString
+CxUTFEditBuffer::undoText(unsigned long row, unsigned long count)
+{
+    CxString text;
+
+    for (unsigned long i = 0; i < count; i++) {
+        CxUTFString *line = _bufferLineList.at(row + i);
+        if (line == 0) break;
+        CxEditJournal::appendRow(&text, line->toBytes());
+    }
+
+    return text;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::undoReplace
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxUTFEditBuffer::undoReplace(unsigned long row, unsigned long count, CxString text, unsigned long newCount)
+{
+    unsigned long offset = 0;
+
+    for (unsigned long k = 0; k < newCount; k++) {
+        CxString bytes = CxEditJournal::nextRow(text, &offset);
+
+        CxUTFString line;
+        line.fromBytes(bytes.data(), bytes.length(), tabSpaces);
+
+        if (k < count) {
+            _bufferLineList.replaceAt(row + k, line);
+        } else if (row + k > 0) {
+            _bufferLineList.insertAfter(row + k - 1, line);
+        } else {
+            _bufferLineList.insertBefore(0, line);
+        }
+    }
+
+    for (unsigned long k = newCount; k < count; k++) {
+        _bufferLineList.removeAt(row + newCount);
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::undoSave
+//
+// Called before count rows from row change, returns how many of them exist. A change that
+// does not belong with the step being recorded ends it, and one that does not overlap the last
+// change recorded completes that change, so both are trimmed while their rows are still where
+// they were recorded.
+//
+//-------------------------------------------------------------------------------------------------
+unsigned long
+CxUTFEditBuffer::undoSave(unsigned long row, unsigned long count, int kind)
+{
+    unsigned long lines = _bufferLineList.entries();
+    if (row + count > lines) {
+        count = (lines > row) ? lines - row : 0;
+    }
+
+    if (!_journal.continues(row, count, kind)) {
+        undoClose();
+    } else if (!_journal.touches(row, count)) {
+        CxEditJournalDelta *d = _journal.untrimmed();
+        if (d != 0) _journal.trimLast(undoText(d->row, d->liveCount));
+    }
+
+    if (_journal.covers(row, count)) {
+        _journal.save(row, count, CxString(), kind, cursor);
+    } else {
+        _journal.save(row, count, undoText(row, count), kind, cursor);
+    }
+
+    return count;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// CxUTFEditBuffer::undoChanged / undoBegin / undoEnd / undoClose
+//
+//-------------------------------------------------------------------------------------------------
+void
+CxUTFEditBuffer::undoChanged(unsigned long count)
+{
+    _journal.changed(count, cursor);
+}
+
+void
+CxUTFEditBuffer::undoBegin(void)
+{
+    if (_journal.depth() == 0) undoClose();
+    _journal.begin();
+}
+
+void
+CxUTFEditBuffer::undoEnd(void)
+{
+    if (_journal.end(cursor)) undoClose();
+}
+
+void
+CxUTFEditBuffer::undoClose(void)
+{
+    CxEditJournalDelta *d = _journal.untrimmed();
+    if (d != 0) _journal.trimLast(undoText(d->row, d->liveCount));
+    _journal.close();
+}
+
+
 //-------------------------------------------------------------------------------------------------
 // State accessors
 //-------------------------------------------------------------------------------------------------
@@ -1558,18 +1841,17 @@ CxUTFEditBuffer::insertCommentBlock(unsigned long lastCol)
 {
     if (readOnly) return;
 
-    // Get the current line text as bytes
+    undoBegin();
+
+    // Get the text before the cursor as bytes (get leading whitespace)
     CxString text = "";
     if (cursor.row < _bufferLineList.entries()) {
         CxUTFString *currentLine = _bufferLineList.at(cursor.row);
         if (currentLine) {
-            text = currentLine->toBytes();
+            text = currentLine->subString(0, cursor.col).toBytes();
         }
     }
 
-    // Cut the preceding text before the cursor (get leading whitespace)
-    text = text.subString(0, cursor.col);
-
     // Calculate how many remaining positions there are for dashes
     unsigned long remainingCharacterNumber = 0;
     if (lastCol > text.length() + 2) {
@@ -1613,4 +1895,6 @@ CxUTFEditBuffer::insertCommentBlock(unsigned long lastCol)
     cursorRightRequest();
     cursorRightRequest();
     cursorRightRequest();
+
+    undoEnd();
 }
@@ -22,6 +22,7 @@
 #include <cx/editbuffer/utfstringlist.h>
 #include <cx/editbuffer/edithint.h>
 #include <cx/editbuffer/editbufferpos.h>
+#include <cx/editbuffer/editjournal.h>
 
 
 //-------------------------------------------------------------------------------------------------
@@ -198,6 +199,21 @@ class CxUTFEditBuffer
     int trimTrailing(void);
     // remove trailing whitespace from all lines, returns count of characters removed
 
+    //----- Undo -----
+
+    CxEditHint undo(void);
+    // put back the rows changed by the last command or run of typing
+
+    CxEditHint redo(void);
+    // make the change undo() last put back again
+
+    int canUndo(void);
+    int canRedo(void);
+    // return TRUE if there is anything to undo or redo
+
+    void setUndoLimit(unsigned long bytes);
+    // most memory the undo history may use
+
     //----- State -----
 
     int isReadOnly(void);
@@ -249,8 +265,23 @@ class CxUTFEditBuffer
 
     CxEditBufferPosition getPositionPriorToCursor(void);
 
+    void appendLines(const char *text, unsigned long len, int dropCR);
+    // parse the lines of text into the end of the buffer
+
     CxEditHint joinLines(void);
 
+    CxString undoText(unsigned long row, unsigned long count);
+    void undoReplace(unsigned long row, unsigned long count, CxString text, unsigned long newCount);
+    unsigned long undoSave(unsigned long row, unsigned long count, int kind);
+    void undoChanged(unsigned long count);
+    void undoBegin(void);
+    void undoEnd(void);
+    void undoClose(void);
+    CxEditHint undoApply(CxEditJournalStep *step, int backward);
+    // record changes in the journal and put them back, as in CxEditBuffer
+
+    CxEditJournal _journal;
+
     CxUTFStringList _bufferLineList;
 
     int markSet;
@@ -125,9 +125,9 @@ CxUTFStringList::grow(unsigned long minCapacity)
     // Allocate new array
     CxUTFString *newList = new CxUTFString[newCapacity];
 
-    // Copy existing entries
+    // Move existing entries, their text is not copied
     for (unsigned long i = 0; i < _entries; i++) {
-        newList[i] = _list[i];
+        newList[i].swap(_list[i]);
     }
 
     // Free old array
@@ -208,7 +208,7 @@ CxUTFStringList::insertBefore(unsigned long index, const CxUTFString &s)
 
     // Shift entries down to make room
     for (unsigned long i = _entries; i > index; i--) {
-        _list[i] = _list[i - 1];
+        _list[i].swap(_list[i - 1]);
     }
 
     _list[index] = s;
@@ -243,13 +243,14 @@ CxUTFStringList::removeAt(unsigned long index)
         return;
     }
 
-    // Shift entries up
+    // Shift entries up, the removed entry ends up last
     for (unsigned long i = index; i < _entries - 1; i++) {
-        _list[i] = _list[i + 1];
+        _list[i].swap(_list[i + 1]);
     }
 
-    // Clear the last entry (now a duplicate)
-    _list[_entries - 1].clear();
+    // Free the removed entry
+    CxUTFString removed;
+    _list[_entries - 1].swap(removed);
 
     _entries--;
 }
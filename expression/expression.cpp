@@ -1330,7 +1330,7 @@ void CxExpression::DumpTokens( void )
 {
     for (int c=0; c<token_list.entries(); c++) {
 
-        CxExpressionToken token = token_list.at(c);
+        CxExpressionToken& token = token_list[c];
         token.Dump();
     }
 }
@@ -1350,7 +1350,7 @@ CxExpression::UnParseExpression(int num, char *s)
        
     for (int c=0; c<token_list.entries(); c++) {
 
-        CxExpressionToken token = token_list.at(c);
+        CxExpressionToken& token = token_list[c];
         outputString = outputString + token.asString();
     }
     
@@ -2173,7 +2173,7 @@ CxExpression::GetVariableList( void )
     
     for (int c=0; c<token_list.entries(); c++) {
 
-        CxExpressionToken token = token_list.at(c);
+        CxExpressionToken& token = token_list[c];
         
         if ((token.ttype == CxExpressionToken::VARIABLE) || 
             (token.ttype == CxExpressionToken::UNKNOWN_VARIABLE)) {
@@ -2201,7 +2201,7 @@ CxExpression::GetUnknownVariableList(void)
     
     for (int c=0; c<token_list.entries(); c++) {
 
-        CxExpressionToken token = token_list.at(c);
+        CxExpressionToken& token = token_list[c];
         
         if (token.ttype == CxExpressionToken::UNKNOWN_VARIABLE) {
             vlist.append( token.text );
@@ -2227,7 +2227,7 @@ CxExpression::GetKnownVariableList(void)
     
     for (int c=0; c<token_list.entries(); c++) {
 
-        CxExpressionToken token = token_list.at(c);
+        CxExpressionToken& token = token_list[c];
         
         if (token.ttype == CxExpressionToken::VARIABLE)  {
             vlist.append( token.text );
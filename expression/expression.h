@@ -20,6 +20,7 @@
 #include <setjmp.h>
 
 #include <cx/base/slist.h>
+#include <cx/base/array.h>
 #include <cx/base/string.h>
 
 #include <cx/expression/vardb.h>
@@ -231,7 +232,7 @@ class CxExpression
 
     
     CxString text;
-    CxSList<CxExpressionToken> token_list;
+    CxArray<CxExpressionToken> token_list;
 
 
     expressionStatus  status;
@@ -0,0 +1,129 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  arenabench.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  arenabench.cpp
+//
+//  Times parsing a document with CxJSONFactory and releasing the tree, once
+//  with the tree on the heap and once in a CxArena, and counts the frees.
+//  Not part of the library, build it against the cx libraries from this
+//  directory, all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o arenabench arenabench.cpp
+//        -L../../lib/linux_x86_64 -lcx_json -lcx_base -lpthread
+//
+//  Run as "arenabench [objects]", the default is 200000 objects, about
+//  39 MB of JSON.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <new>
+
+#include <cx/base/string.h>
+#include <cx/base/arena.h>
+#include <cx/json/json_factory.h>
+
+
+static unsigned long frees = 0;
+
+
+//-------------------------------------------------------------------------
+// operator new, delete, delete[]
+//
+// count every block given back, the memory itself comes from malloc
+//
+//-------------------------------------------------------------------------
+void *
+operator new( size_t n )
+{
+	void *p = malloc( n ? n : 1 );
+	if (p == NULL) throw std::bad_alloc();
+	return( p );
+}
+
+void operator delete( void *p ) throw() { if (p) frees++; free( p ); }
+void operator delete( void *p, size_t ) throw() { if (p) frees++; free( p ); }
+void operator delete[]( void *p ) throw() { if (p) frees++; free( p ); }
+void operator delete[]( void *p, size_t ) throw() { if (p) frees++; free( p ); }
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec + tv.tv_usec / 1e6 );
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+	int objects = argc > 1 ? atoi( argv[1] ) : 200000;
+
+	CxString doc;
+	doc.reserve( objects * 260 );
+	doc += "[";
+
+	char buffer[512];
+
+	for (int i=0; i<objects; i++) {
+		sprintf( buffer, "%s{\"id\":%d,\"name\":\"customer name number %d with some padding\","
+		         "\"active\":true,\"tags\":[\"alpha\",\"beta\",\"gamma\"],\"score\":%d.5,"
+		         "\"address\":{\"street\":\"%d long street name avenue\",\"city\":\"Springfield\"}}",
+		         i ? "," : "", i, i, i, i );
+		doc += buffer;
+	}
+
+	doc += "]";
+
+	printf( "%d objects, %.1f MB of JSON\n", objects, doc.length() / 1048576.0 );
+
+	// the first round warms the heap, the second is the one to read
+
+	for (int round=0; round<2; round++) {
+
+		double start = now();
+		CxJSONBase *root = CxJSONFactory::parse( doc );
+		double parsed = now();
+
+		unsigned long before = frees;
+		delete root;
+		double released = now();
+
+		printf( "heap : parse %.3f s  destroy %.3f s  %9lu frees\n",
+		        parsed - start, released - parsed, frees - before );
+
+		{
+			CxArena arena( 1 << 20 );
+
+			start  = now();
+			root   = CxJSONFactory::parse( doc, &arena );
+			parsed = now();
+
+			before = frees;
+		}
+		released = now();
+
+		printf( "arena: parse %.3f s  destroy %.3f s  %9lu frees\n",
+		        parsed - start, released - parsed, frees - before );
+	}
+
+	return( 0 );
+}
@@ -11,16 +11,29 @@
 //
 //-------------------------------------------------------------------------------------------------
 
+#include <string.h>
+
 #include <cx/json/json_array.h>
+#include <cx/json/json_writer.h>
 
 
 //-------------------------------------------------------------------------
 // CxJSONArray::CxJSONArray
 //
 //-------------------------------------------------------------------------
-CxJSONArray::CxJSONArray(void)
+CxJSONArray::CxJSONArray( CxArena *arena_ )
+: _objectPool( arena_ )
 {
     _type = CxJSONBase::ARRAY;
+
+    _arena         = arena_;
+    _index         = NULL;
+    _indexCount    = 0;
+    _indexCapacity = 0;
+
+    // elements are appended one at a time while parsing, take the list
+    // nodes from a pool so a large array allocates in blocks
+    _objectList.setNodePool( &_objectPool );
 }
 
 //-------------------------------------------------------------------------
@@ -32,10 +45,16 @@ CxJSONArray::~CxJSONArray(void)
 	clear();
 }
 
+//-------------------------------------------------------------------------
+// CxJSONArray::append
+//
+//-------------------------------------------------------------------------
 void
 CxJSONArray::append( CxJSONBase *o)
 {
 	_objectList.append(o);
+
+	if (_index) indexAppend( o );
 }
 
 //-------------------------------------------------------------------------
@@ -56,10 +75,95 @@ CxJSONArray::entries( void ) const
 CxJSONBase *
 CxJSONArray::at( int i ) const
 {
+	if (i >= CXJSON_INDEX_ELEMENTS && _index == NULL && i < (int) _objectList.entries()) {
+		const_cast< CxJSONArray * >( this )->buildIndex();
+	}
+
+	if (_index && i >= 0 && i < _indexCount) {
+		return( _index[i] );
+	}
+
     CxJSONBase *o = _objectList.at( i );
     return(o);
 }
 
+
+//-------------------------------------------------------------------------
+// CxJSONArray::allocateIndex
+//
+//-------------------------------------------------------------------------
+CxJSONBase **
+CxJSONArray::allocateIndex( int capacity )
+{
+	if (_arena) {
+		return( (CxJSONBase **) _arena->allocate( capacity * sizeof(CxJSONBase *) ) );
+	}
+	return( new CxJSONBase *[capacity] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONArray::buildIndex
+//
+//-------------------------------------------------------------------------
+void
+CxJSONArray::buildIndex( void )
+{
+	dropIndex();
+
+	int capacity = 16;
+	while (capacity < (int) _objectList.entries()) capacity *= 2;
+
+	_index         = allocateIndex( capacity );
+	_indexCapacity = capacity;
+
+	for (CxSListIterator< CxJSONBase * > it = _objectList.begin();
+	     it.getCurrentNode() != NULL; ++it) {
+
+		_index[_indexCount++] = *it;
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONArray::indexAppend
+//
+// A table that fills is doubled.  In an arena the old one stays behind
+// until the arena is released.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONArray::indexAppend( CxJSONBase *o )
+{
+	if (_indexCount == _indexCapacity) {
+
+		CxJSONBase **index = allocateIndex( _indexCapacity * 2 );
+		memcpy( index, _index, _indexCount * sizeof(CxJSONBase *) );
+
+		if (_arena == NULL) delete [] _index;
+
+		_index          = index;
+		_indexCapacity *= 2;
+	}
+
+	_index[_indexCount++] = o;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONArray::dropIndex
+//
+//-------------------------------------------------------------------------
+void
+CxJSONArray::dropIndex( void )
+{
+	if (_arena == NULL) delete [] _index;
+
+	_index         = NULL;
+	_indexCount    = 0;
+	_indexCapacity = 0;
+}
+
 //-------------------------------------------------------------------------
 // CxJSONArray::clear
 //
@@ -67,12 +171,21 @@ CxJSONArray::at( int i ) const
 void
 CxJSONArray::clear(void)
 {
-    for (unsigned int c=0; c<_objectList.entries(); c++) {
-        CxJSONBase *o = _objectList.at(c);
+	// objects built in an arena go back with the arena, only the list
+	// nodes are returned here
+	if (_arena) {
+		_objectList.clear();
+		dropIndex();
+		return;
+	}
+
+    // take objects off the front, at(c) would walk the list every time
+    while (_objectList.entries()) {
+        CxJSONBase *o = _objectList.first();
 		delete o;
 	}
 
-    _objectList.clear();
+	dropIndex();
 }
 
 
@@ -83,8 +196,11 @@ void CxJSONArray::print(std::ostream& str ) const
     int first = 1;
 
     str << "[";
-    for (unsigned int c=0; c< _objectList.entries(); c++) {
-        CxJSONBase *b =  _objectList.at(c);
+
+    CxSList< CxJSONBase * >& list = const_cast< CxSList< CxJSONBase * >& >( _objectList );
+
+    for (CxSListIterator< CxJSONBase * > it = list.begin(); it.getCurrentNode() != NULL; ++it) {
+        CxJSONBase *b = *it;
 
 		if (!first) str << ",";
 
@@ -96,26 +212,18 @@ void CxJSONArray::print(std::ostream& str ) const
 }
 
 /* virtual */
-CxString CxJSONArray::toJsonString(void) const
+void CxJSONArray::write( CxJSONWriter& writer ) const
 {
-    CxString result("[");
-    int first = 1;
+    writer.beginArray();
 
-    for (unsigned int c=0; c< _objectList.entries(); c++) {
-        CxJSONBase *b =  _objectList.at(c);
+    // walk the nodes, at() would count from the head for each element
+    CxSList< CxJSONBase * >& list = const_cast< CxSList< CxJSONBase * >& >( _objectList );
 
-        if (!first) result += ",";
-
-        if (b != NULL) {
-            result += b->toJsonString();
-        } else {
-            result += "null";
-        }
-
-        first = 0;
+    for (CxSListIterator< CxJSONBase * > it = list.begin(); it.getCurrentNode() != NULL; ++it) {
+        writer.value( *it );
     }
-    result += "]";
-    return result;
+
+    writer.endArray();
 }
 
 
@@ -13,6 +13,7 @@
 
 #include <cx/base/string.h>
 #include <cx/base/slist.h>
+#include <cx/base/arena.h>
 #include <cx/json/json_base.h>
 
 
@@ -20,16 +21,25 @@
 #define _CXJSON_ARRAY_
 
 
+// at() counts along the list for an index below this, and builds an index
+// of the elements for anything further in
+#define CXJSON_INDEX_ELEMENTS 8
+
 
 //-------------------------------------------------------------------------
 // CxJSONArray
 //
+// The first at() past CXJSON_INDEX_ELEMENTS builds a table of the elements
+// so every at() after it is a single lookup.  append() adds to the table,
+// clear() drops it.
+//
 //-------------------------------------------------------------------------
 class CxJSONArray: public CxJSONBase
 {
   public:
 
-	CxJSONArray( void );
+	CxJSONArray( CxArena *arena_ = NULL );
+	// constructor, list nodes come from arena_ when one is given
 
 	~CxJSONArray( void );
 
@@ -45,7 +55,7 @@ class CxJSONArray: public CxJSONBase
 	void
 	clear(void);
 
-    virtual CxString toJsonString(void) const;
+    virtual void write( CxJSONWriter& writer ) const;
 
   protected:
 
@@ -53,8 +63,25 @@ class CxJSONArray: public CxJSONBase
 
   private:
 
+	void buildIndex( void );
+	void indexAppend( CxJSONBase *b );
+	void dropIndex( void );
+
+	CxJSONBase **allocateIndex( int capacity );
+
+    CxListNodePool< CxJSONBase *> _objectPool;
     CxSList< CxJSONBase *> _objectList;
 
+	CxArena     *_arena;
+	CxJSONBase **_index;
+	int          _indexCount;
+	int          _indexCapacity;
+	// the elements in order, once at() has needed them.  In an arena the
+	// table comes from the arena
+
+    friend class CxJSONPath;
+    // walks the list directly
+
     friend std::ostream& operator<<(std::ostream& str, const CxJSONArray& a_ );
     // outputs a CxString to an ostream
 
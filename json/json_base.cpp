@@ -12,6 +12,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <cx/json/json_base.h>
+#include <cx/json/json_writer.h>
 
 
 //-------------------------------------------------------------------------
@@ -23,6 +24,14 @@ CxJSONBase::CxJSONBase()
     _type = CxJSONBase::BASE;
 }
 
+//-------------------------------------------------------------------------
+// CxJSONBase::~CxJSONBase
+//
+//-------------------------------------------------------------------------
+CxJSONBase::~CxJSONBase()
+{
+}
+
 CxJSONBase::JSONObjectType 
 CxJSONBase::type( void )
 {
@@ -46,7 +55,15 @@ void CxJSONBase::print( std::ostream& str ) const
 /* virtual */
 CxString CxJSONBase::toJsonString(void) const
 {
-    return CxString("null");
+    CxJSONWriter writer;
+    write( writer );
+    return( writer.result() );
+}
+
+/* virtual */
+void CxJSONBase::write( CxJSONWriter& writer ) const
+{
+    writer.null();
 }
 
 //-------------------------------------------------------------------------
@@ -19,6 +19,7 @@
 #include <cx/base/string.h>
 
 class CxJSONBase;
+class CxJSONWriter;
 
 
 //-------------------------------------------------------------------------
@@ -34,6 +35,9 @@ class CxJSONBase
     CxJSONBase(void);
     // constructor
 
+    virtual ~CxJSONBase(void);
+    // destructor
+
     void dump( void );
 
     CxJSONBase::JSONObjectType
@@ -42,6 +46,9 @@ class CxJSONBase
     virtual CxString toJsonString(void) const;
     // returns the JSON representation as a CxString (portable, no sstream needed)
 
+    virtual void write( CxJSONWriter& writer ) const;
+    // write the JSON representation, see CxJSONWriter
+
   protected:
 
     JSONObjectType _type;
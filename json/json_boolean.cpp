@@ -12,6 +12,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <cx/json/json_boolean.h>
+#include <cx/json/json_writer.h>
 
 
 
@@ -78,10 +79,9 @@ void CxJSONBoolean::print(std::ostream& str ) const
 }
 
 /* virtual */
-CxString CxJSONBoolean::toJsonString(void) const
+void CxJSONBoolean::write( CxJSONWriter& writer ) const
 {
-    if (_i) return CxString("true");
-    return CxString("false");
+    writer.boolean( _i );
 }
 
 //-------------------------------------------------------------------------
@@ -46,7 +46,7 @@ class CxJSONBoolean: public CxJSONBase
 
 	void dump(void);
 
-    virtual CxString toJsonString(void) const;
+    virtual void write( CxJSONWriter& writer ) const;
 
   protected:
 
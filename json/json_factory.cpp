@@ -11,119 +11,763 @@
 //
 //-------------------------------------------------------------------------------------------------
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cx/base/utfcharacter.h>
 #include <cx/json/json_factory.h>
 
 
 //-------------------------------------------------------------------------
-// CxJSONFactory::CxJSONFactory
+// CxJSONParser
+//
+// Recursive descent over the text, making each node as its value is read.
+// A string without escapes is copied once, from the text into its node;
+// one with escapes is decoded into a scratch buffer first.  On an error
+// everything built so far is deleted, or given back to the arena, and the
+// first error is recorded.
 //
 //-------------------------------------------------------------------------
-CxJSONFactory::CxJSONFactory(void)
+class CxJSONParser
+{
+  public:
+
+	CxJSONParser( const char *text, int len, CxArena *arena, CxJSONParseError *error,
+	              CxJSONKeys *keys );
+
+	~CxJSONParser( void );
+
+	CxJSONBase *parseDocument( void );
+
+  private:
+
+	CxJSONBase *parseValue( int depth );
+	CxJSONBase *parseObject( int depth );
+	CxJSONBase *parseArray( int depth );
+	CxJSONBase *parseNumber( void );
+
+	int parseString( const char **s, int *len );
+	// read the string at _p, setting s to its characters in the text or
+	// in the scratch buffer
+
+	int parseLiteral( const char *word, int wordLen );
+	int hex4( const char *p, unsigned int *value );
+
+	void skipSpace( void );
+	void fail( const char *at, const char *message );
+	void discard( CxJSONBase *node );
+
+	const char       *_text;
+	const char       *_p;
+	const char       *_end;
+	CxArena          *_arena;
+	CxJSONParseError *_error;
+	CxJSONKeys       *_keys;
+	int               _failed;
+
+	char *_scratch;
+	int   _scratchCapacity;
+};
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::CxJSONParser
+//
+//-------------------------------------------------------------------------
+CxJSONParser::CxJSONParser( const char *text, int len, CxArena *arena,
+                            CxJSONParseError *error, CxJSONKeys *keys )
 {
+	_text            = text;
+	_p               = text;
+	_end             = text + len;
+	_arena           = arena;
+	_error           = error;
+	_keys            = arena ? NULL : keys;
+	_failed          = 0;
+	_scratch         = NULL;
+	_scratchCapacity = 0;
 }
 
+
 //-------------------------------------------------------------------------
-// CxJSONFactory::~CxJSONFactory
+// CxJSONParser::~CxJSONParser
 //
 //-------------------------------------------------------------------------
-CxJSONFactory::~CxJSONFactory(void)
+CxJSONParser::~CxJSONParser( void )
+{
+	delete [] _scratch;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::fail
+//
+// Keep the first error, the later ones follow from it.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONParser::fail( const char *at, const char *message )
+{
+	if (_failed) return;
+	_failed = 1;
+
+	if (_error) {
+		_error->set( _text, (int) (at - _text), message );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::discard
+//
+// A node in an arena goes when the arena is rewound.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONParser::discard( CxJSONBase *node )
 {
+	if (_arena == NULL) delete node;
 }
 
 
+//-------------------------------------------------------------------------
+// CxJSONParser::skipSpace
+//
+//-------------------------------------------------------------------------
+void
+CxJSONParser::skipSpace( void )
+{
+	while (_p < _end && (*_p == ' ' || *_p == '\n' || *_p == '\r' || *_p == '\t')) {
+		_p++;
+	}
+}
+
 
 //-------------------------------------------------------------------------
-// CxString::operator<<
+// CxJSONParser::parseDocument
 //
 //-------------------------------------------------------------------------
 CxJSONBase *
-CxJSONFactory::parse( CxString txt)
+CxJSONParser::parseDocument( void )
 {
-    /*
-    txt.stripLeading(" \t\n");
-    txt.stripTrailing(" \t\n");
-    
-    // hack for parser
-    if ((txt.firstChar('}') !=0) && (txt.lastChar('}')!=0)) {
-        txt.insert("\"DUMMY\":",0);
-    }
-    
-    printf("JSON=[%s]\n", txt.data());
-*/
-    
-	//---------------------------------------------------------------------
-	// use the nx_json C parser to build a tree we can convert
-	// to C++ objects
-	//
-	//---------------------------------------------------------------------
-    const nx_json* json=nx_json_parse_utf8( txt.data() );
-    if (!json) {   
-        return( NULL );
-    }
-
-	//---------------------------------------------------------------------
-	// create and container object
-	//
-	//---------------------------------------------------------------------
-	CxJSONObject *container = new CxJSONObject();
-
-	//---------------------------------------------------------------------
-	// create an object tree from the parser
-	//
-	//---------------------------------------------------------------------
-    CxJSONFactory::walktree( json, container );
-  
-	//---------------------------------------------------------------------
-	// free up the C parser
-	//
-	//---------------------------------------------------------------------
-    nx_json_free(json);
-
-	//---------------------------------------------------------------------
-	// if things in container after walking parse tree is zero thats 
-	// and error
-	//
-	//---------------------------------------------------------------------
-	if (container->entries()==0) {
+	CxArena::Mark start;
+	if (_arena) start = _arena->mark();
+
+	skipSpace();
+
+	if (_p == _end) {
+		fail( _p, "no JSON value" );
 		return( NULL );
 	}
-                
-	//---------------------------------------------------------------------
-	// if things in container after walking parse tree is one thats 
-	// an array of 1 thing, or an object.  return the type it is and 
-	// delete the container object
-	//
-	//---------------------------------------------------------------------
- 	if (container->entries()==1) {
 
-		CxJSONMember *member= container->at(0);
+	if (*_p != '{' && *_p != '[') {
+		fail( _p, "expected an object or an array" );
+		return( NULL );
+	}
 
-		if (member) {
+	CxJSONBase *root = parseValue( 0 );
+
+	if (root) {
+		skipSpace();
+		if (_p != _end) {
+			fail( _p, "unexpected text after the JSON value" );
+			discard( root );
+			root = NULL;
+		}
+	}
 
-			CxJSONBase *innerItem = member->object();
+	if (root == NULL && _arena) {
+		_arena->rewind( start );
+	}
 
-			if (innerItem->type() == CxJSONBase::OBJECT) {
+	return( root );
+}
 
-				CxJSONMember *m = (CxJSONMember *) container->removeAt(0);
-				CxJSONObject *o = (CxJSONObject *) m->object();
-				delete container;
-				return( o );
-			}
 
-			if (innerItem->type() == CxJSONBase::ARRAY) {
-	
-				CxJSONMember *m = container->removeAt(0);
-				CxJSONObject *a = (CxJSONObject *) m->object();
-				delete container;
-				return( a );
+//-------------------------------------------------------------------------
+// CxJSONParser::parseValue
+//
+// Read the value at _p, which is past any white space.
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONParser::parseValue( int depth )
+{
+	if (_p == _end) {
+		fail( _p, "unexpected end of text" );
+		return( NULL );
+	}
+
+	switch (*_p) {
+
+		case '{':
+			return( parseObject( depth + 1 ) );
+
+		case '[':
+			return( parseArray( depth + 1 ) );
+
+		case '"':
+			{
+				const char *s;
+				int len;
+				if (!parseString( &s, &len )) return( NULL );
+				return( new (_arena) CxJSONString( s, len, _arena ) );
 			}
 
+		case 't':
+			if (!parseLiteral( "true", 4 )) return( NULL );
+			return( new (_arena) CxJSONBoolean( 1 ) );
+
+		case 'f':
+			if (!parseLiteral( "false", 5 )) return( NULL );
+			return( new (_arena) CxJSONBoolean( 0 ) );
+
+		case 'n':
+			if (!parseLiteral( "null", 4 )) return( NULL );
+			return( new (_arena) CxJSONNull() );
+
+		case '-': case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			return( parseNumber() );
+
+		default:
+			fail( _p, "expected a value" );
+			return( NULL );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::parseObject
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONParser::parseObject( int depth )
+{
+	if (depth > CXJSON_MAX_DEPTH) {
+		fail( _p, "nesting too deep" );
+		return( NULL );
+	}
+
+	CxJSONObject *o = new (_arena) CxJSONObject( _arena );
+
+	_p++;
+	skipSpace();
+
+	if (_p < _end && *_p == '}') {
+		_p++;
+		return( o );
+	}
+
+	while (1) {
+
+		if (_p == _end || *_p != '"') {
+			fail( _p, "expected a member name" );
+			discard( o );
+			return( NULL );
+		}
+
+		const char *name;
+		int nameLen;
+		if (!parseString( &name, &nameLen )) {
+			discard( o );
+			return( NULL );
+		}
+
+		// the scratch buffer is needed again for the value
+		CxString decodedName;
+		if (name == _scratch) {
+			decodedName = CxString( name, nameLen );
+			name        = decodedName.data();
+			nameLen     = decodedName.length();
+		}
+
+		skipSpace();
+		if (_p == _end || *_p != ':') {
+			fail( _p, "expected ':' after the member name" );
+			discard( o );
+			return( NULL );
+		}
+		_p++;
+		skipSpace();
+
+		CxJSONBase *value = parseValue( depth );
+		if (value == NULL) {
+			discard( o );
+			return( NULL );
+		}
+
+		if (_keys) {
+			o->append( new CxJSONMember( _keys->intern( name, nameLen ), value ) );
+		} else {
+			o->append( new (_arena) CxJSONMember( name, nameLen, value, _arena ) );
+		}
+
+		skipSpace();
+		if (_p < _end && *_p == ',') {
+			_p++;
+			skipSpace();
+			continue;
+		}
+		if (_p < _end && *_p == '}') {
+			_p++;
+			return( o );
+		}
+
+		fail( _p, "expected ',' or '}'" );
+		discard( o );
+		return( NULL );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::parseArray
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONParser::parseArray( int depth )
+{
+	if (depth > CXJSON_MAX_DEPTH) {
+		fail( _p, "nesting too deep" );
+		return( NULL );
+	}
+
+	CxJSONArray *a = new (_arena) CxJSONArray( _arena );
+
+	_p++;
+	skipSpace();
+
+	if (_p < _end && *_p == ']') {
+		_p++;
+		return( a );
+	}
+
+	while (1) {
+
+		CxJSONBase *value = parseValue( depth );
+		if (value == NULL) {
+			discard( a );
+			return( NULL );
+		}
+
+		a->append( value );
+
+		skipSpace();
+		if (_p < _end && *_p == ',') {
+			_p++;
+			skipSpace();
+			continue;
+		}
+		if (_p < _end && *_p == ']') {
+			_p++;
+			return( a );
+		}
+
+		fail( _p, "expected ',' or ']'" );
+		discard( a );
+		return( NULL );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::parseNumber
+//
+// Check the number against the JSON grammar.  Whole numbers of up to 15
+// digits are exact in a double and are added up directly, anything else
+// goes to strtod.
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONParser::parseNumber( void )
+{
+	const char *start = _p;
+	const char *q     = _p;
+	int         whole = 1;
+
+	if (*q == '-') q++;
+
+	if (q < _end && *q == '0') {
+		q++;
+	} else if (q < _end && *q >= '1' && *q <= '9') {
+		while (q < _end && *q >= '0' && *q <= '9') q++;
+	} else {
+		fail( start, "invalid number" );
+		return( NULL );
+	}
+
+	if (q < _end && *q == '.') {
+		whole = 0;
+		q++;
+		if (q == _end || *q < '0' || *q > '9') {
+			fail( start, "invalid number" );
+			return( NULL );
+		}
+		while (q < _end && *q >= '0' && *q <= '9') q++;
+	}
+
+	if (q < _end && (*q == 'e' || *q == 'E')) {
+		whole = 0;
+		q++;
+		if (q < _end && (*q == '+' || *q == '-')) q++;
+		if (q == _end || *q < '0' || *q > '9') {
+			fail( start, "invalid number" );
 			return( NULL );
 		}
+		while (q < _end && *q >= '0' && *q <= '9') q++;
 	}
 
-	return( NULL );
+	_p = q;
+
+	int    len = (int) (q - start);
+	double d;
+
+	if (whole && len <= 15) {
+		const char *digit = start;
+		if (*digit == '-') digit++;
+
+		long long n = 0;
+		for (; digit < q; digit++) n = n * 10 + (*digit - '0');
+		d = (double) n;
+		if (*start == '-') d = -d;
+
+	} else {
+		char  buffer[64];
+		char *number = buffer;
+		if (len >= (int) sizeof(buffer)) number = new char[len + 1];
+
+		memcpy( number, start, len );
+		number[len] = 0;
+		d = strtod( number, NULL );
+
+		if (number != buffer) delete [] number;
+	}
+
+	return( new (_arena) CxJSONNumber( d ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::parseLiteral
+//
+//-------------------------------------------------------------------------
+int
+CxJSONParser::parseLiteral( const char *word, int wordLen )
+{
+	if (_end - _p < wordLen || memcmp( _p, word, wordLen ) != 0) {
+		fail( _p, "expected a value" );
+		return( 0 );
+	}
+
+	_p += wordLen;
+	return( 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::hex4
+//
+//-------------------------------------------------------------------------
+int
+CxJSONParser::hex4( const char *p, unsigned int *value )
+{
+	if (_end - p < 4) return( 0 );
+
+	*value = 0;
+	for (int i=0; i<4; i++) {
+		char c = p[i];
+		int  h;
+		if (c >= '0' && c <= '9')      h = c - '0';
+		else if (c >= 'a' && c <= 'f') h = c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F') h = c - 'A' + 10;
+		else return( 0 );
+		*value = (*value << 4) | h;
+	}
+	return( 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParser::parseString
+//
+// Find the closing quote first.  A string without escapes is left in the
+// text; one with escapes is decoded into the scratch buffer, which is never
+// longer than the escaped form.
+//
+//-------------------------------------------------------------------------
+int
+CxJSONParser::parseString( const char **s, int *len )
+{
+	const char *start   = _p + 1;
+	const char *q       = start;
+	int         escaped = 0;
+
+	while (1) {
+		if (q == _end) {
+			fail( _p, "no closing quote for string" );
+			return( 0 );
+		}
+		unsigned char c = (unsigned char) *q;
+		if (c == '"') break;
+		if (c == '\\') {
+			escaped = 1;
+			q += 2;
+			if (q > _end) q = _end;
+			continue;
+		}
+		if (c < 0x20) {
+			fail( q, "control character in string" );
+			return( 0 );
+		}
+		q++;
+	}
+
+	const char *close = q;
+
+	if (!escaped) {
+		*s   = start;
+		*len = (int) (close - start);
+		_p   = close + 1;
+		return( 1 );
+	}
+
+	int rawLen = (int) (close - start);
+	if (_scratchCapacity < rawLen) {
+		delete [] _scratch;
+		_scratchCapacity = rawLen < 256 ? 256 : rawLen;
+		_scratch = new char[_scratchCapacity];
+	}
+
+	char *d = _scratch;
+	q = start;
+
+	while (q < close) {
+
+		if (*q != '\\') {
+			*d++ = *q++;
+			continue;
+		}
+
+		const char *escape = q;
+		q++;
+
+		switch (*q) {
+			case '"':  *d++ = '"';  q++; break;
+			case '\\': *d++ = '\\'; q++; break;
+			case '/':  *d++ = '/';  q++; break;
+			case 'b':  *d++ = '\b'; q++; break;
+			case 'f':  *d++ = '\f'; q++; break;
+			case 'n':  *d++ = '\n'; q++; break;
+			case 'r':  *d++ = '\r'; q++; break;
+			case 't':  *d++ = '\t'; q++; break;
+
+			case 'u':
+				{
+					unsigned int cp;
+					if (!hex4( q + 1, &cp ) || q + 5 > close) {
+						fail( escape, "invalid unicode escape" );
+						return( 0 );
+					}
+					q += 5;
+
+					if (cp >= 0xDC00 && cp <= 0xDFFF) {
+						fail( escape, "invalid unicode surrogate" );
+						return( 0 );
+					}
+
+					// a high surrogate needs the low one after it
+					if (cp >= 0xD800 && cp <= 0xDBFF) {
+						unsigned int low;
+						if (close - q < 6 || q[0] != '\\' || q[1] != 'u' ||
+						    !hex4( q + 2, &low ) || low < 0xDC00 || low > 0xDFFF) {
+							fail( escape, "invalid unicode surrogate" );
+							return( 0 );
+						}
+						q += 6;
+						cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+					}
+
+					d += cxUTF8Encode( cp, (unsigned char *) d );
+				}
+				break;
+
+			default:
+				fail( escape, "invalid escape" );
+				return( 0 );
+		}
+	}
+
+	*s   = _scratch;
+	*len = (int) (d - _scratch);
+	_p   = close + 1;
+	return( 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParseError::CxJSONParseError
+//
+//-------------------------------------------------------------------------
+CxJSONParseError::CxJSONParseError( void )
+: _offset( 0 ), _line( 0 ), _column( 0 )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParseError::set
+//
+//-------------------------------------------------------------------------
+void
+CxJSONParseError::set( const char *text, int offset_, CxString message_ )
+{
+	_offset  = offset_;
+	_message = message_;
+	_line    = 1;
+	_column  = 1;
+
+	for (int c=0; c<offset_; c++) {
+		if (text[c] == '\n') {
+			_line++;
+			_column = 1;
+		} else {
+			_column++;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParseError::set
+//
+//-------------------------------------------------------------------------
+void
+CxJSONParseError::set( long offset_, long line_, long column_, CxString message_ )
+{
+	_offset  = offset_;
+	_line    = line_;
+	_column  = column_;
+	_message = message_;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParseError::offset
+//
+//-------------------------------------------------------------------------
+long
+CxJSONParseError::offset( void ) const
+{
+	return( _offset );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParseError::line
+//
+//-------------------------------------------------------------------------
+long
+CxJSONParseError::line( void ) const
+{
+	return( _line );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParseError::column
+//
+//-------------------------------------------------------------------------
+long
+CxJSONParseError::column( void ) const
+{
+	return( _column );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParseError::message
+//
+//-------------------------------------------------------------------------
+CxString
+CxJSONParseError::message( void ) const
+{
+	return( _message );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONParseError::why
+//
+//-------------------------------------------------------------------------
+CxString
+CxJSONParseError::why( void ) const
+{
+	char position[64];
+	sprintf( position, " at line %ld column %ld", _line, _column );
+
+	CxString result = _message;
+	result += position;
+	return( result );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONFactory::CxJSONFactory
+//
+//-------------------------------------------------------------------------
+CxJSONFactory::CxJSONFactory(void)
+{
+}
+
+//-------------------------------------------------------------------------
+// CxJSONFactory::~CxJSONFactory
+//
+//-------------------------------------------------------------------------
+CxJSONFactory::~CxJSONFactory(void)
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONFactory::parse
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONFactory::parse( const CxString& txt )
+{
+	return( parse( txt.c_str(), txt.length(), NULL, NULL ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONFactory::parse
+//
+// Build the tree with every node, list node and long string taken from
+// arena.  The tree must not be deleted, it goes away with the arena.
+// A NULL arena builds an ordinary tree.
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONFactory::parse( const CxString& txt, CxArena *arena )
+{
+	return( parse( txt.c_str(), txt.length(), arena, NULL ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONFactory::parse
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONFactory::parse( const char *text, int len, CxArena *arena, CxJSONParseError *error,
+                      CxJSONKeys *keys )
+{
+	if (text == NULL) len = 0;
 
+	CxJSONParser parser( text, len, arena, error, keys );
+	return( parser.parseDocument() );
 }
 
 
@@ -132,7 +776,7 @@ CxJSONFactory::parse( CxString txt)
 //
 //-------------------------------------------------------------------------
 /* static */ 
-void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject ) 
+void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject, CxArena *arena ) 
 {
 	if (!json) {
     	return;
@@ -147,14 +791,14 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
 				case CxJSONBase::ARRAY:
 					{ 
   						CxJSONArray *parentObject = (CxJSONArray *) cxjObject;
-						parentObject->append( new CxJSONNull( ) );
+						parentObject->append( new (arena) CxJSONNull( ) );
 					}
 					break;
 
  				case CxJSONBase::OBJECT:
                     {
 						CxJSONObject *parentObject = (CxJSONObject *) cxjObject;
-						parentObject->append( new CxJSONMember( json->key, new CxJSONNull( ) ));
+						parentObject->append( new (arena) CxJSONMember( json->key, new (arena) CxJSONNull( ), arena ));
 					}
 					break;
                 default:
@@ -166,12 +810,12 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
     	case NX_JSON_OBJECT:
 
       		{
-				CxJSONObject *o = new CxJSONObject();
+				CxJSONObject *o = new (arena) CxJSONObject( arena );
 
         		nx_json* js=json->child;
         		for (js=json->child; js; js=js->next) 
 				{
-          			CxJSONFactory::walktree( js, o );
+          			CxJSONFactory::walktree( js, o, arena );
         		}
 
 				switch( cxjObject->type() ) {
@@ -186,7 +830,7 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
 	 				case CxJSONBase::OBJECT:
 						{
 							CxJSONObject *parentObject = (CxJSONObject *) cxjObject;
-							parentObject->append( new CxJSONMember( json->key, o ));
+							parentObject->append( new (arena) CxJSONMember( json->key, o, arena ));
 						}
 						break;
 
@@ -201,12 +845,12 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
 		case NX_JSON_ARRAY:
 
       		{
-				CxJSONArray *a = new CxJSONArray();
+				CxJSONArray *a = new (arena) CxJSONArray( arena );
 
         		nx_json* js=json->child;
         		for (js=json->child; js; js=js->next) 
 				{
-          			CxJSONFactory::walktree( js, a);
+          			CxJSONFactory::walktree( js, a, arena );
         		}
 
 				switch( cxjObject->type() ) {
@@ -221,7 +865,7 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
 	 				case CxJSONBase::OBJECT:
 						{
 							CxJSONObject *parentObject = (CxJSONObject *) cxjObject;
-							parentObject->append( new CxJSONMember( json->key, a ));
+							parentObject->append( new (arena) CxJSONMember( json->key, a, arena ));
 						}
 						break;
 
@@ -241,14 +885,14 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
 				case CxJSONBase::ARRAY: 
 					{
 						CxJSONArray *parentObject = (CxJSONArray *) cxjObject;
-						parentObject->append( new CxJSONString( json->text_value ) );
+						parentObject->append( new (arena) CxJSONString( json->text_value, arena ) );
 					}
 					break;
 
  				case CxJSONBase::OBJECT:
 					{
 						CxJSONObject *parentObject = (CxJSONObject *) cxjObject;
-						parentObject->append( new CxJSONMember( json->key, new CxJSONString( json->text_value)));
+						parentObject->append( new (arena) CxJSONMember( json->key, new (arena) CxJSONString( json->text_value, arena ), arena ));
 					}
 					break;
                 
@@ -265,14 +909,14 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
 				case CxJSONBase::ARRAY: 
 					{
 						CxJSONArray *parentObject = (CxJSONArray *) cxjObject;
-						parentObject->append( new CxJSONNumber( json->int_value ) );
+						parentObject->append( new (arena) CxJSONNumber( json->int_value ) );
 					}
 					break;
 
  				case CxJSONBase::OBJECT:
 					{
 						CxJSONObject *parentObject = (CxJSONObject *) cxjObject;
-						parentObject->append( new CxJSONMember( json->key, new CxJSONNumber( json->int_value)));
+						parentObject->append( new (arena) CxJSONMember( json->key, new (arena) CxJSONNumber( json->int_value), arena ));
 					}
 					break;
 				
@@ -289,14 +933,14 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
 				case CxJSONBase::ARRAY: 
 					{
 						CxJSONArray *parentObject = (CxJSONArray *) cxjObject;
-						parentObject->append( new CxJSONNumber( json->dbl_value ) );
+						parentObject->append( new (arena) CxJSONNumber( json->dbl_value ) );
 					}
 					break;
 
  				case CxJSONBase::OBJECT:
 					{
 						CxJSONObject *parentObject = (CxJSONObject *) cxjObject;
-						parentObject->append( new CxJSONMember( json->key, new CxJSONNumber( json->dbl_value)));
+						parentObject->append( new (arena) CxJSONMember( json->key, new (arena) CxJSONNumber( json->dbl_value), arena ));
 					}
 					break;
 				            
@@ -313,14 +957,14 @@ void CxJSONFactory::walktree(const nx_json* json, CxJSONBase *cxjObject )
 				case CxJSONBase::ARRAY: 
 					{
 						CxJSONArray *parentObject = (CxJSONArray *) cxjObject;
-						parentObject->append( new CxJSONBoolean( json->int_value ) );
+						parentObject->append( new (arena) CxJSONBoolean( json->int_value ) );
 					}
 					break;
 
  				case CxJSONBase::OBJECT:
 					{
 						CxJSONObject *parentObject = (CxJSONObject *) cxjObject;
-						parentObject->append( new CxJSONMember( json->key, new CxJSONBoolean( json->int_value)));
+						parentObject->append( new (arena) CxJSONMember( json->key, new (arena) CxJSONBoolean( json->int_value), arena ));
 					}
 					break;
 				
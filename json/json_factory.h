@@ -15,6 +15,7 @@
 
 #include <cx/base/string.h>
 #include <cx/base/slist.h>
+#include <cx/base/arena.h>
 
 #include <cx/json/nxjson.h>
 #include <cx/json/json_base.h>
@@ -24,15 +25,61 @@
 #include <cx/json/json_number.h>
 #include <cx/json/json_object.h>
 #include <cx/json/json_array.h>
+#include <cx/json/json_keys.h>
 
 
 #ifndef _CXJSON_FACTORY_
 #define _CXJSON_FACTORY_
 
 
+// nesting deeper than this is an error rather than a way to run out of stack
+#define CXJSON_MAX_DEPTH 512
+
 
 //-------------------------------------------------------------------------
-// CxJSONBoolean
+// CxJSONParseError
+//
+// Where and why a parse failed.  offset counts bytes from the start of
+// the text; line and column count from 1, the column in bytes.
+//
+//-------------------------------------------------------------------------
+class CxJSONParseError
+{
+  public:
+
+	CxJSONParseError( void );
+
+	long offset( void ) const;
+	long line( void ) const;
+	long column( void ) const;
+
+	CxString message( void ) const;
+	// what was wrong, without the position
+
+	CxString why( void ) const;
+	// the message followed by the line and column
+
+	void set( const char *text, int offset_, CxString message_ );
+	// record an error at offset_ in text, working out the line and column
+
+	void set( long offset_, long line_, long column_, CxString message_ );
+	// record an error whose line and column are already known
+
+  private:
+
+	long     _offset;
+	long     _line;
+	long     _column;
+	CxString _message;
+};
+
+
+//-------------------------------------------------------------------------
+// CxJSONFactory
+//
+// Parse JSON text into a tree of CxJSONBase nodes.  The text must be one
+// object or array, with nothing after it but white space; anything else
+// returns NULL.
 //
 //-------------------------------------------------------------------------
 class CxJSONFactory
@@ -44,10 +91,23 @@ class CxJSONFactory
 	~CxJSONFactory( void );
 
     static 
-	CxJSONBase *parse( CxString text );
+	CxJSONBase *parse( const CxString& text );
+
+    static 
+	CxJSONBase *parse( const CxString& text, CxArena *arena );
+	// build the tree in arena, it is released with the arena, not deleted
+
+    static 
+	CxJSONBase *parse( const char *text, int len, CxArena *arena = NULL,
+	                   CxJSONParseError *error = NULL, CxJSONKeys *keys = NULL );
+	// parse len bytes at text, which need not end in a NUL.  When the
+	// parse fails and error is given it says where.  With keys the member
+	// names are interned there; an arena already holds every name once per
+	// use and its strings cannot share, so keys is ignored with an arena
 
     static 
-	void walktree(const nx_json* json, CxJSONBase *cxjObject );
+	void walktree(const nx_json* json, CxJSONBase *cxjObject, CxArena *arena = NULL );
+	// copy a tree built by nxjson, for code that calls it directly
 
 };
 
@@ -0,0 +1,143 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  json_keys.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxJSONKeys Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <string.h>
+
+#include <cx/json/json_member.h>
+#include <cx/json/json_keys.h>
+
+
+//-------------------------------------------------------------------------
+// CxJSONKeys::CxJSONKeys
+//
+//-------------------------------------------------------------------------
+CxJSONKeys::CxJSONKeys( void )
+{
+	_names    = NULL;
+	_hashes   = NULL;
+	_capacity = 0;
+	_entries  = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONKeys::~CxJSONKeys
+//
+//-------------------------------------------------------------------------
+CxJSONKeys::~CxJSONKeys( void )
+{
+	clear();
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONKeys::clear
+//
+//-------------------------------------------------------------------------
+void
+CxJSONKeys::clear( void )
+{
+	delete [] _names;
+	delete [] _hashes;
+
+	_names    = NULL;
+	_hashes   = NULL;
+	_capacity = 0;
+	_entries  = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONKeys::entries
+//
+//-------------------------------------------------------------------------
+int
+CxJSONKeys::entries( void ) const
+{
+	return( _entries );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONKeys::grow
+//
+// Double the table, the strings move by sharing their characters.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONKeys::grow( void )
+{
+	int           capacity = _capacity ? _capacity * 2 : 64;
+	CxString     *names    = new CxString[capacity];
+	unsigned int *hashes   = new unsigned int[capacity];
+
+	memset( hashes, 0, capacity * sizeof(unsigned int) );
+
+	for (int c=0; c<_capacity; c++) {
+
+		if (_hashes[c] == 0) continue;
+
+		int i = (int) (_hashes[c] & (capacity - 1));
+		while (hashes[i]) i = (i + 1) & (capacity - 1);
+
+		hashes[i] = _hashes[c];
+		names[i]  = _names[c];
+	}
+
+	delete [] _names;
+	delete [] _hashes;
+
+	_names    = names;
+	_hashes   = hashes;
+	_capacity = capacity;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONKeys::intern
+//
+//-------------------------------------------------------------------------
+CxString
+CxJSONKeys::intern( const char *name, int len )
+{
+	if ((_entries + 1) * 2 > _capacity) grow();
+
+	unsigned int h    = CxJSONMember::hashName( name, len );
+	int          mask = _capacity - 1;
+	int          i    = (int) (h & mask);
+
+	while (_hashes[i]) {
+		if (_hashes[i] == h && _names[i].length() == len &&
+		    memcmp( _names[i].c_str(), name, len ) == 0) {
+			return( _names[i] );
+		}
+		i = (i + 1) & mask;
+	}
+
+	_hashes[i] = h;
+	_names[i]  = CxString( name, len );
+	_entries++;
+
+	return( _names[i] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONKeys::intern
+//
+//-------------------------------------------------------------------------
+CxString
+CxJSONKeys::intern( const CxString& name )
+{
+	return( intern( name.c_str(), name.length() ) );
+}
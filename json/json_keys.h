@@ -0,0 +1,69 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  json_keys.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxJSONKeys Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include <cx/base/string.h>
+
+#ifndef _CXJSON_KEYS_
+#define _CXJSON_KEYS_
+
+
+//-------------------------------------------------------------------------
+// CxJSONKeys
+//
+// One copy of each member name.  intern() returns a string that shares
+// the characters of the copy kept here, so the same long name in
+// thousands of objects is held once.  Names short enough to live inside
+// a CxString cost nothing extra either way.  Pass one to
+// CxJSONFactory::parse() to have the members of a tree share their names;
+// it may be used for any number of documents and must stay alive only
+// while it is being used, the strings it returns keep their own hold.
+//
+//-------------------------------------------------------------------------
+class CxJSONKeys
+{
+  public:
+
+	CxJSONKeys( void );
+	// constructor
+
+	~CxJSONKeys( void );
+
+	CxString intern( const char *name, int len );
+	// the kept copy of the len characters at name, added if it is new
+
+	CxString intern( const CxString& name );
+
+	int entries( void ) const;
+	// number of different names kept
+
+	void clear( void );
+	// forget every name
+
+  private:
+
+	CxJSONKeys( const CxJSONKeys& );
+	CxJSONKeys& operator=( const CxJSONKeys& );
+	// not copied
+
+	void grow( void );
+
+	CxString     *_names;
+	unsigned int *_hashes;
+	int           _capacity;
+	int           _entries;
+	// open addressed by CxJSONMember::hashName(), a hash of 0 is an empty slot
+};
+
+#endif
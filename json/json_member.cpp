@@ -12,6 +12,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <cx/json/json_member.h>
+#include <cx/json/json_writer.h>
 
 
 
@@ -33,6 +34,20 @@ CxJSONMember::CxJSONMember( CxString var_, CxJSONBase *childObject_ )
 }
 
 
+CxJSONMember::CxJSONMember( const char *var_, CxJSONBase *childObject_, CxArena *arena_ )
+: _var( var_, var_ ? strlen( var_ ) : 0, arena_ )
+{
+    _object = childObject_;
+}
+
+
+CxJSONMember::CxJSONMember( const char *var_, int len, CxJSONBase *childObject_, CxArena *arena_ )
+: _var( var_, len, arena_ )
+{
+    _object = childObject_;
+}
+
+
 CxJSONMember::~CxJSONMember( void )
 {
 	if (_object) delete _object;
@@ -43,13 +58,51 @@ CxJSONMember::~CxJSONMember( void )
 // CxJSONMember::var
 //
 //-------------------------------------------------------------------------
-CxString
+const CxString&
 CxJSONMember::var(void) const
 {
 	return(_var);
 }
 
 
+//-------------------------------------------------------------------------
+// CxJSONMember::matches
+//
+//-------------------------------------------------------------------------
+int
+CxJSONMember::matches( const char *name, int len ) const
+{
+	return( _var.length() == len && memcmp( _var.c_str(), name, len ) == 0 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONMember::nameHash
+//
+//-------------------------------------------------------------------------
+unsigned int
+CxJSONMember::nameHash( void ) const
+{
+	return( hashName( _var.c_str(), _var.length() ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONMember::hashName
+//
+// CxString::hashValue, moved off 0, which marks an empty slot.
+//
+//-------------------------------------------------------------------------
+/* static */
+unsigned int
+CxJSONMember::hashName( const char *name, int len )
+{
+	unsigned int h = CxString::hashValue( name, len );
+
+	return( h ? h : 1 );
+}
+
+
 //-------------------------------------------------------------------------
 // CxJSONMember::val
 //
@@ -82,15 +135,20 @@ void CxJSONMember::print(std::ostream& str ) const
 
 CxString CxJSONMember::toJsonString(void) const
 {
-    CxString result("\"");
-    result += _var;
-    result += "\":";
-    if (_object != NULL) {
-        result += _object->toJsonString();
-    } else {
-        result += "null";
-    }
-    return result;
+    CxJSONWriter writer;
+    write( writer );
+    return( writer.result() );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONMember::write
+//
+//-------------------------------------------------------------------------
+void CxJSONMember::write( CxJSONWriter& writer ) const
+{
+    writer.key( _var );
+    writer.value( _object );
 }
 
 
@@ -15,6 +15,7 @@
 
 #include <cx/base/string.h>
 #include <cx/base/slist.h>
+#include <cx/base/arena.h>
 
 #include <cx/json/json_base.h>
 
@@ -39,10 +40,26 @@ class CxJSONMember
     CxJSONMember( CxString, CxJSONBase *o );
     // construct from name and value strings
 
+    CxJSONMember( const char *name, CxJSONBase *o, CxArena *arena_ );
+    // construct with the name kept in arena_
+
+    CxJSONMember( const char *name, int len, CxJSONBase *o, CxArena *arena_ );
+    // the same for a name of len characters
+
 	~CxJSONMember( void );
 	// destructor
 
-    CxString var( void ) const;
+    const CxString& var( void ) const;
+    // the member's name
+
+    int matches( const char *name, int len ) const;
+    // TRUE if the member is called by the len characters at name
+
+    unsigned int nameHash( void ) const;
+    // hashName() of the member's name
+
+    static unsigned int hashName( const char *name, int len );
+    // hash of a member name, as CxJSONObject and CxJSONKeys index them
 
     CxJSONBase *object(void);
 
@@ -52,6 +69,9 @@ class CxJSONMember
 
     CxString toJsonString(void) const;
 
+    void write( CxJSONWriter& writer ) const;
+    // the quoted name, a colon and the value
+
   protected:
 
     virtual void print(std::ostream& str ) const;
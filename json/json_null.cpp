@@ -12,6 +12,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <cx/json/json_null.h>
+#include <cx/json/json_writer.h>
 
 
 //-------------------------------------------------------------------------
@@ -39,9 +40,9 @@ void CxJSONNull::print(std::ostream& str ) const
 }
 
 /* virtual */
-CxString CxJSONNull::toJsonString(void) const
+void CxJSONNull::write( CxJSONWriter& writer ) const
 {
-    return CxString("null");
+    writer.null();
 }
 
 //-------------------------------------------------------------------------
@@ -36,7 +36,7 @@ class CxJSONNull: public CxJSONBase
 
 	~CxJSONNull( void );
 
-    virtual CxString toJsonString(void) const;
+    virtual void write( CxJSONWriter& writer ) const;
 
   protected:
 
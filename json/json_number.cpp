@@ -12,6 +12,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <cx/json/json_number.h>
+#include <cx/json/json_writer.h>
 
 
 //-------------------------------------------------------------------------
@@ -71,11 +72,9 @@ void CxJSONNumber::print(std::ostream& str ) const
 }
 
 /* virtual */
-CxString CxJSONNumber::toJsonString(void) const
+void CxJSONNumber::write( CxJSONWriter& writer ) const
 {
-    char buf[64];
-    sprintf(buf, "%g", _d);
-    return CxString(buf);
+    writer.number( _d );
 }
 
 
@@ -22,6 +22,7 @@
 #include <cx/json/json_object.h>
 
 #include <cx/json/json_array.h>
+#include <cx/json/json_writer.h>
 
 
 
@@ -29,9 +30,21 @@
 // CxJSONObject::CxJSONObject
 //
 //-------------------------------------------------------------------------
-CxJSONObject::CxJSONObject(void)
+CxJSONObject::CxJSONObject( CxArena *arena_ )
+: _memberPool( arena_ )
 {
     _type = CxJSONBase::OBJECT;
+
+    _arena           = arena_;
+    _indexHash       = NULL;
+    _indexSlot       = NULL;
+    _indexCapacity   = 0;
+    _indexCount      = 0;
+    _indexDuplicates = 0;
+
+    // members are appended one at a time while parsing, take the list
+    // nodes from a pool so a large object allocates in blocks
+    _memberList.setNodePool( &_memberPool );
 }
 
 //-------------------------------------------------------------------------
@@ -51,6 +64,8 @@ void
 CxJSONObject::append( CxJSONMember *v )
 {
     _memberList.append( v );
+
+    if (_indexCapacity) indexInsert( v );
 }
 
 
@@ -87,6 +102,8 @@ CxJSONObject::removeAt( int i )
 
 		CxJSONMember *m = _memberList.at( i );
 		_memberList.removeAt( i );
+
+		if (_indexCapacity) indexRemove( m );
 		return( m );
 	}
 
@@ -95,17 +112,48 @@ CxJSONObject::removeAt( int i )
 
 
 //-------------------------------------------------------------------------
-// CxJSONObject::at
+// CxJSONObject::find
 //
 //-------------------------------------------------------------------------
 CxJSONMember *
-CxJSONObject::find( CxString name )
+CxJSONObject::find( const CxString& name )
 {
-    for (unsigned int c=0; c<_memberList.entries(); c++) {
-        
-		CxJSONMember *m = _memberList.at(c);
+	return( find( name.c_str(), name.length() ) );
+}
 
-		if (m->var() == name) {
+
+//-------------------------------------------------------------------------
+// CxJSONObject::find
+//
+//-------------------------------------------------------------------------
+CxJSONMember *
+CxJSONObject::find( const char *name, int len )
+{
+	if (_indexCapacity == 0 && (int) _memberList.entries() >= CXJSON_INDEX_MEMBERS) {
+		int capacity = 32;
+		while (capacity < (int) _memberList.entries() * 2) capacity *= 2;
+		buildIndex( capacity );
+	}
+
+	if (_indexCapacity) {
+		unsigned int h    = CxJSONMember::hashName( name, len );
+		int          mask = _indexCapacity - 1;
+
+		for (int i = (int) (h & mask); _indexHash[i]; i = (i + 1) & mask) {
+			if (_indexHash[i] == h && _indexSlot[i]->matches( name, len )) {
+				return( _indexSlot[i] );
+			}
+		}
+		return( NULL );
+	}
+
+	// walk the nodes, at() would count from the head for each member
+	for (CxSListIterator< CxJSONMember * > it = _memberList.begin();
+	     it.getCurrentNode() != NULL; ++it) {
+
+		CxJSONMember *m = *it;
+
+		if (m != NULL && m->matches( name, len )) {
 			return( m );
 		}
 	}
@@ -114,6 +162,134 @@ CxJSONObject::find( CxString name )
 }
 
 
+//-------------------------------------------------------------------------
+// CxJSONObject::buildIndex
+//
+// capacity is a power of two at least twice the number of members.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONObject::buildIndex( int capacity )
+{
+	dropIndex();
+
+	if (_arena) {
+		_indexHash = (unsigned int *)  _arena->allocate( capacity * sizeof(unsigned int) );
+		_indexSlot = (CxJSONMember **) _arena->allocate( capacity * sizeof(CxJSONMember *) );
+	} else {
+		_indexHash = new unsigned int[capacity];
+		_indexSlot = new CxJSONMember *[capacity];
+	}
+
+	memset( _indexHash, 0, capacity * sizeof(unsigned int) );
+	_indexCapacity = capacity;
+
+	for (CxSListIterator< CxJSONMember * > it = _memberList.begin();
+	     it.getCurrentNode() != NULL; ++it) {
+
+		if (*it != NULL) indexInsert( *it );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONObject::indexInsert
+//
+// A member whose name is already there is left out, so find() keeps
+// returning the first one.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONObject::indexInsert( CxJSONMember *m )
+{
+	if ((_indexCount + 1) * 2 > _indexCapacity) {
+		buildIndex( _indexCapacity * 2 );
+		return;
+	}
+
+	const CxString& name = m->var();
+	unsigned int    h    = m->nameHash();
+	int             mask = _indexCapacity - 1;
+	int             i    = (int) (h & mask);
+
+	while (_indexHash[i]) {
+		if (_indexHash[i] == h && _indexSlot[i]->matches( name.c_str(), name.length() )) {
+			_indexDuplicates = 1;
+			return;
+		}
+		i = (i + 1) & mask;
+	}
+
+	_indexHash[i] = h;
+	_indexSlot[i] = m;
+	_indexCount++;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONObject::indexRemove
+//
+// Close the gap by moving back any later entry that may, the same as
+// CxHashmap does.  When names are shared a later member may have to take
+// the place of the removed one, so the index is dropped and find() builds
+// it again.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONObject::indexRemove( CxJSONMember *m )
+{
+	if (_indexDuplicates) {
+		dropIndex();
+		return;
+	}
+
+	int mask = _indexCapacity - 1;
+	int i    = (int) (m->nameHash() & mask);
+
+	while (_indexHash[i] && _indexSlot[i] != m) {
+		i = (i + 1) & mask;
+	}
+	if (_indexHash[i] == 0) return;
+
+	int j = i;
+	while (1) {
+		j = (j + 1) & mask;
+		if (_indexHash[j] == 0) break;
+
+		// the entry at j can fill i unless its home slot lies after i, up to j
+		int home = (int) (_indexHash[j] & mask);
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			_indexHash[i] = _indexHash[j];
+			_indexSlot[i] = _indexSlot[j];
+			i = j;
+		}
+	}
+
+	_indexHash[i] = 0;
+	_indexCount--;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONObject::dropIndex
+//
+//-------------------------------------------------------------------------
+void
+CxJSONObject::dropIndex( void )
+{
+	if (_arena == NULL) {
+		delete [] _indexHash;
+		delete [] _indexSlot;
+	}
+
+	_indexHash       = NULL;
+	_indexSlot       = NULL;
+	_indexCapacity   = 0;
+	_indexCount      = 0;
+	_indexDuplicates = 0;
+}
+
+
 //-------------------------------------------------------------------------
 // CxJSONObject::clear
 //
@@ -121,12 +297,21 @@ CxJSONObject::find( CxString name )
 void
 CxJSONObject::clear(void)
 {
-    for (unsigned int c=0; c<_memberList.entries(); c++) {
-        CxJSONMember *m = _memberList.at(c);
+	// members built in an arena go back with the arena, only the list
+	// nodes are returned here
+	if (_arena) {
+		_memberList.clear();
+		dropIndex();
+		return;
+	}
+
+    // take members off the front, at(c) would walk the list every time
+    while (_memberList.entries()) {
+        CxJSONMember *m = _memberList.first();
 		delete m;
 	}
 
-    _memberList.clear();
+	dropIndex();
 }
 
 
@@ -148,24 +333,22 @@ void CxJSONObject::print(std::ostream& str ) const
 }
 
 /* virtual */
-CxString CxJSONObject::toJsonString(void) const
+void CxJSONObject::write( CxJSONWriter& writer ) const
 {
-    CxString result("{");
-    int first = 1;
+    writer.beginObject();
 
-    for (unsigned int c=0; c< _memberList.entries(); c++) {
-        CxJSONMember *m =  _memberList.at(c);
+    // walk the nodes, at() would count from the head for each member
+    CxSList< CxJSONMember * >& list = const_cast< CxSList< CxJSONMember * >& >( _memberList );
 
-        if (!first) result += ",";
+    for (CxSListIterator< CxJSONMember * > it = list.begin(); it.getCurrentNode() != NULL; ++it) {
+        CxJSONMember *m = *it;
 
         if (m != NULL) {
-            result += m->toJsonString();
+            m->write( writer );
         }
-
-        first = 0;
     }
-    result += "}";
-    return result;
+
+    writer.endObject();
 }
 
 //-------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 
 #include <cx/base/string.h>
 #include <cx/base/slist.h>
+#include <cx/base/arena.h>
 
 #include <cx/json/json_base.h>
 #include <cx/json/json_member.h>
@@ -23,15 +24,25 @@
 
 
 
+// members an object needs before find() builds a hash index of their names
+#define CXJSON_INDEX_MEMBERS 16
+
+
 //-------------------------------------------------------------------------
 // CxJSONObject
 //
+// find() looks through the members in order until the object has
+// CXJSON_INDEX_MEMBERS of them, then builds a hash index of their names.
+// append(), removeAt() and clear() keep the index up to date from then on.
+// With more than one member of the same name, find() returns the first.
+//
 //-------------------------------------------------------------------------
 class CxJSONObject: public CxJSONBase
 {
   public:
 
-	CxJSONObject( void );
+	CxJSONObject( CxArena *arena_ = NULL );
+	// constructor, list nodes come from arena_ when one is given
 
 	~CxJSONObject( void );
 
@@ -43,9 +54,15 @@ class CxJSONObject: public CxJSONBase
 
 	CxJSONMember *
 	removeAt( int i );
+	// take member i off the object and return it; on an object built in
+	// an arena the member lives in the arena and must not be deleted
 
 	CxJSONMember *
-	find( CxString name);
+	find( const CxString& name );
+
+	CxJSONMember *
+	find( const char *name, int len );
+	// the first member called by the len characters at name, or NULL
 
 	int 
 	entries(void) const;
@@ -53,7 +70,7 @@ class CxJSONObject: public CxJSONBase
 	void
 	clear(void);
 
-    virtual CxString toJsonString(void) const;
+    virtual void write( CxJSONWriter& writer ) const;
 
   protected:
 
@@ -61,8 +78,27 @@ class CxJSONObject: public CxJSONBase
 
   private:
 
+	void buildIndex( int capacity );
+	void indexInsert( CxJSONMember *m );
+	void indexRemove( CxJSONMember *m );
+	void dropIndex( void );
+
+    CxListNodePool< CxJSONMember *> _memberPool;
     CxSList< CxJSONMember *> _memberList;
 
+	CxArena       *_arena;
+	unsigned int  *_indexHash;
+	CxJSONMember **_indexSlot;
+	int            _indexCapacity;
+	int            _indexCount;
+	int            _indexDuplicates;
+	// open addressed table of the members by name, a hash of 0 is an empty
+	// slot.  In an arena the table comes from the arena.  _indexDuplicates
+	// is set once two members share a name
+
+    friend class CxJSONPath;
+    // walks the list directly
+
     friend std::ostream& operator<<(std::ostream& str, const CxJSONObject& o_ );
     // outputs a CxString to an ostream
 
@@ -0,0 +1,497 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  json_path.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxJSONPath Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+#include <cx/json/json_member.h>
+#include <cx/json/json_path.h>
+
+
+// an index with more digits than this is refused rather than overflowing
+#define CXJSON_PATH_INDEX_DIGITS 9
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::CxJSONPath
+//
+//-------------------------------------------------------------------------
+CxJSONPath::CxJSONPath( void )
+{
+	_compiled    = 0;
+	_single      = 1;
+	_errorOffset = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::CxJSONPath
+//
+//-------------------------------------------------------------------------
+CxJSONPath::CxJSONPath( const char *expression )
+{
+	_compiled    = 0;
+	_single      = 1;
+	_errorOffset = 0;
+
+	compile( expression, expression ? (int) strlen( expression ) : 0 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::CxJSONPath
+//
+//-------------------------------------------------------------------------
+CxJSONPath::CxJSONPath( const CxString& expression )
+{
+	_compiled    = 0;
+	_single      = 1;
+	_errorOffset = 0;
+
+	compile( expression );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::~CxJSONPath
+//
+//-------------------------------------------------------------------------
+CxJSONPath::~CxJSONPath( void )
+{
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::compile
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::compile( const CxString& expression )
+{
+	return( compile( expression.c_str(), expression.length() ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::compile
+//
+// The expression is kept, and read from the copy so error offsets can be
+// taken from its start.
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::compile( const char *expression, int len )
+{
+	_steps.clear();
+	_compiled    = 0;
+	_single      = 1;
+	_error       = "";
+	_errorOffset = 0;
+
+	if (expression == NULL) len = 0;
+	_expression = CxString( expression, len );
+
+	const char *p   = _expression.c_str();
+	const char *end = p + _expression.length();
+
+	if (p == end) {
+		_compiled = 1;
+		return( 1 );
+	}
+
+	if (*p == '/') {
+		_compiled = compilePointer( p, end );
+	} else if (*p == '$') {
+		_compiled = compileJSONPath( p + 1, end );
+	} else {
+		fail( p, "a path starts with '/' or '$'" );
+	}
+
+	if (!_compiled) {
+		_steps.clear();
+		_single = 1;
+	}
+
+	return( _compiled );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::fail
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::fail( const char *at, const char *message )
+{
+	_error       = message;
+	_errorOffset = (int) (at - _expression.c_str());
+
+	return( 0 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::addStep
+//
+//-------------------------------------------------------------------------
+void
+CxJSONPath::addStep( KIND kind, const CxString& name, int index )
+{
+	Step s;
+	s.kind  = kind;
+	s.name  = name;
+	s.index = index;
+
+	_steps.append( s );
+
+	if (kind == ALL) _single = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::compilePointer
+//
+// p is at the '/' before the first token.  A token of digits with no
+// leading zero may be an array index as well as a member name; any other
+// token can only name a member, including "-", which RFC 6901 uses for
+// the element after the last and so never matches anything in an array.
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::compilePointer( const char *p, const char *end )
+{
+	char *token = new char[end - p + 1];
+
+	while (p < end) {
+
+		p++;
+
+		int len = 0;
+		while (p < end && *p != '/') {
+
+			if (*p == '~') {
+				if (p + 1 < end && p[1] == '0') {
+					token[len++] = '~';
+				} else if (p + 1 < end && p[1] == '1') {
+					token[len++] = '/';
+				} else {
+					delete [] token;
+					return( fail( p, "'~' must be followed by 0 or 1" ) );
+				}
+				p += 2;
+				continue;
+			}
+
+			token[len++] = *p++;
+		}
+
+		int number = len > 0 && len <= CXJSON_PATH_INDEX_DIGITS &&
+		             (len == 1 || token[0] != '0');
+
+		int index = 0;
+		for (int c=0; number && c<len; c++) {
+			if (token[c] < '0' || token[c] > '9') number = 0;
+			else index = index * 10 + (token[c] - '0');
+		}
+
+		if (number) {
+			addStep( NAME_OR_INDEX, CxString( token, len ), index );
+		} else {
+			addStep( NAME, CxString( token, len ), -1 );
+		}
+	}
+
+	delete [] token;
+	return( 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::compileJSONPath
+//
+// p is just past the '$'.
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::compileJSONPath( const char *p, const char *end )
+{
+	char *name = new char[end - p + 1];
+	int   ok   = 1;
+
+	while (ok && p < end) {
+
+		if (*p == '.') {
+			p++;
+
+			if (p < end && *p == '.') {
+				ok = fail( p - 1, "'..' is not supported" );
+				break;
+			}
+
+			if (p < end && *p == '*') {
+				p++;
+				addStep( ALL, CxString(), -1 );
+				continue;
+			}
+
+			const char *start = p;
+			while (p < end && *p != '.' && *p != '[') p++;
+
+			if (p == start) {
+				ok = fail( p, "expected a member name after '.'" );
+				break;
+			}
+
+			addStep( NAME, CxString( start, (int) (p - start) ), -1 );
+			continue;
+		}
+
+		if (*p != '[') {
+			ok = fail( p, "expected '.' or '['" );
+			break;
+		}
+		p++;
+
+		if (p < end && *p == '*') {
+			p++;
+			addStep( ALL, CxString(), -1 );
+
+		} else if (p < end && (*p == '\'' || *p == '"')) {
+
+			char quote = *p++;
+			int  len   = 0;
+
+			while (p < end && *p != quote) {
+				if (*p == '\\' && p + 1 < end) p++;
+				name[len++] = *p++;
+			}
+
+			if (p == end) {
+				ok = fail( p, "unterminated name in brackets" );
+				break;
+			}
+			p++;
+
+			addStep( NAME, CxString( name, len ), -1 );
+
+		} else if (p < end && (*p == '-' || (*p >= '0' && *p <= '9'))) {
+
+			int negative = (*p == '-');
+			if (negative) p++;
+
+			const char *digits = p;
+			int         index  = 0;
+
+			while (p < end && *p >= '0' && *p <= '9') {
+				if (p - digits < CXJSON_PATH_INDEX_DIGITS) index = index * 10 + (*p - '0');
+				p++;
+			}
+
+			if (p == digits) {
+				ok = fail( p, "expected a digit" );
+				break;
+			}
+			if (p - digits > CXJSON_PATH_INDEX_DIGITS) {
+				ok = fail( digits, "index too large" );
+				break;
+			}
+
+			addStep( INDEX, CxString(), negative ? -index : index );
+
+		} else {
+			ok = fail( p, "expected a name, an index or '*' in brackets" );
+			break;
+		}
+
+		if (p == end || *p != ']') {
+			ok = fail( p, "expected ']'" );
+			break;
+		}
+		p++;
+	}
+
+	delete [] name;
+	return( ok );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::step
+//
+// A negative INDEX counts back from the end of the array.
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONPath::step( const Step& s, CxJSONBase *node ) const
+{
+	if (node->type() == CxJSONBase::OBJECT) {
+
+		if (s.kind == INDEX) return( NULL );
+
+		CxJSONMember *m = ((CxJSONObject *) node)->find( s.name.c_str(), s.name.length() );
+		return( m ? m->object() : NULL );
+	}
+
+	if (node->type() == CxJSONBase::ARRAY) {
+
+		if (s.kind == NAME) return( NULL );
+
+		CxJSONArray *a = (CxJSONArray *) node;
+
+		int i = s.index;
+		if (i < 0) i += a->entries();
+		if (i < 0 || i >= a->entries()) return( NULL );
+
+		return( a->at( i ) );
+	}
+
+	return( NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::match
+//
+// Steps that reach one value are followed in a loop; only a wildcard
+// recurses, once for each member or element.
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONPath::match( int k, CxJSONBase *node, CxArray< CxJSONBase * > *results ) const
+{
+	int steps = (int) _steps.entries();
+
+	while (node != NULL && k < steps && _steps[k].kind != ALL) {
+		node = step( _steps[k], node );
+		k++;
+	}
+
+	if (node == NULL) return( NULL );
+
+	if (k == steps) {
+		if (results) results->append( node );
+		return( node );
+	}
+
+	k++;
+
+	if (node->type() == CxJSONBase::ARRAY) {
+
+		CxSList< CxJSONBase * >& list = ((CxJSONArray *) node)->_objectList;
+
+		for (CxSListIterator< CxJSONBase * > it = list.begin(); it.getCurrentNode() != NULL; ++it) {
+
+			CxJSONBase *found = match( k, *it, results );
+			if (found && results == NULL) return( found );
+		}
+
+	} else if (node->type() == CxJSONBase::OBJECT) {
+
+		CxSList< CxJSONMember * >& list = ((CxJSONObject *) node)->_memberList;
+
+		for (CxSListIterator< CxJSONMember * > it = list.begin(); it.getCurrentNode() != NULL; ++it) {
+
+			if (*it == NULL) continue;
+
+			CxJSONBase *found = match( k, (*it)->object(), results );
+			if (found && results == NULL) return( found );
+		}
+	}
+
+	return( NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::evaluate
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONPath::evaluate( CxJSONBase *root ) const
+{
+	if (!_compiled || root == NULL) return( NULL );
+
+	return( match( 0, root, NULL ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::evaluate
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::evaluate( CxJSONBase *root, CxArray< CxJSONBase * >& results ) const
+{
+	int before = (int) results.entries();
+
+	if (_compiled && root != NULL) {
+		match( 0, root, &results );
+	}
+
+	return( (int) results.entries() - before );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::isCompiled
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::isCompiled( void ) const
+{
+	return( _compiled );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::isSingle
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::isSingle( void ) const
+{
+	return( _single );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::expression
+//
+//-------------------------------------------------------------------------
+CxString
+CxJSONPath::expression( void ) const
+{
+	return( _expression );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::error
+//
+//-------------------------------------------------------------------------
+CxString
+CxJSONPath::error( void ) const
+{
+	return( _error );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath::errorOffset
+//
+//-------------------------------------------------------------------------
+int
+CxJSONPath::errorOffset( void ) const
+{
+	return( _errorOffset );
+}
@@ -0,0 +1,126 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  json_path.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxJSONPath Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include <cx/base/string.h>
+#include <cx/base/array.h>
+
+#include <cx/json/json_base.h>
+#include <cx/json/json_object.h>
+#include <cx/json/json_array.h>
+
+#ifndef _CXJSON_PATH_
+#define _CXJSON_PATH_
+
+
+//-------------------------------------------------------------------------
+// CxJSONPath
+//
+// A path into a tree, compiled once and evaluated against any number of
+// trees.  Two forms are read:
+//
+//   /cells/17/formula         a JSON Pointer (RFC 6901).  Each token names
+//                             a member of an object or, when it is a
+//                             number, an element of an array.  ~0 stands
+//                             for '~' and ~1 for '/'.  "" is the root
+//
+//   $.cells[*].type           a JSONPath.  $ is the root, followed by any
+//   $['cells'][17]            of .name, ['name'] or ["name"], [n] (from
+//                             the end when negative), and .* or [*] for
+//                             every member or element
+//
+// Members are looked up with CxJSONObject::find() and elements with
+// CxJSONArray::at(), so big objects and arrays are indexed rather than
+// searched.  A wildcard walks the elements in order, which is how one
+// field is pulled out of every element of a large array.
+//
+//-------------------------------------------------------------------------
+class CxJSONPath
+{
+  public:
+
+	CxJSONPath( void );
+	// constructor, matches nothing until compiled
+
+	CxJSONPath( const char *expression );
+	CxJSONPath( const CxString& expression );
+	// compile expression, see isCompiled()
+
+	~CxJSONPath( void );
+
+	int compile( const char *expression, int len );
+	int compile( const CxString& expression );
+	// TRUE if expression is a path, otherwise see error()
+
+	int isCompiled( void ) const;
+
+	int isSingle( void ) const;
+	// TRUE if the path has no wildcard, so it matches one value at most
+
+	CxJSONBase *evaluate( CxJSONBase *root ) const;
+	// the first value the path reaches from root, or NULL
+
+	int evaluate( CxJSONBase *root, CxArray< CxJSONBase * >& results ) const;
+	// append every value the path reaches, in document order, and return
+	// how many were added
+
+	CxString expression( void ) const;
+
+	CxString error( void ) const;
+	int errorOffset( void ) const;
+	// why compile() failed, and the offset in the expression
+
+  private:
+
+	CxJSONPath( const CxJSONPath& );
+	CxJSONPath& operator=( const CxJSONPath& );
+	// not copied
+
+	enum KIND {
+		NAME,           // a member of an object
+		INDEX,          // an element of an array
+		NAME_OR_INDEX,  // a JSON Pointer token, which is either
+		ALL             // every member or element
+	};
+
+	struct Step {
+		KIND     kind;
+		CxString name;
+		int      index;
+		// index is -1 for a token that is not a number
+	};
+
+	int compilePointer( const char *p, const char *end );
+	int compileJSONPath( const char *p, const char *end );
+	int fail( const char *at, const char *message );
+
+	void addStep( KIND kind, const CxString& name, int index );
+
+	CxJSONBase *step( const Step& s, CxJSONBase *node ) const;
+	// the one value a step other than ALL reaches from node, or NULL
+
+	CxJSONBase *match( int k, CxJSONBase *node, CxArray< CxJSONBase * > *results ) const;
+	// follow the steps from k on.  Without results stop at the first
+	// value reached and return it
+
+	CxArray< Step > _steps;
+	int             _compiled;
+	int             _single;
+
+	CxString _expression;
+	CxString _error;
+	int      _errorOffset;
+};
+
+#endif
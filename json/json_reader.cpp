@@ -0,0 +1,905 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  json_reader.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxJSONReader Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <cx/base/utfcharacter.h>
+#include <cx/json/json_reader.h>
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::CxJSONReader
+//
+//-------------------------------------------------------------------------
+CxJSONReader::CxJSONReader( CxFile *file, int bufferSize )
+{
+	init( bufferSize );
+	_file = file;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::CxJSONReader
+//
+//-------------------------------------------------------------------------
+CxJSONReader::CxJSONReader( int fd, int bufferSize )
+{
+	init( bufferSize );
+	_fd = fd;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::CxJSONReader
+//
+//-------------------------------------------------------------------------
+CxJSONReader::CxJSONReader( const char *text, int len )
+{
+	init( 0 );
+	_buffer = (char *) text;
+	_end    = len;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::init
+//
+//-------------------------------------------------------------------------
+void
+CxJSONReader::init( int bufferSize )
+{
+	_file      = NULL;
+	_fd        = -1;
+	_buffer    = NULL;
+	_ownBuffer = 0;
+	_capacity  = 0;
+
+	if (bufferSize > 0) {
+		_buffer    = new char[bufferSize];
+		_ownBuffer = 1;
+		_capacity  = bufferSize;
+	}
+
+	_p         = 0;
+	_end       = 0;
+	_consumed  = 0;
+	_line      = 1;
+	_lineStart = 0;
+
+	_depth = 0;
+	_state = ROOT;
+	_event = START_OBJECT;
+
+	_token         = NULL;
+	_tokenLength   = 0;
+	_tokenCapacity = 0;
+	_text          = NULL;
+	_textLength    = 0;
+
+	_number  = 0.0;
+	_boolean = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::~CxJSONReader
+//
+//-------------------------------------------------------------------------
+CxJSONReader::~CxJSONReader( void )
+{
+	if (_ownBuffer) delete [] _buffer;
+	delete [] _token;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::position
+//
+//-------------------------------------------------------------------------
+long
+CxJSONReader::position( void ) const
+{
+	return( _consumed + _p );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::fill
+//
+// A key is still wanted after the buffer is read past it, so one that
+// was left in the buffer is moved to the token buffer first.
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::fill( void )
+{
+	if (_file == NULL && _fd < 0) return( 0 );
+
+	if (_text != NULL && _text != _token) {
+		_tokenLength = 0;
+		keep( _text, _textLength );
+		_text = _token;
+	}
+
+	_consumed += _end;
+	_p   = 0;
+	_end = 0;
+
+	long n;
+	if (_file) {
+		n = (long) _file->fread( _buffer, 1, _capacity );
+	} else {
+		do {
+			n = (long) ::read( _fd, _buffer, _capacity );
+		} while (n < 0 && errno == EINTR);
+	}
+
+	if (n <= 0) return( 0 );
+
+	_end = (int) n;
+	return( 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::peek
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::peek( void )
+{
+	if (_p == _end && !fill()) return( -1 );
+	return( (unsigned char) _buffer[_p] );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::skipSpace
+//
+// Strings cannot hold a raw newline, so this is the only place lines end.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONReader::skipSpace( void )
+{
+	while (1) {
+		if (_p == _end && !fill()) return;
+
+		char c = _buffer[_p];
+		if (c == '\n') {
+			_p++;
+			_line++;
+			_lineStart = position();
+		} else if (c == ' ' || c == '\r' || c == '\t') {
+			_p++;
+		} else {
+			return;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::keep
+//
+//-------------------------------------------------------------------------
+void
+CxJSONReader::keep( const char *s, int len )
+{
+	if (_tokenLength + len + 1 > _tokenCapacity) {
+		int capacity = _tokenCapacity ? _tokenCapacity : 256;
+		while (capacity < _tokenLength + len + 1) capacity *= 2;
+
+		char *token = new char[capacity];
+		if (_tokenLength) memcpy( token, _token, _tokenLength );
+		delete [] _token;
+
+		_token         = token;
+		_tokenCapacity = capacity;
+	}
+
+	memcpy( _token + _tokenLength, s, len );
+	_tokenLength += len;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::fail
+//
+//-------------------------------------------------------------------------
+CxJSONReader::EVENT
+CxJSONReader::fail( long at, const char *message )
+{
+	if (_state != DONE) {
+		_error.set( at, _line, at - _lineStart + 1, message );
+		_state = DONE;
+		_event = ERROR;
+	}
+	return( ERROR );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::next
+//
+//-------------------------------------------------------------------------
+CxJSONReader::EVENT
+CxJSONReader::next( void )
+{
+	if (_state == DONE) return( _event );
+
+	_text       = NULL;
+	_textLength = 0;
+
+	while (1) {
+
+		skipSpace();
+		int c = peek();
+
+		switch (_state) {
+
+			case ROOT:
+				if (c < 0) return( fail( position(), "no JSON value" ) );
+				if (c != '{' && c != '[') {
+					return( fail( position(), "expected an object or an array" ) );
+				}
+				return( startValue( c ) );
+
+			case FIRST_MEMBER:
+				if (c == '}') {
+					_p++;
+					return( endContainer( END_OBJECT ) );
+				}
+				// fall through
+
+			case MEMBER:
+				if (c != '"') return( fail( position(), "expected a member name" ) );
+				if (!readString()) return( ERROR );
+
+				skipSpace();
+				if (peek() != ':') {
+					return( fail( position(), "expected ':' after the member name" ) );
+				}
+				_p++;
+
+				_state = VALUE;
+				return( _event = KEY );
+
+			case FIRST_ELEMENT:
+				if (c == ']') {
+					_p++;
+					return( endContainer( END_ARRAY ) );
+				}
+				// fall through
+
+			case VALUE:
+				return( startValue( c ) );
+
+			case AFTER_VALUE:
+				if (c == ',') {
+					_p++;
+					_state = _stack[_depth - 1] == '{' ? MEMBER : VALUE;
+					continue;
+				}
+				if (_stack[_depth - 1] == '{') {
+					if (c != '}') return( fail( position(), "expected ',' or '}'" ) );
+					_p++;
+					return( endContainer( END_OBJECT ) );
+				}
+				if (c != ']') return( fail( position(), "expected ',' or ']'" ) );
+				_p++;
+				return( endContainer( END_ARRAY ) );
+
+			case AFTER_ROOT:
+				if (c >= 0) {
+					return( fail( position(), "unexpected text after the JSON value" ) );
+				}
+				_state = DONE;
+				return( _event = END_DOCUMENT );
+
+			default:
+				return( _event );
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::startValue
+//
+// c is the first byte of a value, not yet used.
+//
+//-------------------------------------------------------------------------
+CxJSONReader::EVENT
+CxJSONReader::startValue( int c )
+{
+	switch (c) {
+
+		case '{':
+		case '[':
+			if (_depth == CXJSON_MAX_DEPTH) return( fail( position(), "nesting too deep" ) );
+			_stack[_depth++] = (char) c;
+			_p++;
+			if (c == '{') {
+				_state = FIRST_MEMBER;
+				return( _event = START_OBJECT );
+			}
+			_state = FIRST_ELEMENT;
+			return( _event = START_ARRAY );
+
+		case '"':
+			if (!readString()) return( ERROR );
+			return( finishValue( STRING ) );
+
+		case 't':
+			if (!readLiteral( "true" )) return( ERROR );
+			_boolean = 1;
+			return( finishValue( BOOLEAN ) );
+
+		case 'f':
+			if (!readLiteral( "false" )) return( ERROR );
+			_boolean = 0;
+			return( finishValue( BOOLEAN ) );
+
+		case 'n':
+			if (!readLiteral( "null" )) return( ERROR );
+			return( finishValue( NULLVALUE ) );
+
+		case '-': case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			if (!readNumber()) return( ERROR );
+			return( finishValue( NUMBER ) );
+
+		case -1:
+			return( fail( position(), "unexpected end of text" ) );
+
+		default:
+			return( fail( position(), "expected a value" ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::finishValue
+//
+//-------------------------------------------------------------------------
+CxJSONReader::EVENT
+CxJSONReader::finishValue( EVENT e )
+{
+	_state = _depth ? AFTER_VALUE : AFTER_ROOT;
+	return( _event = e );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::endContainer
+//
+//-------------------------------------------------------------------------
+CxJSONReader::EVENT
+CxJSONReader::endContainer( EVENT e )
+{
+	_depth--;
+	return( finishValue( e ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::readLiteral
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::readLiteral( const char *word )
+{
+	long start = position();
+
+	for (; *word; word++) {
+		if (peek() != (unsigned char) *word) {
+			fail( start, "expected a value" );
+			return( 0 );
+		}
+		_p++;
+	}
+	return( 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::readNumber
+//
+// Follow the JSON grammar a byte at a time, stopping where CxJSONFactory
+// would, and keep the characters for text() and strtod.
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::readNumber( void )
+{
+	long start = position();
+	int  whole = 1;
+	int  c     = peek();
+
+	_tokenLength = 0;
+
+	if (c == '-') {
+		keep( "-", 1 );
+		_p++;
+		c = peek();
+	}
+
+	if (c == '0') {
+		keep( "0", 1 );
+		_p++;
+		c = peek();
+	} else if (c >= '1' && c <= '9') {
+		c = readDigits();
+	} else {
+		fail( start, "invalid number" );
+		return( 0 );
+	}
+
+	if (c == '.') {
+		whole = 0;
+		keep( ".", 1 );
+		_p++;
+		c = peek();
+		if (c < '0' || c > '9') {
+			fail( start, "invalid number" );
+			return( 0 );
+		}
+		c = readDigits();
+	}
+
+	if (c == 'e' || c == 'E') {
+		whole = 0;
+		keep( "e", 1 );
+		_p++;
+		c = peek();
+		if (c == '+' || c == '-') {
+			char sign = (char) c;
+			keep( &sign, 1 );
+			_p++;
+			c = peek();
+		}
+		if (c < '0' || c > '9') {
+			fail( start, "invalid number" );
+			return( 0 );
+		}
+		readDigits();
+	}
+
+	_token[_tokenLength] = 0;
+	_text       = _token;
+	_textLength = _tokenLength;
+
+	if (whole && _tokenLength <= 15) {
+		const char *digit = _token;
+		if (*digit == '-') digit++;
+
+		long long n = 0;
+		for (; *digit; digit++) n = n * 10 + (*digit - '0');
+		_number = (double) n;
+		if (*_token == '-') _number = -_number;
+
+	} else {
+		_number = strtod( _token, NULL );
+	}
+
+	return( 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::readDigits
+//
+// Keep the run of digits at _p, returning the byte after it.
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::readDigits( void )
+{
+	while (1) {
+		int s = _p;
+		while (_p < _end && _buffer[_p] >= '0' && _buffer[_p] <= '9') _p++;
+		keep( _buffer + s, _p - s );
+		if (_p < _end) return( (unsigned char) _buffer[_p] );
+		if (!fill()) return( -1 );
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::readHex4
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::readHex4( unsigned int *value )
+{
+	*value = 0;
+	for (int i=0; i<4; i++) {
+		int c = peek();
+		int h;
+		if (c >= '0' && c <= '9')      h = c - '0';
+		else if (c >= 'a' && c <= 'f') h = c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F') h = c - 'A' + 10;
+		else return( 0 );
+		*value = (*value << 4) | h;
+		_p++;
+	}
+	return( 1 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::readEscape
+//
+// The backslash at escape has been used and another byte follows it.
+// Decode the escape into the token buffer, or return why it is invalid.
+//
+//-------------------------------------------------------------------------
+const char *
+CxJSONReader::readEscape( long escape )
+{
+	int c = peek();
+	_p++;
+
+	char d;
+
+	switch (c) {
+		case '"':  d = '"';  break;
+		case '\\': d = '\\'; break;
+		case '/':  d = '/';  break;
+		case 'b':  d = '\b'; break;
+		case 'f':  d = '\f'; break;
+		case 'n':  d = '\n'; break;
+		case 'r':  d = '\r'; break;
+		case 't':  d = '\t'; break;
+
+		case 'u':
+			{
+				unsigned int cp;
+				if (!readHex4( &cp )) {
+					return( "invalid unicode escape" );
+				}
+
+				if (cp >= 0xDC00 && cp <= 0xDFFF) {
+					return( "invalid unicode surrogate" );
+				}
+
+				// a high surrogate needs the low one after it.  A backslash
+				// not followed by 'u' still escapes the byte after it
+				if (cp >= 0xD800 && cp <= 0xDBFF) {
+					unsigned int low = 0;
+					int ok = peek() == '\\';
+					if (ok) {
+						_p++;
+						ok = peek() == 'u';
+						if (!ok && peek() >= 0) _p++;
+					}
+					if (ok) { _p++; ok = readHex4( &low ); }
+					if (!ok || low < 0xDC00 || low > 0xDFFF) {
+						return( "invalid unicode surrogate" );
+					}
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				}
+
+				unsigned char utf8[4];
+				keep( (const char *) utf8, cxUTF8Encode( cp, utf8 ) );
+			}
+			return( NULL );
+
+		default:
+			return( "invalid escape" );
+	}
+
+	keep( &d, 1 );
+	return( NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::readString
+//
+// A string that ends in the buffer it started in, with no escapes, is
+// left there.  Otherwise its pieces are gathered in the token buffer.
+//
+// As in CxJSONFactory a missing closing quote or a control character is
+// reported ahead of a bad escape before it, so the first bad escape is
+// held until the closing quote is found.
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::readString( void )
+{
+	long        start   = position();
+	long        invalid = 0;
+	const char *why     = NULL;
+
+	_p++;
+	_tokenLength = 0;
+
+	while (1) {
+
+		int s = _p;
+		while (_p < _end) {
+			unsigned char c = (unsigned char) _buffer[_p];
+			if (c == '"' || c == '\\' || c < 0x20) break;
+			_p++;
+		}
+
+		if (_p < _end && _buffer[_p] == '"' && _tokenLength == 0 && why == NULL) {
+			_text       = _buffer + s;
+			_textLength = _p - s;
+			_p++;
+			return( 1 );
+		}
+
+		keep( _buffer + s, _p - s );
+
+		if (_p == _end) {
+			if (!fill()) {
+				fail( start, "no closing quote for string" );
+				return( 0 );
+			}
+			continue;
+		}
+
+		unsigned char c = (unsigned char) _buffer[_p];
+
+		if (c == '"') {
+			if (why != NULL) {
+				fail( invalid, why );
+				return( 0 );
+			}
+			_p++;
+			_text       = _token;
+			_textLength = _tokenLength;
+			return( 1 );
+		}
+
+		if (c < 0x20) {
+			fail( position(), "control character in string" );
+			return( 0 );
+		}
+
+		long escape = position();
+		_p++;
+
+		if (peek() < 0) {
+			fail( start, "no closing quote for string" );
+			return( 0 );
+		}
+
+		// past a bad escape only the closing quote is looked for
+		if (why != NULL) {
+			_p++;
+			continue;
+		}
+
+		why = readEscape( escape );
+		if (why != NULL) invalid = escape;
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::event
+//
+//-------------------------------------------------------------------------
+CxJSONReader::EVENT
+CxJSONReader::event( void ) const
+{
+	return( _event );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::text
+//
+//-------------------------------------------------------------------------
+const char *
+CxJSONReader::text( void ) const
+{
+	return( _text );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::textLength
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::textLength( void ) const
+{
+	return( _textLength );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::string
+//
+//-------------------------------------------------------------------------
+CxString
+CxJSONReader::string( void ) const
+{
+	return( CxString( _text ? _text : "", _textLength ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::number
+//
+//-------------------------------------------------------------------------
+double
+CxJSONReader::number( void ) const
+{
+	return( _number );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::boolean
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::boolean( void ) const
+{
+	return( _boolean );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::depth
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::depth( void ) const
+{
+	return( _depth );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::error
+//
+//-------------------------------------------------------------------------
+const CxJSONParseError&
+CxJSONReader::error( void ) const
+{
+	return( _error );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::offset
+//
+//-------------------------------------------------------------------------
+long
+CxJSONReader::offset( void ) const
+{
+	return( position() );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::skip
+//
+//-------------------------------------------------------------------------
+int
+CxJSONReader::skip( void )
+{
+	if (_event == KEY) {
+		if (next() == ERROR) return( 0 );
+	}
+
+	if (_event == START_OBJECT || _event == START_ARRAY) {
+		int depth = _depth;
+		while (_depth >= depth) {
+			if (next() == ERROR) return( 0 );
+		}
+	}
+
+	return( _event != ERROR );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::value
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONReader::value( CxArena *arena )
+{
+	if (_event == KEY) next();
+
+	CxArena::Mark start;
+	if (arena) start = arena->mark();
+
+	CxJSONBase *v = build( arena );
+
+	if (v == NULL && arena) {
+		arena->rewind( start );
+	}
+
+	return( v );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader::build
+//
+// Make the node for the current event, reading the members or elements
+// of an object or array.  A node in an arena goes when value() rewinds it.
+//
+//-------------------------------------------------------------------------
+CxJSONBase *
+CxJSONReader::build( CxArena *arena )
+{
+	switch (_event) {
+
+		case STRING:
+			return( new (arena) CxJSONString( _text, _textLength, arena ) );
+
+		case NUMBER:
+			return( new (arena) CxJSONNumber( _number ) );
+
+		case BOOLEAN:
+			return( new (arena) CxJSONBoolean( _boolean ) );
+
+		case NULLVALUE:
+			return( new (arena) CxJSONNull() );
+
+		case START_OBJECT:
+			{
+				CxJSONObject *o = new (arena) CxJSONObject( arena );
+
+				while (next() == KEY) {
+
+					// the token buffer is needed again for the value
+					CxString name( _text, _textLength );
+
+					next();
+					CxJSONBase *v = build( arena );
+					if (v == NULL) break;
+
+					o->append( new (arena) CxJSONMember( name.c_str(), name.length(), v, arena ) );
+				}
+
+				if (_event == END_OBJECT) return( o );
+
+				if (arena == NULL) delete o;
+				return( NULL );
+			}
+
+		case START_ARRAY:
+			{
+				CxJSONArray *a = new (arena) CxJSONArray( arena );
+
+				while (next() != END_ARRAY) {
+					CxJSONBase *v = build( arena );
+					if (v == NULL) {
+						if (arena == NULL) delete a;
+						return( NULL );
+					}
+					a->append( v );
+				}
+
+				return( a );
+			}
+
+		default:
+			return( NULL );
+	}
+}
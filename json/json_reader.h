@@ -0,0 +1,191 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  json_reader.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxJSONReader Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include <cx/base/string.h>
+#include <cx/base/file.h>
+#include <cx/base/arena.h>
+
+#include <cx/json/json_factory.h>
+
+#ifndef _CXJSON_READER_
+#define _CXJSON_READER_
+
+
+// bytes read from a file or descriptor at a time
+#define CXJSON_READER_BUFFER 65536
+
+
+//-------------------------------------------------------------------------
+// CxJSONReader
+//
+// Pull parser.  Each call to next() reads just far enough to return the
+// next event, so a document of any size is read through one fixed buffer.
+// The only other memory is for the longest single string or number, and
+// a stack of one byte per open object or array.  The grammar is the one
+// CxJSONFactory accepts, and errors are reported with the same message
+// at the same offset.
+//
+// Read from a CxFile, from a descriptor (a pipe, or a socket's fd()), or
+// from text already in memory, which is used in place.
+//
+//-------------------------------------------------------------------------
+class CxJSONReader
+{
+  public:
+
+	enum EVENT {
+		START_OBJECT,
+		END_OBJECT,
+		START_ARRAY,
+		END_ARRAY,
+		KEY,            // a member name, the value is the next event
+		STRING,
+		NUMBER,
+		BOOLEAN,
+		NULLVALUE,
+		END_DOCUMENT,   // the root has ended and only white space followed
+		ERROR           // see error(), next() keeps returning ERROR
+	};
+
+	CxJSONReader( CxFile *file, int bufferSize = CXJSON_READER_BUFFER );
+	// read from the file's current position
+
+	CxJSONReader( int fd, int bufferSize = CXJSON_READER_BUFFER );
+	// read(2) from a descriptor
+
+	CxJSONReader( const char *text, int len );
+	// read text that is already in memory, it must outlive the reader
+
+	~CxJSONReader( void );
+
+	EVENT next( void );
+	// read the next event
+
+	EVENT event( void ) const;
+	// the event next() last returned
+
+	const char *text( void ) const;
+	int textLength( void ) const;
+	// the decoded characters of a KEY or STRING, or the characters of a
+	// NUMBER.  Not NUL terminated, and only good until the next call
+
+	CxString string( void ) const;
+	// text() as a string
+
+	double number( void ) const;
+	// value of a NUMBER
+
+	int boolean( void ) const;
+	// value of a BOOLEAN
+
+	int depth( void ) const;
+	// number of objects and arrays open, counting one just started
+
+	int skip( void );
+	// after START_OBJECT or START_ARRAY read past the matching end, after
+	// a KEY read past its value.  Returns 0 on an error
+
+	CxJSONBase *value( CxArena *arena = NULL );
+	// build the value that starts with the current event, or after the
+	// current KEY, as a tree and read past it.  The tree is kept in arena
+	// when one is given.  Returns NULL on an error
+
+	const CxJSONParseError& error( void ) const;
+	// where and why reading failed
+
+	long offset( void ) const;
+	// bytes read up to the end of the current event
+
+  private:
+
+	CxJSONReader( const CxJSONReader& );
+	CxJSONReader& operator=( const CxJSONReader& );
+	// not copied
+
+	enum STATE {
+		ROOT,            // before the root value
+		FIRST_MEMBER,    // after '{'
+		MEMBER,          // after ',' in an object
+		FIRST_ELEMENT,   // after '['
+		VALUE,           // after ':' or ',' in an array
+		AFTER_VALUE,     // expecting ',' or the end of the container
+		AFTER_ROOT,      // only white space may follow
+		DONE
+	};
+
+	void init( int bufferSize );
+
+	int fill( void );
+	// read more input once the buffer has been used, 0 at the end
+
+	int peek( void );
+	// the next byte without using it, -1 at the end
+
+	void skipSpace( void );
+
+	EVENT startValue( int c );
+	EVENT finishValue( EVENT e );
+	EVENT endContainer( EVENT e );
+	EVENT fail( long at, const char *message );
+
+	int readString( void );
+	const char *readEscape( long escape );
+	// NULL, or why the escape is invalid
+	int readHex4( unsigned int *value );
+	int readNumber( void );
+	int readDigits( void );
+	int readLiteral( const char *word );
+
+	void keep( const char *s, int len );
+	// add characters to the token buffer
+
+	CxJSONBase *build( CxArena *arena );
+
+	long position( void ) const;
+
+	CxFile *_file;
+	int     _fd;
+
+	char *_buffer;
+	int   _ownBuffer;
+	int   _capacity;
+	int   _p;
+	int   _end;
+	long  _consumed;
+	// bytes that went through the buffer before what it holds now
+
+	long  _line;
+	long  _lineStart;
+	// line of the next byte, and the offset the line began at
+
+	char  _stack[ CXJSON_MAX_DEPTH ];
+	int   _depth;
+	STATE _state;
+	EVENT _event;
+
+	char       *_token;
+	int         _tokenLength;
+	int         _tokenCapacity;
+	const char *_text;
+	int         _textLength;
+	// _text is in the buffer when a string did not need copying
+
+	double _number;
+	int    _boolean;
+
+	CxJSONParseError _error;
+};
+
+#endif
@@ -12,6 +12,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <cx/json/json_string.h>
+#include <cx/json/json_writer.h>
 
 
 //-------------------------------------------------------------------------
@@ -34,6 +35,27 @@ CxJSONString::CxJSONString( CxString s)
 	_string = s;
 }
 
+//-------------------------------------------------------------------------
+// CxJSONString::CxJSONString
+//
+//-------------------------------------------------------------------------
+CxJSONString::CxJSONString( const char *s, CxArena *arena_ )
+: _string( s, s ? strlen( s ) : 0, arena_ )
+{
+    _type   = CxJSONBase::STRING;
+}
+
+//-------------------------------------------------------------------------
+// CxJSONString::CxJSONString
+//
+//-------------------------------------------------------------------------
+CxJSONString::CxJSONString( const char *s, int len, CxArena *arena_ )
+: _string( s, len, arena_ )
+{
+    _type   = CxJSONBase::STRING;
+}
+
+
 //-------------------------------------------------------------------------
 // CxJSONString::~CxJSONString
 //
@@ -99,33 +121,9 @@ void CxJSONString::print(std::ostream& str ) const
 
 
 /* virtual */
-CxString CxJSONString::toJsonString(void) const
+void CxJSONString::write( CxJSONWriter& writer ) const
 {
-    CxString result("\"");
-    CxString& s = const_cast<CxString&>(_string);
-    for (unsigned long i = 0; i < s.length(); i++) {
-        char c = (char)s.charAt(i);
-        switch (c) {
-            case '"':  result += "\\\""; break;
-            case '\\': result += "\\\\"; break;
-            case '\n': result += "\\n"; break;
-            case '\r': result += "\\r"; break;
-            case '\t': result += "\\t"; break;
-            case '\b': result += "\\b"; break;
-            case '\f': result += "\\f"; break;
-            default:
-                if ((unsigned char)c < 0x20) {
-                    char buf[8];
-                    sprintf(buf, "\\u%04x", (unsigned char)c);
-                    result += buf;
-                } else {
-                    result += c;
-                }
-                break;
-        }
-    }
-    result += "\"";
-    return result;
+    writer.string( _string );
 }
 
 
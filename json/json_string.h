@@ -15,6 +15,7 @@
 
 #include <cx/base/string.h>
 #include <cx/base/slist.h>
+#include <cx/base/arena.h>
 
 #include <cx/json/json_base.h>
 
@@ -36,6 +37,12 @@ class CxJSONString: public CxJSONBase
 
 	CxJSONString( CxString s );
 
+	CxJSONString( const char *s, CxArena *arena_ );
+	// construct with the characters kept in arena_
+
+	CxJSONString( const char *s, int len, CxArena *arena_ );
+	// the same for len characters at s
+
 	~CxJSONString( void );
 
 	void 
@@ -46,7 +53,7 @@ class CxJSONString: public CxJSONBase
 
     void dump( void );
 
-    virtual CxString toJsonString(void) const;
+    virtual void write( CxJSONWriter& writer ) const;
 
   protected:
 
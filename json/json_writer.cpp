@@ -0,0 +1,578 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  json_writer.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxJSONWriter Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <cx/json/json_base.h>
+#include <cx/json/json_writer.h>
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::CxJSONWriter
+//
+//-------------------------------------------------------------------------
+CxJSONWriter::CxJSONWriter( STYLE style )
+{
+	init( style, 256 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::CxJSONWriter
+//
+//-------------------------------------------------------------------------
+CxJSONWriter::CxJSONWriter( CxFile *file, STYLE style )
+{
+	init( style, CXJSON_WRITER_BUFFER );
+	_file = file;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::CxJSONWriter
+//
+//-------------------------------------------------------------------------
+CxJSONWriter::CxJSONWriter( int fd, STYLE style )
+{
+	init( style, CXJSON_WRITER_BUFFER );
+	_fd = fd;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::init
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::init( STYLE style, int bufferSize )
+{
+	_file   = NULL;
+	_fd     = -1;
+	_style  = style;
+	_failed = 0;
+
+	_buffer   = new char[bufferSize];
+	_length   = 0;
+	_capacity = bufferSize;
+
+	_items         = NULL;
+	_depth         = 0;
+	_itemsCapacity = 0;
+
+	_afterKey = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::~CxJSONWriter
+//
+//-------------------------------------------------------------------------
+CxJSONWriter::~CxJSONWriter( void )
+{
+	flush();
+
+	delete [] _buffer;
+	delete [] _items;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::send
+//
+//-------------------------------------------------------------------------
+int
+CxJSONWriter::send( const char *s, unsigned long len )
+{
+	while (len && !_failed) {
+
+		long n;
+		if (_file) {
+			n = (long) _file->fwrite( (void *) s, 1, len );
+		} else {
+			do {
+				n = (long) ::write( _fd, s, len );
+			} while (n < 0 && errno == EINTR);
+		}
+
+		if (n <= 0) {
+			_failed = 1;
+		} else {
+			s   += n;
+			len -= n;
+		}
+	}
+
+	return( !_failed );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::flush
+//
+//-------------------------------------------------------------------------
+int
+CxJSONWriter::flush( void )
+{
+	if (_file == NULL && _fd < 0) return( 1 );
+
+	send( _buffer, _length );
+	_length = 0;
+
+	return( !_failed );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::grow
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::grow( unsigned long len )
+{
+	unsigned long capacity = _capacity * 2;
+	while (capacity < _length + len) capacity *= 2;
+
+	char *buffer = new char[capacity];
+	memcpy( buffer, _buffer, _length );
+	delete [] _buffer;
+
+	_buffer   = buffer;
+	_capacity = capacity;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::put
+//
+// Text too long for an empty buffer goes straight to the file.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::put( const char *s, unsigned long len )
+{
+	if (_length + len > _capacity) {
+
+		if (_file == NULL && _fd < 0) {
+			grow( len );
+
+		} else {
+			flush();
+			if (len > _capacity) {
+				send( s, len );
+				return;
+			}
+		}
+	}
+
+	memcpy( _buffer + _length, s, len );
+	_length += len;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::put
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::put( char c )
+{
+	if (_length == _capacity) {
+		put( &c, 1 );
+		return;
+	}
+	_buffer[_length++] = c;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::newline
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::newline( void )
+{
+	static const char spaces[] = "                                ";
+
+	put( '\n' );
+
+	int indent = _depth * 2;
+	while (indent > 0) {
+		int n = indent < (int) sizeof(spaces) - 1 ? indent : (int) sizeof(spaces) - 1;
+		put( spaces, n );
+		indent -= n;
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::separate
+//
+// A value after a key follows the colon.  Otherwise anything but the first
+// item in a container needs a comma, and in PRETTY starts a new line.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::separate( void )
+{
+	if (_afterKey) {
+		_afterKey = 0;
+		return;
+	}
+
+	if (_depth == 0) return;
+
+	if (_items[_depth - 1]) put( ',' );
+	_items[_depth - 1] = 1;
+
+	if (_style == PRETTY) newline();
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::open
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::open( char c )
+{
+	separate();
+	put( c );
+
+	if (_depth == _itemsCapacity) {
+		int   capacity = _itemsCapacity ? _itemsCapacity * 2 : 32;
+		char *items    = new char[capacity];
+		if (_depth) memcpy( items, _items, _depth );
+		delete [] _items;
+
+		_items         = items;
+		_itemsCapacity = capacity;
+	}
+
+	_items[_depth++] = 0;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::close
+//
+// An empty container stays on one line.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::close( char c )
+{
+	if (_depth == 0) return;
+
+	_depth--;
+	if (_style == PRETTY && _items[_depth]) newline();
+
+	put( c );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::beginObject
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::beginObject( void )
+{
+	open( '{' );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::endObject
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::endObject( void )
+{
+	close( '}' );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::beginArray
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::beginArray( void )
+{
+	open( '[' );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::endArray
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::endArray( void )
+{
+	close( ']' );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::quote
+//
+// Runs that need no escape are copied in one piece.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::quote( const char *s, int len )
+{
+	put( '"' );
+
+	int run = 0;
+
+	for (int i=0; i<len; i++) {
+
+		unsigned char c = (unsigned char) s[i];
+		if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+		put( s + run, i - run );
+		run = i + 1;
+
+		switch (c) {
+			case '"':  put( "\\\"", 2 ); break;
+			case '\\': put( "\\\\", 2 ); break;
+			case '\n': put( "\\n", 2 );  break;
+			case '\r': put( "\\r", 2 );  break;
+			case '\t': put( "\\t", 2 );  break;
+			case '\b': put( "\\b", 2 );  break;
+			case '\f': put( "\\f", 2 );  break;
+			default:
+				{
+					char escape[8];
+					sprintf( escape, "\\u%04x", c );
+					put( escape, 6 );
+				}
+				break;
+		}
+	}
+
+	put( s + run, len - run );
+	put( '"' );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::key
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::key( const char *name, int len )
+{
+	separate();
+	quote( name, len );
+
+	put( ':' );
+	if (_style == PRETTY) put( ' ' );
+
+	_afterKey = 1;
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::key
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::key( const char *name )
+{
+	key( name, (int) strlen( name ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::key
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::key( const CxString& name )
+{
+	key( name.c_str(), (int) name.length() );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::string
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::string( const char *s, int len )
+{
+	separate();
+	quote( s, len );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::string
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::string( const char *s )
+{
+	string( s, (int) strlen( s ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::string
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::string( const CxString& s )
+{
+	string( s.c_str(), (int) s.length() );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::number
+//
+// Whole numbers below 10^15 are written digit by digit.  Anything else
+// gets the shortest of %.15g and %.17g that reads back as the same double.
+// JSON has no infinity or NaN, they are written as null.
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::number( double d )
+{
+	separate();
+
+	if (d != d || d - d != 0) {
+		put( "null", 4 );
+		return;
+	}
+
+	char buffer[32];
+
+	if (d > -1e15 && d < 1e15) {
+		long long n = (long long) d;
+
+		if ((double) n == d && (n != 0 || !signbit( d ))) {
+			char *p = buffer + sizeof(buffer);
+			unsigned long long u = n < 0 ? -n : n;
+			do {
+				*--p = (char) ('0' + u % 10);
+				u /= 10;
+			} while (u);
+			if (n < 0) *--p = '-';
+
+			put( p, buffer + sizeof(buffer) - p );
+			return;
+		}
+	}
+
+	sprintf( buffer, "%.15g", d );
+	if (strtod( buffer, NULL ) != d) {
+		sprintf( buffer, "%.17g", d );
+	}
+
+	put( buffer, strlen( buffer ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::boolean
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::boolean( int b )
+{
+	separate();
+
+	if (b) put( "true", 4 );
+	else   put( "false", 5 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::null
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::null( void )
+{
+	separate();
+	put( "null", 4 );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::value
+//
+//-------------------------------------------------------------------------
+void
+CxJSONWriter::value( const CxJSONBase *node )
+{
+	if (node == NULL) {
+		null();
+		return;
+	}
+
+	node->write( *this );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::ok
+//
+//-------------------------------------------------------------------------
+int
+CxJSONWriter::ok( void ) const
+{
+	return( !_failed );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::result
+//
+//-------------------------------------------------------------------------
+CxString
+CxJSONWriter::result( void ) const
+{
+	return( CxString( _buffer, (int) _length ) );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::data
+//
+//-------------------------------------------------------------------------
+const char *
+CxJSONWriter::data( void ) const
+{
+	return( _buffer );
+}
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter::length
+//
+//-------------------------------------------------------------------------
+unsigned long
+CxJSONWriter::length( void ) const
+{
+	return( _length );
+}
@@ -0,0 +1,133 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  json_writer.h
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  CxJSONWriter Class
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include <cx/base/string.h>
+#include <cx/base/file.h>
+
+#ifndef _CXJSON_WRITER_
+#define _CXJSON_WRITER_
+
+
+class CxJSONBase;
+
+// bytes held before they are written to a file or descriptor
+#define CXJSON_WRITER_BUFFER 65536
+
+
+//-------------------------------------------------------------------------
+// CxJSONWriter
+//
+// Write JSON text as it is produced, into one buffer that grows, or
+// through a fixed buffer to a CxFile or a descriptor (a pipe, or a
+// socket's fd()).  Commas, and the new lines and indents of PRETTY, are
+// put in by the writer; the caller only opens and closes containers and
+// writes keys and values in order.  Strings and keys are escaped.
+//
+//-------------------------------------------------------------------------
+class CxJSONWriter
+{
+  public:
+
+	enum STYLE {
+		COMPACT,        // no white space
+		PRETTY          // one member or element per line, indented by two
+	};
+
+	CxJSONWriter( STYLE style = COMPACT );
+	// write into memory, see result()
+
+	CxJSONWriter( CxFile *file, STYLE style = COMPACT );
+	// write to an open file
+
+	CxJSONWriter( int fd, STYLE style = COMPACT );
+	// write(2) to a descriptor
+
+	~CxJSONWriter( void );
+	// flushes what is left to the file or descriptor
+
+	void beginObject( void );
+	void endObject( void );
+	void beginArray( void );
+	void endArray( void );
+
+	void key( const char *name );
+	void key( const char *name, int len );
+	void key( const CxString& name );
+	// the name of the next member, its value follows
+
+	void string( const char *s );
+	void string( const char *s, int len );
+	void string( const CxString& s );
+	void number( double d );
+	void boolean( int b );
+	void null( void );
+
+	void value( const CxJSONBase *node );
+	// write a tree, NULL is written as null
+
+	int flush( void );
+	// write what is buffered to the file or descriptor, 0 if that failed
+
+	int ok( void ) const;
+	// 0 once a write to the file or descriptor has failed
+
+	CxString result( void ) const;
+	const char *data( void ) const;
+	unsigned long length( void ) const;
+	// the text written so far, when writing to memory.  data() is not
+	// NUL terminated
+
+  private:
+
+	CxJSONWriter( const CxJSONWriter& );
+	CxJSONWriter& operator=( const CxJSONWriter& );
+	// not copied
+
+	void init( STYLE style, int bufferSize );
+
+	void separate( void );
+	// the comma and new line before a value or key
+
+	void open( char c );
+	void close( char c );
+	void newline( void );
+
+	void quote( const char *s, int len );
+
+	void put( const char *s, unsigned long len );
+	void put( char c );
+	void grow( unsigned long len );
+
+	int send( const char *s, unsigned long len );
+	// write straight to the file or descriptor
+
+	CxFile *_file;
+	int     _fd;
+	STYLE   _style;
+	int     _failed;
+
+	char          *_buffer;
+	unsigned long  _length;
+	unsigned long  _capacity;
+
+	char *_items;
+	int   _depth;
+	int   _itemsCapacity;
+	// for each open container, whether anything has been written in it
+
+	int _afterKey;
+};
+
+#endif
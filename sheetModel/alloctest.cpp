@@ -0,0 +1,176 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  alloctest.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  alloctest.cpp
+//
+//  Counts the heap allocations made parsing a sheet with CxJSONFactory and
+//  loading it with CxSheetModel, by replacing operator new and new[].  Not
+//  part of the library, build it against the cx libraries from this
+//  directory, all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o alloctest alloctest.cpp
+//        -L../../lib/linux_x86_64 -lcx_sheetmodel -lcx_expression
+//        -lcx_json -lcx_base -lpthread
+//
+//  Run as "alloctest [cells]", the default is 20000 cells.  The counts are
+//  printed on stderr, since the expression parser traces on stdout.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <new>
+
+#include <cx/base/string.h>
+#include <cx/base/file.h>
+#include <cx/json/json_factory.h>
+#include <cx/sheetModel/sheetModel.h>
+
+
+#define SHEET_PATH "/tmp/alloctest_sheet.json"
+
+
+static unsigned long allocations = 0;
+
+
+//-------------------------------------------------------------------------
+// operator new, new[], delete, delete[]
+//
+// count every allocation, the memory itself comes from malloc
+//
+//-------------------------------------------------------------------------
+void *
+operator new( size_t n )
+{
+    allocations++;
+    void *p = malloc( n ? n : 1 );
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void *
+operator new[]( size_t n )
+{
+    allocations++;
+    void *p = malloc( n ? n : 1 );
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete( void *p ) throw() { free( p ); }
+void operator delete[]( void *p ) throw() { free( p ); }
+void operator delete( void *p, size_t ) throw() { free( p ); }
+void operator delete[]( void *p, size_t ) throw() { free( p ); }
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+//-------------------------------------------------------------------------
+// writeSheet
+//
+// a sheet with equal numbers of number, text and formula cells, 20 to a row
+//
+//-------------------------------------------------------------------------
+static int
+writeSheet( const char *path, int cells )
+{
+    FILE *f = fopen( path, "w" );
+    if (f == NULL) return FALSE;
+
+    fprintf( f, "{\n\"currentPosition\": \"A:1\",\n\"cells\": [\n" );
+
+    for (int i = 0; i < cells; i++) {
+
+        int col = i % 20;
+        int row = i / 20 + 1;
+
+        if (i % 3 == 0) {
+            fprintf( f, "{\"cell\": \"%c:%d\", \"type\": \"double\", \"value\": %d, "
+                        "\"decimalPlaces\": 2}", 'A' + col, row, i );
+        } else if (i % 3 == 1) {
+            fprintf( f, "{\"cell\": \"%c:%d\", \"type\": \"text\", \"text\": \"label %d\", "
+                        "\"bold\": true}", 'A' + col, row, i );
+        } else {
+            fprintf( f, "{\"cell\": \"%c:%d\", \"type\": \"formula\", \"formula\": \"=A%d+1\"}",
+                     'A' + col, row, row );
+        }
+
+        fprintf( f, i + 1 < cells ? ",\n" : "\n" );
+    }
+
+    fprintf( f, "]\n}\n" );
+    fclose( f );
+
+    return TRUE;
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+    int cells = argc > 1 ? atoi( argv[1] ) : 20000;
+
+    if (!writeSheet( SHEET_PATH, cells )) {
+        fprintf( stderr, "cannot write %s\n", SHEET_PATH );
+        return 1;
+    }
+
+    CxFile in;
+    in.open( SHEET_PATH, "r" );
+
+    CxString text;
+    CxString line = in.getUntil( '\n' );
+    while (line.length()) {
+        text += line;
+        line = in.getUntil( '\n' );
+    }
+    in.close();
+
+    unsigned long before = allocations;
+    double        start  = now();
+
+    CxJSONBase *root = CxJSONFactory::parse( text );
+
+    double        parseTime   = now() - start;
+    unsigned long parseAllocs = allocations - before;
+
+    delete root;
+
+    CxSheetModel model;
+
+    before = allocations;
+    start  = now();
+
+    model.loadSheet( SHEET_PATH );
+
+    double        loadTime   = now() - start;
+    unsigned long loadAllocs = allocations - before;
+
+    fprintf( stderr, "%d cells, %ld bytes of JSON\n", cells, (long) text.length() );
+    fprintf( stderr, "CxJSONFactory::parse     %10lu allocations  %.3f s\n", parseAllocs, parseTime );
+    fprintf( stderr, "CxSheetModel::loadSheet  %10lu allocations  %.3f s\n", loadAllocs, loadTime );
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  hashbench.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  hashbench.cpp
+//
+//  Times CxHashmap inserts and lookups with cell name CxString keys and
+//  CxSheetCellCoordinate keys, and reports how well hashValue() spreads
+//  them and how many key compares a lookup makes.  Not part of the
+//  library, build it against the cx libraries from this directory, all on
+//  one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o hashbench hashbench.cpp
+//        -L../../lib/linux_x86_64 -lcx_sheetmodel -lcx_expression
+//        -lcx_json -lcx_base -lpthread
+//
+//  Run as "hashbench [keys]", the default is 1000000 keys.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include <cx/base/string.h>
+#include <cx/base/hashmap.h>
+#include <cx/sheetModel/sheetCellCoordinate.h>
+
+
+static unsigned long compares = 0;
+
+
+//-------------------------------------------------------------------------
+// CountedKey
+//
+// a key that counts every compare the map makes, so the compares per
+// lookup show how far the map probes
+//
+//-------------------------------------------------------------------------
+template <class K>
+class CountedKey
+{
+  public:
+	CountedKey( void ) { }
+	CountedKey( const K& k_ ) : k( k_ ) { }
+
+	unsigned int hashValue( void ) const { return( k.hashValue() ); }
+
+	int operator==( const CountedKey<K>& other_ ) const
+	{
+		compares++;
+		return( k == other_.k );
+	}
+
+	K k;
+};
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec + tv.tv_usec / 1e6 );
+}
+
+
+//-------------------------------------------------------------------------
+// compareHash
+//
+//-------------------------------------------------------------------------
+static int
+compareHash( const void *a, const void *b )
+{
+	unsigned int x = *(const unsigned int *) a;
+	unsigned int y = *(const unsigned int *) b;
+
+	return( x < y ? -1 : (x > y ? 1 : 0) );
+}
+
+
+//-------------------------------------------------------------------------
+// distinctHashes
+//
+// how many different hashValue()s the keys have
+//
+//-------------------------------------------------------------------------
+template <class K>
+static int
+distinctHashes( const K *keys, int n )
+{
+	unsigned int *h = new unsigned int[n];
+
+	for (int i=0; i<n; i++) h[i] = keys[i].hashValue();
+
+	qsort( h, n, sizeof(unsigned int), compareHash );
+
+	int distinct = n ? 1 : 0;
+	for (int i=1; i<n; i++) {
+		if (h[i] != h[i-1]) distinct++;
+	}
+
+	delete [] h;
+	return( distinct );
+}
+
+
+//-------------------------------------------------------------------------
+// run
+//
+//-------------------------------------------------------------------------
+template <class K>
+static int
+run( const char *what, const K *keys, int n )
+{
+	int failed = 0;
+
+	// throughput with the keys themselves
+
+	CxHashmap<K,int> map;
+
+	double start = now();
+	for (int i=0; i<n; i++) map.insert( keys[i], i );
+	double inserted = now() - start;
+
+	long sum = 0;
+	start = now();
+
+	for (int round=0; round<3; round++) {
+		for (int i=0; i<n; i++) {
+			const int *found = map.find( keys[i] );
+			if (found == NULL || *found != i) failed = 1;
+			else sum += *found;
+		}
+	}
+
+	double looked = now() - start;
+
+	// the same keys again, counting compares, at a smaller size when the
+	// map probes far enough that a full run would not finish
+
+	int counted = n < 100000 ? n : 100000;
+
+	CxHashmap< CountedKey<K>, int > countedMap;
+	for (int i=0; i<counted; i++) countedMap.insert( CountedKey<K>( keys[i] ), i );
+
+	compares = 0;
+	for (int i=0; i<counted; i++) {
+		if (countedMap.find( CountedKey<K>( keys[i] ) ) == NULL) failed = 1;
+	}
+
+	printf( "%-12s %8d keys  %8d hashes  insert %7.3f s  lookup %7.2f M/s  "
+	        "%.2f compares per lookup at %d\n",
+	        what, n, distinctHashes( keys, n ), inserted, 3.0 * n / looked / 1e6,
+	        (double) compares / counted, counted );
+
+	if (failed) printf( "FAILED: %s lookup did not find its key\n", what );
+
+	return( failed );
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+	int n = argc > 1 ? atoi( argv[1] ) : 1000000;
+
+	char buffer[32];
+
+	// cell names, as the sheet and the expression evaluator key on
+
+	CxString *names = new CxString[n];
+
+	for (int i=0; i<n; i++) {
+		sprintf( buffer, "%c%c:%d", 'A' + i % 26, 'A' + (i / 26) % 26, i / 676 + 1 );
+		names[i] = buffer;
+	}
+
+	// cells of a sheet 100 columns wide
+
+	CxSheetCellCoordinate *cells = new CxSheetCellCoordinate[n];
+
+	for (int i=0; i<n; i++) {
+		cells[i] = CxSheetCellCoordinate( i / 100, i % 100 );
+	}
+
+	int failed = run( "CxString", names, n );
+	failed |= run( "coordinate", cells, n );
+
+	delete [] names;
+	delete [] cells;
+
+	printf( failed ? "FAILED\n" : "passed\n" );
+
+	return( failed ? 1 : 0 );
+}
@@ -129,6 +129,12 @@ CxSheetDependencyGraph::removeDependency(CxSheetCellCoordinate formula,
     for (int i = 0; i < (int)depList->entries(); i++) {
         if (depList->at(i) == formula) {
             depList->removeAt(i);
+
+            // Drop the entry entirely once nothing depends on the cell,
+            // so the map doesn't fill up with empty lists.
+            if (depList->entries() == 0) {
+                dependents.remove(referencedCell);
+            }
             return;  // Found and removed - we're done.
         }
     }
@@ -171,6 +177,10 @@ CxSheetDependencyGraph::clearDependenciesFor(CxSheetCellCoordinate formula)
     // We need to check every cell's dependents list and remove 'formula' if present.
     // This is O(n) where n is the number of cells that have dependents.
 
+    // Lists that end up empty are collected and removed from the map after
+    // the walk (removing while iterating would shift slots under the iterator).
+    CxSList<CxSheetCellCoordinate> emptied;
+
     CxHashmapIterator<CxSheetCellCoordinate, CxSList<CxSheetCellCoordinate> > iter(&dependents);
 
     while (iter.next()) {
@@ -180,14 +190,25 @@ CxSheetDependencyGraph::clearDependenciesFor(CxSheetCellCoordinate formula)
             continue;
         }
 
-        // Search for 'formula' in this list and remove it.
-        for (int i = 0; i < (int)depList->entries(); i++) {
-            if (depList->at(i) == formula) {
+        // Search for 'formula' in this list and remove it.  The lists are
+        // walked with iterators, at(i) on a CxSList starts from the head.
+        int i = 0;
+        for (CxSListIterator<CxSheetCellCoordinate> it = depList->begin();
+             it.getCurrentNode() != NULL; ++it, i++) {
+            if (*it == formula) {
                 depList->removeAt(i);
+                if (depList->entries() == 0) {
+                    emptied.append(*iter.getKey());
+                }
                 break;  // Each cell appears at most once per list.
             }
         }
     }
+
+    for (CxSListIterator<CxSheetCellCoordinate> it = emptied.begin();
+         it.getCurrentNode() != NULL; ++it) {
+        dependents.remove(*it);
+    }
 }
 
 
@@ -286,22 +307,9 @@ CxSheetDependencyGraph::getDependentCount(CxSheetCellCoordinate cell)
 void
 CxSheetDependencyGraph::clear(void)
 {
-    // The hashmap doesn't have a clear() method, so we need to
-    // iterate and remove entries. For now, we can just let
-    // the model create a new graph if needed.
-    //
-    // TODO: Add a clear method if this becomes a performance issue.
-    // For now, this is called rarely (only on reset).
-
-    // Walk through and clear each list
-    CxHashmapIterator<CxSheetCellCoordinate, CxSList<CxSheetCellCoordinate> > iter(&dependents);
-
-    while (iter.next()) {
-        CxSList<CxSheetCellCoordinate>* depList = iter.getEntry();
-        if (depList != NULL) {
-            depList->clear();
-        }
-    }
+    // Drop every entry. The table keeps its size, so a sheet that is
+    // reloaded doesn't have to grow it again.
+    dependents.clear();
 }
 
 
@@ -27,6 +27,8 @@
 #include <cx/json/json_null.h>
 #include <cx/json/json_object.h>
 #include <cx/json/json_array.h>
+#include <cx/json/json_reader.h>
+#include <cx/json/json_writer.h>
 
 
 //-------------------------------------------------------------------------
@@ -67,6 +69,8 @@ CxSheetModel::CxSheetModel(const CxSheetModel& other)
     // Copy cells using iterator (we'll rebuild dependencies after)
     loadingInProgress = 1;  // Prevent recalculation during cell insert
 
+    cellHashMap.reserve(other.cellHashMap.getSize());
+
     CxHashmapIterator<CxSheetCellCoordinate, CxSheetCell> iter(
         (CxHashmap<CxSheetCellCoordinate, CxSheetCell>*)&other.cellHashMap);
 
@@ -126,6 +130,8 @@ CxSheetModel::operator=(const CxSheetModel& other)
         // (created in constructor, not changed here)
 
         // Copy cells using iterator
+        cellHashMap.reserve(other.cellHashMap.getSize());
+
         CxHashmapIterator<CxSheetCellCoordinate, CxSheetCell> iter(
             (CxHashmap<CxSheetCellCoordinate, CxSheetCell>*)&other.cellHashMap);
 
@@ -149,10 +155,6 @@ CxSheetModel::operator=(const CxSheetModel& other)
 void
 CxSheetModel::reset(void)
 {
-    // Create a new empty hashmap by reconstructing
-    // Note: We need to be careful here as CxHashmap doesn't have a clear() method
-    // The destructor will be called when we go out of scope
-
     currentCellPosition = CxSheetCellCoordinate(0, 0);
     sheetPath = CxString();
     readOnly = 0;
@@ -160,11 +162,11 @@ CxSheetModel::reset(void)
     maxRowUsed = 0;
     maxColUsed = 0;
 
+    // Remove all cells (the table keeps its size for the next load)
+    cellHashMap.clear();
+
     // Clear the dependency graph since all cells are being removed
     dependencyGraph.clear();
-
-    // Note: To truly clear the hashmap, we would need to iterate and remove
-    // or reconstruct it. For now, setting extents to 0 effectively marks it empty.
 }
 
 
@@ -375,39 +377,65 @@ CxSheetModel::setCell(CxSheetCellCoordinate coord, CxSheetCell cell)
 //
 // Load the sheet from disk. Sheet is stored in json format
 // Returns 1 on success, 0 on failure
+//
+// The file is streamed through a CxJSONReader, so only one cell is held as
+// a JSON tree at a time however large the sheet is.  A first pass checks
+// the whole file and counts the cells before anything is changed, so a bad
+// file leaves the current sheet alone.
 //-------------------------------------------------------------------------
 int
 CxSheetModel::loadSheet(CxString filepath)
 {
-    // Open and read the file
     CxFile inFile;
     if (!inFile.open(filepath, "r")) {
         return 0;
     }
 
-    // Read entire file contents
-    CxString buffer;
-    CxString line = inFile.getUntil('\n');
-    while (line.length()) {
-        buffer += line;
-        line = inFile.getUntil('\n');
-    }
-    inFile.close();
+    //-------------------------------------------------------------------------
+    // First pass: check the JSON and count the objects in the cells array
+    //-------------------------------------------------------------------------
+    unsigned long cellCount = 0;
+    {
+        CxJSONReader check(&inFile);
 
-    if (buffer.length() == 0) {
-        return 0;
-    }
+        if (check.next() != CxJSONReader::START_OBJECT) {
+            inFile.close();
+            return 0;
+        }
+
+        int cellsKey = 0;
+        int inCells = 0;
+
+        CxJSONReader::EVENT e = check.next();
+        while (e != CxJSONReader::END_DOCUMENT) {
 
-    // Parse JSON
-    CxJSONBase *parsed = CxJSONFactory::parse(buffer);
-    if (parsed == NULL || parsed->type() != CxJSONBase::OBJECT) {
-        if (parsed != NULL) {
-            delete parsed;
+            if (e == CxJSONReader::ERROR) {
+                inFile.close();
+                return 0;
+            }
+
+            if (check.depth() == 1) {
+                if (e == CxJSONReader::KEY) {
+                    cellsKey = (check.string() == "cells");
+                }
+                inCells = 0;
+            } else if (check.depth() == 2 && e == CxJSONReader::START_ARRAY) {
+                inCells = cellsKey;
+            } else if (check.depth() == 3 && e == CxJSONReader::START_OBJECT && inCells) {
+                cellCount++;
+            }
+
+            e = check.next();
         }
-        return 0;
     }
 
-    CxJSONObject *root = (CxJSONObject *)parsed;
+    //-------------------------------------------------------------------------
+    // Second pass: load from the top of the file again
+    //-------------------------------------------------------------------------
+    inFile.seek(0, SEEK_SET);
+
+    CxJSONReader reader(&inFile);
+    reader.next();
 
     // Reset the model before loading
     reset();
@@ -420,140 +448,175 @@ CxSheetModel::loadSheet(CxString filepath)
     //-------------------------------------------------------------------------
     loadingInProgress = 1;
 
-    // Load current position if present (stored as cell address like "A:1")
-    CxJSONMember *posMember = root->find("currentPosition");
-    if (posMember != NULL && posMember->object()->type() == CxJSONBase::STRING) {
-        CxString posAddr = ((CxJSONString *)posMember->object())->get();
-        currentCellPosition.parseAddress(posAddr);
-    }
+    // Size the cell table once for the whole sheet instead of growing it
+    // repeatedly while the cells are inserted.
+    cellHashMap.reserve(cellCount);
 
-    // Load cells
-    CxJSONMember *cellsMember = root->find("cells");
-    if (cellsMember != NULL && cellsMember->object()->type() == CxJSONBase::ARRAY) {
-        CxJSONArray *cellsArray = (CxJSONArray *)cellsMember->object();
+    // each cell is built in the arena and given back before the next
+    CxArena arena;
 
-        for (int i = 0; i < cellsArray->entries(); i++) {
-            CxJSONBase *cellBase = cellsArray->at(i);
+    while (reader.next() == CxJSONReader::KEY) {
 
-            if (cellBase->type() != CxJSONBase::OBJECT) {
-                continue;
-            }
+        CxString key = reader.string();
 
-            CxJSONObject *cellObj = (CxJSONObject *)cellBase;
+        // Load current position if present (stored as cell address like "A:1")
+        if (key == "currentPosition") {
+            if (reader.next() == CxJSONReader::STRING) {
+                currentCellPosition.parseAddress(reader.string());
+            } else {
+                reader.skip();
+            }
+        }
 
-            // Get cell address (e.g., "A:1", "B:2")
-            CxJSONMember *cellMember = cellObj->find("cell");
-            CxJSONMember *typeMember = cellObj->find("type");
+        // Load cells
+        else if (key == "cells") {
+            if (reader.next() == CxJSONReader::START_ARRAY) {
+                CxJSONReader::EVENT e = reader.next();
+                while (e != CxJSONReader::END_ARRAY && e != CxJSONReader::ERROR) {
+                    CxArenaScope scope(&arena);
 
-            if (cellMember == NULL || typeMember == NULL) {
-                continue;
+                    CxJSONBase *cellBase = reader.value(&arena);
+                    if (cellBase != NULL && cellBase->type() == CxJSONBase::OBJECT) {
+                        loadCell((CxJSONObject *)cellBase);
+                    }
+                    e = reader.next();
+                }
+            } else {
+                reader.skip();
             }
+        }
 
-            if (cellMember->object()->type() != CxJSONBase::STRING ||
-                typeMember->object()->type() != CxJSONBase::STRING) {
-                continue;
-            }
+        else {
+            reader.skip();
+        }
+    }
 
-            CxString cellAddr = ((CxJSONString *)cellMember->object())->get();
-            CxString type = ((CxJSONString *)typeMember->object())->get();
+    inFile.close();
 
-            CxSheetCellCoordinate coord;
-            if (!coord.parseAddress(cellAddr)) {
-                continue;  // Skip invalid addresses
-            }
+    //-------------------------------------------------------------------------
+    // Loading complete - now recalculate all formulas.
+    // This is done once at the end rather than after each cell insert.
+    //-------------------------------------------------------------------------
+    loadingInProgress = 0;
+    recalculateAll();
 
-            CxSheetCell cell;
+    // the file changed between the two passes
+    if (reader.event() == CxJSONReader::ERROR) {
+        return 0;
+    }
 
-            if (type == "text") {
-                CxJSONMember *textMember = cellObj->find("text");
-                if (textMember != NULL && textMember->object()->type() == CxJSONBase::STRING) {
-                    cell.setText(((CxJSONString *)textMember->object())->get());
-                }
-            }
-            else if (type == "double") {
-                CxJSONMember *valueMember = cellObj->find("value");
-                if (valueMember != NULL && valueMember->object()->type() == CxJSONBase::NUMBER) {
-                    cell.setDouble(CxDouble(((CxJSONNumber *)valueMember->object())->get()));
-                }
+    sheetPath = filepath;
+    touched = 0;
+    return 1;
+}
 
-                // Load display settings
-                CxJSONMember *decMember = cellObj->find("decimalPlaces");
-                if (decMember != NULL && decMember->object()->type() == CxJSONBase::NUMBER) {
-                    cell.displayDecimalPlaces = (int)((CxJSONNumber *)decMember->object())->get();
-                }
 
-                CxJSONMember *currMember = cellObj->find("currency");
-                if (currMember != NULL && currMember->object()->type() == CxJSONBase::BOOLEAN) {
-                    cell.displayCurrency = ((CxJSONBoolean *)currMember->object())->get();
-                }
+//-------------------------------------------------------------------------
+// CxSheetModel::loadCell
+//
+// Insert one cell object from a sheet file into the model.  Objects without
+// a valid cell address and type are skipped.
+//-------------------------------------------------------------------------
+void
+CxSheetModel::loadCell(CxJSONObject *cellObj)
+{
+    // Get cell address (e.g., "A:1", "B:2")
+    CxJSONMember *cellMember = cellObj->find("cell");
+    CxJSONMember *typeMember = cellObj->find("type");
 
-                CxJSONMember *commaMember = cellObj->find("commas");
-                if (commaMember != NULL && commaMember->object()->type() == CxJSONBase::BOOLEAN) {
-                    cell.displayCommas = ((CxJSONBoolean *)commaMember->object())->get();
-                }
-            }
-            else if (type == "formula") {
-                CxJSONMember *formulaMember = cellObj->find("formula");
-                if (formulaMember != NULL && formulaMember->object()->type() == CxJSONBase::STRING) {
-                    CxString formulaText = ((CxJSONString *)formulaMember->object())->get();
-                    // Strip leading "=" if present (added for readability in saved files)
-                    if (formulaText.length() > 0 && formulaText.data()[0] == '=') {
-                        formulaText = CxString(formulaText.data() + 1);
-                    }
-                    cell.setFormula(formulaText);
-                }
+    if (cellMember == NULL || typeMember == NULL) {
+        return;
+    }
 
-                // Load display settings
-                CxJSONMember *decMember = cellObj->find("decimalPlaces");
-                if (decMember != NULL && decMember->object()->type() == CxJSONBase::NUMBER) {
-                    cell.displayDecimalPlaces = (int)((CxJSONNumber *)decMember->object())->get();
-                }
+    if (cellMember->object()->type() != CxJSONBase::STRING ||
+        typeMember->object()->type() != CxJSONBase::STRING) {
+        return;
+    }
 
-                CxJSONMember *currMember = cellObj->find("currency");
-                if (currMember != NULL && currMember->object()->type() == CxJSONBase::BOOLEAN) {
-                    cell.displayCurrency = ((CxJSONBoolean *)currMember->object())->get();
-                }
+    CxString cellAddr = ((CxJSONString *)cellMember->object())->get();
+    CxString type = ((CxJSONString *)typeMember->object())->get();
 
-                CxJSONMember *commaMember = cellObj->find("commas");
-                if (commaMember != NULL && commaMember->object()->type() == CxJSONBase::BOOLEAN) {
-                    cell.displayCommas = ((CxJSONBoolean *)commaMember->object())->get();
-                }
-            }
+    CxSheetCellCoordinate coord;
+    if (!coord.parseAddress(cellAddr)) {
+        return;  // Skip invalid addresses
+    }
 
-            // Load formatting attributes (common to all cell types)
-            CxJSONMember *boldMember = cellObj->find("bold");
-            if (boldMember != NULL && boldMember->object()->type() == CxJSONBase::BOOLEAN) {
-                cell.bold = ((CxJSONBoolean *)boldMember->object())->get() ? 1 : 0;
-            }
+    CxSheetCell cell;
 
-            CxJSONMember *fgColorMember = cellObj->find("fgColor");
-            if (fgColorMember != NULL && fgColorMember->object()->type() == CxJSONBase::STRING) {
-                cell.fgColor = ((CxJSONString *)fgColorMember->object())->get();
-            }
+    if (type == "text") {
+        CxJSONMember *textMember = cellObj->find("text");
+        if (textMember != NULL && textMember->object()->type() == CxJSONBase::STRING) {
+            cell.setText(((CxJSONString *)textMember->object())->get());
+        }
+    }
+    else if (type == "double") {
+        CxJSONMember *valueMember = cellObj->find("value");
+        if (valueMember != NULL && valueMember->object()->type() == CxJSONBase::NUMBER) {
+            cell.setDouble(CxDouble(((CxJSONNumber *)valueMember->object())->get()));
+        }
+
+        // Load display settings
+        CxJSONMember *decMember = cellObj->find("decimalPlaces");
+        if (decMember != NULL && decMember->object()->type() == CxJSONBase::NUMBER) {
+            cell.displayDecimalPlaces = (int)((CxJSONNumber *)decMember->object())->get();
+        }
 
-            CxJSONMember *bgColorMember = cellObj->find("bgColor");
-            if (bgColorMember != NULL && bgColorMember->object()->type() == CxJSONBase::STRING) {
-                cell.bgColor = ((CxJSONString *)bgColorMember->object())->get();
+        CxJSONMember *currMember = cellObj->find("currency");
+        if (currMember != NULL && currMember->object()->type() == CxJSONBase::BOOLEAN) {
+            cell.displayCurrency = ((CxJSONBoolean *)currMember->object())->get();
+        }
+
+        CxJSONMember *commaMember = cellObj->find("commas");
+        if (commaMember != NULL && commaMember->object()->type() == CxJSONBase::BOOLEAN) {
+            cell.displayCommas = ((CxJSONBoolean *)commaMember->object())->get();
+        }
+    }
+    else if (type == "formula") {
+        CxJSONMember *formulaMember = cellObj->find("formula");
+        if (formulaMember != NULL && formulaMember->object()->type() == CxJSONBase::STRING) {
+            CxString formulaText = ((CxJSONString *)formulaMember->object())->get();
+            // Strip leading "=" if present (added for readability in saved files)
+            if (formulaText.length() > 0 && formulaText.data()[0] == '=') {
+                formulaText = CxString(formulaText.data() + 1);
             }
+            cell.setFormula(formulaText);
+        }
 
-            // Insert cell into model (setCell will update maxRowUsed/maxColUsed)
-            setCell(coord, cell);
+        // Load display settings
+        CxJSONMember *decMember = cellObj->find("decimalPlaces");
+        if (decMember != NULL && decMember->object()->type() == CxJSONBase::NUMBER) {
+            cell.displayDecimalPlaces = (int)((CxJSONNumber *)decMember->object())->get();
+        }
+
+        CxJSONMember *currMember = cellObj->find("currency");
+        if (currMember != NULL && currMember->object()->type() == CxJSONBase::BOOLEAN) {
+            cell.displayCurrency = ((CxJSONBoolean *)currMember->object())->get();
+        }
+
+        CxJSONMember *commaMember = cellObj->find("commas");
+        if (commaMember != NULL && commaMember->object()->type() == CxJSONBase::BOOLEAN) {
+            cell.displayCommas = ((CxJSONBoolean *)commaMember->object())->get();
         }
     }
 
-    // Clean up
-    delete root;
+    // Load formatting attributes (common to all cell types)
+    CxJSONMember *boldMember = cellObj->find("bold");
+    if (boldMember != NULL && boldMember->object()->type() == CxJSONBase::BOOLEAN) {
+        cell.bold = ((CxJSONBoolean *)boldMember->object())->get() ? 1 : 0;
+    }
 
-    //-------------------------------------------------------------------------
-    // Loading complete - now recalculate all formulas.
-    // This is done once at the end rather than after each cell insert.
-    //-------------------------------------------------------------------------
-    loadingInProgress = 0;
-    recalculateAll();
+    CxJSONMember *fgColorMember = cellObj->find("fgColor");
+    if (fgColorMember != NULL && fgColorMember->object()->type() == CxJSONBase::STRING) {
+        cell.fgColor = ((CxJSONString *)fgColorMember->object())->get();
+    }
 
-    sheetPath = filepath;
-    touched = 0;
-    return 1;
+    CxJSONMember *bgColorMember = cellObj->find("bgColor");
+    if (bgColorMember != NULL && bgColorMember->object()->type() == CxJSONBase::STRING) {
+        cell.bgColor = ((CxJSONString *)bgColorMember->object())->get();
+    }
+
+    // Insert cell into model (setCell will update maxRowUsed/maxColUsed)
+    setCell(coord, cell);
 }
 
 
@@ -584,18 +647,27 @@ CxSheetModel::loadSheet(CxString filepath)
 int
 CxSheetModel::saveSheet(CxString filepath)
 {
-    // Create the root JSON object
-    CxJSONObject *root = new CxJSONObject();
+    CxFile outFile;
+    if (!outFile.open(filepath, "w")) {
+        return 0;
+    }
+
+    // Cells are written to the file as they are visited, no JSON tree is built
+    CxJSONWriter writer(&outFile);
+
+    writer.beginObject();
 
     // Add version
-    root->append(new CxJSONMember("version", new CxJSONNumber(1)));
+    writer.key("version");
+    writer.number(1);
 
     // Add current position as cell address (e.g., "A:1")
-    root->append(new CxJSONMember("currentPosition",
-        new CxJSONString(currentCellPosition.toAddress())));
+    writer.key("currentPosition");
+    writer.string(currentCellPosition.toAddress());
 
     // Add cells array
-    CxJSONArray *cellsArray = new CxJSONArray();
+    writer.key("cells");
+    writer.beginArray();
 
     // Iterate through all cells and add to array
     CxHashmapIterator<CxSheetCellCoordinate, CxSheetCell> iter(&cellHashMap);
@@ -608,78 +680,87 @@ CxSheetModel::saveSheet(CxString filepath)
             continue;
         }
 
-        // Skip empty cells
-        if (cell->getType() == CxSheetCell::EMPTY) {
+        // Skip empty cells and unknown types
+        if (cell->getType() != CxSheetCell::TEXT &&
+            cell->getType() != CxSheetCell::DOUBLE &&
+            cell->getType() != CxSheetCell::FORMULA) {
             continue;
         }
 
-        CxJSONObject *cellObj = new CxJSONObject();
+        writer.beginObject();
 
         // Add cell address (e.g., "A:1", "B:2")
-        cellObj->append(new CxJSONMember("cell", new CxJSONString(key->toAddress())));
+        writer.key("cell");
+        writer.string(key->toAddress());
 
         // Add type-specific data
         switch (cell->getType()) {
 
             case CxSheetCell::TEXT:
-                cellObj->append(new CxJSONMember("type", new CxJSONString("text")));
-                cellObj->append(new CxJSONMember("text", new CxJSONString(cell->getText())));
+                writer.key("type");
+                writer.string("text");
+                writer.key("text");
+                writer.string(cell->getText());
                 break;
 
             case CxSheetCell::DOUBLE:
-                cellObj->append(new CxJSONMember("type", new CxJSONString("double")));
-                cellObj->append(new CxJSONMember("value", new CxJSONNumber(cell->getDouble().value)));
-                cellObj->append(new CxJSONMember("decimalPlaces", new CxJSONNumber(cell->displayDecimalPlaces)));
-                cellObj->append(new CxJSONMember("currency", new CxJSONBoolean(cell->displayCurrency)));
-                cellObj->append(new CxJSONMember("commas", new CxJSONBoolean(cell->displayCommas)));
+                writer.key("type");
+                writer.string("double");
+                writer.key("value");
+                writer.number(cell->getDouble().value);
+                writer.key("decimalPlaces");
+                writer.number(cell->displayDecimalPlaces);
+                writer.key("currency");
+                writer.boolean(cell->displayCurrency);
+                writer.key("commas");
+                writer.boolean(cell->displayCommas);
                 break;
 
             case CxSheetCell::FORMULA:
-                cellObj->append(new CxJSONMember("type", new CxJSONString("formula")));
+                writer.key("type");
+                writer.string("formula");
                 // Prepend "=" for readability (like Excel)
-                cellObj->append(new CxJSONMember("formula",
-                    new CxJSONString(CxString("=") + cell->getFormulaText())));
-                cellObj->append(new CxJSONMember("decimalPlaces", new CxJSONNumber(cell->displayDecimalPlaces)));
-                cellObj->append(new CxJSONMember("currency", new CxJSONBoolean(cell->displayCurrency)));
-                cellObj->append(new CxJSONMember("commas", new CxJSONBoolean(cell->displayCommas)));
+                writer.key("formula");
+                writer.string(CxString("=") + cell->getFormulaText());
+                writer.key("decimalPlaces");
+                writer.number(cell->displayDecimalPlaces);
+                writer.key("currency");
+                writer.boolean(cell->displayCurrency);
+                writer.key("commas");
+                writer.boolean(cell->displayCommas);
                 break;
 
             default:
-                // Skip unknown types
-                delete cellObj;
-                continue;
+                break;
         }
 
         // Add formatting attributes (only if set to non-default values)
         if (cell->bold) {
-            cellObj->append(new CxJSONMember("bold", new CxJSONBoolean(1)));
+            writer.key("bold");
+            writer.boolean(1);
         }
         if (cell->fgColor.length() > 0) {
-            cellObj->append(new CxJSONMember("fgColor", new CxJSONString(cell->fgColor)));
+            writer.key("fgColor");
+            writer.string(cell->fgColor);
         }
         if (cell->bgColor.length() > 0) {
-            cellObj->append(new CxJSONMember("bgColor", new CxJSONString(cell->bgColor)));
+            writer.key("bgColor");
+            writer.string(cell->bgColor);
         }
 
-        cellsArray->append(cellObj);
+        writer.endObject();
     }
 
-    root->append(new CxJSONMember("cells", cellsArray));
+    writer.endArray();
+    writer.endObject();
 
-    // Write to file
-    CxFile outFile;
-    if (!outFile.open(filepath, "w")) {
-        delete root;
-        return 0;
-    }
-
-    // Serialize to string using portable toJsonString() method
-    CxString jsonStr = root->toJsonString();
-    outFile.printf("%s\n", jsonStr.data());
+    int written = writer.flush();
+    outFile.printf("\n");
     outFile.close();
 
-    // Clean up
-    delete root;
+    if (!written) {
+        return 0;
+    }
 
     sheetPath = filepath;
     touched = 0;
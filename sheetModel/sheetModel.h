@@ -31,8 +31,9 @@
 #ifndef _CxSheetModel_
 #define _CxSheetModel_
 
-// Forward declaration
+// Forward declarations
 class CxSheetVariableDatabase;
+class CxJSONObject;
 
 
 //-------------------------------------------------------------------------------------------------
@@ -195,6 +196,9 @@ class CxSheetModel
     // When loading, we don't want to recalculate after every cell insert.
     // Instead, we do one full recalculation at the end of loading.
 
+    void loadCell(CxJSONObject *cellObj);
+    // Insert one cell object read by loadSheet() into the model.
+
     void recalculateAll(void);
     // Recalculate ALL formula cells in dependency order.
     // Used after loading a sheet (can't use targeted recalc since everything is new).
@@ -59,6 +59,8 @@ class CxPCQueue
 	CxMutex      _lock;
 	CxCondition  _notFull;
 	CxCondition  _notEmpty;
+
+	CxListNodePool< T > _nodePool;
 	CxSList< T > _list;
 };
 
@@ -71,6 +73,10 @@ template <class T>
 CxPCQueue<T>::CxPCQueue( size_t qSize_ )
 :_qSize( qSize_ )
 {
+	// the list is only touched under _lock, so it can recycle its nodes
+	// through an unlocked pool.  Once the queue has been as deep as it
+	// will get, enQueue and deQueue stop calling the allocator
+	_list.setNodePool( &_nodePool );
 }
 
 
@@ -12,10 +12,9 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <stdio.h>
-#include <iostream.h>
 
 #include <cx/base/string.h>
-#include <cx/base/slist.h>
+#include <cx/base/array.h>
 #include <cx/base/exception.h>
 #include <cx/thread/mutex.h>
 #include <cx/thread/thread.h>
@@ -49,8 +48,10 @@ class CxPriorityQueue
 	// throws CxConditionTimeoutException if time expires
 
 	T deQueue( double minPriority_, double maxPriority_, time_t waitSec_=0 );
-	// remove an item or items from the sample queue that occurred between min
-	// and max sample time.
+	// remove the item with the earliest sample time from the queue and
+	// return it, waiting while the queue is empty.  It is taken off the
+	// queue, as CxSList::first() did before the queue moved to CxArray.
+	// minPriority_ and maxPriority_ are not used.
 	// throws CxConditionTimeoutException if time expires
 
   private:
@@ -59,7 +60,7 @@ class CxPriorityQueue
 	CxMutex      _lock;
 	CxCondition  _notFull;
 	CxCondition  _notEmpty;
-	CxSList< T > _list;
+	CxArray< T > _list;
 };
 
 
@@ -114,46 +115,26 @@ CxPriorityQueue<T>::enQueue( T s_, time_t sec_ )
 		}
 	}
 
-	// ok insert the message in the message queue according to the correct priority
-	int c;
+	// ok insert the item in the queue according to its priority.  The queue
+	// is kept sorted by sample time, so binary search for the first item
+	// with a later sample time and insert in front of it.  Items with equal
+	// sample times stay in the order they were queued.
+	int low  = 0;
+	int high = (int) _list.entries();
 
-	CxMessage *lastMessage = NULL;
-	CxMessage *thisMessage = NULL;
+	while (low < high) {
 
-	int nMessages = _list.entries();
+		int mid = low + (high - low) / 2;
 
-	for (c=0; c<nMessages; c++) {
-
-		lastMessage = thisMessage;
-		thisMessage = _list.at(c);
-
-		// if this is the first item in the list
-		if (c==0) {
-			if ( newMessage->sampleTime() < thisMessage->sampleTime() ) {
-				_list.insertBefore( c, newMessage );
-				break;
-			}
-		}
-
-		// if this is not the first item
-		if ((c>0) && (c<nMessage-1)) {
-			// if the message is between this and last
-			if ((newMessage->sampleTime() >= lastMessage->sampleTime()) &&
-		    	(newMessage->sampleTime() <= thisMessage->sampleTime())) 
-				_list.insertBefore( c, newMessage );
-			}
-		}
-
-		// if this is the last item in the list
-		if (c==nMessage-1) {
-			
-			if (newMessage->sampleTime() >= thisMessage->sampleTime()) {
-				_list.insertAfter( c, newMessage );
-				break;
-			}
+		if ( _list[mid]->sampleTime() <= s_->sampleTime() ) {
+			low = mid + 1;
+		} else {
+			high = mid;
 		}
 	}
 
+	_list.insertAt( low, s_ );
+
 	// ok we are done, release the lock.
 	_lock.release();
 
@@ -184,7 +165,8 @@ CxPriorityQueue<T>::deQueue( double minPriority_, double maxPriority_, time_t se
 		}
 	}
 
-	T s = _list.first();
+	T s = _list[0];
+	_list.removeAt( 0 );
 
 	_lock.release();
 
@@ -0,0 +1,192 @@
+//-------------------------------------------------------------------------------------------------
+//
+//  queuebench.cpp
+//  cx
+//
+//  Copyright 2022-2025 Todd Vernon. All rights reserved.
+//  Licensed under the Apache License, Version 2.0
+//  See LICENSE file for details.
+//
+//  queuebench.cpp
+//
+//  Counts the calls to operator new made moving items through a CxPCQueue
+//  and parsing a document with CxJSONFactory, the two places CxSList nodes
+//  hit the allocator hardest, and prints the CxListNodePool statistics for
+//  a list that is filled and cleared.  Not part of the library, build it
+//  against the cx libraries from this directory, all on one line:
+//
+//    g++ -D_LINUX_ -O2 -I../.. -o queuebench queuebench.cpp
+//        -L../../lib/linux_x86_64 -lcx_json -lcx_thread -lcx_base -lpthread
+//
+//  Run as "queuebench [rounds]", the default is 100000 rounds of 16 items.
+//  Build it with -DNO_NODEPOOL to run against a tree without the pool.
+//
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include <new>
+
+#include <cx/base/string.h>
+#include <cx/base/slist.h>
+#include <cx/thread/pc.h>
+#include <cx/json/json_factory.h>
+
+
+#define BURST 16
+
+
+static unsigned long allocations = 0;
+
+
+//-------------------------------------------------------------------------
+// operator new, new[], delete, delete[]
+//
+// count every allocation, the memory itself comes from malloc
+//
+//-------------------------------------------------------------------------
+void *
+operator new( size_t n )
+{
+	allocations++;
+	void *p = malloc( n ? n : 1 );
+	if (p == NULL) throw std::bad_alloc();
+	return( p );
+}
+
+void *
+operator new[]( size_t n )
+{
+	allocations++;
+	void *p = malloc( n ? n : 1 );
+	if (p == NULL) throw std::bad_alloc();
+	return( p );
+}
+
+void operator delete( void *p ) throw() { free( p ); }
+void operator delete[]( void *p ) throw() { free( p ); }
+void operator delete( void *p, size_t ) throw() { free( p ); }
+void operator delete[]( void *p, size_t ) throw() { free( p ); }
+
+
+//-------------------------------------------------------------------------
+// now
+//
+//-------------------------------------------------------------------------
+static double
+now( void )
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec + tv.tv_usec / 1e6 );
+}
+
+
+static CxPCQueue<int *> *queue;
+static int               rounds = 100000;
+static int               item;
+
+
+//-------------------------------------------------------------------------
+// consumer
+//
+//-------------------------------------------------------------------------
+static void *
+consumer( void * )
+{
+	for (int i=0; i<rounds * BURST; i++) queue->deQueue();
+	return( NULL );
+}
+
+
+//-------------------------------------------------------------------------
+// main
+//
+//-------------------------------------------------------------------------
+int
+main( int argc, char **argv )
+{
+	if (argc > 1) rounds = atoi( argv[1] );
+
+	CxPCQueue<int *> pcQueue( 64 );
+	queue = &pcQueue;
+
+	// one thread, bursts of BURST in then BURST out
+
+	unsigned long before = allocations;
+	double        start  = now();
+
+	for (int r=0; r<rounds; r++) {
+		for (int k=0; k<BURST; k++) queue->enQueue( &item );
+		for (int k=0; k<BURST; k++) queue->deQueue();
+	}
+
+	printf( "queue, 1 thread : %9d items  %9lu allocations  %.3f s\n",
+	        rounds * BURST, allocations - before, now() - start );
+
+	// a producer and a consumer
+
+	pthread_t id;
+
+	before = allocations;
+	start  = now();
+
+	pthread_create( &id, NULL, consumer, NULL );
+	for (int i=0; i<rounds * BURST; i++) queue->enQueue( &item );
+	pthread_join( id, NULL );
+
+	printf( "queue, 2 threads: %9d items  %9lu allocations  %.3f s\n",
+	        rounds * BURST, allocations - before, now() - start );
+
+	// a document of 2000 objects of 20 members
+
+	CxString doc( "[" );
+	char     buffer[64];
+
+	for (int i=0; i<2000; i++) {
+		doc += i ? ",{" : "{";
+		for (int m=0; m<20; m++) {
+			sprintf( buffer, "%s\"k%d\":%d", m ? "," : "", m, i * m );
+			doc += buffer;
+		}
+		doc += "}";
+	}
+	doc += "]";
+
+	before = allocations;
+	start  = now();
+
+	CxJSONBase *root = CxJSONFactory::parse( doc );
+
+	printf( "json parse      : %9d members  %7lu allocations  %.3f s\n",
+	        2000 * 20, allocations - before, now() - start );
+
+	delete root;
+
+#if !defined(NO_NODEPOOL)
+
+	// a list filled and cleared through its own pool
+
+	CxListNodePool<int> pool;
+	CxSList<int>        list;
+	list.setNodePool( &pool );
+
+	before = allocations;
+
+	for (int r=0; r<1000; r++) {
+		for (int i=0; i<1000; i++) list.append( i );
+		list.clear();
+	}
+
+	printf( "pool            : allocated %lu  recycled %lu  peak %lu  blocks %lu  "
+	        "%lu allocations\n", pool.allocated(), pool.recycled(), pool.peak(),
+	        pool.blocks(), allocations - before );
+
+	list.setNodePool( NULL );
+
+#endif
+
+	return( 0 );
+}